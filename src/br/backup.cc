@@ -109,7 +109,10 @@ butil::Status Backup::Init() {
   auto lambda_exit_function = [this, &status]() {
     if (!status.ok()) {
       DoFinish();
-      last_error_ = status;
+      BAIDU_SCOPED_LOCK(mutex_);
+      if (last_error_.ok()) {
+        last_error_ = status;
+      }
     };
   };
 
@@ -244,7 +247,10 @@ butil::Status Backup::Run() {
   auto lambda_exit_function = [this, &status]() {
     if (!status.ok()) {
       DoFinish();
-      last_error_ = status;
+      BAIDU_SCOPED_LOCK(mutex_);
+      if (last_error_.ok()) {
+        last_error_ = status;
+      }
     };
   };
 
@@ -899,7 +905,9 @@ butil::Status Backup::DoRegisterBackupToCoordinatorInternal(ServerInteractionPtr
       }
       {
         BAIDU_SCOPED_LOCK(mutex_);
-        last_error_ = status;
+        if (last_error_.ok()) {
+          last_error_ = status;
+        }
       }
       break;
     }
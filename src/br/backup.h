@@ -108,7 +108,7 @@ class Backup : public std::enable_shared_from_this<Backup> {
   bool balance_leader_enable_after_finish_;
   bool balance_region_enable_after_finish_;
 
-  // last error
+  // last error, protected by mutex_
   butil::Status last_error_;
 
   std::shared_ptr<BackupMeta> backup_meta_;
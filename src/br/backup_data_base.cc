@@ -52,6 +52,18 @@ void BackupDataBase::SetRegionMap(std::shared_ptr<dingodb::pb::common::RegionMap
   region_map_ = region_map;
 }
 
+void BackupDataBase::SetLastError(const butil::Status& status) {
+  std::lock_guard<std::mutex> guard(last_error_mutex_);
+  if (last_error_.ok()) {
+    last_error_ = status;
+  }
+}
+
+butil::Status BackupDataBase::GetLastError() {
+  std::lock_guard<std::mutex> guard(last_error_mutex_);
+  return last_error_;
+}
+
 butil::Status BackupDataBase::Filter() { return butil::Status::OK(); }
 
 butil::Status BackupDataBase::Run() { return butil::Status::OK(); }
@@ -274,11 +286,16 @@ butil::Status BackupDataBase::DoBackupRegionInternal(
     ServerInteractionPtr interaction, const std::string& service_name,
     std::shared_ptr<std::vector<dingodb::pb::common::Region>> wait_for_handle_regions,
     std::atomic<int64_t>& already_handle_regions,
-    std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_region_map) {
-  for (const auto& region : *wait_for_handle_regions) {
-    if (is_need_exit_) {
+    std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_region_map,
+    std::shared_ptr<std::atomic<int64_t>> next_region_index) {
+  // workers share next_region_index, every worker take the next unhandled region.
+  while (!is_need_exit_) {
+    int64_t region_index = next_region_index->fetch_add(1);
+    if (region_index >= static_cast<int64_t>(wait_for_handle_regions->size())) {
       break;
     }
+    const auto& region = (*wait_for_handle_regions)[region_index];
+
     dingodb::pb::store::BackupDataRequest request;
     dingodb::pb::store::BackupDataResponse response;
 
@@ -301,7 +318,7 @@ butil::Status BackupDataBase::DoBackupRegionInternal(
       is_need_exit_ = true;
       std::string s = fmt::format("Fail to backup region, region_id={}, status={}", region.id(), status.error_cstr());
       DINGO_LOG(ERROR) << s;
-      last_error_ = status;
+      SetLastError(status);
       return status;
     }
 
@@ -311,13 +328,16 @@ butil::Status BackupDataBase::DoBackupRegionInternal(
           fmt::format("Fail to backup region, region_id={}, error={}", region.id(), response.error().errmsg());
       DINGO_LOG(ERROR) << s;
       status = butil::Status(response.error().errcode(), s);
-      last_error_ = status;
+      SetLastError(status);
       return status;
     }
 
     DINGO_LOG_IF(INFO, FLAGS_br_log_switch_backup_detail_detail) << name_ << " " << response.DebugString();
 
-    save_region_map->insert({region.id(), response.sst_metas()});
+    {
+      std::lock_guard<std::mutex> guard(save_region_map_mutex_);
+      save_region_map->insert({region.id(), response.sst_metas()});
+    }
 
     already_handle_regions++;
   }
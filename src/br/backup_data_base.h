@@ -15,8 +15,10 @@
 #ifndef DINGODB_BR_BACKUP_DATA_BASE_H_
 #define DINGODB_BR_BACKUP_DATA_BASE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "br/interation.h"
@@ -51,6 +53,10 @@ class BackupDataBase {
 
   std::shared_ptr<std::vector<dingodb::pb::common::BackupMeta>> GetBackupMeta();
 
+  // regions are backup concurrently, keep the first error.
+  void SetLastError(const butil::Status& status);
+  butil::Status GetLastError();
+
   friend BackupSdkData;
   friend BackupSqlData;
 
@@ -66,7 +72,8 @@ class BackupDataBase {
       ServerInteractionPtr interaction, const std::string& service_name,
       std::shared_ptr<std::vector<dingodb::pb::common::Region>> wait_for_handle_regions,
       std::atomic<int64_t>& already_handle_regions,
-      std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_region_map);
+      std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_region_map,
+      std::shared_ptr<std::atomic<int64_t>> next_region_index);
 
  private:
   ServerInteractionPtr coordinator_interaction_;
@@ -95,6 +102,9 @@ class BackupDataBase {
   std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_index_region_map_;
   std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_document_region_map_;
 
+  // protect save_*_region_map_, regions are backup concurrently.
+  std::mutex save_region_map_mutex_;
+
   std::string name_;
 
   std::vector<std::string> save_region_files_;
@@ -103,6 +113,7 @@ class BackupDataBase {
   std::shared_ptr<std::vector<dingodb::pb::common::BackupMeta>> backup_data_base_;
 
   // last error
+  std::mutex last_error_mutex_;
   butil::Status last_error_;
 };
 
@@ -14,6 +14,7 @@
 
 #include "br/backup_sdk_data.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <ostream>
@@ -201,7 +202,7 @@ butil::Status BackupSdkData::Run() {
   }
 
   if (is_need_exit_) {
-    return last_error_;
+    return GetLastError();
   }
 
   std::cerr << ">" << " 100.00%" << " [" << "S:" << wait_for_handle_store_regions_->size()
@@ -228,35 +229,41 @@ butil::Status BackupSdkData::DoAsyncBackupRegion(
     std::atomic<int64_t>& already_handle_regions,
     std::shared_ptr<std::map<int64_t, dingodb::pb::common::BackupDataFileValueSstMetaGroup>> save_region_map) {
   std::shared_ptr<BackupSdkData> self = GetSelf();
-  auto lambda_call = [self, interaction, &service_name, wait_for_handle_regions, &already_handle_regions,
-                      save_region_map]() {
+  auto next_region_index = std::make_shared<std::atomic<int64_t>>(0);
+  auto lambda_call = [self, interaction, service_name, wait_for_handle_regions, &already_handle_regions,
+                      save_region_map, next_region_index]() {
     self->DoBackupRegionInternal(interaction, service_name, wait_for_handle_regions, already_handle_regions,
-                                 save_region_map);
+                                 save_region_map, next_region_index);
   };
 
+  uint32_t concurrency = std::max(1U, FLAGS_br_backup_region_concurrency);
+  concurrency = std::min(concurrency, static_cast<uint32_t>(std::max(wait_for_handle_regions->size(), 1UL)));
+
+  for (uint32_t i = 0; i < concurrency; i++) {
 #if defined(ENABLE_BACKUP_SDK_DATA_PTHREAD)
-  std::thread th(lambda_call);
-  th.detach();
+    std::thread th(lambda_call);
+    th.detach();
 #else
 
-  std::function<void()>* call = new std::function<void()>;
-  *call = lambda_call;
-  bthread_t th;
-
-  int ret = bthread_start_background(
-      &th, nullptr,
-      [](void* arg) -> void* {
-        auto* call = static_cast<std::function<void()>*>(arg);
-        (*call)();
-        delete call;
-        return nullptr;
-      },
-      call);
-  if (ret != 0) {
-    DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail");
-    return butil::Status(dingodb::pb::error::EINTERNAL, "bthread_start_background fail");
-  }
+    std::function<void()>* call = new std::function<void()>;
+    *call = lambda_call;
+    bthread_t th;
+
+    int ret = bthread_start_background(
+        &th, nullptr,
+        [](void* arg) -> void* {
+          auto* call = static_cast<std::function<void()>*>(arg);
+          (*call)();
+          delete call;
+          return nullptr;
+        },
+        call);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail");
+      return butil::Status(dingodb::pb::error::EINTERNAL, "bthread_start_background fail");
+    }
 #endif  // #if defined(ENABLE_BACKUP_SDK_DATA_PTHREAD)
+  }
 
   return butil::Status::OK();
 }
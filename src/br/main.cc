@@ -32,6 +32,7 @@
 #include "br/interaction_manager.h"
 #include "br/interation.h"
 #include "br/parameter.h"
+#include "br/restore.h"
 #include "br/utils.h"
 #include "butil/status.h"
 #include "common/helper.h"
@@ -466,6 +467,8 @@ int main(int argc, char* argv[]) {
         "--backupts='2020-01-01 "
         "00:00:00 +08:00' "
         "--storage=local:///opt/backup-2020-01-01\n");
+
+    printf("./dingodb_br --br_coor_url=127.0.0.1:22001 --br_type=restore --storage=local:///opt/backup-2020-01-01\n");
     exit(-1);
   }
 
@@ -537,18 +540,17 @@ int main(int argc, char* argv[]) {
       return -1;
     }
   } else if (br::FLAGS_br_type == "restore") {
-    // TODO : restore
-    DINGO_LOG(ERROR) << "br type not support, please check parameter --br_type=" << br::FLAGS_br_type;
-    return -1;
   } else {
     DINGO_LOG(ERROR) << "br type not support, please check parameter --br_type=" << br::FLAGS_br_type;
     return -1;
   }
 
-  status = br::Utils::ConvertBackupTsToTso(br::FLAGS_backupts, br::FLAGS_backuptso_internal);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return -1;
+  if (br::FLAGS_br_type == "backup") {
+    status = br::Utils::ConvertBackupTsToTso(br::FLAGS_backupts, br::FLAGS_backuptso_internal);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return -1;
+    }
   }
 
   if (br::FLAGS_storage.empty()) {
@@ -667,6 +669,64 @@ int main(int argc, char* argv[]) {
 
     DINGO_LOG(INFO) << "Backup finish";
 
+  } else if (br::FLAGS_br_type == "restore") {
+    br::RestoreParams params;
+    params.coor_url = br::FLAGS_br_coor_url;
+    params.br_type = br::FLAGS_br_type;
+    params.storage = br::FLAGS_storage;
+    params.storage_internal = br::FLAGS_storage_internal;
+
+    std::cout << "Full Restore Parameter :" << std::endl;
+    DINGO_LOG(INFO) << "Full Restore Parameter :";
+
+    std::cout << "coordinator url    : "
+              << br::InteractionManager::GetInstance().GetCoordinatorInteraction()->GetAddrsAsString() << std::endl;
+    DINGO_LOG(INFO) << "coordinator url    : "
+                    << br::InteractionManager::GetInstance().GetCoordinatorInteraction()->GetAddrsAsString();
+
+    std::cout << "br type            : " << params.br_type << std::endl;
+    DINGO_LOG(INFO) << "br type            : " << params.br_type;
+
+    std::cout << "storage            : " << params.storage << std::endl;
+    DINGO_LOG(INFO) << "storage            : " << params.storage;
+
+    std::cout << "storage_internal   : " << params.storage_internal << std::endl;
+    DINGO_LOG(INFO) << "storage_internal   : " << params.storage_internal;
+
+    std::shared_ptr<br::Restore> restore = std::make_shared<br::Restore>(params);
+
+    std::cout << std::endl;
+    DINGO_LOG(INFO) << "";
+
+    std::cout << "Full Restore" << std::endl;
+    DINGO_LOG(INFO) << "Full Restore";
+
+    status = restore->Init();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      std::cout << "Restore failed" << std::endl;
+      DINGO_LOG(INFO) << "Restore failed";
+      return -1;
+    }
+
+    status = restore->Run();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      std::cout << "Restore failed" << std::endl;
+      DINGO_LOG(INFO) << "Restore failed";
+      return -1;
+    }
+
+    status = restore->Finish();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      std::cout << "Restore failed" << std::endl;
+      DINGO_LOG(INFO) << "Restore failed";
+      return -1;
+    }
+
+    DINGO_LOG(INFO) << "Restore finish";
+
   } else {
     DINGO_LOG(ERROR) << "br type not support, please check parameter --br_type=" << br::FLAGS_br_type;
     return -1;
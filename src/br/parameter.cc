@@ -37,6 +37,17 @@ DEFINE_uint32(backup_task_timeout_s, 100, "backup task timeout in seconds. defau
 // backup task max retry times. default 5
 DEFINE_uint32(backup_task_max_retry, 5, "backup task max retry times. default 5");
 
+DEFINE_uint32(br_backup_region_concurrency, 8,
+             "backup region concurrency for each region type(store/index/document). default 8");
+
+DEFINE_uint32(br_restore_region_concurrency, 8, "restore region concurrency. default 8");
+
+DEFINE_int64(br_restore_rate_limit_bytes_per_second, 0,
+             "restore rate limit of sst bytes ingested per second. default 0, no limit");
+
+DEFINE_uint32(br_restore_wait_region_ready_timeout_s, 60,
+              "restore wait created region has leader and normal state timeout in seconds. default 60s");
+
 DEFINE_bool(br_server_interaction_print_each_rpc_request, false,
             "br server interaction log switch rpc request. default is false");
 
@@ -41,6 +41,14 @@ DECLARE_uint32(backup_task_timeout_s);
 // backup task max retry times. default 5
 DECLARE_uint32(backup_task_max_retry);
 
+DECLARE_uint32(br_backup_region_concurrency);
+
+DECLARE_uint32(br_restore_region_concurrency);
+
+DECLARE_int64(br_restore_rate_limit_bytes_per_second);
+
+DECLARE_uint32(br_restore_wait_region_ready_timeout_s);
+
 struct BackupParams {
   std::string coor_url;
   std::string br_type;
@@ -51,6 +59,13 @@ struct BackupParams {
   std::string storage_internal;
 };
 
+struct RestoreParams {
+  std::string coor_url;
+  std::string br_type;
+  std::string storage;
+  std::string storage_internal;
+};
+
 inline const std::string kBackupFileLock = "backup.lock";
 
 DECLARE_bool(br_server_interaction_print_each_rpc_request);
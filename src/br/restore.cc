@@ -0,0 +1,291 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "br/restore.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "br/interaction_manager.h"
+#include "br/sst_file_reader.h"
+#include "br/utils.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/version.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/meta.pb.h"
+
+namespace br {
+
+// same as coordinator tso layout, see coordinator/tso_control.h
+static constexpr int kTsoLogicalBits = 18;
+static constexpr int64_t kTsoSaveIntervalMs = 3000;
+
+Restore::Restore(const RestoreParams& params)
+    : backup_tso_(0), start_time_ms_(dingodb::Helper::TimestampMs()), end_time_ms_(0) {
+  coor_url_ = params.coor_url;
+  br_type_ = params.br_type;
+  storage_ = params.storage;
+  storage_internal_ = params.storage_internal;
+}
+
+Restore::~Restore() = default;
+
+std::shared_ptr<Restore> Restore::GetSelf() { return shared_from_this(); }
+
+butil::Status Restore::Init() {
+  butil::Status status = ParamsCheck();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = CheckBackupMeta();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::cout << "backup meta check ok" << std::endl;
+  DINGO_LOG(INFO) << "backup meta check ok";
+
+  restore_data_ = std::make_shared<RestoreData>(br::InteractionManager::GetInstance().GetCoordinatorInteraction(),
+                                                br::InteractionManager::GetInstance().GetStoreInteraction(),
+                                                br::InteractionManager::GetInstance().GetIndexInteraction(),
+                                                br::InteractionManager::GetInstance().GetDocumentInteraction(),
+                                                storage_, storage_internal_);
+
+  status = restore_data_->Init();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::Run() {
+  // advance tso before any data is visible.
+  butil::Status status = AdvanceTso();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = restore_data_->Run();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  return restore_data_->Finish();
+}
+
+butil::Status Restore::Finish() {
+  end_time_ms_ = dingodb::Helper::TimestampMs();
+
+  std::cout << fmt::format("Full Restore finish. elapsed : {} ms", end_time_ms_ - start_time_ms_) << std::endl;
+  DINGO_LOG(INFO) << fmt::format("Full Restore finish. elapsed : {} ms", end_time_ms_ - start_time_ms_);
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::ParamsCheck() {
+  butil::Status status = Utils::DirExists(storage_internal_);
+  if (!status.ok()) {
+    std::string s = fmt::format("Check storage : {} storage_internal_ : {} failed: {}", storage_, storage_internal_,
+                                status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(status.error_code(), s);
+  }
+
+  std::string lock_path = storage_internal_ + "/" + kBackupFileLock;
+  status = Utils::FileExistsAndRegular(lock_path);
+  if (status.ok()) {
+    std::string s = fmt::format("Backup may be running or not finished, lock file : {}", lock_path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_EXIST, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::CheckBackupMeta() {
+  std::string file_path = storage_internal_ + "/" + dingodb::Constant::kBackupMetaName;
+  butil::Status status = Utils::FileExistsAndRegular(file_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = SstFileReader().ReadFile(file_path, backup_meta_kvs_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // backup and restore must use the same version.
+  auto iter = backup_meta_kvs_.find(dingodb::Constant::kBackupVersionKey);
+  if (iter == backup_meta_kvs_.end()) {
+    std::string s = fmt::format("{} not found in {}", dingodb::Constant::kBackupVersionKey, file_path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EBACKUP_VERSION_NOT_MATCH, s);
+  }
+
+  dingodb::pb::common::VersionInfo version_info_backup;
+  version_info_backup.ParseFromString(iter->second);
+  dingodb::pb::common::VersionInfo version_info_local = dingodb::GetVersionInfo();
+  if (version_info_local.git_commit_hash() != version_info_backup.git_commit_hash()) {
+    std::string s = fmt::format("git_commit_hash is different. local : {} backup : {}",
+                                version_info_local.git_commit_hash(), version_info_backup.git_commit_hash());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EBACKUP_VERSION_NOT_MATCH, s);
+  }
+
+  iter = backup_meta_kvs_.find(dingodb::Constant::kBackupBackupParamKey);
+  if (iter == backup_meta_kvs_.end()) {
+    std::string s = fmt::format("{} not found in {}", dingodb::Constant::kBackupBackupParamKey, file_path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_NOT_EXIST, s);
+  }
+
+  dingodb::pb::common::BackupParam backup_param;
+  backup_param.ParseFromString(iter->second);
+  backup_tso_ = backup_param.backuptso_internal();
+
+  // region and sst meta files must not be modified after backup.
+  iter = backup_meta_kvs_.find(dingodb::Constant::kBackupMetaDataFileName);
+  if (iter == backup_meta_kvs_.end()) {
+    std::string s = fmt::format("{} not found in {}", dingodb::Constant::kBackupMetaDataFileName, file_path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_NOT_EXIST, s);
+  }
+
+  dingodb::pb::common::BackupMeta data_meta;
+  data_meta.ParseFromString(iter->second);
+  status = CheckFileSha1(storage_internal_ + "/" + data_meta.file_name(), data_meta.encryption());
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> data_meta_kvs;
+  status = SstFileReader().ReadFile(storage_internal_ + "/" + data_meta.file_name(), data_meta_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  for (const auto& [file_name, value] : data_meta_kvs) {
+    dingodb::pb::common::BackupMeta meta;
+    meta.ParseFromString(value);
+    status = CheckFileSha1(storage_internal_ + "/" + meta.file_name(), meta.encryption());
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::CheckFileSha1(const std::string& file_path, const std::string& encryption) {
+  std::string hash_code;
+  butil::Status status = dingodb::Helper::CalSha1CodeWithFileEx(file_path, hash_code);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  if (hash_code != encryption) {
+    std::string s = fmt::format("file sha1 not match, file : {} sha1 : {} expect : {}", file_path, hash_code, encryption);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  return butil::Status::OK();
+}
+
+int64_t Restore::CalcAdvanceTsoPhysical(int64_t backup_tso, int64_t current_tso) {
+  if (current_tso > backup_tso) {
+    return 0;
+  }
+
+  return (backup_tso >> kTsoLogicalBits) + 1;
+}
+
+butil::Status Restore::AdvanceTso() {
+  dingodb::pb::meta::TsoRequest request;
+  dingodb::pb::meta::TsoResponse response;
+  request.set_op_type(dingodb::pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(1);
+
+  butil::Status status = br::InteractionManager::GetInstance().GetCoordinatorInteraction()->SendRequest(
+      "MetaService", "TsoService", request, response);
+  if (!status.ok()) {
+    std::string s = fmt::format("Fail to get tso, status={}", status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return status;
+  }
+
+  if (response.error().errcode() != dingodb::pb::error::OK) {
+    std::string s = fmt::format("Fail to get tso, error={}", response.error().errmsg());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EINTERNAL, s);
+  }
+
+  int64_t current_tso =
+      (response.start_timestamp().physical() << kTsoLogicalBits) + response.start_timestamp().logical();
+  int64_t new_physical = CalcAdvanceTsoPhysical(backup_tso_, current_tso);
+  if (new_physical == 0) {
+    DINGO_LOG(INFO) << fmt::format("current tso {}({}) is past backup tso {}({}), not need advance.", current_tso,
+                                   Utils::ConvertTsoToDateTime(current_tso), backup_tso_,
+                                   Utils::ConvertTsoToDateTime(backup_tso_));
+    return butil::Status::OK();
+  }
+
+  request.Clear();
+  response.Clear();
+  request.set_op_type(dingodb::pb::meta::TsoOpType::OP_UPDATE_TSO);
+  request.mutable_current_timestamp()->set_physical(new_physical);
+  request.mutable_current_timestamp()->set_logical(0);
+  request.set_save_physical(new_physical + kTsoSaveIntervalMs);
+
+  status = br::InteractionManager::GetInstance().GetCoordinatorInteraction()->SendRequest("MetaService", "TsoService",
+                                                                                          request, response);
+  if (!status.ok()) {
+    std::string s = fmt::format("Fail to advance tso, status={}", status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return status;
+  }
+
+  if (response.error().errcode() != dingodb::pb::error::OK) {
+    std::string s = fmt::format("Fail to advance tso, error={}", response.error().errmsg());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EINTERNAL, s);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("advance tso {}({}) past backup tso {}({})", current_tso,
+                                 Utils::ConvertTsoToDateTime(current_tso), backup_tso_,
+                                 Utils::ConvertTsoToDateTime(backup_tso_));
+
+  return butil::Status::OK();
+}
+
+}  // namespace br
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BR_RESTORE_H_
+#define DINGODB_BR_RESTORE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "br/parameter.h"
+#include "br/restore_data.h"
+#include "butil/status.h"
+#include "fmt/core.h"
+
+namespace br {
+
+class Restore : public std::enable_shared_from_this<Restore> {
+ public:
+  Restore(const RestoreParams& params);
+  ~Restore();
+
+  Restore(const Restore&) = delete;
+  const Restore& operator=(const Restore&) = delete;
+  Restore(Restore&&) = delete;
+  Restore& operator=(Restore&&) = delete;
+
+  std::shared_ptr<Restore> GetSelf();
+
+  butil::Status Init();
+
+  butil::Status Run();
+
+  butil::Status Finish();
+
+  // restored data is committed before backup tso, the physical part of tso must be advanced past it,
+  // otherwise new transactions read stale snapshot. return 0 if current tso is already past backup tso.
+  static int64_t CalcAdvanceTsoPhysical(int64_t backup_tso, int64_t current_tso);
+
+ protected:
+ private:
+  butil::Status ParamsCheck();
+  butil::Status CheckBackupMeta();
+  butil::Status CheckFileSha1(const std::string& file_path, const std::string& encryption);
+  butil::Status AdvanceTso();
+
+  std::string coor_url_;
+  std::string br_type_;
+  std::string storage_;
+  std::string storage_internal_;
+
+  // content of backupmeta
+  std::map<std::string, std::string> backup_meta_kvs_;
+
+  // backuptso_internal of backup param
+  int64_t backup_tso_;
+
+  std::shared_ptr<RestoreData> restore_data_;
+
+  // statistics
+  int64_t start_time_ms_;
+
+  // statistics
+  int64_t end_time_ms_;
+};
+
+}  // namespace br
+
+#endif  // DINGODB_BR_RESTORE_H_
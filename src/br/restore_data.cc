@@ -0,0 +1,389 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "br/restore_data.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "br/helper.h"
+#include "br/parameter.h"
+#include "br/sst_file_reader.h"
+#include "br/utils.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/coordinator.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace br {
+
+RestoreData::RestoreData(ServerInteractionPtr coordinator_interaction, ServerInteractionPtr store_interaction,
+                         ServerInteractionPtr index_interaction, ServerInteractionPtr document_interaction,
+                         const std::string& storage, const std::string& storage_internal)
+    : coordinator_interaction_(coordinator_interaction),
+      store_interaction_(store_interaction),
+      index_interaction_(index_interaction),
+      document_interaction_(document_interaction),
+      storage_(storage),
+      storage_internal_(storage_internal),
+      is_need_exit_(false),
+      already_restore_regions_(0),
+      already_restore_bytes_(0),
+      rate_limit_next_time_us_(0) {}
+
+RestoreData::~RestoreData() = default;
+
+std::shared_ptr<RestoreData> RestoreData::GetSelf() { return shared_from_this(); }
+
+butil::Status RestoreData::Init() {
+  butil::Status status;
+
+  const std::vector<std::tuple<std::string, std::string, ServerInteractionPtr, std::string>> files = {
+      {dingodb::Constant::kStoreRegionSqlDataSstName, dingodb::Constant::kStoreCfSstMetaSqlDataSstName,
+       store_interaction_, "StoreService"},
+      {dingodb::Constant::kIndexRegionSqlDataSstName, dingodb::Constant::kIndexCfSstMetaSqlDataSstName,
+       index_interaction_, "IndexService"},
+      {dingodb::Constant::kDocumentRegionSqlDataSstName, dingodb::Constant::kDocumentCfSstMetaSqlDataSstName,
+       document_interaction_, "DocumentService"},
+      {dingodb::Constant::kStoreRegionSdkDataSstName, dingodb::Constant::kStoreCfSstMetaSdkDataSstName,
+       store_interaction_, "StoreService"},
+      {dingodb::Constant::kIndexRegionSdkDataSstName, dingodb::Constant::kIndexCfSstMetaSdkDataSstName,
+       index_interaction_, "IndexService"},
+      {dingodb::Constant::kDocumentRegionSdkDataSstName, dingodb::Constant::kDocumentCfSstMetaSdkDataSstName,
+       document_interaction_, "DocumentService"},
+  };
+
+  for (const auto& [region_file_name, cf_sst_meta_file_name, interaction, service_name] : files) {
+    status = LoadRegionTasks(region_file_name, cf_sst_meta_file_name, interaction, service_name);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("restore data total regions : {}", tasks_.size());
+
+  return butil::Status::OK();
+}
+
+butil::Status RestoreData::LoadRegionTasks(const std::string& region_file_name,
+                                           const std::string& cf_sst_meta_file_name, ServerInteractionPtr interaction,
+                                           const std::string& service_name) {
+  std::string region_file_path = storage_internal_ + "/" + region_file_name;
+
+  // region file is not exist if backup has no such region.
+  butil::Status status = Utils::FileExistsAndRegular(region_file_path);
+  if (!status.ok()) {
+    if (status.error_code() == dingodb::pb::error::EFILE_NOT_EXIST) {
+      return butil::Status::OK();
+    }
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> region_kvs;
+  status = SstFileReader().ReadFile(region_file_path, region_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> cf_sst_meta_kvs;
+  std::string cf_sst_meta_file_path = storage_internal_ + "/" + cf_sst_meta_file_name;
+  status = Utils::FileExistsAndRegular(cf_sst_meta_file_path);
+  if (status.ok()) {
+    status = SstFileReader().ReadFile(cf_sst_meta_file_path, cf_sst_meta_kvs);
+  } else if (status.error_code() == dingodb::pb::error::EFILE_NOT_EXIST) {
+    status = butil::Status::OK();
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  for (const auto& [region_id, region_value] : region_kvs) {
+    RestoreRegionTask task;
+    if (!task.region.ParseFromString(region_value)) {
+      std::string s = fmt::format("Fail to parse region, file : {} region_id : {}", region_file_path, region_id);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    auto iter = cf_sst_meta_kvs.find(region_id);
+    if (iter != cf_sst_meta_kvs.end() && !task.sst_metas.ParseFromString(iter->second)) {
+      std::string s = fmt::format("Fail to parse sst meta, file : {} region_id : {}", cf_sst_meta_file_path, region_id);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    task.interaction = interaction;
+    task.service_name = service_name;
+    tasks_.push_back(std::move(task));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status RestoreData::Run() {
+  if (tasks_.empty()) {
+    return butil::Status::OK();
+  }
+
+  auto next_task_index = std::make_shared<std::atomic<int64_t>>(0);
+
+  uint32_t concurrency = std::max(1U, FLAGS_br_restore_region_concurrency);
+  concurrency = std::min(concurrency, static_cast<uint32_t>(tasks_.size()));
+
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  for (uint32_t i = 0; i < concurrency; i++) {
+    threads.emplace_back([self = GetSelf(), next_task_index]() { self->DoRestoreRegionInternal(next_task_index); });
+  }
+
+  int64_t total_regions_count = tasks_.size();
+  int64_t last_already_restore_regions = 0;
+  std::cerr << "Full Restore Data " << "<";
+  DINGO_LOG(INFO) << "Full Restore Data " << "<";
+  std::string s;
+  while (!is_need_exit_) {
+    int64_t already_restore_regions = already_restore_regions_.load();
+    for (int64_t i = last_already_restore_regions; i < already_restore_regions; i++) {
+      std::cerr << "-";
+      s += "-";
+    }
+    last_already_restore_regions = already_restore_regions;
+
+    if (already_restore_regions >= total_regions_count) {
+      break;
+    }
+
+    sleep(1);
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (is_need_exit_) {
+    std::cerr << std::endl;
+    std::lock_guard<std::mutex> guard(last_error_mutex_);
+    return last_error_;
+  }
+
+  std::cerr << ">" << " 100.00%" << " [" << "R:" << total_regions_count << ",B:" << already_restore_bytes_.load()
+            << "]";
+  DINGO_LOG(INFO) << s;
+  DINGO_LOG(INFO) << ">" << " 100.00%" << " [" << "R:" << total_regions_count
+                  << ",B:" << already_restore_bytes_.load() << "]";
+
+  std::cout << std::endl;
+
+  return butil::Status::OK();
+}
+
+butil::Status RestoreData::Finish() {
+  DINGO_LOG(INFO) << fmt::format("restore data total regions : {} total bytes : {}", already_restore_regions_.load(),
+                                 already_restore_bytes_.load());
+  return butil::Status::OK();
+}
+
+void RestoreData::DoRestoreRegionInternal(std::shared_ptr<std::atomic<int64_t>> next_task_index) {
+  // workers share next_task_index, every worker take the next unhandled region.
+  while (!is_need_exit_) {
+    int64_t task_index = next_task_index->fetch_add(1);
+    if (task_index >= static_cast<int64_t>(tasks_.size())) {
+      break;
+    }
+
+    butil::Status status = DoRestoreRegion(tasks_[task_index]);
+    if (!status.ok()) {
+      is_need_exit_ = true;
+      std::lock_guard<std::mutex> guard(last_error_mutex_);
+      last_error_ = status;
+      return;
+    }
+
+    already_restore_regions_++;
+  }
+}
+
+butil::Status RestoreData::DoRestoreRegion(const RestoreRegionTask& task) {
+  const auto& region = task.region;
+
+  int64_t new_region_id = 0;
+  butil::Status status = CreateRegion(region, new_region_id);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  dingodb::pb::common::Region new_region;
+  status = WaitRegionReady(new_region_id, new_region);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // region without data only need to be created.
+  if (task.sst_metas.backup_data_file_value_sst_metas().empty()) {
+    return butil::Status::OK();
+  }
+
+  int64_t bytes = 0;
+  for (const auto& sst_meta : task.sst_metas.backup_data_file_value_sst_metas()) {
+    bytes += sst_meta.file_size();
+  }
+  RateLimit(bytes);
+
+  dingodb::pb::store::RestoreDataRequest request;
+  dingodb::pb::store::RestoreDataResponse response;
+
+  request.mutable_request_info()->set_request_id(Helper::GetRandInt());
+  request.mutable_context()->set_region_id(new_region_id);
+  request.mutable_context()->mutable_region_epoch()->CopyFrom(new_region.definition().epoch());
+  request.set_storage_path(storage_);
+  request.mutable_storage_backend()->mutable_local()->set_path(storage_internal_);
+  request.mutable_sst_metas()->CopyFrom(task.sst_metas);
+
+  DINGO_LOG_IF(INFO, FLAGS_br_log_switch_backup_detail_detail) << request.DebugString();
+
+  status = task.interaction->SendRequest(task.service_name, "RestoreData", request, response);
+  if (!status.ok()) {
+    std::string s = fmt::format("Fail to restore region, region_id={} new_region_id={}, status={}", region.id(),
+                                new_region_id, status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(status.error_code(), s);
+  }
+
+  if (response.error().errcode() != dingodb::pb::error::OK) {
+    std::string s = fmt::format("Fail to restore region, region_id={} new_region_id={}, error={}", region.id(),
+                                new_region_id, response.error().errmsg());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(response.error().errcode(), s);
+  }
+
+  already_restore_bytes_ += bytes;
+
+  DINGO_LOG_IF(INFO, FLAGS_br_log_switch_backup_detail)
+      << fmt::format("restore region ok, region_id={} new_region_id={} files={} bytes={}", region.id(), new_region_id,
+                     task.sst_metas.backup_data_file_value_sst_metas_size(), bytes);
+
+  return butil::Status::OK();
+}
+
+butil::Status RestoreData::CreateRegion(const dingodb::pb::common::Region& region, int64_t& new_region_id) {
+  const auto& definition = region.definition();
+
+  dingodb::pb::coordinator::CreateRegionRequest request;
+  dingodb::pb::coordinator::CreateRegionResponse response;
+
+  request.mutable_request_info()->set_request_id(Helper::GetRandInt());
+  request.set_region_name(definition.name());
+  request.set_replica_num(definition.peers_size());
+  request.mutable_range()->CopyFrom(definition.range());
+  request.set_raw_engine(definition.raw_engine());
+  request.set_store_engine(definition.store_engine());
+  request.set_schema_id(definition.schema_id());
+  request.set_table_id(definition.table_id());
+  request.set_index_id(definition.index_id());
+  request.set_part_id(definition.part_id());
+  request.set_tenant_id(definition.tenant_id());
+  request.set_region_type(region.region_type());
+  if (definition.has_index_parameter()) {
+    request.mutable_index_parameter()->CopyFrom(definition.index_parameter());
+  }
+
+  butil::Status status = coordinator_interaction_->SendRequest("CoordinatorService", "CreateRegion", request, response);
+  if (!status.ok()) {
+    std::string s = fmt::format("Fail to create region, region_id={}, status={}", region.id(), status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(status.error_code(), s);
+  }
+
+  if (response.error().errcode() != dingodb::pb::error::OK) {
+    std::string s = fmt::format("Fail to create region, region_id={}, error={}", region.id(), response.error().errmsg());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(response.error().errcode(), s);
+  }
+
+  new_region_id = response.region_id();
+
+  return butil::Status::OK();
+}
+
+butil::Status RestoreData::WaitRegionReady(int64_t region_id, dingodb::pb::common::Region& new_region) {
+  int64_t deadline_ms = dingodb::Helper::TimestampMs() + FLAGS_br_restore_wait_region_ready_timeout_s * 1000;
+
+  while (!is_need_exit_) {
+    dingodb::pb::coordinator::QueryRegionRequest request;
+    dingodb::pb::coordinator::QueryRegionResponse response;
+
+    request.mutable_request_info()->set_request_id(Helper::GetRandInt());
+    request.set_region_id(region_id);
+
+    butil::Status status =
+        coordinator_interaction_->SendRequest("CoordinatorService", "QueryRegion", request, response);
+    if (status.ok() && response.error().errcode() == dingodb::pb::error::OK &&
+        response.region().leader_store_id() > 0 &&
+        response.region().state() == dingodb::pb::common::RegionState::REGION_NORMAL) {
+      new_region = response.region();
+      return butil::Status::OK();
+    }
+
+    if (dingodb::Helper::TimestampMs() > deadline_ms) {
+      std::string s = fmt::format("Wait region ready timeout, region_id={}, timeout={}s", region_id,
+                                  FLAGS_br_restore_wait_region_ready_timeout_s);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  }
+
+  return butil::Status(dingodb::pb::error::EINTERNAL, "restore is canceled");
+}
+
+void RestoreData::RateLimit(int64_t bytes) {
+  if (FLAGS_br_restore_rate_limit_bytes_per_second <= 0 || bytes <= 0) {
+    return;
+  }
+
+  // reserve time slot for bytes, then wait until the slot begin.
+  int64_t start_time_us = 0;
+  {
+    std::lock_guard<std::mutex> guard(rate_limit_mutex_);
+    int64_t now_us = dingodb::Helper::TimestampUs();
+    start_time_us = std::max(now_us, rate_limit_next_time_us_);
+    rate_limit_next_time_us_ = start_time_us + bytes * 1000000 / FLAGS_br_restore_rate_limit_bytes_per_second;
+  }
+
+  int64_t wait_us = start_time_us - dingodb::Helper::TimestampUs();
+  if (wait_us > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+  }
+}
+
+}  // namespace br
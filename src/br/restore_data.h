@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BR_RESTORE_DATA_H_
+#define DINGODB_BR_RESTORE_DATA_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "br/interation.h"
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+
+namespace br {
+
+// Restore sdk data and sql data of backup. Every backup region is created again by coordinator with the same
+// definition, then the leader ingests the backup sst files of the region through raft.
+class RestoreData : public std::enable_shared_from_this<RestoreData> {
+ public:
+  RestoreData(ServerInteractionPtr coordinator_interaction, ServerInteractionPtr store_interaction,
+              ServerInteractionPtr index_interaction, ServerInteractionPtr document_interaction,
+              const std::string& storage, const std::string& storage_internal);
+  ~RestoreData();
+
+  RestoreData(const RestoreData&) = delete;
+  const RestoreData& operator=(const RestoreData&) = delete;
+  RestoreData(RestoreData&&) = delete;
+  RestoreData& operator=(RestoreData&&) = delete;
+
+  std::shared_ptr<RestoreData> GetSelf();
+
+  butil::Status Init();
+
+  butil::Status Run();
+
+  butil::Status Finish();
+
+ protected:
+ private:
+  struct RestoreRegionTask {
+    dingodb::pb::common::Region region;
+    dingodb::pb::common::BackupDataFileValueSstMetaGroup sst_metas;
+    ServerInteractionPtr interaction;
+    std::string service_name;
+  };
+
+  butil::Status LoadRegionTasks(const std::string& region_file_name, const std::string& cf_sst_meta_file_name,
+                                ServerInteractionPtr interaction, const std::string& service_name);
+  void DoRestoreRegionInternal(std::shared_ptr<std::atomic<int64_t>> next_task_index);
+  butil::Status DoRestoreRegion(const RestoreRegionTask& task);
+  butil::Status CreateRegion(const dingodb::pb::common::Region& region, int64_t& new_region_id);
+  butil::Status WaitRegionReady(int64_t region_id, dingodb::pb::common::Region& new_region);
+  void RateLimit(int64_t bytes);
+
+  ServerInteractionPtr coordinator_interaction_;
+  ServerInteractionPtr store_interaction_;
+  ServerInteractionPtr index_interaction_;
+  ServerInteractionPtr document_interaction_;
+  std::string storage_;
+  std::string storage_internal_;
+
+  std::vector<RestoreRegionTask> tasks_;
+
+  // notify other threads to exit
+  std::atomic<bool> is_need_exit_;
+
+  std::atomic<int64_t> already_restore_regions_;
+  std::atomic<int64_t> already_restore_bytes_;
+
+  // next time in microseconds that sst bytes are allowed to send.
+  std::mutex rate_limit_mutex_;
+  int64_t rate_limit_next_time_us_;
+
+  std::mutex last_error_mutex_;
+  butil::Status last_error_;
+};
+
+}  // namespace br
+
+#endif  // DINGODB_BR_RESTORE_DATA_H_
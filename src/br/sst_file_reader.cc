@@ -0,0 +1,42 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "br/sst_file_reader.h"
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/iterator.h"
+
+namespace br {
+
+butil::Status SstFileReader::ReadFile(const std::string& filename, std::map<std::string, std::string>& kvs) {
+  auto status = sst_reader_->Open(filename);
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  std::unique_ptr<rocksdb::Iterator> iter(sst_reader_->NewIterator(rocksdb::ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    kvs.emplace(iter->key().ToString(), iter->value().ToString());
+  }
+
+  if (!iter->status().ok()) {
+    return butil::Status(iter->status().code(), iter->status().ToString());
+  }
+
+  return butil::Status();
+}
+
+}  // namespace br
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BR_SST_FILE_READER_H_
+#define DINGODB_BR_SST_FILE_READER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "butil/status.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_reader.h"
+
+namespace br {
+class SstFileReader {
+ public:
+  SstFileReader() : sst_reader_(std::make_unique<rocksdb::SstFileReader>(options_)) {}
+  ~SstFileReader() = default;
+
+  SstFileReader(SstFileReader&& rhs) = delete;
+  SstFileReader& operator=(SstFileReader&& rhs) = delete;
+
+  // read all key-value of sst file which saved by SstFileWriter::SaveFile.
+  butil::Status ReadFile(const std::string& filename, std::map<std::string, std::string>& kvs);
+
+ private:
+  rocksdb::Options options_;
+  std::unique_ptr<rocksdb::SstFileReader> sst_reader_;
+};
+using SstFileReaderPtr = std::shared_ptr<SstFileReader>;
+}  // namespace br
+
+#endif  // DINGODB_BR_SST_FILE_READER_H_
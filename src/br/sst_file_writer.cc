@@ -25,19 +25,41 @@
 namespace br {
 
 butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename) {
-  auto status = sst_writer_->Open(filename);
+  auto status = Open(filename);
   if (!status.ok()) {
-    return butil::Status(status.code(), status.ToString());
+    return status;
   }
 
   for (const auto& [key, value] : kvs) {
-    status = sst_writer_->Put(key, value);
+    status = Put(key, value);
     if (!status.ok()) {
-      return butil::Status(status.code(), status.ToString());
+      return status;
     }
   }
 
-  status = sst_writer_->Finish();
+  return Finish();
+}
+
+butil::Status SstFileWriter::Open(const std::string& filename) {
+  auto status = sst_writer_->Open(filename);
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstFileWriter::Put(const std::string& key, const std::string& value) {
+  auto status = sst_writer_->Put(key, value);
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstFileWriter::Finish() {
+  auto status = sst_writer_->Finish();
   if (!status.ok()) {
     return butil::Status(status.code(), status.ToString());
   }
@@ -37,6 +37,11 @@ class SstFileWriter {
 
   butil::Status SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename);
 
+  // streaming write, key must be put in ascending order.
+  butil::Status Open(const std::string& filename);
+  butil::Status Put(const std::string& key, const std::string& value);
+  butil::Status Finish();
+
   int64_t GetSize() { return sst_writer_->FileSize(); }
 
  private:
@@ -267,10 +267,12 @@ class Constant {
   inline static const std::string kDiskannSearchDramBudgetGbConfigName = "search_dram_budget_gb";
   inline static const std::string kDiskannBuildDramBudgetGbConfigName = "build_dram_budget_gb";
   inline static const std::string kDiskannImportTimeoutSecondConfigName = "import_timeout_s";
+  inline static const std::string kDiskannNodeCacheBudgetMbConfigName = "node_cache_budget_mb";
   inline static const uint32_t kDiskannNumThreadsDefaultValue = 64;
   inline static const float kDiskannSearchDramBudgetGbDefaultValue = 1.0f;
   inline static const float kDiskannBuildDramBudgetGbDefaultValue = 10.0f;
   inline static const int64_t kDiskannImportTimeoutSecondDefaultValue = 30;
+  inline static const int64_t kDiskannNodeCacheBudgetMbDefaultValue = 0;
 
   // tenant
   inline static const int64_t kDefaultTenantId = 0;
@@ -313,6 +315,9 @@ class Constant {
   inline static const std::string kBackupMetaEncryptionName = "backupmeta.encryption";
   inline static const std::string kBackupMetaDebugName = "backupmeta.debug";
 
+  // restore sst files are staged here(per region) before ingest.
+  inline static const std::string kRestoreStagingDirName = "restore_staging";
+
   inline static const std::string kIdEpochTypeAndValueKey = "dingodb::pb::meta::IdEpochTypeAndValue";
   inline static const std::string kTableIncrementKey = "dingodb::pb::meta::TableIncrementGroup";
 
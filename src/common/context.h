@@ -24,6 +24,7 @@
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "diskann/diskann_utils.h"
+#include "engine/txn_pessimistic_lock_table.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
 
@@ -146,6 +147,11 @@ class Context {
   DiskANNCoreState DiskANNCoreStateX() { return diskann_core_state_; };
   void SetDiskANNCoreStateX(enum DiskANNCoreState state) { diskann_core_state_ = state; }
 
+  PessimisticLockTablePtr PessimisticLockTable() { return pessimistic_lock_table_; }
+  void SetPessimisticLockTable(PessimisticLockTablePtr pessimistic_lock_table) {
+    pessimistic_lock_table_ = pessimistic_lock_table;
+  }
+
 #if defined(ENABLE_GC_MOCK)
   RawEngine::WriterPtr Writer() { return writer_; }
   void SetWriter(RawEngine::WriterPtr writer) { writer_ = writer; }
@@ -190,6 +196,9 @@ class Context {
 
   enum DiskANNCoreState diskann_core_state_ {};
 
+  // in-memory pessimistic locks of region, txn lock read/scan merge them with lock cf.
+  PessimisticLockTablePtr pessimistic_lock_table_;
+
 #if defined(ENABLE_GC_MOCK)
   RawEngine::WriterPtr writer_;
 #endif
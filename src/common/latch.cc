@@ -14,6 +14,8 @@
 
 #include "common/latch.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <utility>
 
@@ -106,27 +108,58 @@ Latches::~Latches() { delete slots_ptr; }
 // }
 
 bool Latches::Acquire(Lock* lock, uint64_t who) const {
-  size_t acquired_count = 0;
-  for (size_t i = lock->ownedCount; i < lock->requiredHashes.size(); ++i) {
-    auto key_hash = lock->requiredHashes[i];
-    BAIDU_SCOPED_LOCK(GetSlot(key_hash)->mutex);
-    Latch& latch = GetSlot(key_hash)->latch;
-
-    auto first_req = latch.GetFirstReqByHash(key_hash);
-    if (first_req.has_value()) {
-      if (first_req == who) {
-        ++acquired_count;
-      } else {
-        latch.WaitForWake(key_hash, who);
-        break;
+  // lock hold nothing before first acquired, so no one read it concurrently
+  if (lock->ownedCount == 0) {
+    SortBySlot(lock->requiredHashes);
+    lock->owner = who;
+  }
+
+  const auto& hashes = lock->requiredHashes;
+  size_t i = lock->ownedCount;
+  while (i < hashes.size()) {
+    // hashes of the same slot are handled in one pass
+    auto slot_index = GetSlotIndex(hashes[i]);
+    size_t group_end = i + 1;
+    while (group_end < hashes.size() && GetSlotIndex(hashes[group_end]) == slot_index) {
+      ++group_end;
+    }
+    auto* slot = GetSlot(hashes[i]);
+
+    // fast path, slot is free, hold all hashes of the slot by CAS
+    uint64_t expected = Slot::kSlotFree;
+    if (slot->owner.compare_exchange_strong(expected, reinterpret_cast<uint64_t>(lock), std::memory_order_acq_rel)) {
+      i = group_end;
+      continue;
+    }
+
+    // slow path, slot is contended
+    bool is_blocked = false;
+    {
+      BAIDU_SCOPED_LOCK(slot->mutex);
+      InflateSlot(slot, slot_index, slots_size);
+
+      Latch& latch = slot->latch;
+      for (; i < group_end; ++i) {
+        auto key_hash = hashes[i];
+        auto first_req = latch.GetFirstReqByHash(key_hash);
+        if (first_req.has_value()) {
+          if (first_req.value() != who) {
+            latch.WaitForWake(key_hash, who);
+            is_blocked = true;
+            break;
+          }
+        } else {
+          latch.WaitForWake(key_hash, who);
+        }
       }
-    } else {
-      latch.WaitForWake(key_hash, who);
-      ++acquired_count;
+    }
+
+    if (is_blocked) {
+      break;
     }
   }
 
-  lock->ownedCount += acquired_count;
+  lock->ownedCount = i;
   return lock->Acquired();
 }
 
@@ -139,40 +172,68 @@ std::vector<uint64_t> Latches::Release(Lock* lock, uint64_t who,
   if (keep_latches_for_next_cmd.has_value()) {
     keep_latchtes_for_next_cmd_pair = &keep_latches_for_next_cmd.value();
     keep_latches_for_cid = keep_latchtes_for_next_cmd_pair->first;
+    // next cmd must iterate hashes in the same order
+    SortBySlot(keep_latchtes_for_next_cmd_pair->second->requiredHashes);
     keep_latches_it = keep_latchtes_for_next_cmd_pair->second->requiredHashes.begin();
   }
 
   std::vector<uint64_t> wakeup_list;
-  for (auto key_hash_iter = lock->requiredHashes.begin();
-       key_hash_iter != lock->requiredHashes.begin() + lock->ownedCount; ++key_hash_iter) {
-    BAIDU_SCOPED_LOCK(GetSlot(*key_hash_iter)->mutex);
-    auto* slot = this->GetSlot(*key_hash_iter);
+  const auto& hashes = lock->requiredHashes;
+  size_t i = 0;
+  while (i < lock->ownedCount) {
+    auto slot_index = GetSlotIndex(hashes[i]);
+    size_t group_end = i + 1;
+    while (group_end < lock->ownedCount && GetSlotIndex(hashes[group_end]) == slot_index) {
+      ++group_end;
+    }
+    auto* slot = GetSlot(hashes[i]);
+
+    bool has_keep_latches = keep_latchtes_for_next_cmd_pair != nullptr &&
+                            keep_latches_it != keep_latchtes_for_next_cmd_pair->second->requiredHashes.end() &&
+                            GetSlotIndex(*keep_latches_it) == slot_index;
+
+    // fast path, slot is still held by CAS and no one wait it
+    uint64_t expected = reinterpret_cast<uint64_t>(lock);
+    if (!has_keep_latches &&
+        slot->owner.compare_exchange_strong(expected, Slot::kSlotFree, std::memory_order_acq_rel)) {
+      i = group_end;
+      continue;
+    }
+
+    BAIDU_SCOPED_LOCK(slot->mutex);
+    InflateSlot(slot, slot_index, slots_size);
+
     auto* latch = &slot->latch;
-    auto value = latch->PopFront(*key_hash_iter);
-    assert(value.has_value());
-    auto v = value.value().first;
-    auto front = value.value().second;
-    assert(front == who);
-    assert(v == *key_hash_iter);
-
-    bool keep_for_next_cmd = false;
-    if (keep_latchtes_for_next_cmd_pair != nullptr &&
-        keep_latches_it != keep_latchtes_for_next_cmd_pair->second->requiredHashes.end()) {
-      assert(*keep_latches_it >= *key_hash_iter);
-      if (*keep_latches_it == *key_hash_iter) {
-        ++keep_latches_it;
-        keep_for_next_cmd = true;
+    for (; i < group_end; ++i) {
+      auto key_hash = hashes[i];
+      auto value = latch->PopFront(key_hash);
+      assert(value.has_value());
+      auto v = value.value().first;
+      auto front = value.value().second;
+      assert(front == who);
+      assert(v == key_hash);
+
+      bool keep_for_next_cmd = false;
+      if (keep_latchtes_for_next_cmd_pair != nullptr &&
+          keep_latches_it != keep_latchtes_for_next_cmd_pair->second->requiredHashes.end()) {
+        assert(!SlotLess(*keep_latches_it, key_hash));
+        if (*keep_latches_it == key_hash) {
+          ++keep_latches_it;
+          keep_for_next_cmd = true;
+        }
       }
-    }
 
-    if (!keep_for_next_cmd) {
-      auto wakeup = latch->GetFirstReqByHash(*key_hash_iter);
-      if (wakeup.has_value()) {
-        wakeup_list.push_back(wakeup.value());
+      if (!keep_for_next_cmd) {
+        auto wakeup = latch->GetFirstReqByHash(key_hash);
+        if (wakeup.has_value()) {
+          wakeup_list.push_back(wakeup.value());
+        }
+      } else {
+        latch->PushPreemptive(key_hash, keep_latches_for_cid);
       }
-    } else {
-      latch->PushPreemptive(*key_hash_iter, keep_latches_for_cid);
     }
+
+    MaybeDeflateSlot(slot);
   }
 
   assert(keep_latchtes_for_next_cmd_pair == nullptr ||
@@ -181,6 +242,30 @@ std::vector<uint64_t> Latches::Release(Lock* lock, uint64_t who,
   return wakeup_list;
 }
 
+void Latches::InflateSlot(Slot* slot, uint64_t slot_index, size_t slots_size) {
+  uint64_t owner = slot->owner.load(std::memory_order_acquire);
+  while (owner != Slot::kSlotInflated) {
+    if (slot->owner.compare_exchange_weak(owner, Slot::kSlotInflated, std::memory_order_acq_rel)) {
+      if (owner != Slot::kSlotFree) {
+        // fast path holder release need the slot mutex after inflated, so the lock is alive here.
+        auto* holder = reinterpret_cast<Lock*>(owner);
+        for (auto it = holder->requiredHashes.rbegin(); it != holder->requiredHashes.rend(); ++it) {
+          if ((*it & (slots_size - 1)) == slot_index) {
+            slot->latch.PushPreemptive(*it, holder->owner);
+          }
+        }
+      }
+      return;
+    }
+  }
+}
+
+void Latches::MaybeDeflateSlot(Slot* slot) {
+  if (slot->latch.waiting.empty()) {
+    slot->owner.store(Slot::kSlotFree, std::memory_order_release);
+  }
+}
+
 size_t Latches::NextPowerOfTwo(size_t n) {
   if (n == 0) {
     return 1;
@@ -195,9 +280,18 @@ size_t Latches::NextPowerOfTwo(size_t n) {
   return n + 1;
 }
 
-Slot* Latches::GetSlot(uint64_t hash) const {
-  auto index = hash & (slots_size - 1);
-  return &(*slots_ptr)[index];
+size_t Latches::GetSlotIndex(uint64_t hash) const { return hash & (slots_size - 1); }
+
+Slot* Latches::GetSlot(uint64_t hash) const { return &(*slots_ptr)[GetSlotIndex(hash)]; }
+
+bool Latches::SlotLess(uint64_t a, uint64_t b) const {
+  auto slot_a = GetSlotIndex(a);
+  auto slot_b = GetSlotIndex(b);
+  return slot_a != slot_b ? slot_a < slot_b : a < b;
+}
+
+void Latches::SortBySlot(std::vector<uint64_t>& hashes) const {
+  std::sort(hashes.begin(), hashes.end(), [this](uint64_t a, uint64_t b) { return SlotLess(a, b); });
 }
 
 }  // namespace dingodb
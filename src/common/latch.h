@@ -15,8 +15,11 @@
 #ifndef DINGODB_COMMON_LATCH_H_
 #define DINGODB_COMMON_LATCH_H_
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "bthread/mutex.h"
@@ -44,8 +47,11 @@ class Latch {
 
 class Lock {
  public:
+  // sorted by slot and hash when acquire, so hashes of the same slot are handled in one pass
   std::vector<uint64_t> requiredHashes;
   size_t ownedCount = 0;
+  // who is acquiring the lock, used when other one inflate the slot held by fast path
+  uint64_t owner = 0;
 
   Lock(const std::vector<std::string>& keys);
 
@@ -58,7 +64,15 @@ class Lock {
   static uint64_t Hash(const std::string& key);
 };
 
-struct Slot {
+// Slot is padded to cache line, avoid false sharing between neighbor slots.
+// owner is the fast path of uncontended slot, it is one of:
+//   kSlotFree: no one hold the slot and latch.waiting is empty.
+//   Lock*: the lock hold all its hashes of the slot by CAS, without mutex and latch.waiting.
+//   kSlotInflated: the slot is contended, holders and waiters are in latch.waiting protected by mutex.
+struct alignas(64) Slot {
+  static constexpr uint64_t kSlotFree = 0;
+  static constexpr uint64_t kSlotInflated = 1;
+
   Slot() { CHECK_EQ(0, bthread_mutex_init(&mutex, nullptr)); }
   ~Slot() { CHECK_EQ(0, bthread_mutex_destroy(&mutex)); }
 
@@ -76,6 +90,7 @@ struct Slot {
     return *this;
   }
 
+  std::atomic<uint64_t> owner{kSlotFree};
   bthread_mutex_t mutex;
   Latch latch;
 };
@@ -98,12 +113,22 @@ class Latches {
   size_t GetSlotIndex(uint64_t hash) const;
   Slot* GetSlot(uint64_t hash) const;
 
+  // order by slot index then hash, all locks must use the same order to avoid deadlock
+  bool SlotLess(uint64_t a, uint64_t b) const;
+  void SortBySlot(std::vector<uint64_t>& hashes) const;
+
   std::vector<Slot>* slots_ptr;
   size_t slots_size;
 
   static size_t NextPowerOfTwo(size_t n);
+
+ private:
+  // need hold slot mutex, move the fast path holder into latch.waiting.
+  static void InflateSlot(Slot* slot, uint64_t slot_index, size_t slots_size);
+  // need hold slot mutex, back to fast path when no one hold or wait the slot.
+  static void MaybeDeflateSlot(Slot* slot);
 };
 
 }  // namespace dingodb
 
-#endif
\ No newline at end of file
+#endif  // DINGODB_COMMON_LATCH_H_
\ No newline at end of file
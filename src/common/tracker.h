@@ -48,8 +48,18 @@ class Tracker {
     uint64_t document_index_write_time_ns{0};
 
     uint64_t read_store_time_ns{0};
+
+    // read path stages, accumulated when run multiple times in one request
+    uint64_t lock_check_time_ns{0};
+    uint64_t iterator_seek_time_ns{0};
+    uint64_t coprocessor_time_ns{0};
+    uint64_t vector_search_time_ns{0};
+    uint64_t scalar_filter_time_ns{0};
   };
 
+  const pb::common::RequestInfo& RequestInfo() const { return request_info_; }
+  const Metrics& GetMetrics() const { return metrics_; }
+
   void SetTotalRpcTime() { metrics_.total_rpc_time_ns = Helper::TimestampNs() - start_time_; }
   uint64_t TotalRpcTime() const { return metrics_.total_rpc_time_ns; }
 
@@ -125,6 +135,21 @@ class Tracker {
   }
   inline uint64_t ReadStoreTime() const { return metrics_.read_store_time_ns; }
 
+  void AddLockCheckTime(uint64_t elapsed_time) { metrics_.lock_check_time_ns += elapsed_time; }
+  uint64_t LockCheckTime() const { return metrics_.lock_check_time_ns; }
+
+  void AddIteratorSeekTime(uint64_t elapsed_time) { metrics_.iterator_seek_time_ns += elapsed_time; }
+  uint64_t IteratorSeekTime() const { return metrics_.iterator_seek_time_ns; }
+
+  void AddCoprocessorTime(uint64_t elapsed_time) { metrics_.coprocessor_time_ns += elapsed_time; }
+  uint64_t CoprocessorTime() const { return metrics_.coprocessor_time_ns; }
+
+  void AddVectorSearchTime(uint64_t elapsed_time) { metrics_.vector_search_time_ns += elapsed_time; }
+  uint64_t VectorSearchTime() const { return metrics_.vector_search_time_ns; }
+
+  void AddScalarFilterTime(uint64_t elapsed_time) { metrics_.scalar_filter_time_ns += elapsed_time; }
+  uint64_t ScalarFilterTime() const { return metrics_.scalar_filter_time_ns; }
+
   // latency statistics
   static bvar::LatencyRecorder service_queue_latency;
   static bvar::LatencyRecorder prepair_commit_latency;
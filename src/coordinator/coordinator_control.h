@@ -182,6 +182,10 @@ struct StoreMetricsSlim {
   pb::common::StoreOwnMetrics store_own_metrics;
   int64_t region_num;
   int64_t update_time;
+  // version of the last full or in-sequence delta region metrics applied for this store
+  int64_t region_metrics_version{0};
+  // time of the last full or in-sequence delta region metrics, regions omitted by a delta heartbeat are still alive
+  int64_t region_metrics_update_time{0};
 };
 
 class CoordinatorControl : public MetaControl {
@@ -710,6 +714,10 @@ class CoordinatorControl : public MetaControl {
   int64_t UpdateStoreMetrics(const pb::common::StoreMetrics &store_metrics,
                              pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // check delta region metrics is based on the last region metrics version applied by this coordinator
+  // return false if some heartbeat is lost or coordinator leader is changed, store need to send full region metrics
+  bool CheckStoreRegionMetricsVersion(const pb::common::StoreMetrics &store_metrics);
+
   // drop table
   // in: schema_id
   // in: table_id
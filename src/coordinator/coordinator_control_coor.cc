@@ -19,6 +19,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -870,6 +871,15 @@ void CoordinatorControl::UpdateRegionState() {
     return;
   }
 
+  // regions omitted by delta heartbeat have no change since last report, use store's region metrics time instead
+  std::map<int64_t, int64_t> store_region_metrics_update_times;
+  {
+    BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+    for (const auto& [store_id, store_metrics_slim] : store_metrics_map_) {
+      store_region_metrics_update_times[store_id] = store_metrics_slim.region_metrics_update_time;
+    }
+  }
+
   for (const auto& it : region_map_temp) {
     pb::common::RegionMetrics region_metrics;
     auto ret = region_metrics_map_.Get(it.first, region_metrics);
@@ -884,8 +894,13 @@ void CoordinatorControl::UpdateRegionState() {
                      << pb::common::RegionState_Name(it.second.state()) << " last_update_timestamp "
                      << region_metrics.region_status().last_update_timestamp() << " now " << butil::gettimeofday_ms();
 
-    if (region_metrics.region_status().last_update_timestamp() + (FLAGS_region_heartbeat_timeout * 1000) >=
-        butil::gettimeofday_ms()) {
+    int64_t last_update_timestamp = region_metrics.region_status().last_update_timestamp();
+    auto store_time_it = store_region_metrics_update_times.find(region_metrics.leader_store_id());
+    if (store_time_it != store_region_metrics_update_times.end()) {
+      last_update_timestamp = std::max(last_update_timestamp, store_time_it->second);
+    }
+
+    if (last_update_timestamp + (FLAGS_region_heartbeat_timeout * 1000) >= butil::gettimeofday_ms()) {
       if (region_metrics.region_status().heartbeat_status() != pb::common::RegionHeartbeatState::REGION_ONLINE) {
         DINGO_LOG(INFO) << "CoordinatorUpdateState... update region " << it.first << " state to online";
         TrySetRegionToOnline(it.first);
@@ -4472,6 +4487,11 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                        "region_metrics_map_size = "
                     << store_metrics.region_metrics_map_size()
                     << ", region_metrics=" << store_metrics.ShortDebugString();
+  } else if (store_metrics.is_delta_region_metrics()) {
+    DINGO_LOG(INFO) << "UpdateRegionMapAndStoreOperation delta heartbeat, region_metrics_map_size = "
+                    << store_metrics.region_metrics_map_size()
+                    << ", version = " << store_metrics.region_metrics_version()
+                    << ", base_version = " << store_metrics.base_region_metrics_version();
   } else {
     DINGO_LOG(INFO) << "UpdateRegionMapAndStoreOperation full heartbeat, region_metrics_map_size = "
                     << store_metrics.region_metrics_map_size();
@@ -4709,6 +4729,26 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
   }
 }
 
+bool CoordinatorControl::CheckStoreRegionMetricsVersion(const pb::common::StoreMetrics& store_metrics) {
+  if (!store_metrics.is_delta_region_metrics()) {
+    return true;
+  }
+
+  BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+  auto it = store_metrics_map_.find(store_metrics.id());
+  if (it == store_metrics_map_.end() ||
+      it->second.region_metrics_version != store_metrics.base_region_metrics_version()) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "CheckStoreRegionMetricsVersion delta heartbeat version mismatch, store_id={} base_version={} "
+        "applied_version={}, need full region metrics",
+        store_metrics.id(), store_metrics.base_region_metrics_version(),
+        it == store_metrics_map_.end() ? 0 : it->second.region_metrics_version);
+    return false;
+  }
+
+  return true;
+}
+
 int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& store_metrics,
                                                pb::coordinator_internal::MetaIncrement& meta_increment) {
   //   int64_t store_map_epoch =
@@ -4728,6 +4768,24 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
     store_metrics_slim.region_num = store_metrics.region_metrics_map_size();
     store_metrics_slim.update_time = butil::gettimeofday_ms();
 
+    auto it = store_metrics_map_.find(store_metrics.id());
+    if (it != store_metrics_map_.end()) {
+      store_metrics_slim.region_metrics_version = it->second.region_metrics_version;
+      store_metrics_slim.region_metrics_update_time = it->second.region_metrics_update_time;
+      // delta heartbeat only carry changed regions, keep the region num of the last full heartbeat
+      if (store_metrics.is_delta_region_metrics()) {
+        store_metrics_slim.region_num = it->second.region_num;
+      }
+    }
+
+    // only full heartbeat or delta heartbeat based on the last applied version can prove the omitted regions alive
+    if (store_metrics.region_metrics_version() > 0 &&
+        (!store_metrics.is_delta_region_metrics() ||
+         store_metrics.base_region_metrics_version() == store_metrics_slim.region_metrics_version)) {
+      store_metrics_slim.region_metrics_version = store_metrics.region_metrics_version();
+      store_metrics_slim.region_metrics_update_time = store_metrics_slim.update_time;
+    }
+
     store_metrics_map_.insert_or_assign(store_metrics.id(), std::move(store_metrics_slim));
 
     DINGO_LOG(INFO) << "UpdateStoreMetrics store_metrics.id=" << store_metrics.id()
@@ -4742,13 +4800,13 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
 
   {
     BAIDU_SCOPED_LOCK(store_region_metrics_map_mutex_);
-    if (store_metrics.is_partial_region_metrics()) {
+    if (store_metrics.is_partial_region_metrics() || store_metrics.is_delta_region_metrics()) {
       if (store_region_metrics_map_.find(store_metrics.id()) == store_region_metrics_map_.end()) {
         store_region_metrics_map_.insert_or_assign(store_metrics.id(), store_metrics);
       } else {
+        auto* mut_region_metrics_map = store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map();
         for (const auto& region_metrics : store_metrics.region_metrics_map()) {
-          store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map()->insert(
-              {region_metrics.first, region_metrics.second});
+          (*mut_region_metrics_map)[region_metrics.first] = region_metrics.second;
         }
       }
     } else {
@@ -30,18 +30,27 @@
 #include "common/safe_map.h"
 #include "coordinator/coordinator_meta_storage.h"
 #include "coordinator/coordinator_prefix.h"
+#include "coordinator/kv_watch_hub.h"
+#include "coordinator/lease_timer_wheel.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator_internal.pb.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DECLARE_uint32(version_lease_timer_wheel_shard_num);
+DECLARE_int64(version_lease_timer_wheel_tick_ms);
+
 KvControl::KvControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<MetaWriter> meta_writer,
                      std::shared_ptr<RawEngine> raw_engine_of_meta)
     : meta_reader_(meta_reader), meta_writer_(meta_writer), leader_term_(-1), raw_engine_of_meta_(raw_engine_of_meta) {
   // init bthread mutex
   bthread_mutex_init(&lease_to_key_map_mutex_, nullptr);
   bthread_mutex_init(&one_time_watch_map_mutex_, nullptr);
+  kv_watch_hub_ = std::make_unique<KvWatchHub>(this);
+  lease_timer_wheel_ = std::make_unique<LeaseTimerWheel>(FLAGS_version_lease_timer_wheel_shard_num,
+                                                         FLAGS_version_lease_timer_wheel_tick_ms, Helper::TimestampMs());
   leader_term_.store(-1, butil::memory_order_release);
 
   // the data structure below will write to raft
@@ -29,6 +29,8 @@
 #include "common/meta_control.h"
 #include "common/safe_map.h"
 #include "coordinator/coordinator_meta_storage.h"
+#include "coordinator/kv_watch_hub.h"
+#include "coordinator/lease_timer_wheel.h"
 #include "engine/engine.h"
 #include "engine/snapshot.h"
 #include "google/protobuf/stubs/callback.h"
@@ -327,6 +329,15 @@ class KvControl : public MetaControl {
   butil::Status TriggerOneWatch(const std::string &key, pb::version::Event::EventType event_type,
                                 pb::version::Kv &new_kv, pb::version::Kv &prev_kv);
 
+  // stream watch, key and prefix watchers are multiplexed on a brpc stream
+  butil::Status StreamWatch(const pb::version::WatchRequest &request, brpc::Controller *cntl);
+
+  // is there any one time watch or stream watch
+  bool HasWatcher();
+  // trigger one time watch and stream watch, called by raft apply
+  void TriggerWatch(const std::string &key, pb::version::Event::EventType event_type, pb::version::Kv &new_kv,
+                    pb::version::Kv &prev_kv);
+
  private:
   // deprecated, will removed in the future
   // ids_epochs_temp (out of state machine, only for leader use)
@@ -344,6 +355,8 @@ class KvControl : public MetaControl {
   std::map<int64_t, KvLeaseWithKeys> lease_to_key_map_;
   bthread_mutex_t lease_to_key_map_mutex_;
   butil::atomic<int64_t> lease_to_key_map_init_term_{0};
+  // lease deadline of lease_to_key_map_, find expired leases without sweep all leases
+  std::unique_ptr<LeaseTimerWheel> lease_timer_wheel_;
 
   // 15.version kv with lease
   DingoSafeStdMap<std::string, pb::coordinator_internal::KvIndexInternal> kv_index_map_;
@@ -360,6 +373,9 @@ class KvControl : public MetaControl {
   std::atomic<uint64_t> one_time_watch_closure_seq_{1000};  // used to generate unique closure id
   DingoSafeStdMap<uint64_t, bool> one_time_watch_closure_status_map_;
 
+  // stream watch, only work on leader, is out of state machine
+  std::unique_ptr<KvWatchHub> kv_watch_hub_;
+
   // Read meta data from persistence storage.
   std::shared_ptr<MetaReader> meta_reader_;
   // Write meta data to persistence storage.
@@ -88,6 +88,9 @@ void KvControl::OnLeaderStart(int64_t term) {
   }
   DINGO_LOG(INFO) << "OnLeaderStart clear one_time_watch_map_, term=" << term;
 
+  // streams accepted in the last term are stale
+  kv_watch_hub_->CloseAllStreams();
+
   DINGO_LOG(INFO) << "OnLeaderStart finished, term=" << term;
 }
 
@@ -107,6 +110,9 @@ void KvControl::OnLeaderStop() {
   }
   DINGO_LOG(INFO) << "OnLeaderStop clear one_time_watch_map_";
 
+  // client will rewatch on new leader
+  kv_watch_hub_->CloseAllStreams();
+
   DINGO_LOG(INFO) << "OnLeaderStop finished";
 }
 
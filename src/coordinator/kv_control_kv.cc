@@ -51,6 +51,8 @@ BRPC_VALIDATE_GFLAG(version_kv_max_count, brpc::NonNegativeInteger);
 DEFINE_bool(dingo_log_switch_coor_kv, false, "log switch for kv control");
 BRPC_VALIDATE_GFLAG(dingo_log_switch_coor_kv, brpc::PassValidate);
 
+DECLARE_bool(dingo_log_switch_coor_watch);
+
 std::string KvControl::RevisionToString(const pb::coordinator_internal::RevisionInternal &revision) {
   Buf buf(17);
   buf.WriteLong(revision.main());
@@ -717,9 +719,10 @@ butil::Status KvControl::KvPutApply(const std::string &key,
       << "), kv_index: " << kv_index.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvPutApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
-                    << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
+  if (HasWatcher()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "KvPutApply has watcher, will trigger watch, key: " << key << "(" << Helper::StringToHex(key)
+        << "), one time watch size: " << one_time_watch_map_.size();
 
     if (prev_kv.create_revision() > 0) {
       prev_kv.set_lease(kv_rev_last.kv().lease());
@@ -733,7 +736,7 @@ butil::Status KvControl::KvPutApply(const std::string &key,
     new_kv.mutable_kv()->set_key(key);
     new_kv.mutable_kv()->set_value(kv_rev.kv().value());
 
-    TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
+    TriggerWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
   }
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
@@ -859,9 +862,10 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
       << "), revision: " << op_revision.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvDeleteApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
-                    << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
+  if (HasWatcher()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "KvDeleteApply has watcher, will trigger watch, key: " << key << "(" << Helper::StringToHex(key)
+        << "), one time watch size: " << one_time_watch_map_.size();
 
     if (prev_kv.create_revision() > 0) {
       prev_kv.set_lease(kv_rev_last.kv().lease());
@@ -875,7 +879,7 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
     new_kv.mutable_kv()->set_key(key);
     new_kv.mutable_kv()->set_value(kv_rev.kv().value());
 
-    TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
+    TriggerWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
   }
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
@@ -14,6 +14,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -24,6 +25,8 @@
 #include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "butil/time.h"
+#include "bvar/bvar.h"
+#include "bvar/latency_recorder.h"
 #include "common/logging.h"
 #include "coordinator/kv_control.h"
 #include "gflags/gflags.h"
@@ -48,6 +51,23 @@ BRPC_VALIDATE_GFLAG(version_lease_print_ttl_remaining_seconds, brpc::NonNegative
 DEFINE_bool(dingo_log_switch_coor_lease, false, "switch for dingo log of kv control lease");
 BRPC_VALIDATE_GFLAG(dingo_log_switch_coor_lease, brpc::PassValidate);
 
+DEFINE_uint32(version_lease_timer_wheel_shard_num, 32, "shard num of lease timer wheel");
+DEFINE_int64(version_lease_timer_wheel_tick_ms, 100, "tick ms of lease timer wheel");
+DEFINE_int64(version_lease_revoke_batch_size, 1000, "max expired lease count revoked in one meta increment");
+BRPC_VALIDATE_GFLAG(version_lease_revoke_batch_size, brpc::PositiveInteger);
+
+static bvar::Adder<int64_t> g_lease_expired_count("dingo_version_lease_expired_count");
+static bvar::LatencyRecorder g_lease_revoke_batch_latency("dingo_version_lease_revoke_batch_latency");
+
+// expired when now_seconds > last_renew_ts_seconds + ttl_seconds
+static int64_t LeaseDeadlineMs(const pb::coordinator_internal::LeaseInternal &lease) {
+  return (lease.last_renew_ts_seconds() + lease.ttl_seconds() + 1) * 1000;
+}
+
+static bool IsLeaseExpired(const pb::coordinator_internal::LeaseInternal &lease, int64_t now_seconds) {
+  return lease.ttl_seconds() + lease.last_renew_ts_seconds() < now_seconds;
+}
+
 butil::Status KvControl::LeaseGrant(int64_t lease_id, int64_t ttl_seconds, int64_t &granted_id,
                                     int64_t &granted_ttl_seconds,
                                     pb::coordinator_internal::MetaIncrement &meta_increment) {
@@ -112,6 +132,7 @@ butil::Status KvControl::LeaseGrant(int64_t lease_id, int64_t ttl_seconds, int64
   {
     BAIDU_SCOPED_LOCK(lease_to_key_map_mutex_);
     lease_to_key_map_.emplace(lease_with_keys.lease.id(), lease_with_keys);
+    lease_timer_wheel_->Add(granted_id, LeaseDeadlineMs(lease_with_keys.lease));
   }
 
   return butil::Status::OK();
@@ -135,7 +156,17 @@ butil::Status KvControl::LeaseRenew(int64_t lease_id, int64_t &ttl_seconds,
 
   auto iter = lease_to_key_map_.find(lease_id);
   if (iter != lease_to_key_map_.end()) {
-    iter->second.lease.set_last_renew_ts_seconds(now_time_seconds);
+    auto &renew_lease = iter->second.lease;
+    auto remaining_ttl_seconds =
+        renew_lease.ttl_seconds() - (now_time_seconds - renew_lease.last_renew_ts_seconds());
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_lease &&
+                           remaining_ttl_seconds < FLAGS_version_lease_print_ttl_remaining_seconds)
+        << "lease id " << lease_id << " renew late, last_renew_ts_seconds " << renew_lease.last_renew_ts_seconds()
+        << ", ttl_seconds " << renew_lease.ttl_seconds() << ", remaining ttl_seconds " << remaining_ttl_seconds;
+
+    renew_lease.set_last_renew_ts_seconds(now_time_seconds);
+    // only update deadline, O(1)
+    lease_timer_wheel_->Renew(lease_id, LeaseDeadlineMs(renew_lease));
   } else {
     DINGO_LOG(WARNING) << "lease id " << lease_id << " not found, cannot renew";
     return butil::Status(pb::error::Errno::ELEASE_NOT_EXISTS_OR_EXPIRED, "lease id %lu not found", lease_id);
@@ -211,6 +242,7 @@ butil::Status KvControl::LeaseRevoke(int64_t lease_id, pb::coordinator_internal:
 
     // delete lease from map
     lease_to_key_map_.erase(lease_id);
+    lease_timer_wheel_->Remove(lease_id);
   }
 
   if (!has_mutex_locked) {
@@ -300,6 +332,7 @@ void KvControl::LeaseTask() {
       {
         BAIDU_SCOPED_LOCK(lease_to_key_map_mutex_);
         lease_to_key_map_.clear();
+        lease_timer_wheel_->Clear(Helper::TimestampMs());
       }
 
       lease_to_key_map_init_term_.store(0, butil::memory_order_release);
@@ -313,31 +346,42 @@ void KvControl::LeaseTask() {
   }
 
   // for leader, do lease task
-  std::vector<int64_t> lease_ids_to_revoke;
-  pb::coordinator_internal::MetaIncrement meta_increment;
-  {
+  // the timer wheel only return the due leases, no need to sweep all leases with mutex locked.
+  auto expired_lease_ids = lease_timer_wheel_->Advance(Helper::TimestampMs());
+  if (expired_lease_ids.empty()) {
+    return;
+  }
+
+  DINGO_LOG(INFO) << "lease task found expired lease count: " << expired_lease_ids.size()
+                  << ", lease count: " << lease_timer_wheel_->Size();
+
+  // revoke in batch, release mutex between batches to not block grant/renew too long
+  size_t batch_size = FLAGS_version_lease_revoke_batch_size;
+  for (size_t start = 0; start < expired_lease_ids.size(); start += batch_size) {
+    size_t end = std::min(expired_lease_ids.size(), start + batch_size);
+    int64_t batch_start_time_us = Helper::TimestampUs();
+
+    pb::coordinator_internal::MetaIncrement meta_increment;
     BAIDU_SCOPED_LOCK(lease_to_key_map_mutex_);
-    if (lease_to_key_map_.empty()) {
-      return;
-    }
 
-    for (const auto &it : lease_to_key_map_) {
-      const auto &lease = it.second.lease;
-      if (lease.ttl_seconds() + lease.last_renew_ts_seconds() < butil::gettimeofday_s()) {
-        DINGO_LOG(INFO) << "lease id " << lease.id() << " expired, will revoke";
-        lease_ids_to_revoke.emplace_back(lease.id());
-      } else {
-        auto remaining_ttl_seconds = lease.ttl_seconds() - (butil::gettimeofday_s() - lease.last_renew_ts_seconds());
-        if (remaining_ttl_seconds < FLAGS_version_lease_print_ttl_remaining_seconds) {
-          DINGO_LOG(INFO) << "lease id " << lease.id() << " is ok, last_renew_ts_seconds "
-                          << lease.last_renew_ts_seconds() << ", ttl_seconds " << lease.ttl_seconds()
-                          << ", remaining ttl_seconds " << remaining_ttl_seconds;
-        }
+    auto now_seconds = butil::gettimeofday_s();
+    for (size_t i = start; i < end; ++i) {
+      auto lease_id = expired_lease_ids[i];
+      auto it = lease_to_key_map_.find(lease_id);
+      if (it == lease_to_key_map_.end()) {
+        continue;
       }
-    }
 
-    for (const auto &lease_id : lease_ids_to_revoke) {
+      // double check with lease_to_key_map_, it is the source of truth
+      const auto &lease = it->second.lease;
+      if (!IsLeaseExpired(lease, now_seconds)) {
+        lease_timer_wheel_->Add(lease_id, LeaseDeadlineMs(lease));
+        continue;
+      }
+
+      DINGO_LOG(INFO) << "lease id " << lease_id << " expired, will revoke";
       LeaseRevoke(lease_id, meta_increment, true);
+      g_lease_expired_count << 1;
     }
 
     // submit meta_increment with mutex locked
@@ -348,6 +392,8 @@ void KvControl::LeaseTask() {
         DINGO_LOG(ERROR) << "SubmitMetaIncrementSync failed, status: " << ret;
       }
     }
+
+    g_lease_revoke_batch_latency << Helper::TimestampUs() - batch_start_time_us;
   }
 
   auto lease_task_end_time_ms = Helper::TimestampMs();
@@ -454,6 +500,12 @@ void KvControl::BuildLeaseToKeyMap() {
   // swap lease_to_key_map_
   lease_to_key_map_.swap(temp_lease_to_key_map);
 
+  // rebuild lease timer wheel
+  lease_timer_wheel_->Clear(Helper::TimestampMs());
+  for (const auto &it : lease_to_key_map_) {
+    lease_timer_wheel_->Add(it.first, LeaseDeadlineMs(it.second.lease));
+  }
+
   // update flag to true
   lease_to_key_map_init_term_.store(leader_term, butil::memory_order_release);
 
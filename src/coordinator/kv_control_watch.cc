@@ -49,10 +49,11 @@ butil::Status KvControl::OneTimeWatch(const std::string& watch_key, int64_t star
                                       [[maybe_unused]] brpc::Controller* cntl) {
   brpc::ClosureGuard done_guard(done);
 
-  DINGO_LOG(INFO) << "OneTimeWatch, watch_key:" << watch_key << ", hex_key: " << Helper::StringToHex(watch_key)
-                  << ", start_revision:" << start_revision << ", no_put_event:" << no_put_event
-                  << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
-                  << ", wait_on_not_exist_key:" << wait_on_not_exist_key << ", done:" << done;
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "OneTimeWatch, watch_key:" << watch_key << ", hex_key: " << Helper::StringToHex(watch_key)
+      << ", start_revision:" << start_revision << ", no_put_event:" << no_put_event
+      << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
+      << ", wait_on_not_exist_key:" << wait_on_not_exist_key << ", done:" << done;
 
   BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
 
@@ -122,19 +123,20 @@ butil::Status KvControl::AddOneTimeWatch(const std::string& watch_key, int64_t s
   // add to watch
   KvWatchNode watch_node(closure_id, start_revision, no_put_event, no_delete_event, need_prev_kv);
 
-  DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key:" << watch_key << ", hex_key: " << Helper::StringToHex(watch_key)
-                  << ", start_revision:" << start_revision << ", no_put_event:" << no_put_event
-                  << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
-                  << ", closure_id:" << closure_id;
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "AddOneTimeWatch, watch_key:" << watch_key << ", hex_key: " << Helper::StringToHex(watch_key)
+      << ", start_revision:" << start_revision << ", no_put_event:" << no_put_event
+      << ", no_delete_event:" << no_delete_event << ", need_prev_kv:" << need_prev_kv
+      << ", closure_id:" << closure_id;
 
   auto it = one_time_watch_map_.find(watch_key);
   if (it == one_time_watch_map_.end()) {
     std::map<uint64_t, KvWatchNode> watch_node_map;
     watch_node_map.insert_or_assign(closure_id, watch_node);
     one_time_watch_map_.insert_or_assign(watch_key, watch_node_map);
-    DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key not found, insert, watch_key:" << watch_key
-                    << ", hex_key: " << Helper::StringToHex(watch_key)
-                    << ", watch_node_map.size:" << watch_node_map.size();
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "AddOneTimeWatch, watch_key not found, insert, watch_key:" << watch_key
+        << ", hex_key: " << Helper::StringToHex(watch_key) << ", watch_node_map.size:" << watch_node_map.size();
   } else {
     auto& exist_watch_node_map = it->second;
     exist_watch_node_map.insert_or_assign(closure_id, watch_node);
@@ -156,11 +158,13 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
   }
   auto& defer_done = it_defer_done->second;
 
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, closure_id:" << closure_id << ", done->Run() start";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, closure_id:" << closure_id << ", done->Run() start";
   int64_t start_ts = butil::gettimeofday_ms();
   defer_done.Done();
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, closure_id:" << closure_id
-                  << ", done->Run() finish, cost: " << butil::gettimeofday_ms() - start_ts << " ms";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, closure_id:" << closure_id << ", done->Run() finish, cost: "
+      << butil::gettimeofday_ms() - start_ts << " ms";
 
   auto watch_key = defer_done.GetWatchKey();
   if (watch_key.empty()) {
@@ -185,11 +189,13 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
   }
 
   watch_node_map.erase(it_watch_node);
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, done->Run: " << closure_id << ", watch_key:" << watch_key
-                  << ", cost: " << butil::gettimeofday_ms() - start_ts << " ms";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, done->Run: " << closure_id << ", watch_key:" << watch_key
+      << ", cost: " << butil::gettimeofday_ms() - start_ts << " ms";
 
   if (watch_node_map.empty()) {
-    DINGO_LOG(INFO) << "RemoveOneTimeWatch, watch_node_map is empty, watch_key:" << watch_key;
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "RemoveOneTimeWatch, watch_node_map is empty, watch_key:" << watch_key;
     one_time_watch_map_.erase(it_watch_key);
   }
 
@@ -270,8 +276,9 @@ butil::Status KvControl::RemoveOneTimeWatch(uint64_t closure_id) {
 
 butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Event::EventType event_type,
                                          pb::version::Kv& new_kv, pb::version::Kv& prev_kv) {
-  DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
-                  << ", new_kv:" << new_kv.ShortDebugString() << ", prev_kv:" << prev_kv.ShortDebugString();
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "TriggerOneWatch, key:" << key << ", event_type:" << event_type << ", new_kv:" << new_kv.ShortDebugString()
+      << ", prev_kv:" << prev_kv.ShortDebugString();
 
   BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
 
@@ -306,12 +313,13 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
       continue;
     }
 
-    DINGO_LOG(INFO) << "TriggerOneWatch will GetResponse, key:" << key << ", event_type:" << event_type
-                    << ", watch_node.first:" << watch_node.first
-                    << ", watch_detail: start_revision=" << watch_node.second.start_revision
-                    << ", no_put_event=" << watch_node.second.no_put_event
-                    << ", no_delete_event=" << watch_node.second.no_delete_event
-                    << ", need_prev_kv=" << watch_node.second.need_prev_kv;
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "TriggerOneWatch will GetResponse, key:" << key << ", event_type:" << event_type
+        << ", watch_node.first:" << watch_node.first
+        << ", watch_detail: start_revision=" << watch_node.second.start_revision
+        << ", no_put_event=" << watch_node.second.no_put_event
+        << ", no_delete_event=" << watch_node.second.no_delete_event
+        << ", need_prev_kv=" << watch_node.second.need_prev_kv;
 
     pb::version::WatchResponse* response = nullptr;
     auto closure_id = watch_node.first;
@@ -350,8 +358,8 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
 
     done_list.push_back(closure_id);
 
-    DINGO_LOG(INFO) << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type
-                    << ", closure_id:" << closure_id;
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type << ", closure_id:" << closure_id;
   }
 
   for (auto& closure_id : done_list) {
@@ -368,4 +376,26 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
   return butil::Status::OK();
 }
 
+butil::Status KvControl::StreamWatch(const pb::version::WatchRequest& request, brpc::Controller* cntl) {
+  if (!cntl->has_remote_stream()) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "stream watch need attach a stream");
+  }
+
+  return kv_watch_hub_->AcceptStream(cntl, request);
+}
+
+bool KvControl::HasWatcher() { return !one_time_watch_map_.empty() || kv_watch_hub_->HasWatcher(); }
+
+void KvControl::TriggerWatch(const std::string& key, pb::version::Event::EventType event_type, pb::version::Kv& new_kv,
+                             pb::version::Kv& prev_kv) {
+  if (!one_time_watch_map_.empty()) {
+    TriggerOneWatch(key, event_type, new_kv, prev_kv);
+  }
+
+  // stream watch is notified in apply order, so events are in revision order
+  if (kv_watch_hub_->HasWatcher()) {
+    kv_watch_hub_->Notify(key, event_type, new_kv, prev_kv);
+  }
+}
+
 }  // namespace dingodb
@@ -0,0 +1,730 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/kv_watch_hub.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/endpoint.h"
+#include "butil/scoped_lock.h"
+#include "bvar/bvar.h"
+#include "bvar/latency_recorder.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "coordinator/kv_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_int32(kv_watch_index_shard_num, 32, "shard num of kv watch index, take effect after restart");
+BRPC_VALIDATE_GFLAG(kv_watch_index_shard_num, brpc::PositiveInteger);
+DEFINE_int32(kv_watch_index_shard_prefix_len, 4, "key prefix length used to choose kv watch index shard");
+BRPC_VALIDATE_GFLAG(kv_watch_index_shard_prefix_len, brpc::NonNegativeInteger);
+DEFINE_int64(kv_watch_stream_max_pending, 10000, "max pending response of one watch stream, close stream if exceed");
+BRPC_VALIDATE_GFLAG(kv_watch_stream_max_pending, brpc::PositiveInteger);
+DEFINE_int64(kv_watch_replay_max_count, 10000, "max kv count replayed when create watch with start_revision");
+BRPC_VALIDATE_GFLAG(kv_watch_replay_max_count, brpc::PositiveInteger);
+
+DECLARE_int64(version_watch_max_count);
+DECLARE_bool(dingo_log_switch_coor_watch);
+
+static bvar::Adder<int64_t> g_kv_watch_stream_num("dingo_kv_watch_stream_num");
+static bvar::LatencyRecorder g_kv_watch_notify_latency("dingo_kv_watch_notify_latency");
+static bvar::LatencyRecorder g_kv_watch_fanout("dingo_kv_watch_fanout");
+
+static void SetResponseError(pb::version::WatchResponse& response, pb::error::Errno errcode,
+                             const std::string& errmsg) {
+  response.mutable_error()->set_errcode(errcode);
+  response.mutable_error()->set_errmsg(errmsg);
+}
+
+// Every message on stream is a WatchRequest, handler is deleted when stream is closed.
+class KvWatchStreamHandler : public brpc::StreamInputHandler {
+ public:
+  explicit KvWatchStreamHandler(KvWatchHub* hub) : hub_(hub) {}
+  ~KvWatchStreamHandler() override = default;
+
+  void SetStream(KvWatchStreamPtr stream) { stream_ = stream; }
+
+  int on_received_messages(brpc::StreamId id, butil::IOBuf* const messages[], size_t size) override {
+    for (size_t i = 0; i < size; ++i) {
+      pb::version::WatchRequest request;
+      butil::IOBufAsZeroCopyInputStream wrapper(*messages[i]);
+      if (!request.ParseFromZeroCopyStream(&wrapper)) {
+        DINGO_LOG(ERROR) << fmt::format("[watch.stream][{}] parse request fail.", id);
+        continue;
+      }
+
+      hub_->HandleRequest(stream_, request);
+    }
+
+    return 0;
+  }
+
+  void on_idle_timeout(brpc::StreamId id) override {
+    DINGO_LOG(INFO) << fmt::format("[watch.stream][{}] stream idle timeout, close it.", id);
+    brpc::StreamClose(id);
+  }
+
+  void on_closed(brpc::StreamId id) override {
+    DINGO_LOG(INFO) << fmt::format("[watch.stream][{}] stream closed.", id);
+    if (stream_ != nullptr) {
+      hub_->HandleStreamClosed(stream_);
+    }
+    delete this;
+  }
+
+ private:
+  KvWatchHub* hub_;
+  KvWatchStreamPtr stream_;
+};
+
+KvWatchIndex::KvWatchIndex(uint32_t shard_num, uint32_t shard_prefix_len) : shard_prefix_len_(shard_prefix_len) {
+  shard_num = std::max(shard_num, static_cast<uint32_t>(1));
+  shards_.reserve(shard_num);
+  for (uint32_t i = 0; i < shard_num; ++i) {
+    auto shard = std::make_unique<Shard>();
+    bthread_mutex_init(&shard->mutex, nullptr);
+    shards_.push_back(std::move(shard));
+  }
+  bthread_mutex_init(&short_shard_.mutex, nullptr);
+}
+
+KvWatchIndex::~KvWatchIndex() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard->mutex);
+  }
+  bthread_mutex_destroy(&short_shard_.mutex);
+}
+
+KvWatchIndex::Shard& KvWatchIndex::GetShard(const std::string& key) {
+  if (key.size() < shard_prefix_len_) {
+    return short_shard_;
+  }
+
+  size_t hash = std::hash<std::string_view>{}(std::string_view(key).substr(0, shard_prefix_len_));
+  return *shards_[hash % shards_.size()];
+}
+
+void KvWatchIndex::Add(KvWatcherPtr watcher) {
+  auto& shard = GetShard(watcher->key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  Node* node = &shard.root;
+  for (char c : watcher->key) {
+    auto& child = node->children[c];
+    if (child == nullptr) {
+      child = std::make_unique<Node>();
+    }
+    node = child.get();
+  }
+
+  auto& watchers = watcher->is_prefix ? node->prefix_watchers : node->key_watchers;
+  if (watchers.insert_or_assign(watcher->id, watcher).second) {
+    watcher_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void KvWatchIndex::Remove(KvWatcherPtr watcher) {
+  auto& shard = GetShard(watcher->key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  std::vector<Node*> path;
+  path.reserve(watcher->key.size() + 1);
+  Node* node = &shard.root;
+  path.push_back(node);
+  for (char c : watcher->key) {
+    auto it = node->children.find(c);
+    if (it == node->children.end()) {
+      return;
+    }
+    node = it->second.get();
+    path.push_back(node);
+  }
+
+  auto& watchers = watcher->is_prefix ? node->prefix_watchers : node->key_watchers;
+  if (watchers.erase(watcher->id) == 0) {
+    return;
+  }
+  watcher_count_.fetch_sub(1, std::memory_order_relaxed);
+
+  // prune empty nodes from leaf, path[i] is the parent of key[i]
+  for (size_t i = watcher->key.size(); i > 0; --i) {
+    if (!path[i]->IsEmpty()) {
+      break;
+    }
+    path[i - 1]->children.erase(watcher->key[i - 1]);
+  }
+}
+
+void KvWatchIndex::MatchInShard(Shard& shard, const std::string& key, std::vector<KvWatcherPtr>& watchers) {
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  const Node* node = &shard.root;
+  size_t depth = 0;
+  for (;;) {
+    for (const auto& [id, watcher] : node->prefix_watchers) {
+      watchers.push_back(watcher);
+    }
+
+    if (depth == key.size()) {
+      for (const auto& [id, watcher] : node->key_watchers) {
+        watchers.push_back(watcher);
+      }
+      break;
+    }
+
+    auto it = node->children.find(key[depth]);
+    if (it == node->children.end()) {
+      break;
+    }
+    node = it->second.get();
+    ++depth;
+  }
+}
+
+std::vector<KvWatcherPtr> KvWatchIndex::Match(const std::string& key) {
+  std::vector<KvWatcherPtr> watchers;
+  if (watcher_count_.load(std::memory_order_relaxed) == 0) {
+    return watchers;
+  }
+
+  // prefix shorter than shard_prefix_len_ only in short shard
+  MatchInShard(short_shard_, key, watchers);
+  if (key.size() >= shard_prefix_len_) {
+    MatchInShard(GetShard(key), key, watchers);
+  }
+
+  return watchers;
+}
+
+KvWatchStream::KvWatchStream(brpc::StreamId stream_id) : stream_id_(stream_id) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+KvWatchStream::~KvWatchStream() { bthread_mutex_destroy(&mutex_); }
+
+bool KvWatchStream::AddWatcher(KvWatcherPtr watcher) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (watcher->watch_id == 0) {
+    while (watchers_.find(next_watch_id_) != watchers_.end()) {
+      ++next_watch_id_;
+    }
+    watcher->watch_id = next_watch_id_++;
+  }
+
+  return watchers_.insert({watcher->watch_id, watcher}).second;
+}
+
+KvWatcherPtr KvWatchStream::RemoveWatcher(int64_t watch_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = watchers_.find(watch_id);
+  if (it == watchers_.end()) {
+    return nullptr;
+  }
+
+  auto watcher = it->second;
+  watchers_.erase(it);
+  return watcher;
+}
+
+std::vector<KvWatcherPtr> KvWatchStream::RemoveAllWatchers() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<KvWatcherPtr> watchers;
+  watchers.reserve(watchers_.size());
+  for (auto& [watch_id, watcher] : watchers_) {
+    watchers.push_back(watcher);
+  }
+  watchers_.clear();
+
+  return watchers;
+}
+
+void KvWatchStream::Send(const pb::version::WatchResponse& response) {
+  bool need_close = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    SendWithLock(response, need_close);
+  }
+
+  if (need_close) {
+    brpc::StreamClose(stream_id_);
+  }
+}
+
+void KvWatchStream::SendEvent(KvWatcherPtr watcher, const pb::version::Event& event) {
+  bool need_close = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    if (closed_) {
+      return;
+    }
+
+    if (!watcher->synced) {
+      watcher->buffered_events.push_back(event);
+      if (static_cast<int64_t>(watcher->buffered_events.size()) > FLAGS_kv_watch_stream_max_pending) {
+        DINGO_LOG(WARNING) << fmt::format("[watch.stream][{}] watch({}) buffer too many events when replay.",
+                                          stream_id_, watcher->watch_id);
+        closed_ = true;
+        need_close = true;
+      }
+    } else {
+      pb::version::WatchResponse response;
+      response.set_watch_id(watcher->watch_id);
+      *response.add_events() = event;
+      SendWithLock(response, need_close);
+    }
+  }
+
+  if (need_close) {
+    brpc::StreamClose(stream_id_);
+  }
+}
+
+void KvWatchStream::FinishSync(KvWatcherPtr watcher, const std::vector<pb::version::Event>& replay_events) {
+  bool need_close = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    auto events = MergeSyncEvents(replay_events, watcher->buffered_events);
+    if (!events.empty()) {
+      pb::version::WatchResponse response;
+      response.set_watch_id(watcher->watch_id);
+      for (auto& event : events) {
+        *response.add_events() = std::move(event);
+      }
+      SendWithLock(response, need_close);
+    }
+
+    watcher->buffered_events.clear();
+    watcher->synced = true;
+  }
+
+  if (need_close) {
+    brpc::StreamClose(stream_id_);
+  }
+}
+
+std::vector<pb::version::Event> KvWatchStream::FilterBufferedEvents(
+    const std::vector<pb::version::Event>& replay_events, const std::vector<pb::version::Event>& buffered_events) {
+  // replay is a snapshot of present kvs, the revision of a replayed kv cover all events of the key before it.
+  std::map<std::string, int64_t> replay_revisions;
+  for (const auto& event : replay_events) {
+    auto& revision = replay_revisions[event.kv().kv().key()];
+    revision = std::max(revision, event.kv().mod_revision());
+  }
+
+  std::vector<pb::version::Event> events;
+  events.reserve(buffered_events.size());
+  for (const auto& event : buffered_events) {
+    auto it = replay_revisions.find(event.kv().kv().key());
+    if (it != replay_revisions.end() && event.kv().mod_revision() <= it->second) {
+      continue;
+    }
+
+    events.push_back(event);
+  }
+
+  return events;
+}
+
+std::vector<pb::version::Event> KvWatchStream::MergeSyncEvents(const std::vector<pb::version::Event>& replay_events,
+                                                               const std::vector<pb::version::Event>& buffered_events) {
+  std::vector<pb::version::Event> events = replay_events;
+  for (auto& event : FilterBufferedEvents(replay_events, buffered_events)) {
+    events.push_back(std::move(event));
+  }
+
+  // replay is ordered by key, so keep the global revision order for watcher.
+  std::stable_sort(events.begin(), events.end(), [](const pb::version::Event& lhs, const pb::version::Event& rhs) {
+    return lhs.kv().mod_revision() < rhs.kv().mod_revision();
+  });
+
+  auto it = std::unique(events.begin(), events.end(), [](const pb::version::Event& lhs, const pb::version::Event& rhs) {
+    return lhs.kv().mod_revision() == rhs.kv().mod_revision() && lhs.kv().kv().key() == rhs.kv().kv().key();
+  });
+  events.erase(it, events.end());
+
+  return events;
+}
+
+void KvWatchStream::Close() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  closed_ = true;
+  pending_messages_.clear();
+}
+
+void KvWatchStream::SendWithLock(const pb::version::WatchResponse& response, bool& need_close) {
+  if (closed_) {
+    return;
+  }
+
+  butil::IOBuf data;
+  butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+  if (!response.SerializeToZeroCopyStream(&wrapper)) {
+    DINGO_LOG(ERROR) << fmt::format("[watch.stream][{}] serialize response fail.", stream_id_);
+    return;
+  }
+
+  pending_messages_.push_back(std::move(data));
+  if (static_cast<int64_t>(pending_messages_.size()) > FLAGS_kv_watch_stream_max_pending) {
+    DINGO_LOG(WARNING) << fmt::format("[watch.stream][{}] too many pending response({}), close it.", stream_id_,
+                                      pending_messages_.size());
+    closed_ = true;
+    need_close = true;
+    return;
+  }
+
+  if (!waiting_writable_) {
+    FlushWithLock(need_close);
+  }
+}
+
+void KvWatchStream::FlushWithLock(bool& need_close) {
+  while (!pending_messages_.empty()) {
+    int ret = brpc::StreamWrite(stream_id_, pending_messages_.front());
+    if (ret == 0) {
+      pending_messages_.pop_front();
+    } else if (ret == EAGAIN) {
+      waiting_writable_ = true;
+      brpc::StreamWait(stream_id_, nullptr, &KvWatchStream::OnWritable, new KvWatchStreamPtr(shared_from_this()));
+      return;
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("[watch.stream][{}] write response fail, error: {}.", stream_id_, ret);
+      closed_ = true;
+      need_close = true;
+      return;
+    }
+  }
+}
+
+void KvWatchStream::OnWritable(brpc::StreamId /*id*/, void* arg, int error_code) {
+  std::unique_ptr<KvWatchStreamPtr> stream(static_cast<KvWatchStreamPtr*>(arg));
+  auto& self = *stream;
+
+  bool need_close = false;
+  {
+    BAIDU_SCOPED_LOCK(self->mutex_);
+    self->waiting_writable_ = false;
+    if (self->closed_) {
+      return;
+    }
+
+    if (error_code != 0) {
+      DINGO_LOG(WARNING) << fmt::format("[watch.stream][{}] wait writable fail, error: {}.", self->stream_id_,
+                                        error_code);
+      self->closed_ = true;
+      need_close = true;
+    } else {
+      self->FlushWithLock(need_close);
+    }
+  }
+
+  if (need_close) {
+    brpc::StreamClose(self->stream_id_);
+  }
+}
+
+KvWatchHub::KvWatchHub(KvControl* kv_control)
+    : kv_control_(kv_control), index_(FLAGS_kv_watch_index_shard_num, FLAGS_kv_watch_index_shard_prefix_len) {
+  bthread_mutex_init(&streams_mutex_, nullptr);
+}
+
+KvWatchHub::~KvWatchHub() { bthread_mutex_destroy(&streams_mutex_); }
+
+butil::Status KvWatchHub::AcceptStream(brpc::Controller* cntl, const pb::version::WatchRequest& request) {
+  auto* handler = new KvWatchStreamHandler(this);
+
+  brpc::StreamOptions options;
+  options.handler = handler;
+  // watch stream is long-lived, no idle timeout
+
+  brpc::StreamId stream_id;
+  if (brpc::StreamAccept(&stream_id, *cntl, &options) != 0) {
+    DINGO_LOG(ERROR) << "[watch.stream] accept stream fail, remote: " << butil::endpoint2str(cntl->remote_side());
+    delete handler;
+    return butil::Status(pb::error::EINTERNAL, "accept watch stream fail");
+  }
+
+  auto stream = std::make_shared<KvWatchStream>(stream_id);
+  handler->SetStream(stream);
+  {
+    BAIDU_SCOPED_LOCK(streams_mutex_);
+    streams_[stream_id] = stream;
+  }
+
+  g_kv_watch_stream_num << 1;
+  DINGO_LOG(INFO) << fmt::format("[watch.stream][{}] accept stream, remote: {}.", stream_id,
+                                 butil::endpoint2str(cntl->remote_side()).c_str());
+
+  if (request.has_create_request() || request.has_cancel_request()) {
+    HandleRequest(stream, request);
+  }
+
+  return butil::Status::OK();
+}
+
+void KvWatchHub::HandleRequest(KvWatchStreamPtr stream, const pb::version::WatchRequest& request) {
+  if (request.has_create_request()) {
+    CreateWatch(stream, request.create_request());
+  } else if (request.has_cancel_request()) {
+    CancelWatch(stream, request.cancel_request());
+  } else {
+    pb::version::WatchResponse response;
+    SetResponseError(response, pb::error::EILLEGAL_PARAMTETERS, "watch stream only support create/cancel request");
+    stream->Send(response);
+  }
+}
+
+void KvWatchHub::HandleStreamClosed(KvWatchStreamPtr stream) {
+  stream->Close();
+
+  auto watchers = stream->RemoveAllWatchers();
+  for (auto& watcher : watchers) {
+    index_.Remove(watcher);
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(streams_mutex_);
+    streams_.erase(stream->Id());
+  }
+
+  g_kv_watch_stream_num << -1;
+  DINGO_LOG(INFO) << fmt::format("[watch.stream][{}] remove stream, watcher count: {}.", stream->Id(),
+                                 watchers.size());
+}
+
+void KvWatchHub::CreateWatch(KvWatchStreamPtr stream, const pb::version::WatchCreateRequest& request) {
+  pb::version::WatchResponse response;
+  response.set_watch_id(request.watch_id());
+
+  if (request.key().empty()) {
+    SetResponseError(response, pb::error::EILLEGAL_PARAMTETERS, "key is empty");
+    stream->Send(response);
+    return;
+  }
+
+  // only support single key and prefix, range_end is the next of prefix like etcd.
+  bool is_prefix = !request.range_end().empty();
+  if (is_prefix && request.range_end() != Helper::PrefixNext(request.key())) {
+    SetResponseError(response, pb::error::ENOT_SUPPORT, "only support watch key or prefix");
+    stream->Send(response);
+    return;
+  }
+
+  if (index_.WatcherCount() >= FLAGS_version_watch_max_count) {
+    SetResponseError(response, pb::error::EWATCH_COUNT_EXCEEDS_LIMIT, "watch count exceeds limit");
+    stream->Send(response);
+    return;
+  }
+
+  auto watcher = std::make_shared<KvWatcher>();
+  watcher->id = watcher_id_seq_.fetch_add(1, std::memory_order_relaxed);
+  watcher->watch_id = request.watch_id();
+  watcher->key = request.key();
+  watcher->is_prefix = is_prefix;
+  watcher->start_revision = request.start_revision();
+  watcher->need_prev_kv = request.need_prev_kv();
+  for (const auto& filter : request.filters()) {
+    if (filter == pb::version::EventFilterType::NOPUT) {
+      watcher->no_put_event = true;
+    } else if (filter == pb::version::EventFilterType::NODELETE) {
+      watcher->no_delete_event = true;
+    }
+  }
+  // no history to replay, only watch the future events
+  watcher->synced = watcher->start_revision == 0;
+  watcher->stream = stream;
+
+  if (!stream->AddWatcher(watcher)) {
+    SetResponseError(response, pb::error::EILLEGAL_PARAMTETERS, "watch_id is already used");
+    stream->Send(response);
+    return;
+  }
+
+  // response created before any event
+  response.set_watch_id(watcher->watch_id);
+  response.set_created(true);
+  stream->Send(response);
+
+  // add to index before replay, so no event is lost between them
+  index_.Add(watcher);
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << fmt::format(
+      "[watch.stream][{}] create watch({}), key: {}, is_prefix: {}, start_revision: {}.", stream->Id(),
+      watcher->watch_id, Helper::StringToHex(watcher->key), watcher->is_prefix, watcher->start_revision);
+
+  if (watcher->synced) {
+    return;
+  }
+
+  std::vector<pb::version::Event> replay_events;
+  auto status = Replay(watcher, replay_events);
+  if (!status.ok()) {
+    index_.Remove(watcher);
+    stream->RemoveWatcher(watcher->watch_id);
+
+    pb::version::WatchResponse cancel_response;
+    cancel_response.set_watch_id(watcher->watch_id);
+    cancel_response.set_canceled(true);
+    SetResponseError(cancel_response, static_cast<pb::error::Errno>(status.error_code()), status.error_str());
+    stream->Send(cancel_response);
+    return;
+  }
+
+  stream->FinishSync(watcher, replay_events);
+}
+
+void KvWatchHub::CancelWatch(KvWatchStreamPtr stream, const pb::version::WatchCancelRequest& request) {
+  pb::version::WatchResponse response;
+  response.set_watch_id(request.watch_id());
+
+  auto watcher = stream->RemoveWatcher(request.watch_id());
+  if (watcher == nullptr) {
+    SetResponseError(response, pb::error::EILLEGAL_PARAMTETERS, "watch_id not found");
+    stream->Send(response);
+    return;
+  }
+
+  index_.Remove(watcher);
+
+  response.set_canceled(true);
+  stream->Send(response);
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << fmt::format("[watch.stream][{}] cancel watch({}).", stream->Id(), watcher->watch_id);
+}
+
+// replay the present kvs which is modified since start_revision, kv history is compacted so not replayed.
+butil::Status KvWatchHub::Replay(KvWatcherPtr watcher, std::vector<pb::version::Event>& events) {
+  if (watcher->no_put_event) {
+    return butil::Status::OK();
+  }
+
+  std::string range_end = watcher->is_prefix ? Helper::PrefixNext(watcher->key) : std::string();
+
+  std::vector<pb::version::Kv> kvs;
+  int64_t total_count = 0;
+  bool has_more = false;
+  auto status = kv_control_->KvRange(watcher->key, range_end, FLAGS_kv_watch_replay_max_count, false, false, kvs,
+                                     total_count, has_more);
+  if (!status.ok()) {
+    return status;
+  }
+  if (has_more) {
+    return butil::Status(pb::error::EWATCH_COUNT_EXCEEDS_LIMIT,
+                         "too many kvs to replay, please use a larger start_revision");
+  }
+
+  std::sort(kvs.begin(), kvs.end(), [](const pb::version::Kv& lhs, const pb::version::Kv& rhs) {
+    return lhs.mod_revision() < rhs.mod_revision();
+  });
+
+  for (auto& kv : kvs) {
+    if (kv.mod_revision() < watcher->start_revision) {
+      continue;
+    }
+
+    pb::version::Event event;
+    event.set_type(pb::version::Event::EventType::Event_EventType_PUT);
+    *event.mutable_kv() = std::move(kv);
+    events.push_back(std::move(event));
+  }
+
+  return butil::Status::OK();
+}
+
+void KvWatchHub::Notify(const std::string& key, pb::version::Event::EventType event_type,
+                        const pb::version::Kv& new_kv, const pb::version::Kv& prev_kv) {
+  int64_t start_time_us = Helper::TimestampUs();
+
+  auto watchers = index_.Match(key);
+  if (watchers.empty()) {
+    return;
+  }
+
+  pb::version::Event event;
+  event.set_type(event_type);
+  *event.mutable_kv() = new_kv;
+  pb::version::Event event_with_prev_kv;
+
+  int64_t fanout = 0;
+  for (auto& watcher : watchers) {
+    if (watcher->no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
+      continue;
+    }
+    if (watcher->no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) {
+      continue;
+    }
+    if (watcher->start_revision > new_kv.mod_revision()) {
+      continue;
+    }
+
+    if (watcher->need_prev_kv) {
+      if (!event_with_prev_kv.has_kv()) {
+        event_with_prev_kv = event;
+        *event_with_prev_kv.mutable_prev_kv() = prev_kv;
+      }
+      watcher->stream->SendEvent(watcher, event_with_prev_kv);
+    } else {
+      watcher->stream->SendEvent(watcher, event);
+    }
+    ++fanout;
+  }
+
+  g_kv_watch_fanout << fanout;
+  g_kv_watch_notify_latency << Helper::TimestampUs() - start_time_us;
+}
+
+void KvWatchHub::CloseAllStreams() {
+  std::vector<brpc::StreamId> stream_ids;
+  {
+    BAIDU_SCOPED_LOCK(streams_mutex_);
+    for (auto& [stream_id, stream] : streams_) {
+      stream_ids.push_back(stream_id);
+    }
+  }
+
+  // watchers are removed in on_closed of stream
+  for (auto stream_id : stream_ids) {
+    brpc::StreamClose(stream_id);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[watch.stream] close all streams, count: {}.", stream_ids.size());
+}
+
+int64_t KvWatchHub::StreamCount() {
+  BAIDU_SCOPED_LOCK(streams_mutex_);
+  return streams_.size();
+}
+
+}  // namespace dingodb
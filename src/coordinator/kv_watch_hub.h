@@ -0,0 +1,202 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_KV_WATCH_HUB_H_
+#define DINGODB_COORDINATOR_KV_WATCH_HUB_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/controller.h"
+#include "brpc/stream.h"
+#include "bthread/types.h"
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "proto/version.pb.h"
+
+namespace dingodb {
+
+class KvControl;
+class KvWatchStream;
+using KvWatchStreamPtr = std::shared_ptr<KvWatchStream>;
+
+// A persistent watch on a key or a key prefix, it lives until canceled or its stream closed.
+struct KvWatcher {
+  // unique in the hub, used by index
+  int64_t id{0};
+  // unique in the stream, given by client or allocated by server
+  int64_t watch_id{0};
+
+  std::string key;
+  bool is_prefix{false};
+  int64_t start_revision{0};
+  bool no_put_event{false};
+  bool no_delete_event{false};
+  bool need_prev_kv{false};
+
+  KvWatchStreamPtr stream;
+
+  // below protected by stream mutex
+  // false when replaying history kv, events are buffered until replay is done.
+  bool synced{false};
+  std::vector<pb::version::Event> buffered_events;
+};
+using KvWatcherPtr = std::shared_ptr<KvWatcher>;
+
+// Index watchers by key and prefix, match a key cost O(len(key) + matched watchers).
+// The trie is sharded by the first shard_prefix_len bytes of key, a key only walk one shard,
+// all its prefix watchers which are not shorter than shard_prefix_len are in the same shard.
+// Watchers shorter than shard_prefix_len are in a standalone short trie.
+class KvWatchIndex {
+ public:
+  KvWatchIndex(uint32_t shard_num, uint32_t shard_prefix_len);
+  ~KvWatchIndex();
+
+  KvWatchIndex(const KvWatchIndex&) = delete;
+  void operator=(const KvWatchIndex&) = delete;
+
+  void Add(KvWatcherPtr watcher);
+  void Remove(KvWatcherPtr watcher);
+
+  // key watchers equal to key and prefix watchers is a prefix of key
+  std::vector<KvWatcherPtr> Match(const std::string& key);
+
+  int64_t WatcherCount() const { return watcher_count_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node {
+    std::map<char, std::unique_ptr<Node>> children;
+    std::map<int64_t, KvWatcherPtr> key_watchers;
+    std::map<int64_t, KvWatcherPtr> prefix_watchers;
+
+    bool IsEmpty() const { return children.empty() && key_watchers.empty() && prefix_watchers.empty(); }
+  };
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    Node root;
+  };
+
+  Shard& GetShard(const std::string& key);
+  static void MatchInShard(Shard& shard, const std::string& key, std::vector<KvWatcherPtr>& watchers);
+
+  const uint32_t shard_prefix_len_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  Shard short_shard_;
+
+  std::atomic<int64_t> watcher_count_{0};
+};
+
+// A brpc stream carry multiple watchers, request and response are WatchRequest/WatchResponse.
+// Responses are written in order, pending when stream is full, and the stream is closed when too
+// many pending responses, the client should rewatch from the last received revision.
+class KvWatchStream : public std::enable_shared_from_this<KvWatchStream> {
+ public:
+  explicit KvWatchStream(brpc::StreamId stream_id);
+  ~KvWatchStream();
+
+  KvWatchStream(const KvWatchStream&) = delete;
+  void operator=(const KvWatchStream&) = delete;
+
+  brpc::StreamId Id() const { return stream_id_; }
+
+  // allocate watch_id when client not given, return false if watch_id is used.
+  bool AddWatcher(KvWatcherPtr watcher);
+  KvWatcherPtr RemoveWatcher(int64_t watch_id);
+  std::vector<KvWatcherPtr> RemoveAllWatchers();
+
+  void Send(const pb::version::WatchResponse& response);
+
+  // send event of watcher, buffered when it is not synced.
+  void SendEvent(KvWatcherPtr watcher, const pb::version::Event& event);
+  // send replayed events and the buffered events which is newer than replayed, in revision order.
+  void FinishSync(KvWatcherPtr watcher, const std::vector<pb::version::Event>& replay_events);
+
+  // buffered events to send after replay, dedup per key, a key's event is skipped only when replayed kv of
+  // the key already cover it, events of keys not in replay(e.g. deleted) are all kept.
+  static std::vector<pb::version::Event> FilterBufferedEvents(const std::vector<pb::version::Event>& replay_events,
+                                                              const std::vector<pb::version::Event>& buffered_events);
+  // merge replayed events and filtered buffered events, sort by mod_revision and dedup same revision of a key.
+  static std::vector<pb::version::Event> MergeSyncEvents(const std::vector<pb::version::Event>& replay_events,
+                                                         const std::vector<pb::version::Event>& buffered_events);
+
+  void Close();
+
+ private:
+  void SendWithLock(const pb::version::WatchResponse& response, bool& need_close);
+  // write pending messages until stream is full
+  void FlushWithLock(bool& need_close);
+  static void OnWritable(brpc::StreamId id, void* arg, int error_code);
+
+  const brpc::StreamId stream_id_;
+
+  bthread_mutex_t mutex_;
+  bool closed_{false};
+  bool waiting_writable_{false};
+  std::deque<butil::IOBuf> pending_messages_;
+  int64_t next_watch_id_{1};
+  std::map<int64_t, KvWatcherPtr> watchers_;
+};
+
+// Own all watch streams and the watch index of KvControl, only work on leader.
+// Events are dispatched in raft apply thread, so they are in revision order.
+class KvWatchHub {
+ public:
+  explicit KvWatchHub(KvControl* kv_control);
+  ~KvWatchHub();
+
+  KvWatchHub(const KvWatchHub&) = delete;
+  void operator=(const KvWatchHub&) = delete;
+
+  // accept stream attached to watch rpc, request of rpc is handled as the first message of stream.
+  butil::Status AcceptStream(brpc::Controller* cntl, const pb::version::WatchRequest& request);
+
+  void HandleRequest(KvWatchStreamPtr stream, const pb::version::WatchRequest& request);
+  void HandleStreamClosed(KvWatchStreamPtr stream);
+
+  bool HasWatcher() const { return index_.WatcherCount() > 0; }
+
+  // called by raft apply
+  void Notify(const std::string& key, pb::version::Event::EventType event_type, const pb::version::Kv& new_kv,
+              const pb::version::Kv& prev_kv);
+
+  // close all streams when leader stop
+  void CloseAllStreams();
+
+  int64_t StreamCount();
+  int64_t WatcherCount() const { return index_.WatcherCount(); }
+
+ private:
+  void CreateWatch(KvWatchStreamPtr stream, const pb::version::WatchCreateRequest& request);
+  void CancelWatch(KvWatchStreamPtr stream, const pb::version::WatchCancelRequest& request);
+
+  butil::Status Replay(KvWatcherPtr watcher, std::vector<pb::version::Event>& events);
+
+  KvControl* kv_control_;
+
+  KvWatchIndex index_;
+  std::atomic<int64_t> watcher_id_seq_{1};
+
+  bthread_mutex_t streams_mutex_;
+  std::map<brpc::StreamId, KvWatchStreamPtr> streams_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_KV_WATCH_HUB_H_
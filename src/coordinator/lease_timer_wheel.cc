@@ -0,0 +1,209 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/lease_timer_wheel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+
+namespace dingodb {
+
+LeaseTimerWheel::LeaseTimerWheel(uint32_t shard_num, int64_t tick_ms, int64_t now_ms)
+    : tick_ms_(std::max(tick_ms, static_cast<int64_t>(1))) {
+  shard_num = std::max(shard_num, static_cast<uint32_t>(1));
+  shards_.reserve(shard_num);
+  for (uint32_t i = 0; i < shard_num; ++i) {
+    auto shard = std::make_unique<Shard>();
+    bthread_mutex_init(&shard->mutex, nullptr);
+    shard->slots.resize(kLevelNum * kSlotNum);
+    shard->current_tick = now_ms / tick_ms_;
+    shards_.push_back(std::move(shard));
+  }
+}
+
+LeaseTimerWheel::~LeaseTimerWheel() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard->mutex);
+  }
+}
+
+int64_t LeaseTimerWheel::DeadlineTick(int64_t deadline_ms) const { return (deadline_ms + tick_ms_ - 1) / tick_ms_; }
+
+void LeaseTimerWheel::Add(int64_t lease_id, int64_t deadline_ms) {
+  auto& shard = GetShard(lease_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  Entry entry{lease_id, ++shard.next_generation};
+  auto [it, inserted] = shard.leases.insert_or_assign(lease_id, Lease{deadline_ms, entry.generation});
+  if (inserted) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Schedule(shard, entry, deadline_ms);
+}
+
+bool LeaseTimerWheel::Renew(int64_t lease_id, int64_t deadline_ms) {
+  auto& shard = GetShard(lease_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.leases.find(lease_id);
+  if (it == shard.leases.end()) {
+    return false;
+  }
+
+  auto& lease = it->second;
+  // the scheduled entry is later than new deadline, reschedule it.
+  if (deadline_ms < lease.deadline_ms) {
+    lease.generation = ++shard.next_generation;
+    Schedule(shard, Entry{lease_id, lease.generation}, deadline_ms);
+  }
+  lease.deadline_ms = deadline_ms;
+
+  return true;
+}
+
+void LeaseTimerWheel::Remove(int64_t lease_id) {
+  auto& shard = GetShard(lease_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  // entry in wheel is dropped when its slot is due
+  if (shard.leases.erase(lease_id) > 0) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void LeaseTimerWheel::Clear(int64_t now_ms) {
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+
+    size_.fetch_sub(shard->leases.size(), std::memory_order_relaxed);
+    shard->leases.clear();
+    for (auto& slot : shard->slots) {
+      slot.clear();
+      slot.shrink_to_fit();
+    }
+    shard->current_tick = now_ms / tick_ms_;
+  }
+}
+
+std::vector<int64_t> LeaseTimerWheel::Advance(int64_t now_ms) {
+  std::vector<int64_t> expired_lease_ids;
+
+  int64_t now_tick = now_ms / tick_ms_;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+
+    // nothing to do, skip the idle ticks
+    if (shard->leases.empty()) {
+      shard->current_tick = std::max(shard->current_tick, now_tick);
+      continue;
+    }
+
+    while (shard->current_tick < now_tick) {
+      ++shard->current_tick;
+
+      // move entries of higher level to lower level when the lower level turns a round
+      for (uint32_t level = kLevelNum - 1; level > 0; --level) {
+        int64_t mask = (static_cast<int64_t>(1) << (kLevelBits * level)) - 1;
+        if ((shard->current_tick & mask) == 0) {
+          Cascade(*shard, level);
+        }
+      }
+
+      Expire(*shard, expired_lease_ids);
+    }
+  }
+
+  return expired_lease_ids;
+}
+
+void LeaseTimerWheel::Schedule(Shard& shard, const Entry& entry, int64_t deadline_ms) {
+  int64_t expire_tick = DeadlineTick(deadline_ms);
+  int64_t delta = expire_tick - shard.current_tick;
+  if (delta <= 0) {
+    // due, expire at next tick
+    delta = 1;
+    expire_tick = shard.current_tick + 1;
+  }
+
+  // beyond the span, park it at the farthest slot and reschedule then
+  int64_t max_delta = (static_cast<int64_t>(1) << (kLevelBits * kLevelNum)) - 1;
+  if (delta > max_delta) {
+    delta = max_delta;
+    expire_tick = shard.current_tick + delta;
+  }
+
+  uint32_t level = 0;
+  while (delta >= (static_cast<int64_t>(1) << (kLevelBits * (level + 1)))) {
+    ++level;
+  }
+
+  uint32_t slot = (expire_tick >> (kLevelBits * level)) & (kSlotNum - 1);
+  shard.slots[level * kSlotNum + slot].push_back(entry);
+}
+
+void LeaseTimerWheel::Cascade(Shard& shard, uint32_t level) {
+  uint32_t slot = (shard.current_tick >> (kLevelBits * level)) & (kSlotNum - 1);
+  std::vector<Entry> entries;
+  entries.swap(shard.slots[level * kSlotNum + slot]);
+
+  for (const auto& entry : entries) {
+    auto it = shard.leases.find(entry.lease_id);
+    if (it == shard.leases.end() || it->second.generation != entry.generation) {
+      continue;
+    }
+
+    // due at this tick, expire is right after cascade
+    if (DeadlineTick(it->second.deadline_ms) <= shard.current_tick) {
+      shard.slots[shard.current_tick & (kSlotNum - 1)].push_back(entry);
+      continue;
+    }
+
+    Schedule(shard, entry, it->second.deadline_ms);
+  }
+}
+
+void LeaseTimerWheel::Expire(Shard& shard, std::vector<int64_t>& expired_lease_ids) {
+  uint32_t slot = shard.current_tick & (kSlotNum - 1);
+  std::vector<Entry> entries;
+  entries.swap(shard.slots[slot]);
+
+  for (const auto& entry : entries) {
+    auto it = shard.leases.find(entry.lease_id);
+    if (it == shard.leases.end() || it->second.generation != entry.generation) {
+      continue;
+    }
+
+    // renewed, reschedule to the new deadline
+    if (DeadlineTick(it->second.deadline_ms) > shard.current_tick) {
+      Schedule(shard, entry, it->second.deadline_ms);
+      continue;
+    }
+
+    expired_lease_ids.push_back(entry.lease_id);
+    shard.leases.erase(it);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace dingodb
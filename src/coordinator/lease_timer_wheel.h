@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_LEASE_TIMER_WHEEL_H_
+#define DINGODB_COORDINATOR_LEASE_TIMER_WHEEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Hierarchical timer wheel of lease deadline, sharded by lease id.
+// Every shard has 4 levels and 64 slots per level, the span is 2^24 ticks.
+// Renew only update the deadline of lease, the entry in wheel is rescheduled lazily when its slot is due,
+// so renew is O(1) and never touch the wheel. Expire cost is proportional to the due entries.
+// Time is given by caller, so it is easy to test.
+class LeaseTimerWheel {
+ public:
+  LeaseTimerWheel(uint32_t shard_num, int64_t tick_ms, int64_t now_ms);
+  ~LeaseTimerWheel();
+
+  LeaseTimerWheel(const LeaseTimerWheel&) = delete;
+  void operator=(const LeaseTimerWheel&) = delete;
+
+  // add or reset lease
+  void Add(int64_t lease_id, int64_t deadline_ms);
+  // return false if lease not exist
+  bool Renew(int64_t lease_id, int64_t deadline_ms);
+  void Remove(int64_t lease_id);
+  // remove all leases, and restart from now
+  void Clear(int64_t now_ms);
+
+  // advance wheel to now, return the expired lease ids which are removed from wheel.
+  std::vector<int64_t> Advance(int64_t now_ms);
+
+  int64_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint32_t kLevelBits = 6;
+  static constexpr uint32_t kSlotNum = 1 << kLevelBits;
+  static constexpr uint32_t kLevelNum = 4;
+
+  struct Lease {
+    int64_t deadline_ms{0};
+    // entry in wheel with old generation is stale
+    uint64_t generation{0};
+  };
+
+  struct Entry {
+    int64_t lease_id{0};
+    uint64_t generation{0};
+  };
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    std::unordered_map<int64_t, Lease> leases;
+    // level * kSlotNum + slot
+    std::vector<std::vector<Entry>> slots;
+    int64_t current_tick{0};
+    uint64_t next_generation{0};
+  };
+
+  Shard& GetShard(int64_t lease_id) { return *shards_[static_cast<uint64_t>(lease_id) % shards_.size()]; }
+
+  int64_t DeadlineTick(int64_t deadline_ms) const;
+
+  // caller must hold shard mutex
+  void Schedule(Shard& shard, const Entry& entry, int64_t deadline_ms);
+  void Cascade(Shard& shard, uint32_t level);
+  void Expire(Shard& shard, std::vector<int64_t>& expired_lease_ids);
+
+  const int64_t tick_ms_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::atomic<int64_t> size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_LEASE_TIMER_WHEEL_H_
@@ -18,20 +18,165 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "brpc/closure_guard.h"
+#include "brpc/reloadable_flags.h"
+#include "brpc/stream.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "engine/snapshot.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
 #include "proto/meta.pb.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_tso_batch, true, "enable coalesce concurrent gen tso requests into one allocation");
+DEFINE_int32(tso_max_batch_size, 4096, "max gen tso requests in one batch");
+BRPC_VALIDATE_GFLAG(tso_max_batch_size, brpc::PositiveInteger);
+DEFINE_int32(tso_stream_idle_timeout_ms, 60000, "tso stream is closed when idle for a while");
+
+static bvar::LatencyRecorder g_tso_batch_wait_latency("dingo_tso_batch_wait");
+static bvar::LatencyRecorder g_tso_batch_size("dingo_tso_batch_size");
+static bvar::LatencyRecorder g_tso_batch_alloc_latency("dingo_tso_batch_alloc");
+static bvar::Adder<int64_t> g_tso_stream_num("dingo_tso_stream_num");
+
+// Reply gen tso request from stream, write response back to stream.
+class TsoStreamClosure : public google::protobuf::Closure {
+ public:
+  explicit TsoStreamClosure(brpc::StreamId stream_id) : stream_id_(stream_id) {}
+  ~TsoStreamClosure() override = default;
+
+  pb::meta::TsoRequest *Request() { return &request_; }
+  pb::meta::TsoResponse *Response() { return &response_; }
+
+  void Run() override {
+    butil::IOBuf data;
+    butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+    // client match responses by order, a lost response break the order, so close the stream and
+    // let client retry the pending requests on a new stream.
+    if (!response_.SerializeToZeroCopyStream(&wrapper)) {
+      DINGO_LOG(ERROR) << fmt::format("[tso.stream][{}] serialize response fail, close it.", stream_id_);
+      brpc::StreamClose(stream_id_);
+    } else {
+      int ret = brpc::StreamWrite(stream_id_, data);
+      if (ret != 0) {
+        DINGO_LOG(WARNING) << fmt::format("[tso.stream][{}] write response fail, error: {}, close it.", stream_id_,
+                                          ret);
+        brpc::StreamClose(stream_id_);
+      }
+    }
+
+    delete this;
+  }
+
+ private:
+  brpc::StreamId stream_id_;
+  pb::meta::TsoRequest request_;
+  pb::meta::TsoResponse response_;
+};
+
+// Every message on stream is a TsoRequest, handler is deleted when stream is closed.
+// Error replies go through the gen tso queue too, so they never overtake the queued responses.
+class TsoStreamHandler : public brpc::StreamInputHandler {
+ public:
+  explicit TsoStreamHandler(TsoControl *tso_control) : tso_control_(tso_control) {}
+  ~TsoStreamHandler() override = default;
+
+  int on_received_messages(brpc::StreamId id, butil::IOBuf *const messages[], size_t size) override {
+    for (size_t i = 0; i < size; ++i) {
+      auto *done = new TsoStreamClosure(id);
+
+      butil::IOBufAsZeroCopyInputStream wrapper(*messages[i]);
+      if (!done->Request()->ParseFromZeroCopyStream(&wrapper)) {
+        done->Response()->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+        done->Response()->mutable_error()->set_errmsg("parse tso request fail");
+      } else if (done->Request()->op_type() != pb::meta::OP_GEN_TSO) {
+        done->Response()->set_op_type(done->Request()->op_type());
+        done->Response()->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+        done->Response()->mutable_error()->set_errmsg("tso stream only support gen tso");
+      } else if (!tso_control_->IsLeader()) {
+        done->Response()->set_op_type(done->Request()->op_type());
+        tso_control_->RedirectResponse(done->Response());
+      }
+
+      tso_control_->AsyncGenTso(done->Request(), done->Response(), done);
+    }
+
+    return 0;
+  }
+
+  void on_idle_timeout(brpc::StreamId id) override {
+    DINGO_LOG(INFO) << fmt::format("[tso.stream][{}] stream idle timeout, close it.", id);
+    brpc::StreamClose(id);
+  }
+
+  void on_closed(brpc::StreamId id) override {
+    DINGO_LOG(INFO) << fmt::format("[tso.stream][{}] stream closed.", id);
+    g_tso_stream_num << -1;
+    delete this;
+  }
+
+ private:
+  TsoControl *tso_control_;
+};
+
+static int GenTsoRoutine(void *meta, bthread::TaskIterator<GenTsoTask *> &iter) {  // NOLINT
+  TsoControl *tso_control = static_cast<TsoControl *>(meta);
+
+  std::vector<GenTsoTask *> tasks;
+  tasks.reserve(FLAGS_tso_max_batch_size);
+
+  // requests arrived during the allocation are coalesced into the next batch.
+  // only sleep when timestamp is not ready, the kept tasks are retried in front of the next batch.
+  int retry_times = 0;
+  for (;;) {
+    int64_t now_time = Helper::TimestampUs();
+    while (iter && tasks.size() < static_cast<size_t>(FLAGS_tso_max_batch_size)) {
+      GenTsoTask *task = *iter;
+      ++iter;
+      if (BAIDU_UNLIKELY(task == nullptr)) {
+        continue;
+      }
+
+      g_tso_batch_wait_latency << now_time - task->start_time_us;
+      tasks.push_back(task);
+    }
+
+    if (tasks.empty()) {
+      break;
+    }
+
+    g_tso_batch_size << tasks.size();
+
+    if (!tso_control->GenTsoBatch(tasks, retry_times + 1 >= kGenTsoBatchMaxRetryTimes)) {
+      ++retry_times;
+      bthread_usleep(kUpdateTimestampIntervalMs * 1000LL);
+      continue;
+    }
+
+    retry_times = 0;
+    for (auto *task : tasks) {
+      delete task;
+    }
+    tasks.clear();
+  }
+
+  if (BAIDU_UNLIKELY(iter.is_queue_stopped())) {
+    DINGO_LOG(INFO) << "[tso] gen tso execution queue is stop.";
+  }
+
+  return 0;
+}
+
 void TsoClosure::Run() {
   // DINGO_LOG(INFO) << "TsoClosure run";
   if (!status().ok()) {
@@ -134,30 +279,17 @@ int TsoControl::SyncTimestamp(const pb::meta::TsoTimestamp& current_timestamp, i
   return 0;
 }
 
-void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
-  int64_t count = request->count();
-  response->set_op_type(request->op_type());
-  if (count == 0) {
-    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("tso count should be positive");
-    return;
-  }
-  if (!is_healty_) {
-    DINGO_LOG(ERROR) << "TSO has wrong status, retry later";
-    response->mutable_error()->set_errcode(pb::error::Errno::ERETRY_LATER);
-    response->mutable_error()->set_errmsg("timestamp not ok, retry later");
-    return;
-  }
-  pb::meta::TsoTimestamp current;
+butil::Status TsoControl::AllocTso(int64_t count, pb::meta::TsoTimestamp& start_timestamp, bool is_wait) {
+  size_t max_try_times = is_wait ? 50 : 1;
   bool need_retry = false;
-  for (size_t i = 0; i < 50; i++) {
+  for (size_t i = 0; i < max_try_times; i++) {
     {
       BAIDU_SCOPED_LOCK(tso_mutex_);
       int64_t physical = tso_obj_.current_timestamp.physical();
       if (physical != 0) {
         int64_t new_logical = tso_obj_.current_timestamp.logical() + count;
         if (new_logical < kMaxLogical) {
-          current = tso_obj_.current_timestamp;
+          start_timestamp = tso_obj_.current_timestamp;
           tso_obj_.current_timestamp.set_logical(new_logical);
           need_retry = false;
         } else {
@@ -171,22 +303,180 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     }
     if (!need_retry) {
       break;
-    } else {
+    } else if (i + 1 < max_try_times) {
       bthread_usleep(kUpdateTimestampIntervalMs * 1000LL);
     }
   }
   if (need_retry) {
-    response->mutable_error()->set_errcode(pb::error::Errno::EEXEC_FAIL);
-    response->mutable_error()->set_errmsg("gen tso failed");
+    if (!is_wait) {
+      return butil::Status(pb::error::Errno::ERETRY_LATER, "timestamp not ready, retry later");
+    }
     DINGO_LOG(ERROR) << "gen tso failed";
+    return butil::Status(pb::error::Errno::EEXEC_FAIL, "gen tso failed");
+  }
+
+  return butil::Status::OK();
+}
+
+void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
+  int64_t count = request->count();
+  response->set_op_type(request->op_type());
+  if (count <= 0) {
+    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+    response->mutable_error()->set_errmsg("tso count should be positive");
     return;
   }
-  DINGO_LOG(INFO) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
+  if (!is_healty_) {
+    DINGO_LOG(ERROR) << "TSO has wrong status, retry later";
+    response->mutable_error()->set_errcode(pb::error::Errno::ERETRY_LATER);
+    response->mutable_error()->set_errmsg("timestamp not ok, retry later");
+    return;
+  }
+  pb::meta::TsoTimestamp current;
+  auto status = AllocTso(count, current, true);
+  if (!status.ok()) {
+    response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    response->mutable_error()->set_errmsg(status.error_str());
+    return;
+  }
+  DINGO_LOG(DEBUG) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
   auto* timestamp = response->mutable_start_timestamp();
   *timestamp = current;
   response->set_count(count);
 }
 
+void TsoControl::AsyncGenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response,
+                             google::protobuf::Closure* done) {
+  brpc::ClosureGuard done_guard(done);
+
+  // error is already set, e.g. not leader, it is only queued to keep the reply order.
+  bool has_error = response->error().errcode() != pb::error::Errno::OK;
+
+  if (FLAGS_enable_tso_batch && gen_tso_queue_started_) {
+    auto* task = new GenTsoTask();
+    task->request = request;
+    task->response = response;
+    task->done = done;
+    task->start_time_us = Helper::TimestampUs();
+
+    if (BAIDU_LIKELY(bthread::execution_queue_execute(gen_tso_queue_id_, task) == 0)) {
+      done_guard.release();
+      return;
+    }
+
+    delete task;
+    DINGO_LOG(WARNING) << "[tso] gen tso execution queue execute fail, gen tso directly.";
+  }
+
+  if (!has_error) {
+    GenTso(request, response);
+  }
+}
+
+bool TsoControl::GenTsoBatch(std::vector<GenTsoTask*>& tasks, bool is_last_try) {
+  std::vector<GenTsoTask*> valid_tasks;
+  valid_tasks.reserve(tasks.size());
+
+  int64_t total_count = 0;
+  for (auto* task : tasks) {
+    // error is set or already allocated by previous try.
+    if (task->response->error().errcode() != pb::error::Errno::OK || task->response->has_start_timestamp()) {
+      continue;
+    }
+
+    int64_t count = task->request->count();
+    task->response->set_op_type(task->request->op_type());
+    if (count <= 0) {
+      task->response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      task->response->mutable_error()->set_errmsg("tso count should be positive");
+      continue;
+    }
+    if (!is_healty_) {
+      task->response->mutable_error()->set_errcode(pb::error::Errno::ERETRY_LATER);
+      task->response->mutable_error()->set_errmsg("timestamp not ok, retry later");
+      continue;
+    }
+
+    total_count += count;
+    valid_tasks.push_back(task);
+  }
+
+  // timestamp not ready, keep the tasks unreplied for next try unless it is the last try.
+  auto is_not_ready = [is_last_try](const butil::Status& status) {
+    return !is_last_try && status.error_code() == pb::error::Errno::ERETRY_LATER;
+  };
+
+  auto fill_response = [](GenTsoTask* task, const butil::Status& status, int64_t physical, int64_t logical) {
+    if (!status.ok()) {
+      task->response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+      task->response->mutable_error()->set_errmsg(status.error_str());
+      return;
+    }
+
+    auto* timestamp = task->response->mutable_start_timestamp();
+    timestamp->set_physical(physical);
+    timestamp->set_logical(logical);
+    task->response->set_count(task->request->count());
+  };
+
+  if (total_count >= kMaxLogical) {
+    // the batch can not fit in one physical tick, gen one by one.
+    for (auto* task : valid_tasks) {
+      pb::meta::TsoTimestamp start_timestamp;
+      auto status = AllocTso(task->request->count(), start_timestamp, false);
+      if (is_not_ready(status)) {
+        return false;
+      }
+      fill_response(task, status, start_timestamp.physical(), start_timestamp.logical());
+    }
+  } else if (!valid_tasks.empty()) {
+    int64_t start_time = Helper::TimestampUs();
+    pb::meta::TsoTimestamp start_timestamp;
+    auto status = AllocTso(total_count, start_timestamp, false);
+    g_tso_batch_alloc_latency << Helper::TimestampUs() - start_time;
+    if (is_not_ready(status)) {
+      return false;
+    }
+
+    DINGO_LOG(DEBUG) << fmt::format("[tso] gen tso batch size({}) count({}) start({}, {}).", valid_tasks.size(),
+                                    total_count, start_timestamp.physical(), start_timestamp.logical());
+
+    int64_t logical = start_timestamp.logical();
+    for (auto* task : valid_tasks) {
+      fill_response(task, status, start_timestamp.physical(), logical);
+      logical += task->request->count();
+    }
+  }
+
+  // reply in queue order, so responses of a stream are in the order of its requests.
+  for (auto* task : tasks) {
+    task->done->Run();
+  }
+
+  return true;
+}
+
+bool TsoControl::AcceptTsoStream(brpc::Controller* cntl) {
+  auto* handler = new TsoStreamHandler(this);
+
+  brpc::StreamOptions options;
+  options.handler = handler;
+  options.idle_timeout_ms = FLAGS_tso_stream_idle_timeout_ms;
+
+  brpc::StreamId stream_id;
+  if (brpc::StreamAccept(&stream_id, *cntl, &options) != 0) {
+    DINGO_LOG(ERROR) << "[tso.stream] accept stream fail, remote: " << butil::endpoint2str(cntl->remote_side());
+    delete handler;
+    return false;
+  }
+
+  g_tso_stream_num << 1;
+  DINGO_LOG(INFO) << fmt::format("[tso.stream][{}] accept stream, remote: {}.", stream_id,
+                                 butil::endpoint2str(cntl->remote_side()).c_str());
+
+  return true;
+}
+
 // This method is called by the gRPC server.
 // This method is used to process the request from the client.
 // The response is filled by the state machine and sent back to the client.
@@ -223,7 +513,11 @@ void TsoControl::Process(google::protobuf::RpcController* controller, const pb::
   }
   // gen tso out of raft state machine
   if (request->op_type() == pb::meta::OP_GEN_TSO) {
-    GenTso(request, response);
+    // client attach stream to pipeline more gen tso requests.
+    if (cntl->has_remote_stream()) {
+      AcceptTsoStream(cntl);
+    }
+    AsyncGenTso(request, response, done_guard.release());
     return;
   }
   butil::IOBuf data;
@@ -316,6 +610,27 @@ TsoControl::TsoControl() {
   leader_term_.store(-1, butil::memory_order_release);
 }
 
+TsoControl::~TsoControl() {
+  if (gen_tso_queue_started_) {
+    bthread::execution_queue_stop(gen_tso_queue_id_);
+    bthread::execution_queue_join(gen_tso_queue_id_);
+  }
+  bthread_mutex_destroy(&tso_mutex_);
+}
+
+bool TsoControl::InitGenTsoQueue() {
+  bthread::ExecutionQueueOptions options;
+  options.bthread_attr = BTHREAD_ATTR_NORMAL;
+
+  if (bthread::execution_queue_start(&gen_tso_queue_id_, &options, GenTsoRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << "[tso] start gen tso execution queue failed.";
+    return false;
+  }
+
+  gen_tso_queue_started_ = true;
+  return true;
+}
+
 // tso_update_timer_ is a timer to update timestamp
 // tso_update_timer_ is started when OnLeaderStart
 // and is stopped in OnLeaderStop
@@ -326,7 +641,7 @@ bool TsoControl::Init() {
   tso_obj_.current_timestamp.set_logical(0);
   tso_obj_.last_save_physical = 0;
 
-  return true;
+  return InitGenTsoQueue();
 }
 
 bool TsoControl::Recover() {
@@ -21,7 +21,10 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "brpc/controller.h"
+#include "bthread/execution_queue.h"
 #include "common/meta_control.h"
 #include "engine/engine.h"
 #include "proto/coordinator_internal.pb.h"
@@ -35,6 +38,7 @@ constexpr int64_t kSaveIntervalMs = 3000LL;            // 3000ms
 constexpr int64_t kBaseTimestampMs = 1577808000000LL;  // 2020-01-01 00:00:00
 constexpr int kLogicalBits = 18;
 constexpr int64_t kMaxLogical = 1 << kLogicalBits;
+constexpr int kGenTsoBatchMaxRetryTimes = 50;
 
 inline int64_t ClockRealtimeMs() {
   struct timespec tp;
@@ -104,10 +108,18 @@ class TsoSnapshot : public dingodb::Snapshot {
   const int64_t *snapshot_;
 };
 
+// gen tso request waiting in queue, concurrent requests are coalesced into one allocation.
+struct GenTsoTask {
+  const pb::meta::TsoRequest *request{nullptr};
+  pb::meta::TsoResponse *response{nullptr};
+  google::protobuf::Closure *done{nullptr};
+  int64_t start_time_us{0};
+};
+
 class TsoControl : public MetaControl {
  public:
   TsoControl();
-  ~TsoControl() override = default;
+  ~TsoControl() override;
 
   template <typename T>
   void RedirectResponse(T response) {
@@ -167,6 +179,16 @@ class TsoControl : public MetaControl {
                pb::meta::TsoResponse *response, google::protobuf::Closure *done);
 
   void GenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response);
+  // gen tso in queue, done is run after response is filled.
+  void AsyncGenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response,
+                   google::protobuf::Closure *done);
+  // allocate one continuous range for all tasks under one lock, then split it by request count.
+  // tasks with error already set are only replied, all tasks are replied in order.
+  // return false without reply when timestamp is not ready and is_last_try is false, caller retry the tasks later.
+  bool GenTsoBatch(std::vector<GenTsoTask *> &tasks, bool is_last_try = true);
+  // accept the stream attached to TsoService, client can pipeline TsoRequest on it,
+  // and TsoResponse is written back in the same order.
+  bool AcceptTsoStream(brpc::Controller *cntl);
   void ResetTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
   void UpdateTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
 
@@ -175,11 +197,18 @@ class TsoControl : public MetaControl {
   void OnApply(braft::Iterator &iter);
 
  private:
+  bool InitGenTsoQueue();
+  // need not hold tso_mutex_, wait timestamp ready only when is_wait is true.
+  butil::Status AllocTso(int64_t count, pb::meta::TsoTimestamp &start_timestamp, bool is_wait);
+
   TsoTimer tso_update_timer_;
   TsoObj tso_obj_;
   bthread_mutex_t tso_mutex_;  // for tso_obj_
   bool is_healty_ = true;
 
+  bool gen_tso_queue_started_{false};
+  bthread::ExecutionQueueId<GenTsoTask *> gen_tso_queue_id_{0};
+
   // node is leader or not
   butil::atomic<int64_t> leader_term_;
 
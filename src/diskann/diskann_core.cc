@@ -20,11 +20,16 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/logging.h"
@@ -33,12 +38,31 @@
 #include "diskann/diskann_utils.h"
 #include "distance.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "linux_aligned_file_reader.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 
 namespace dingodb {
 
+DEFINE_int64(diskann_search_list_size, 100, "default search list size of diskann search, at least top_n");
+BRPC_VALIDATE_GFLAG(diskann_search_list_size, brpc::PositiveInteger);
+DEFINE_int64(diskann_search_parallel_min_batch, 2, "search queries of batch in parallel when batch size reach it");
+BRPC_VALIDATE_GFLAG(diskann_search_parallel_min_batch, brpc::PositiveInteger);
+DEFINE_int64(diskann_filter_search_expand_multiple, 4, "filtered search fetch top_n * multiple candidates at first");
+BRPC_VALIDATE_GFLAG(diskann_filter_search_expand_multiple, brpc::PositiveInteger);
+DEFINE_int64(diskann_filter_search_max_k, 4096, "filtered search widen candidates up to max k");
+BRPC_VALIDATE_GFLAG(diskann_filter_search_max_k, brpc::PositiveInteger);
+
+DEFINE_int64(diskann_query_trace_sample_interval, 16, "sample one of interval queries into query trace");
+BRPC_VALIDATE_GFLAG(diskann_query_trace_sample_interval, brpc::PositiveInteger);
+DEFINE_int64(diskann_query_trace_capacity, 10000, "max sampled queries in query trace of each diskann");
+BRPC_VALIDATE_GFLAG(diskann_query_trace_capacity, brpc::PositiveInteger);
+DEFINE_int64(diskann_query_trace_max_mb, 8, "max memory of query trace of each diskann");
+BRPC_VALIDATE_GFLAG(diskann_query_trace_max_mb, brpc::PositiveInteger);
+DEFINE_int64(diskann_node_cache_trace_min_count, 100,
+             "select cached nodes from query trace when reach it, otherwise cache nodes around medoid");
+
 DiskANNCore::DiskANNCore(int64_t vector_index_id, const pb::common::VectorIndexParameter& vector_index_parameter,
                          u_int32_t num_threads, float search_dram_budget_gb, float build_dram_budget_gb,
                          const std::string& data_path, const std::string& index_path_prefix)
@@ -59,13 +83,21 @@ DiskANNCore::DiskANNCore(int64_t vector_index_id, const pb::common::VectorIndexP
       metric_(diskann::Metric::L2),
       num_nodes_to_cache_(0),
       warmup_(true),
-      state_(DiskANNCoreState::kUninitialized) {
+      state_(DiskANNCoreState::kUninitialized),
+      load_version_(0),
+      search_count_(0),
+      query_trace_seq_(0),
+      query_trace_pos_(0) {
+  bthread_mutex_init(&node_cache_mutex_, nullptr);
+  bthread_mutex_init(&query_trace_mutex_, nullptr);
   state_ = DiskANNCoreState::kInitialized;
 }
 
 DiskANNCore::~DiskANNCore() {
   DiskANNCoreState state;
   Reset(false, state, true);
+  bthread_mutex_destroy(&node_cache_mutex_);
+  bthread_mutex_destroy(&query_trace_mutex_);
 }
 
 butil::Status DiskANNCore::Build(bool force_to_build, DiskANNCoreState& state) {
@@ -245,7 +277,8 @@ butil::Status DiskANNCore::Load(const pb::common::LoadDiskAnnParam& load_param,
 }
 
 butil::Status DiskANNCore::Search(uint32_t top_n, const pb::common::SearchDiskAnnParam& search_param,
-                                  const std::vector<pb::common::Vector>& vectors, ExistFunction exist_func,
+                                  const std::vector<pb::common::Vector>& vectors,
+                                  const std::unordered_set<uint64_t>* filter_ids, ExistFunction exist_func,
                                   std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state) {
   RWLockReadGuard guard(&rw_lock_);
   auto lambda_set_state_function = [&state, this]() { state = state_.load(); };
@@ -278,35 +311,100 @@ butil::Status DiskANNCore::Search(uint32_t top_n, const pb::common::SearchDiskAn
     memcpy(vector_floats[i].data(), vector_value.data(), dimension_ * sizeof(float));
   }
 
-  uint64_t k_search = top_n;
-  uint64_t l_search = k_search;
+  search_count_.fetch_add(vector_floats.size(), std::memory_order_relaxed);
+  RecordQueryTrace(vector_floats);
 
-  std::vector<uint64_t> res_ids;
-  std::vector<float> res_dists;
+  uint64_t k_search = top_n;
+  // search list size is decoupled from top_n, larger is better recall but slower.
+  uint64_t l_search = search_param.search_list_size() > 0 ? search_param.search_list_size()
+                                                          : FLAGS_diskann_search_list_size;
+  l_search = std::max(l_search, k_search);
 
   const uint64_t beam_width = (0 == search_param.beamwidth()) ? 1 : search_param.beamwidth();
+
+  std::vector<std::vector<uint64_t>> result_labels(vector_floats.size());
+  std::vector<std::vector<float>> result_distances(vector_floats.size());
+  std::vector<butil::Status> statuses(vector_floats.size());
+
+  // flash index is loaded with num_threads_ thread data, so at most num_threads_ queries run concurrently.
+  int parallel_num = static_cast<int>(std::min(static_cast<size_t>(std::max(num_threads_, 1U)), vector_floats.size()));
+  if (static_cast<int64_t>(vector_floats.size()) < FLAGS_diskann_search_parallel_min_batch) {
+    parallel_num = 1;
+  }
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(parallel_num)
+  for (int64_t i = 0; i < static_cast<int64_t>(vector_floats.size()); ++i) {
+    statuses[i] = SearchOne(vector_floats[i].data(), k_search, l_search, beam_width, filter_ids, result_labels[i],
+                            result_distances[i]);
+  }
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  FillSearchResult(top_n, result_distances, result_labels, results);
+
+  return butil::Status::OK();
+}
+
+// search one query, with filter the beam search is widened until top k allowed ids are found.
+// result size is k_search, the vacant is filled with uint64 max.
+butil::Status DiskANNCore::SearchOne(const float* query, uint64_t k_search, uint64_t l_search, uint64_t beam_width,
+                                     const std::unordered_set<uint64_t>* filter_ids, std::vector<uint64_t>& res_ids,
+                                     std::vector<float>& res_dists) {
   const bool use_reorder_data = false;
   diskann::QueryStats query_stats;
 
-  std::vector<std::vector<uint64_t>> result_labels;
-  std::vector<std::vector<float>> result_distances;
+  uint64_t fetch_k = k_search;
+  if (filter_ids != nullptr) {
+    fetch_k = k_search * std::max(FLAGS_diskann_filter_search_expand_multiple, static_cast<int64_t>(1));
+  }
+  uint64_t max_fetch_k = std::max(static_cast<uint64_t>(FLAGS_diskann_filter_search_max_k), k_search);
+  if (count_ > 0) {
+    max_fetch_k = std::min(max_fetch_k, static_cast<uint64_t>(count_));
+  }
+
+  std::vector<uint64_t> fetch_ids;
+  std::vector<float> fetch_dists;
+  for (;;) {
+    fetch_k = std::max(std::min(fetch_k, max_fetch_k), k_search);
+    fetch_ids.assign(fetch_k, std::numeric_limits<uint64_t>::max());
+    fetch_dists.assign(fetch_k, std::numeric_limits<float>::max());
 
-  for (const auto& vector_float : vector_floats) {
-    res_ids.resize(k_search, std::numeric_limits<uint64_t>::max());
-    res_dists.resize(k_search, std::numeric_limits<float>::max());
     try {
-      flash_index_->cached_beam_search(vector_float.data(), k_search, l_search, res_ids.data(), res_dists.data(),
-                                       beam_width, use_reorder_data, &query_stats);
+      flash_index_->cached_beam_search(query, fetch_k, std::max(l_search, fetch_k), fetch_ids.data(),
+                                       fetch_dists.data(), beam_width, use_reorder_data, &query_stats);
     } catch (const std::exception& e) {
       std::string s = fmt::format("cached_beam_search exception : {} {}", e.what(), FormatParameter());
-      DINGO_LOG(ERROR) << s;
       return butil::Status(pb::error::Errno::EINTERNAL, s);
     }
-    result_labels.emplace_back(res_ids);
-    result_distances.emplace_back(res_dists);
+
+    if (filter_ids == nullptr) {
+      res_ids.swap(fetch_ids);
+      res_dists.swap(fetch_dists);
+      return butil::Status::OK();
+    }
+
+    res_ids.clear();
+    res_dists.clear();
+    for (uint64_t i = 0; i < fetch_k && res_ids.size() < k_search; ++i) {
+      if (filter_ids->count(fetch_ids[i]) > 0) {
+        res_ids.push_back(fetch_ids[i]);
+        res_dists.push_back(fetch_dists[i]);
+      }
+    }
+
+    if (res_ids.size() >= k_search || fetch_k >= max_fetch_k) {
+      break;
+    }
+    fetch_k *= 2;
   }
 
-  FillSearchResult(top_n, result_distances, result_labels, results);
+  res_ids.resize(k_search, std::numeric_limits<uint64_t>::max());
+  res_dists.resize(k_search, std::numeric_limits<float>::max());
 
   return butil::Status::OK();
 }
@@ -679,38 +777,17 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
     reader = std::make_shared<LinuxAlignedFileReader>();
     flash_index = std::make_unique<diskann::PQFlashIndex<float>>(reader, metric);
 
-    try {
-      index_path_prefix = index_path_prefix_;
-      if (!index_path_prefix.empty()) {
-        if (index_path_prefix.back() != '/') {
-          index_path_prefix += "/";
-        }
-      }
-
-      // diskann/src/linux_aligned_file_reader.cpp #define MAX_EVENTS 1024
-      std::atomic<int64_t> this_aio_wait_count = ++aio_wait_count;
-      butil::Status status = DiskANNUtils::CheckAioRelatedInformation(num_threads_, 1024, this_aio_wait_count);
-      if (!status.ok()) {
-        aio_wait_count--;
-        DINGO_LOG(ERROR) << status.error_cstr();
-        return status;
-      }
-
-      int res = flash_index->load(num_threads_, index_path_prefix.c_str());
-      if (res != 0) {
-        aio_wait_count--;
-        std::string s = fmt::format("load diskann failed ret : {} {}", res, FormatParameter());
-        DINGO_LOG(ERROR) << s;
-        return butil::Status(pb::error::Errno::EINTERNAL, s);
+    index_path_prefix = index_path_prefix_;
+    if (!index_path_prefix.empty()) {
+      if (index_path_prefix.back() != '/') {
+        index_path_prefix += "/";
       }
-    } catch (const std::exception& e) {
-      aio_wait_count--;
-      std::string s = fmt::format("load diskann exception : {} {}", e.what(), FormatParameter());
-      DINGO_LOG(ERROR) << s;
-      return butil::Status(pb::error::Errno::EINTERNAL, s);
     }
 
-    aio_wait_count--;
+    butil::Status status = DoLoadFlashIndex(flash_index.get(), index_path_prefix);
+    if (!status.ok()) {
+      return status;
+    }
 
     if (count != flash_index->get_num_points()) {
       std::string s = fmt::format("count not match : file :{} load :{}", count, flash_index->get_num_points());
@@ -734,8 +811,7 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
     warmup = load_param.warmup();
 
     std::vector<uint32_t> node_list;
-    DINGO_LOG(INFO) << "Caching " << num_nodes_to_cache << " nodes around medoid(s)" << std::endl;
-    flash_index->cache_bfs_levels(num_nodes_to_cache, node_list);
+    GenerateCacheList(flash_index.get(), index_path_prefix, num_nodes_to_cache, node_list);
 
     flash_index->load_cache_list(node_list);
     node_list.clear();
@@ -807,12 +883,200 @@ butil::Status DiskANNCore::DoLoad(const pb::common::LoadDiskAnnParam& load_param
   state = this->state_.load();
   index_path_prefix_ = index_path_prefix;
   is_load_ = true;
+  ++load_version_;
 
   DINGO_LOG(INFO) << "load success :  " << FormatParameter();
 
   return butil::Status::OK();
 }
 
+butil::Status DiskANNCore::DoLoadFlashIndex(diskann::PQFlashIndex<float>* flash_index,
+                                            const std::string& index_path_prefix) {
+  // diskann/src/linux_aligned_file_reader.cpp #define MAX_EVENTS 1024
+  std::atomic<int64_t> this_aio_wait_count = ++aio_wait_count;
+  ON_SCOPE_EXIT([]() { aio_wait_count--; });
+  butil::Status status = DiskANNUtils::CheckAioRelatedInformation(num_threads_, 1024, this_aio_wait_count);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  try {
+    int res = flash_index->load(num_threads_, index_path_prefix.c_str());
+    if (res != 0) {
+      std::string s = fmt::format("load diskann failed ret : {} {}", res, FormatParameter());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+  } catch (const std::exception& e) {
+    std::string s = fmt::format("load diskann exception : {} {}", e.what(), FormatParameter());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  return butil::Status::OK();
+}
+
+// nodes visited by the recent queries are hot, cache them first.
+// without enough query trace, cache nodes around medoid(s).
+void DiskANNCore::GenerateCacheList(diskann::PQFlashIndex<float>* flash_index, const std::string& index_path_prefix,
+                                    uint32_t num_nodes_to_cache, std::vector<uint32_t>& node_list) {
+  if (0 == num_nodes_to_cache) {
+    return;
+  }
+
+  std::vector<std::vector<float>> query_trace;
+  {
+    BAIDU_SCOPED_LOCK(query_trace_mutex_);
+    query_trace = query_trace_;
+  }
+
+  if (!query_trace.empty() && static_cast<int64_t>(query_trace.size()) >= FLAGS_diskann_node_cache_trace_min_count) {
+    // load and node cache update may generate cache list at the same time, use a unique trace file.
+    std::string trace_file =
+        fmt::format("{}_query_trace_{}.bin", index_path_prefix, query_trace_file_seq.fetch_add(1));
+    try {
+      std::ofstream writer;
+      diskann::open_file_to_write(writer, trace_file);
+      uint32_t npts = query_trace.size();
+      uint32_t dim = query_trace.front().size();
+      writer.write(reinterpret_cast<char*>(&npts), sizeof(uint32_t));
+      writer.write(reinterpret_cast<char*>(&dim), sizeof(uint32_t));
+      for (const auto& query : query_trace) {
+        writer.write(reinterpret_cast<const char*>(query.data()), dim * sizeof(float));
+      }
+      writer.close();
+
+      DINGO_LOG(INFO) << fmt::format("Caching {} nodes from {} sampled queries", num_nodes_to_cache, npts);
+      flash_index->generate_cache_list_from_sample_queries(trace_file, 15, 6, num_nodes_to_cache, num_threads_,
+                                                           node_list);
+      DiskANNUtils::RemoveFile(trace_file);
+      return;
+    } catch (const std::exception& e) {
+      DiskANNUtils::RemoveFile(trace_file);
+      node_list.clear();
+      DINGO_LOG(WARNING) << fmt::format("generate cache list from query trace exception : {} {}", e.what(),
+                                        FormatParameter());
+    }
+  }
+
+  DINGO_LOG(INFO) << "Caching " << num_nodes_to_cache << " nodes around medoid(s)";
+  flash_index->cache_bfs_levels(num_nodes_to_cache, node_list);
+}
+
+void DiskANNCore::RecordQueryTrace(const std::vector<std::vector<float>>& queries) {
+  // query trace is only used by node cache rebalance.
+  if (node_cache_budget_mb.load(std::memory_order_relaxed) <= 0) {
+    return;
+  }
+
+  for (const auto& query : queries) {
+    uint64_t seq = query_trace_seq_.fetch_add(1, std::memory_order_relaxed);
+    if (seq % FLAGS_diskann_query_trace_sample_interval != 0) {
+      continue;
+    }
+
+    // capacity is limited by both count and bytes
+    int64_t query_bytes = std::max(query.size() * sizeof(float), sizeof(float));
+    size_t capacity = std::max(
+        std::min(FLAGS_diskann_query_trace_capacity, FLAGS_diskann_query_trace_max_mb * 1024 * 1024 / query_bytes),
+        static_cast<int64_t>(1));
+
+    BAIDU_SCOPED_LOCK(query_trace_mutex_);
+    if (query_trace_.size() > capacity) {
+      query_trace_.resize(capacity);
+      query_trace_.shrink_to_fit();
+    }
+    if (query_trace_.size() < capacity) {
+      query_trace_.push_back(query);
+    } else {
+      query_trace_[query_trace_pos_ % query_trace_.size()] = query;
+    }
+    query_trace_pos_ = (query_trace_pos_ + 1) % capacity;
+  }
+}
+
+int64_t DiskANNCore::QueryTraceBytes() {
+  BAIDU_SCOPED_LOCK(query_trace_mutex_);
+  int64_t bytes = 0;
+  for (const auto& query : query_trace_) {
+    bytes += query.capacity() * sizeof(float);
+  }
+  return bytes;
+}
+
+butil::Status DiskANNCore::UpdateNodeCache(uint32_t num_nodes_to_cache) {
+  BAIDU_SCOPED_LOCK(node_cache_mutex_);
+
+  std::string index_path_prefix;
+  uint64_t load_version = 0;
+  diskann::Metric metric;
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    if (!is_load_) {
+      std::string s = fmt::format("diskann not load, skip update node cache. {}", FormatParameter());
+      DINGO_LOG(WARNING) << s;
+      return butil::Status(pb::error::Errno::EDISKANN_NOT_LOAD, s);
+    }
+
+    index_path_prefix = index_path_prefix_;
+    load_version = load_version_;
+    metric = metric_;
+    num_nodes_to_cache = std::min(num_nodes_to_cache, count_);
+    if (num_nodes_to_cache == num_nodes_to_cache_) {
+      return butil::Status::OK();
+    }
+  }
+
+  // prepare a new flash index with the new cache, searching still use the old one.
+  std::shared_ptr<AlignedFileReader> reader = std::make_shared<LinuxAlignedFileReader>();
+  auto flash_index = std::make_unique<diskann::PQFlashIndex<float>>(reader, metric);
+  butil::Status status = DoLoadFlashIndex(flash_index.get(), index_path_prefix);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::vector<uint32_t> node_list;
+  GenerateCacheList(flash_index.get(), index_path_prefix, num_nodes_to_cache, node_list);
+  flash_index->load_cache_list(node_list);
+
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    if (!is_load_ || load_version != load_version_) {
+      std::string s = fmt::format("diskann reloaded, drop node cache update. {}", FormatParameter());
+      DINGO_LOG(WARNING) << s;
+      return butil::Status(pb::error::Errno::EDISKANN_NOT_LOAD, s);
+    }
+
+    // old one is released out of lock
+    std::swap(reader_, reader);
+    std::swap(flash_index_, flash_index);
+    num_nodes_to_cache_ = num_nodes_to_cache;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("update node cache success, num_nodes_to_cache : {} {}", num_nodes_to_cache,
+                                 FormatParameter());
+
+  return butil::Status::OK();
+}
+
+uint32_t DiskANNCore::NumNodesToCache() {
+  RWLockReadGuard guard(&rw_lock_);
+  return is_load_ ? num_nodes_to_cache_ : 0;
+}
+
+int64_t DiskANNCore::NodeCacheBytesPerNode() {
+  RWLockReadGuard guard(&rw_lock_);
+  if (!is_load_ || flash_index_ == nullptr) {
+    return 0;
+  }
+
+  // coords aligned to 8 floats and neighbors with count
+  int64_t data_dim = flash_index_->get_data_dim();
+  int64_t max_degree = vector_index_parameter_.diskann_parameter().max_degree();
+  return ROUND_UP(data_dim, 8) * sizeof(float) + (max_degree + 1) * sizeof(uint32_t);
+}
+
 butil::Status DiskANNCore::DoPrepareTryLoad(const pb::common::CreateDiskAnnParam& diskann_parameter,
                                             diskann::Metric& metric, const pb::common::MetricType& metric_type,
                                             size_t& count, size_t& dim, bool& build_with_mem_index) {
@@ -18,9 +18,14 @@
 #include <sys/types.h>
 #include <xmmintrin.h>
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
+#include "bthread/types.h"
 #include "butil/status.h"
 #include "common/synchronization.h"
 #include "diskann/diskann_utils.h"
@@ -48,9 +53,11 @@ class DiskANNCore {
   butil::Status Build(bool force_to_build, DiskANNCoreState& state);
   butil::Status UpdateIndexPathPrefix(const std::string& index_path_prefix, DiskANNCoreState& state);
   butil::Status Load(const pb::common::LoadDiskAnnParam& load_param, DiskANNCoreState& state);
+  // filter_ids is the allowed diskann internal ids, nullptr means no filter.
   butil::Status Search(uint32_t top_n, const pb::common::SearchDiskAnnParam& search_param,
-                       const std::vector<pb::common::Vector>& vectors, ExistFunction exist_func,
-                       std::vector<pb::index::VectorWithDistanceResult>& results, DiskANNCoreState& state);
+                       const std::vector<pb::common::Vector>& vectors, const std::unordered_set<uint64_t>* filter_ids,
+                       ExistFunction exist_func, std::vector<pb::index::VectorWithDistanceResult>& results,
+                       DiskANNCoreState& state);
   butil::Status Reset(bool is_delete_files, DiskANNCoreState& state, bool is_force = false);
   butil::Status Init(int64_t vector_index_id, const pb::common::VectorIndexParameter& vector_index_parameter,
                      u_int32_t num_threads, float search_dram_budget_gb, float build_dram_budget_gb,
@@ -63,6 +70,21 @@ class DiskANNCore {
   std::string Dump();
   butil::Status Count(int64_t& count, DiskANNCoreState& state);
 
+  // node cache budget is managed by DiskANNItemManager, the cached nodes are selected from the recent query trace
+  // and swapped in after ready, searching is not blocked and no need to reload.
+  butil::Status UpdateNodeCache(uint32_t num_nodes_to_cache);
+  uint32_t NumNodesToCache();
+  // dram bytes of one cached node, 0 if not loaded.
+  int64_t NodeCacheBytesPerNode();
+  int64_t Count() const { return count_; }
+  // query count since last fetch
+  int64_t FetchSearchCount() { return search_count_.exchange(0, std::memory_order_relaxed); }
+  // dram bytes of the sampled query trace, it is counted in node cache budget.
+  int64_t QueryTraceBytes();
+
+  // query trace is only recorded when node cache budget is set.
+  static void SetNodeCacheBudgetMb(int64_t budget_mb) { DiskANNCore::node_cache_budget_mb = budget_mb; }
+
  protected:
  private:
   butil::Status DoBuild(DiskANNCoreState& state, DiskANNCoreState old_state);
@@ -71,6 +93,13 @@ class DiskANNCore {
   butil::Status DoPrepareTryLoad(const pb::common::CreateDiskAnnParam& diskann_parameter, diskann::Metric& metric,
                                  const pb::common::MetricType& metric_type, size_t& count, size_t& dim,
                                  bool& build_with_mem_index);
+  butil::Status DoLoadFlashIndex(diskann::PQFlashIndex<float>* flash_index, const std::string& index_path_prefix);
+  void GenerateCacheList(diskann::PQFlashIndex<float>* flash_index, const std::string& index_path_prefix,
+                         uint32_t num_nodes_to_cache, std::vector<uint32_t>& node_list);
+  void RecordQueryTrace(const std::vector<std::vector<float>>& queries);
+  butil::Status SearchOne(const float* query, uint64_t k_search, uint64_t l_search, uint64_t beam_width,
+                          const std::unordered_set<uint64_t>* filter_ids, std::vector<uint64_t>& res_ids,
+                          std::vector<float>& res_dists);
   butil::Status FillSearchResult(uint32_t topk, const std::vector<std::vector<float>>& distances,
                                  const std::vector<std::vector<uint64_t>>& labels,
                                  std::vector<pb::index::VectorWithDistanceResult>& results);
@@ -97,7 +126,19 @@ class DiskANNCore {
   bool warmup_;
   std::atomic<DiskANNCoreState> state_;
   RWLock rw_lock_;
+
+  // increase when loaded, node cache update is dropped if reloaded meanwhile.
+  uint64_t load_version_;
+  bthread_mutex_t node_cache_mutex_;
+  std::atomic<int64_t> search_count_;
+  std::atomic<uint64_t> query_trace_seq_;
+  // ring buffer of sampled queries
+  bthread_mutex_t query_trace_mutex_;
+  std::vector<std::vector<float>> query_trace_;
+  size_t query_trace_pos_;
   static inline std::atomic<int64_t> aio_wait_count = 0;
+  static inline std::atomic<int64_t> node_cache_budget_mb = 0;
+  static inline std::atomic<uint64_t> query_trace_file_seq = 0;
 };
 
 }  // namespace dingodb
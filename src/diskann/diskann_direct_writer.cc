@@ -0,0 +1,238 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "diskann/diskann_direct_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "bvar/bvar.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(diskann_import_direct_io, true, "diskann import write data file with O_DIRECT");
+DEFINE_int32(diskann_import_buffer_size_kb, 8 * 1024, "diskann import aligned write buffer size");
+DEFINE_int32(diskann_import_preallocate_size_mb, 256, "diskann import preallocate file space in chunk");
+
+bvar::Adder<int64_t> g_diskann_import_write_bytes("dingo_diskann_import_write_bytes");
+bvar::LatencyRecorder g_diskann_import_flush_latency("dingo_diskann_import_flush_latency");
+
+static constexpr size_t kDirectIoAlignment = 4096;
+
+static size_t AlignUp(size_t size) { return (size + kDirectIoAlignment - 1) / kDirectIoAlignment * kDirectIoAlignment; }
+
+DiskANNDirectWriter::~DiskANNDirectWriter() { Close(); }
+
+butil::Status DiskANNDirectWriter::Open(const std::string& path, size_t header_size) {
+  Close();
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  if (FLAGS_diskann_import_direct_io) {
+    fd_ = open(path.c_str(), flags | O_DIRECT, 0644);
+    is_direct_ = fd_ >= 0;
+    if (fd_ < 0 && errno == EINVAL) {
+      DINGO_LOG(WARNING) << fmt::format("[diskann.writer] not support O_DIRECT, fallback to buffered write, path: {}",
+                                        path);
+    }
+  }
+  if (fd_ < 0) {
+    fd_ = open(path.c_str(), flags, 0644);
+    is_direct_ = false;
+  }
+  if (fd_ < 0) {
+    std::string s = fmt::format("open file failed, path: {} error: {}", path, strerror(errno));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  buffer_size_ = AlignUp(std::max(FLAGS_diskann_import_buffer_size_kb, 4) * 1024L);
+  void* buffer = nullptr;
+  if (posix_memalign(&buffer, kDirectIoAlignment, buffer_size_) != 0) {
+    Close();
+    std::string s = fmt::format("alloc aligned buffer failed, size: {}", buffer_size_);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  buffer_ = static_cast<char*>(buffer);
+  buffer_used_ = 0;
+  flushed_offset_ = 0;
+  preallocated_offset_ = 0;
+  path_ = path;
+
+  // reserve header
+  std::string header(header_size, '\0');
+  return Append(header.data(), header.size());
+}
+
+butil::Status DiskANNDirectWriter::Append(const void* data, size_t size) {
+  if (!IsOpen()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "writer not open");
+  }
+
+  const char* src = static_cast<const char*>(data);
+  while (size > 0) {
+    size_t copy_size = std::min(size, buffer_size_ - buffer_used_);
+    memcpy(buffer_ + buffer_used_, src, copy_size);
+    buffer_used_ += copy_size;
+    src += copy_size;
+    size -= copy_size;
+
+    if (buffer_used_ == buffer_size_) {
+      auto status = FlushBuffer(buffer_size_);
+      if (!status.ok()) {
+        return status;
+      }
+      flushed_offset_ += buffer_size_;
+      buffer_used_ = 0;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DiskANNDirectWriter::Finish(const void* header, size_t header_size) {
+  if (!IsOpen()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "writer not open");
+  }
+
+  int64_t file_size = Size();
+  if (static_cast<int64_t>(header_size) > file_size) {
+    std::string s = fmt::format("header size: {} more than file size: {}", header_size, file_size);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  // O_DIRECT write must be aligned, pad the tail and truncate it after.
+  if (buffer_used_ > 0) {
+    size_t padded_size = AlignUp(buffer_used_);
+    memset(buffer_ + buffer_used_, 0, padded_size - buffer_used_);
+    auto status = FlushBuffer(padded_size);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  if (ftruncate(fd_, file_size) != 0 || fdatasync(fd_) != 0) {
+    std::string s = fmt::format("truncate and sync file failed, path: {} error: {}", path_, strerror(errno));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  close(fd_);
+  fd_ = -1;
+
+  // header is small and unaligned, write it in buffered mode, only one page is touched.
+  int fd = open(path_.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    std::string s = fmt::format("open file failed, path: {} error: {}", path_, strerror(errno));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  ON_SCOPE_EXIT([fd]() { close(fd); });
+
+  if (pwrite(fd, header, header_size, 0) != static_cast<ssize_t>(header_size) || fdatasync(fd) != 0) {
+    std::string s = fmt::format("write header failed, path: {} error: {}", path_, strerror(errno));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+  Close();
+
+  return butil::Status::OK();
+}
+
+void DiskANNDirectWriter::Close() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  if (buffer_ != nullptr) {
+    free(buffer_);
+    buffer_ = nullptr;
+  }
+  buffer_size_ = 0;
+  buffer_used_ = 0;
+}
+
+butil::Status DiskANNDirectWriter::FlushBuffer(size_t size) {
+  BvarLatencyGuard bvar_guard(&g_diskann_import_flush_latency);
+
+  auto status = Preallocate(flushed_offset_ + size);
+  if (!status.ok()) {
+    return status;
+  }
+
+  size_t written = 0;
+  while (written < size) {
+    ssize_t ret = pwrite(fd_, buffer_ + written, size - written, flushed_offset_ + written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::string s = fmt::format("write file failed, path: {} offset: {} size: {} error: {}", path_,
+                                  flushed_offset_ + written, size - written, strerror(errno));
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+    written += ret;
+  }
+  g_diskann_import_write_bytes << size;
+
+  // buffered write, write back and drop the pages, not to pollute page cache.
+  if (!is_direct_) {
+    sync_file_range(fd_, flushed_offset_, size,
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(fd_, flushed_offset_, size, POSIX_FADV_DONTNEED);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DiskANNDirectWriter::Preallocate(int64_t end_offset) {
+  if (end_offset <= preallocated_offset_) {
+    return butil::Status::OK();
+  }
+
+  int64_t chunk_size = std::max(FLAGS_diskann_import_preallocate_size_mb, 1) * 1024L * 1024L;
+  int64_t new_offset = (end_offset + chunk_size - 1) / chunk_size * chunk_size;
+  if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, preallocated_offset_, new_offset - preallocated_offset_) != 0) {
+    if (errno == EOPNOTSUPP || errno == ENOSYS) {
+      // not support, never try again
+      preallocated_offset_ = std::numeric_limits<int64_t>::max();
+      return butil::Status::OK();
+    }
+    std::string s = fmt::format("preallocate file failed, path: {} offset: {} size: {} error: {}", path_,
+                                preallocated_offset_, new_offset - preallocated_offset_, strerror(errno));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+  preallocated_offset_ = new_offset;
+
+  return butil::Status::OK();
+}
+
+}  // namespace dingodb
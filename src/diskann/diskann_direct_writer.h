@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DISKANN_DISKANN_DIRECT_WRITER_H_  // NOLINT
+#define DINGODB_DISKANN_DISKANN_DIRECT_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Append only writer of diskann import file.
+// Data is staged in a large aligned buffer and written with O_DIRECT, so the imported vectors never go through
+// page cache and not evict the hot index pages of searching. If the file system not support O_DIRECT,
+// fallback to buffered write and drop the written pages from page cache.
+// The file space is preallocated in large chunks, the header is reserved at the beginning and written by Finish.
+class DiskANNDirectWriter {
+ public:
+  DiskANNDirectWriter() = default;
+  ~DiskANNDirectWriter();
+
+  DiskANNDirectWriter(const DiskANNDirectWriter& rhs) = delete;
+  DiskANNDirectWriter& operator=(const DiskANNDirectWriter& rhs) = delete;
+  DiskANNDirectWriter(DiskANNDirectWriter&& rhs) = delete;
+  DiskANNDirectWriter& operator=(DiskANNDirectWriter&& rhs) = delete;
+
+  // create or truncate file, and reserve header_size bytes at the beginning.
+  butil::Status Open(const std::string& path, size_t header_size);
+  butil::Status Append(const void* data, size_t size);
+  // flush data, truncate file to real size, then write header and sync.
+  butil::Status Finish(const void* header, size_t header_size);
+  // close without finish, the file is left as it is.
+  void Close();
+
+  bool IsOpen() const { return fd_ >= 0; }
+  bool IsDirect() const { return is_direct_; }
+  // bytes appended include header.
+  int64_t Size() const { return flushed_offset_ + static_cast<int64_t>(buffer_used_); }
+
+ private:
+  butil::Status FlushBuffer(size_t size);
+  butil::Status Preallocate(int64_t end_offset);
+
+  int fd_{-1};
+  bool is_direct_{false};
+  std::string path_;
+
+  char* buffer_{nullptr};
+  size_t buffer_size_{0};
+  size_t buffer_used_{0};
+
+  // file offset of buffer start, always aligned
+  int64_t flushed_offset_{0};
+  int64_t preallocated_offset_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DISKANN_DISKANN_DIRECT_WRITER_H_  // NOLINT
@@ -19,8 +19,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -82,10 +84,10 @@ DiskANNItem::DiskANNItem(std::shared_ptr<Context> ctx, int64_t vector_index_id,
 }
 
 DiskANNItem::~DiskANNItem() {
-  if (writer_.is_open()) writer_.close();
+  if (writer_.IsOpen()) writer_.Close();
   if (diskann_core_) diskann_core_.reset();
 #if defined(ENABLE_DISKANN_ID_MAPPING)
-  if (id_writer_.is_open()) id_writer_.close();
+  if (id_writer_.IsOpen()) id_writer_.Close();
 #endif
 }
 
@@ -149,7 +151,7 @@ butil::Status DiskANNItem::Import(std::shared_ptr<Context> ctx, const std::vecto
     return status;
   }
 
-  if (writer_.is_open()) {
+  if (writer_.IsOpen()) {
     if (ts != ts_) {
       std::string s = fmt::format("diskann import ts is : {}  not equal to last ts : {}", ts, ts_);
       DINGO_LOG(ERROR) << s;
@@ -371,6 +373,7 @@ butil::Status DiskANNItem::Load(std::shared_ptr<Context> ctx, const pb::common::
 butil::Status DiskANNItem::Search(std::shared_ptr<Context> ctx, uint32_t top_n,
                                   const pb::common::SearchDiskAnnParam& search_param,
                                   const std::vector<pb::common::Vector>& vectors,
+                                  const std::vector<int64_t>& filter_vector_ids,
                                   std::vector<pb::index::VectorWithDistanceResult>& results, int64_t& ts) {
   butil::Status status;
   RWLockReadGuard guard(&rw_lock_);
@@ -430,9 +433,29 @@ butil::Status DiskANNItem::Search(std::shared_ptr<Context> ctx, uint32_t top_n,
 
   DiskANNCoreState state;
 
+  // vector ids to diskann internal ids, unknown ids are ignored.
+  std::unordered_set<uint64_t> filter_ids;
+  for (auto vector_id : filter_vector_ids) {
+#if defined(ENABLE_DISKANN_ID_MAPPING)
+    auto iter = vector_to_diskann_ids_.find(vector_id);
+    if (iter != vector_to_diskann_ids_.end()) {
+      filter_ids.insert(iter->second);
+    }
+#else
+    filter_ids.insert(static_cast<uint64_t>(vector_id));
+#endif
+  }
+
+  if (!filter_vector_ids.empty() && filter_ids.empty()) {
+    results.resize(vectors.size());
+    ts = ts_;
+    return butil::Status::OK();
+  }
+  const std::unordered_set<uint64_t>* filter_ids_ptr = filter_vector_ids.empty() ? nullptr : &filter_ids;
+
 #if defined(ENABLE_DISKANN_ID_MAPPING)
   BvarLatencyGuard bvar_guard(&g_diskann_server_search_latency);
-  status = diskann_core_->Search(top_n, search_param, vectors, IsBuildedFilesExist, results, state);
+  status = diskann_core_->Search(top_n, search_param, vectors, filter_ids_ptr, IsBuildedFilesExist, results, state);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -450,7 +473,7 @@ butil::Status DiskANNItem::Search(std::shared_ptr<Context> ctx, uint32_t top_n,
 #else
   ts = ts_;
   BvarLatencyGuard bvar_guard(&g_diskann_server_search_latency);
-  status = diskann_core_->Search(top_n, search_param, vectors, IsBuildedFilesExist, results, state);
+  status = diskann_core_->Search(top_n, search_param, vectors, filter_ids_ptr, IsBuildedFilesExist, results, state);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -459,6 +482,15 @@ butil::Status DiskANNItem::Search(std::shared_ptr<Context> ctx, uint32_t top_n,
 #endif
 }
 
+std::shared_ptr<DiskANNCore> DiskANNItem::GetLoadedCore() {
+  RWLockReadGuard guard(&rw_lock_);
+  if (DiskANNCoreState::kLoaded != state_.load()) {
+    return nullptr;
+  }
+
+  return diskann_core_;
+}
+
 butil::Status DiskANNItem::TryLoad(std::shared_ptr<Context> ctx, const pb::common::LoadDiskAnnParam& load_param,
                                    bool is_sync) {
   DiskANNCoreState old_state;
@@ -782,7 +814,7 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     return butil::Status(pb::error::Errno::EDISKANN_FILE_TRANSFER_QUANTITY_MISMATCH, s);
   }
 
-  if (!writer_.is_open()) {
+  if (!writer_.IsOpen()) {
     last_import_time_ms_ = Helper::TimestampMs();
   }
 
@@ -797,7 +829,7 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
 
   last_import_time_ms_ = current_time_ms;
 
-  if (!writer_.is_open()) {
+  if (!writer_.IsOpen()) {
     state_.store(DiskANNCoreState::kImporting);
     old_state = state_;
     std::string data_path = fmt::format("{}/{}/{}/{}", base_dir, tmp_name, vector_index_id_, input_name);
@@ -805,43 +837,46 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name);
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name + "/" + std::to_string(vector_index_id_));
     DiskANNUtils::RemoveFile(data_path);
-    diskann::open_file_to_write(writer_, data_path);
+    // header(count, dim) is written when import finished.
+    auto status = writer_.Open(data_path, sizeof(uint32_t) * 2);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     data_path_ = data_path;
-    uint32_t count = 0;
-    uint32_t dim = dimension;
-    writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    writer_.write(reinterpret_cast<char*>(&dim), sizeof(uint32_t));
   }
 
 #if defined(ENABLE_DISKANN_ID_MAPPING)
-  if (!id_writer_.is_open()) {
+  if (!id_writer_.IsOpen()) {
     std::string id_path = fmt::format("{}/{}/{}/{}", base_dir, tmp_name, vector_index_id_, id_name);
     DiskANNUtils::CreateDir(base_dir);
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name);
     DiskANNUtils::CreateDir(base_dir + "/" + tmp_name + "/" + std::to_string(vector_index_id_));
     DiskANNUtils::RemoveFile(id_path);
-    diskann::open_file_to_write(id_writer_, id_path);
+    // header(count, dim, ts) is written when import finished.
+    auto status = id_writer_.Open(id_path, sizeof(uint32_t) * 2 + sizeof(int64_t));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     id_path_ = id_path;
-    uint32_t count = 0;
-    uint32_t dim = dimension;
-    id_writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    id_writer_.write(reinterpret_cast<char*>(&dim), sizeof(uint32_t));
-    id_writer_.write(reinterpret_cast<char*>(&ts), sizeof(int64_t));
     ts_ = ts;
     tso_ = tso;
   }
 #endif
 
   for (const auto& vector : vectors) {
-    const auto& vector_value = vector.float_values();
-    uint32_t total = dimension * sizeof(float);
-    uint32_t remain = total;
-    uint32_t already = 0;
-    while (remain > 0) {
-      uint32_t write_size = std::min(remain, (uint32_t)4 * 1024);
-      writer_.write(reinterpret_cast<const char*>(vector_value.data()) + already, write_size);
-      already += write_size;
-      remain -= write_size;
+    if (vector.float_values_size() != dimension) {
+      std::string s = fmt::format("diskann import vector dimension is : {}  not equal to : {}",
+                                  vector.float_values_size(), dimension);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+    }
+
+    auto status = writer_.Append(vector.float_values().data(), dimension * sizeof(float));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
     }
   }
 
@@ -856,7 +891,12 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
   for (const auto& id : vector_ids) {
     vector_to_diskann_ids_.insert(std::make_pair(id, diskann_to_vector_ids_.size()));
     diskann_to_vector_ids_.push_back(id);
-    id_writer_.write(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+
+  auto status = id_writer_.Append(vector_ids.data(), vector_ids.size() * sizeof(int64_t));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
   }
 
   if (vector_to_diskann_ids_.size() != diskann_to_vector_ids_.size()) {
@@ -878,7 +918,6 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
   }
 
   if (!has_more) {
-    writer_.seekp(0, std::ios::beg);
     if (already_recv_vector_count < Constant::kDiskannMinCount) {
       std::string s = fmt::format("diskann import total vector count is : {}  less than : {}, not support build. {}",
                                   already_recv_vector_count, Constant::kDiskannMinCount, FormatParameter());
@@ -887,22 +926,31 @@ butil::Status DiskANNItem::DoImport(const std::vector<pb::common::Vector>& vecto
     }
 
     uint32_t count = already_recv_vector_count;
-    writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    writer_.close();
+    uint32_t header[2] = {count, static_cast<uint32_t>(dimension)};
+    butil::Status status = writer_.Finish(header, sizeof(header));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     std::string new_path = fmt::format("{}/{}/{}/{}", base_dir, normal_name, vector_index_id_, input_name);
     DiskANNUtils::CreateDir(base_dir);
     DiskANNUtils::CreateDir(base_dir + "/" + normal_name);
     DiskANNUtils::CreateDir(base_dir + "/" + normal_name + "/" + std::to_string(vector_index_id_));
-    butil::Status status = DiskANNUtils::Rename(data_path_, new_path);
+    status = DiskANNUtils::Rename(data_path_, new_path);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
     }
 
 #if defined(ENABLE_DISKANN_ID_MAPPING)
-    id_writer_.seekp(0, std::ios::beg);
-    id_writer_.write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-    id_writer_.close();
+    char id_header[sizeof(uint32_t) * 2 + sizeof(int64_t)];
+    memcpy(id_header, header, sizeof(header));
+    memcpy(id_header + sizeof(header), &ts_, sizeof(int64_t));
+    status = id_writer_.Finish(id_header, sizeof(id_header));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
     std::string new_id_path = fmt::format("{}/{}/{}/{}", base_dir, normal_name, vector_index_id_, id_name);
     DiskANNUtils::CreateDir(base_dir);
     DiskANNUtils::CreateDir(base_dir + "/" + normal_name);
@@ -1228,13 +1276,13 @@ butil::Status DiskANNItem::DoClose(std::shared_ptr<Context> ctx, bool is_destroy
   index_path_prefix_ = "";
   is_import_ = false;
   state_ = DiskANNCoreState::kUnknown;
-  if (writer_.is_open()) writer_.close();
+  if (writer_.IsOpen()) writer_.Close();
   already_recv_vector_count_ = 0;
   if (diskann_core_) diskann_core_.reset();
 #if defined(ENABLE_DISKANN_ID_MAPPING)
   diskann_to_vector_ids_.clear();
   vector_to_diskann_ids_.clear();
-  if (id_writer_.is_open()) id_writer_.close();
+  if (id_writer_.IsOpen()) id_writer_.Close();
   id_path_.clear();
 #endif
   ts_ = std::numeric_limits<int64_t>::min();
@@ -1309,8 +1357,8 @@ std::string DiskANNItem::FormatParameter() {
       "vector_index_parameter: {} ",
       vector_index_id_, num_threads_, search_dram_budget_gb_, build_dram_budget_gb_, data_path_, index_path_prefix_,
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
-      diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.is_open() ? "open" : "close"), id_path_,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
+      diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.IsOpen() ? "open" : "close"), id_path_,
       ts_, tso_, last_error_.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_, vector_index_parameter_.ShortDebugString());
 #else
@@ -1322,7 +1370,7 @@ std::string DiskANNItem::FormatParameter() {
       "vector_index_parameter: {} ",
       vector_index_id_, num_threads_, search_dram_budget_gb_, build_dram_budget_gb_, data_path_, index_path_prefix_,
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
       last_error.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_, vector_index_parameter_.ShortDebugString());
 #endif
@@ -1338,8 +1386,8 @@ std::string DiskANNItem::MiniFormatParameter() {
       "vector_to_diskann_ids.size():{} id_writer:{} id_path:\"{}\" ts:{} tso:{} last_error : {} {} remote_side:{} "
       "local_side:{} error_remote_side:{} error_local_side:{} ",
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
-      diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.is_open() ? "open" : "close"), id_path_,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"),
+      diskann_to_vector_ids_.size(), vector_to_diskann_ids_.size(), (id_writer_.IsOpen() ? "open" : "close"), id_path_,
       ts_, tso_, last_error_.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_);
 #else
@@ -1348,7 +1396,7 @@ std::string DiskANNItem::MiniFormatParameter() {
       "already_recv_vector_count:{} diskann_core:\"{}\" ts:{} tso:{} last_error_ : {} {} remote_side:{} "
       "local_side:{} error_remote_side:{} error_local_side:{} ",
       (is_import_ ? "true" : "false"), DiskANNUtils::DiskANNCoreStateToString(state_),
-      (writer_.is_open() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
+      (writer_.IsOpen() ? "open" : "close"), already_recv_vector_count_, (diskann_core_ ? "exist" : "null"), ts, tso,
       last_error.error_code(), last_error_.error_cstr(), remote_side_, local_side_, error_remote_side_,
       error_local_side_);
 #endif
@@ -1372,7 +1420,7 @@ void DiskANNItem::NoDataSymbolCreate() {
   DiskANNUtils::CreateDir(base_dir + "/" + nodata_name);
   std::string nodata_path = fmt::format("{}/{}/{}", base_dir, nodata_name, std::to_string(vector_index_id_));
   std::ofstream writer_nodata;
-  diskann::open_file_to_write(writer_, nodata_path);
+  diskann::open_file_to_write(writer_nodata, nodata_path);
   writer_nodata.close();
 }
 
@@ -28,6 +28,7 @@
 #include "common/context.h"
 #include "common/synchronization.h"
 #include "diskann/diskann_core.h"
+#include "diskann/diskann_direct_writer.h"
 #include "diskann/diskann_utils.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
@@ -62,7 +63,7 @@ class DiskANNItem : public std::enable_shared_from_this<DiskANNItem> {
   butil::Status Build(std::shared_ptr<Context> ctx, bool force_to_build, bool is_sync);
   butil::Status Load(std::shared_ptr<Context> ctx, const pb::common::LoadDiskAnnParam& load_param, bool is_sync);
   butil::Status Search(std::shared_ptr<Context> ctx, uint32_t top_n, const pb::common::SearchDiskAnnParam& search_param,
-                       const std::vector<pb::common::Vector>& vectors,
+                       const std::vector<pb::common::Vector>& vectors, const std::vector<int64_t>& filter_vector_ids,
                        std::vector<pb::index::VectorWithDistanceResult>& results, int64_t& ts);  // NOLINT
   butil::Status TryLoad(std::shared_ptr<Context> ctx, const pb::common::LoadDiskAnnParam& load_param, bool is_sync);
   butil::Status Close(std::shared_ptr<Context> ctx);
@@ -72,6 +73,8 @@ class DiskANNItem : public std::enable_shared_from_this<DiskANNItem> {
   butil::Status Count(std::shared_ptr<Context> ctx, int64_t& count);  // NOLINT
   butil::Status SetNoData(std::shared_ptr<Context> ctx);
   butil::Status SetImportTooMany(std::shared_ptr<Context> ctx);
+  // return nullptr if not loaded, the node cache of loaded core is managed by DiskANNItemManager.
+  std::shared_ptr<DiskANNCore> GetLoadedCore();
 
 
   static void SetImportTimeout(int64_t timeout_s) { DiskANNItem::import_timeout_s = timeout_s; }
@@ -114,13 +117,13 @@ class DiskANNItem : public std::enable_shared_from_this<DiskANNItem> {
   std::string index_path_prefix_;
   bool is_import_;
   std::atomic<DiskANNCoreState> state_;
-  std::ofstream writer_;
+  DiskANNDirectWriter writer_;
   int64_t already_recv_vector_count_;
   std::shared_ptr<DiskANNCore> diskann_core_;
 #if defined(ENABLE_DISKANN_ID_MAPPING)
   std::vector<int64_t> diskann_to_vector_ids_;
   std::unordered_map<int64_t, uint32_t> vector_to_diskann_ids_;
-  std::ofstream id_writer_;
+  DiskANNDirectWriter id_writer_;
   std::string id_path_;
 #endif
   int64_t ts_;
@@ -18,8 +18,12 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,18 +33,27 @@
 #include "common/synchronization.h"
 #include "diskann/diskann_utils.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 
 namespace dingodb {
 
+DEFINE_int64(diskann_node_cache_rebalance_interval_s, 60, "interval of rebalance node cache budget between diskann");
+DEFINE_double(diskann_node_cache_even_share_ratio, 0.2, "ratio of node cache budget split evenly, others by load");
+DEFINE_double(diskann_node_cache_rebalance_min_change_ratio, 0.1,
+              "update node cache of diskann only when the change ratio reach it");
+DEFINE_double(diskann_node_cache_load_smooth_factor, 0.5, "weight of the latest interval in smoothed query load");
+
 DiskANNItemManager::DiskANNItemManager()
     : num_threads_(Constant::kDiskannNumThreadsDefaultValue),
       search_dram_budget_gb_(Constant::kDiskannSearchDramBudgetGbDefaultValue),
       build_dram_budget_gb_(Constant::kDiskannBuildDramBudgetGbDefaultValue),
-      import_timeout_s_(Constant::kDiskannImportTimeoutSecondDefaultValue) {}
+      import_timeout_s_(Constant::kDiskannImportTimeoutSecondDefaultValue),
+      node_cache_budget_mb_(Constant::kDiskannNodeCacheBudgetMbDefaultValue) {}
 
 DiskANNItemManager::~DiskANNItemManager() {
+  StopNodeCacheRebalancer();
   RWLockWriteGuard guard(&rw_lock_);
   items_.clear();
 }
@@ -109,8 +122,24 @@ bool DiskANNItemManager::Init(std::shared_ptr<Config> config) {
     }
   }
 
+  if (auto iter = conf.find(Constant::kDiskannNodeCacheBudgetMbConfigName); iter != conf.end()) {
+    try {
+      decltype(node_cache_budget_mb_) node_cache_budget_mb;
+      node_cache_budget_mb = std::stol(iter->second);
+      if (node_cache_budget_mb >= 0) {
+        node_cache_budget_mb_ = node_cache_budget_mb;
+      }
+    } catch (std::exception& e) {
+    }
+  }
+
   DiskANNItem::SetImportTimeout(import_timeout_s_);
   DiskANNItem::SetBaseDir(path_);
+  DiskANNCore::SetNodeCacheBudgetMb(node_cache_budget_mb_);
+
+  if (node_cache_budget_mb_ > 0) {
+    StartNodeCacheRebalancer();
+  }
 
   return true;
 }
@@ -162,4 +191,163 @@ std::vector<std::shared_ptr<DiskANNItem>> DiskANNItemManager::FindAll() {
   return items;
 }
 
+std::vector<int64_t> DiskANNItemManager::ApportionNodeCache(int64_t budget_bytes, double even_share_ratio,
+                                                           const std::vector<NodeCacheDemand>& demands) {
+  std::vector<int64_t> num_nodes(demands.size(), 0);
+  even_share_ratio = std::clamp(even_share_ratio, 0.0, 1.0);
+
+  std::vector<size_t> actives;
+  for (size_t i = 0; i < demands.size(); ++i) {
+    if (demands[i].bytes_per_node > 0 && demands[i].max_nodes > 0) {
+      actives.push_back(i);
+    }
+  }
+
+  double budget = std::max(budget_bytes, static_cast<int64_t>(0));
+  while (!actives.empty() && budget > 0) {
+    double total_load = 0;
+    for (auto i : actives) {
+      total_load += std::max(demands[i].load, 0.0);
+    }
+
+    // the capped demand get less than its share, so the remain budget is enough for the others of this round.
+    double round_budget = budget;
+    std::vector<size_t> uncappeds;
+    for (auto i : actives) {
+      const auto& demand = demands[i];
+      double share = round_budget * even_share_ratio / actives.size();
+      if (total_load > 0) {
+        share += round_budget * (1 - even_share_ratio) * std::max(demand.load, 0.0) / total_load;
+      } else {
+        share += round_budget * (1 - even_share_ratio) / actives.size();
+      }
+
+      num_nodes[i] = static_cast<int64_t>(share / demand.bytes_per_node);
+      if (num_nodes[i] >= demand.max_nodes) {
+        num_nodes[i] = demand.max_nodes;
+        budget -= static_cast<double>(demand.max_nodes) * demand.bytes_per_node;
+      } else {
+        uncappeds.push_back(i);
+      }
+    }
+
+    if (uncappeds.size() == actives.size()) {
+      break;
+    }
+    actives.swap(uncappeds);
+  }
+
+  return num_nodes;
+}
+
+void DiskANNItemManager::RebalanceNodeCache() {
+  if (node_cache_budget_mb_ <= 0) {
+    return;
+  }
+
+  std::map<int64_t, std::shared_ptr<DiskANNItem>> items;
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    items = items_;
+  }
+
+  std::vector<int64_t> vector_index_ids;
+  std::vector<std::shared_ptr<DiskANNCore>> cores;
+  std::vector<NodeCacheDemand> demands;
+  std::map<int64_t, double> search_loads;
+  int64_t budget_bytes = node_cache_budget_mb_ * 1024 * 1024;
+  double smooth_factor = std::clamp(FLAGS_diskann_node_cache_load_smooth_factor, 0.0, 1.0);
+  for (const auto& [vector_index_id, item] : items) {
+    auto core = item->GetLoadedCore();
+    if (core == nullptr) {
+      continue;
+    }
+
+    // query trace is kept for selecting cached nodes, count it in budget.
+    budget_bytes -= core->QueryTraceBytes();
+
+    int64_t bytes_per_node = core->NodeCacheBytesPerNode();
+    if (bytes_per_node <= 0) {
+      continue;
+    }
+
+    double load = static_cast<double>(core->FetchSearchCount());
+    if (auto iter = search_loads_.find(vector_index_id); iter != search_loads_.end()) {
+      load = iter->second * (1 - smooth_factor) + load * smooth_factor;
+    }
+    search_loads[vector_index_id] = load;
+
+    vector_index_ids.push_back(vector_index_id);
+    cores.push_back(core);
+    demands.push_back(NodeCacheDemand{load, bytes_per_node, core->Count()});
+  }
+  // drop the unloaded
+  search_loads_.swap(search_loads);
+
+  auto num_nodes = ApportionNodeCache(budget_bytes, FLAGS_diskann_node_cache_even_share_ratio, demands);
+
+  // shrink first, so the grown ones reuse the released budget. the old cache is released only after the new one is
+  // swapped in, so the peak memory of each update is old plus new cache of that diskann, that is up to the budget
+  // plus the old cache of the updating one.
+  std::vector<size_t> orders(cores.size());
+  std::vector<int64_t> current_num_nodes(cores.size());
+  for (size_t i = 0; i < cores.size(); ++i) {
+    orders[i] = i;
+    current_num_nodes[i] = cores[i]->NumNodesToCache();
+  }
+  std::sort(orders.begin(), orders.end(), [&](size_t lhs, size_t rhs) {
+    return num_nodes[lhs] - current_num_nodes[lhs] < num_nodes[rhs] - current_num_nodes[rhs];
+  });
+
+  for (auto i : orders) {
+    int64_t diff = std::abs(num_nodes[i] - current_num_nodes[i]);
+    if (diff == 0 ||
+        diff < std::max(num_nodes[i], current_num_nodes[i]) * FLAGS_diskann_node_cache_rebalance_min_change_ratio) {
+      continue;
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[diskann.node_cache] vector_index_id: {} load: {:.2f} num_nodes_to_cache: {} -> {}",
+                                   vector_index_ids[i], demands[i].load, current_num_nodes[i], num_nodes[i]);
+    auto status = cores[i]->UpdateNodeCache(num_nodes[i]);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[diskann.node_cache] vector_index_id: {} update node cache failed, error: {}",
+                                        vector_index_ids[i], status.error_cstr());
+    }
+  }
+}
+
+void DiskANNItemManager::StartNodeCacheRebalancer() {
+  if (node_cache_rebalancer_.joinable()) {
+    return;
+  }
+
+  is_rebalancer_stop_ = false;
+  node_cache_rebalancer_ = std::thread([this]() {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(rebalancer_mutex_);
+        rebalancer_cond_.wait_for(lock, std::chrono::seconds(FLAGS_diskann_node_cache_rebalance_interval_s),
+                                  [this]() { return is_rebalancer_stop_; });
+        if (is_rebalancer_stop_) {
+          break;
+        }
+      }
+
+      RebalanceNodeCache();
+    }
+  });
+}
+
+void DiskANNItemManager::StopNodeCacheRebalancer() {
+  {
+    std::lock_guard<std::mutex> lock(rebalancer_mutex_);
+    is_rebalancer_stop_ = true;
+  }
+  rebalancer_cond_.notify_all();
+
+  if (node_cache_rebalancer_.joinable()) {
+    node_cache_rebalancer_.join();
+  }
+}
+
 }  // namespace dingodb
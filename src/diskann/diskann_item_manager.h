@@ -18,8 +18,14 @@
 #include <sys/types.h>
 #include <xmmintrin.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "butil/status.h"
 #include "common/synchronization.h"
@@ -64,15 +70,40 @@ class DiskANNItemManager : public DiskANNItemManagerSingleton<DiskANNItemManager
 
   std::vector<std::shared_ptr<DiskANNItem>> FindAll();
 
+  struct NodeCacheDemand {
+    // query load of the diskann
+    double load{0};
+    int64_t bytes_per_node{0};
+    int64_t max_nodes{0};
+  };
+
+  // split node cache budget, part of it evenly and others by query load, the capped share is given to others.
+  // return the number of nodes to cache of each demand.
+  static std::vector<int64_t> ApportionNodeCache(int64_t budget_bytes, double even_share_ratio,
+                                                 const std::vector<NodeCacheDemand>& demands);
+
+  void RebalanceNodeCache();
+
  protected:
  private:
+  void StartNodeCacheRebalancer();
+  void StopNodeCacheRebalancer();
+
   std::string path_;
   uint32_t num_threads_;
   float search_dram_budget_gb_;
   float build_dram_budget_gb_;
   int64_t import_timeout_s_;
+  int64_t node_cache_budget_mb_;
   std::map<int64_t, std::shared_ptr<DiskANNItem>> items_;
   RWLock rw_lock_;
+
+  // only accessed by rebalancer thread, smoothed query load of diskann
+  std::map<int64_t, double> search_loads_;
+  std::thread node_cache_rebalancer_;
+  std::mutex rebalancer_mutex_;
+  std::condition_variable rebalancer_cond_;
+  bool is_rebalancer_stop_{false};
 };
 
 }  // namespace dingodb
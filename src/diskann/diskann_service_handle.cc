@@ -147,7 +147,8 @@ butil::Status DiskAnnServiceHandle::VectorTryLoad(std::shared_ptr<Context> ctx,
 
 butil::Status DiskAnnServiceHandle::VectorSearch(std::shared_ptr<Context> ctx, int64_t vector_index_id, uint32_t top_n,
                                                  const pb::common::SearchDiskAnnParam& search_param,
-                                                 const std::vector<pb::common::Vector>& vectors) {
+                                                 const std::vector<pb::common::Vector>& vectors,
+                                                 const std::vector<int64_t>& filter_vector_ids) {
   butil::Status status;
   auto item = item_manager.Find(vector_index_id);
   if (item == nullptr) {
@@ -159,7 +160,7 @@ butil::Status DiskAnnServiceHandle::VectorSearch(std::shared_ptr<Context> ctx, i
 
   std::vector<pb::index::VectorWithDistanceResult> results;
   int64_t ts = 0;
-  status = item->Search(ctx, top_n, search_param, vectors, results, ts);
+  status = item->Search(ctx, top_n, search_param, vectors, filter_vector_ids, results, ts);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
   }
@@ -45,7 +45,8 @@ class DiskAnnServiceHandle {
 
   static butil::Status VectorSearch(std::shared_ptr<Context> ctx, int64_t vector_index_id, uint32_t top_n,
                                     const pb::common::SearchDiskAnnParam& search_param,
-                                    const std::vector<pb::common::Vector>& vectors);
+                                    const std::vector<pb::common::Vector>& vectors,
+                                    const std::vector<int64_t>& filter_vector_ids);
 
   static butil::Status VectorReset(std::shared_ptr<Context> ctx, int64_t vector_index_id, bool delete_data_file);
 
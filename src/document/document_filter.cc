@@ -0,0 +1,277 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document/document_filter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <regex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kRowIdFieldName = "row_id";
+
+static std::string JoinClauses(const std::vector<std::string>& clauses, const std::string& separator) {
+  std::string result;
+  for (const auto& clause : clauses) {
+    if (!result.empty()) {
+      result += separator;
+    }
+    result += clause;
+  }
+  return result;
+}
+
+// phrase of tantivy query, escape the quote and backslash.
+static std::string QuotePhrase(const std::string& value) {
+  std::string result = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+    }
+    result.push_back(c);
+  }
+  result.push_back('"');
+  return result;
+}
+
+// rfc3339, e.g. 2024-01-02T03:04:05Z or 2024-01-02T03:04:05.123+08:00
+static bool IsValidDatetime(const std::string& value) {
+  static const std::regex kRfc3339Regex(R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d{1,9})?(Z|[+-]\d{2}:\d{2})$)");
+  return std::regex_match(value, kRfc3339Regex);
+}
+
+std::set<std::string> DocumentFilter::GetRawTextFields(const std::string& json_parameter) {
+  std::set<std::string> raw_text_fields;
+  if (!nlohmann::json::accept(json_parameter)) {
+    return raw_text_fields;
+  }
+
+  nlohmann::json json = nlohmann::json::parse(json_parameter);
+  for (const auto& item : json.items()) {
+    const auto& tokenizer = item.value();
+    if (!tokenizer.is_object() || tokenizer.find("tokenizer") == tokenizer.end()) {
+      continue;
+    }
+    const auto& tokenizer_item = tokenizer.at("tokenizer");
+    if (tokenizer_item.is_object() && tokenizer_item.find("type") != tokenizer_item.end() &&
+        tokenizer_item.at("type") == "raw") {
+      raw_text_fields.insert(item.key());
+    }
+  }
+
+  return raw_text_fields;
+}
+
+butil::Status DocumentFilter::FormatValue(const std::string& key, pb::common::ScalarFieldType field_type,
+                                          const pb::common::DocumentValue& value, std::string& result) {
+  if (value.field_type() != field_type) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("filter field({}) value type({}) not match schema type({})", key,
+                                     pb::common::ScalarFieldType_Name(value.field_type()),
+                                     pb::common::ScalarFieldType_Name(field_type)));
+  }
+
+  switch (field_type) {
+    case pb::common::ScalarFieldType::STRING:
+      result = QuotePhrase(value.field_value().string_data());
+      break;
+    case pb::common::ScalarFieldType::INT64:
+      result = std::to_string(value.field_value().long_data());
+      break;
+    case pb::common::ScalarFieldType::DOUBLE:
+      result = fmt::format("{}", value.field_value().double_data());
+      break;
+    case pb::common::ScalarFieldType::DATETIME:
+      // inserted into query without quote, only rfc3339 is allowed.
+      result = value.field_value().datetime_data();
+      if (!IsValidDatetime(result)) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                             fmt::format("filter field({}) datetime({}) is not rfc3339", key, result));
+      }
+      break;
+    case pb::common::ScalarFieldType::BOOL:
+      result = value.field_value().bool_data() ? "true" : "false";
+      break;
+    default:
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("filter field({}) type({}) not support", key,
+                                       pb::common::ScalarFieldType_Name(field_type)));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentFilter::BuildScalarQuery(
+    const pb::common::DocumentIndexParameter& index_parameter,
+    const google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter>& scalar_filters, std::string& query) {
+  const auto& scalar_schema = index_parameter.scalar_schema();
+  std::set<std::string> raw_text_fields;
+  bool has_text_filter = std::any_of(scalar_filters.begin(), scalar_filters.end(), [&](const auto& scalar_filter) {
+    return std::any_of(scalar_schema.fields().begin(), scalar_schema.fields().end(), [&](const auto& field) {
+      return field.key() == scalar_filter.key() && field.field_type() == pb::common::ScalarFieldType::STRING;
+    });
+  });
+  if (has_text_filter) {
+    raw_text_fields = GetRawTextFields(index_parameter.json_parameter());
+  }
+
+  std::vector<std::string> clauses;
+  clauses.reserve(scalar_filters.size());
+
+  for (const auto& scalar_filter : scalar_filters) {
+    const auto& key = scalar_filter.key();
+    auto it = std::find_if(scalar_schema.fields().begin(), scalar_schema.fields().end(),
+                           [&key](const auto& field) { return field.key() == key; });
+    if (it == scalar_schema.fields().end()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("filter field({}) not in scalar schema", key));
+    }
+    auto field_type = it->field_type();
+    bool is_text = field_type == pb::common::ScalarFieldType::STRING;
+
+    std::vector<std::string> values;
+    for (const auto& value : scalar_filter.values()) {
+      std::string formatted_value;
+      auto status = FormatValue(key, field_type, value, formatted_value);
+      if (!status.ok()) {
+        return status;
+      }
+      values.push_back(std::move(formatted_value));
+    }
+    if (values.empty()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("filter field({}) missing value", key));
+    }
+
+    const char* range_op = nullptr;
+    switch (scalar_filter.op()) {
+      case pb::common::DocumentFilterOp::FILTER_OP_EQ:
+      case pb::common::DocumentFilterOp::FILTER_OP_IN:
+        if (scalar_filter.op() == pb::common::DocumentFilterOp::FILTER_OP_EQ && values.size() != 1) {
+          return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                               fmt::format("filter field({}) EQ need one value", key));
+        }
+        if (is_text) {
+          // tokenized text only match phrase, that is contains not equal.
+          if (raw_text_fields.count(key) == 0) {
+            return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                                 fmt::format("filter field({}) EQ/IN need raw tokenizer", key));
+          }
+          // raw tokenizer keep the whole value as one term, the phrase is an exact term match.
+          std::vector<std::string> phrases;
+          for (const auto& value : values) {
+            phrases.push_back(fmt::format("{}:{}", key, value));
+          }
+          clauses.push_back(fmt::format("({})", JoinClauses(phrases, " OR ")));
+        } else {
+          clauses.push_back(fmt::format("{}: IN [{}]", key, JoinClauses(values, " ")));
+        }
+        continue;
+      case pb::common::DocumentFilterOp::FILTER_OP_GT:
+        range_op = ">";
+        break;
+      case pb::common::DocumentFilterOp::FILTER_OP_GE:
+        range_op = ">=";
+        break;
+      case pb::common::DocumentFilterOp::FILTER_OP_LT:
+        range_op = "<";
+        break;
+      case pb::common::DocumentFilterOp::FILTER_OP_LE:
+        range_op = "<=";
+        break;
+      default:
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                             fmt::format("filter field({}) op({}) not support", key,
+                                         pb::common::DocumentFilterOp_Name(scalar_filter.op())));
+    }
+
+    if (is_text || field_type == pb::common::ScalarFieldType::BOOL || values.size() != 1) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("filter field({}) range need one value of number or datetime", key));
+    }
+    clauses.push_back(fmt::format("{}: {} {}", key, range_op, values[0]));
+  }
+
+  query = JoinClauses(clauses, " AND ");
+
+  return butil::Status::OK();
+}
+
+bool DocumentFilter::BuildIdQuery(std::vector<int64_t> document_ids, uint32_t max_range_num, std::string& query) {
+  if (document_ids.empty()) {
+    return false;
+  }
+
+  std::sort(document_ids.begin(), document_ids.end());
+  document_ids.erase(std::unique(document_ids.begin(), document_ids.end()), document_ids.end());
+
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (auto document_id : document_ids) {
+    if (!ranges.empty() && ranges.back().second + 1 == document_id) {
+      ranges.back().second = document_id;
+      continue;
+    }
+    if (ranges.size() >= max_range_num) {
+      return false;
+    }
+    ranges.emplace_back(document_id, document_id);
+  }
+
+  std::vector<std::string> single_ids;
+  std::vector<std::string> clauses;
+  for (const auto& [start_id, end_id] : ranges) {
+    if (start_id == end_id) {
+      single_ids.push_back(std::to_string(start_id));
+    } else {
+      clauses.push_back(fmt::format("({0}: >= {1} AND {0}: <= {2})", kRowIdFieldName, start_id, end_id));
+    }
+  }
+  if (!single_ids.empty()) {
+    clauses.push_back(fmt::format("{}: IN [{}]", kRowIdFieldName, JoinClauses(single_ids, " ")));
+  }
+
+  query = clauses.size() == 1 ? clauses[0] : fmt::format("({})", JoinClauses(clauses, " OR "));
+
+  return true;
+}
+
+std::string DocumentFilter::CombineQuery(const std::string& query_string,
+                                         const std::vector<std::string>& filter_queries) {
+  std::vector<std::string> clauses;
+  for (const auto& filter_query : filter_queries) {
+    if (!filter_query.empty()) {
+      clauses.push_back(fmt::format("({})", filter_query));
+    }
+  }
+  if (clauses.empty()) {
+    return query_string;
+  }
+
+  // only filter, e.g. pure scalar or id filter search.
+  if (!query_string.empty()) {
+    clauses.insert(clauses.begin(), fmt::format("({})", query_string));
+  }
+  return JoinClauses(clauses, " AND ");
+}
+
+}  // namespace dingodb
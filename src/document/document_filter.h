@@ -0,0 +1,56 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DOCUMENT_FILTER_H_
+#define DINGODB_DOCUMENT_FILTER_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "google/protobuf/repeated_ptr_field.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Compile the filters of document search into tantivy query clauses, so they are evaluated inside the index
+// by term set and fast field range query, instead of materializing id list and passing it through ffi.
+// Term set and range query are constant score, the bm25 order of the origin query is kept.
+class DocumentFilter {
+ public:
+  // filters are AND-ed, the field must exist in scalar schema and the value type must match it.
+  // EQ/IN of text field is only allowed on raw tokenizer field, a tokenized field can't match exactly.
+  static butil::Status BuildScalarQuery(
+      const pb::common::DocumentIndexParameter& index_parameter,
+      const google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter>& scalar_filters, std::string& query);
+
+  // text fields with raw tokenizer in json_parameter.
+  static std::set<std::string> GetRawTextFields(const std::string& json_parameter);
+
+  // compress ids into row_id ranges, return false if the ranges more than max_range_num.
+  static bool BuildIdQuery(std::vector<int64_t> document_ids, uint32_t max_range_num, std::string& query);
+
+  // (query_string) AND (filter_query)...
+  static std::string CombineQuery(const std::string& query_string, const std::vector<std::string>& filter_queries);
+
+ private:
+  static butil::Status FormatValue(const std::string& key, pb::common::ScalarFieldType field_type,
+                                   const pb::common::DocumentValue& value, std::string& result);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DOCUMENT_FILTER_H_
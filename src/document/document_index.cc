@@ -17,16 +17,19 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "braft/protobuf_file.h"
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
+#include "document/document_filter.h"
 #include "document/document_index_factory.h"
 #include "fmt/core.h"
 #include "mvcc/codec.h"
@@ -40,6 +43,20 @@ namespace dingodb {
 DEFINE_int32(document_index_save_log_gap, 10, "document index save log gap");
 BRPC_VALIDATE_GFLAG(document_index_save_log_gap, brpc::PositiveInteger);
 
+DEFINE_int32(document_index_reader_refresh_interval_ms, 100,
+             "document index coalesce writes within the interval, then commit and reload reader in background, 0 is "
+             "commit and reload inline");
+BRPC_VALIDATE_GFLAG(document_index_reader_refresh_interval_ms, brpc::NonNegativeInteger);
+
+DEFINE_int32(document_index_read_your_writes_timeout_ms, 5000, "document index search wait reader refresh timeout");
+BRPC_VALIDATE_GFLAG(document_index_read_your_writes_timeout_ms, brpc::PositiveInteger);
+
+DEFINE_uint32(document_search_id_filter_max_range_num, 64,
+              "document search push down id filter into index query when ids can be compressed into the ranges");
+
+bvar::LatencyRecorder g_document_index_commit_latency("dingo_document_index_commit_latency");
+bvar::LatencyRecorder g_document_index_reader_reload_latency("dingo_document_index_reader_reload_latency");
+
 butil::Status DocumentIndex::RemoveIndexFiles(int64_t id, const std::string& index_path) {
   // index_path: /home/dingo-store/dist/document1/data/document_index/80040/epoch_1
   // need remove index_path: /home/dingo-store/dist/document1/data/document_index/80040
@@ -94,6 +111,10 @@ void DocumentIndex::SetApplyLogId(int64_t apply_log_id) {
   this->apply_log_id_.store(apply_log_id, std::memory_order_relaxed);
 }
 
+void DocumentIndex::SetPendingSaveApplyLogId(int64_t apply_log_id) {
+  pending_save_apply_log_id_.store(apply_log_id, std::memory_order_release);
+}
+
 pb::common::RegionEpoch DocumentIndex::Epoch() const { return epoch_; };
 
 pb::common::Range DocumentIndex::Range(bool is_encode) const {
@@ -117,8 +138,22 @@ void DocumentIndex::UnlockWrite() { rw_lock_.UnlockWrite(); }
 butil::Status DocumentIndex::SaveMeta(int64_t apply_log_id) {
   LockWrite();
 
+  // the writes before apply_log_id must be durable before the meta is saved.
+  auto status = Commit();
+  if (!status.ok()) {
+    UnlockWrite();
+    return status;
+  }
+
   SetApplyLogId(apply_log_id);
 
+  status = SaveMetaFile(apply_log_id);
+  UnlockWrite();
+
+  return status;
+}
+
+butil::Status DocumentIndex::SaveMetaFile(int64_t apply_log_id) {
   // Write meta to meta_file
   pb::store_internal::DocumentIndexSnapshotMeta meta;
   meta.set_document_index_id(id_);
@@ -134,11 +169,27 @@ butil::Status DocumentIndex::SaveMeta(int64_t apply_log_id) {
     return butil::Status(pb::error::EINTERNAL, "save meta fail");
   }
 
-  UnlockWrite();
+  saved_apply_log_id_ = apply_log_id;
 
   return butil::Status::OK();
 }
 
+void DocumentIndex::SaveMetaIfNeeded(int64_t apply_log_id) {
+  if (apply_log_id - saved_apply_log_id_ < FLAGS_document_index_save_log_gap) {
+    return;
+  }
+
+  if (apply_log_id > ApplyLogId()) {
+    SetApplyLogId(apply_log_id);
+  }
+
+  auto status = SaveMetaFile(apply_log_id);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] save meta fail, apply_log_id({}).", id_,
+                                    apply_log_id);
+  }
+}
+
 std::string DocumentIndex::GetIndexPath(int64_t document_index_id, const pb::common::RegionEpoch& epoch) {
   return fmt::format("{}/{}/epoch_{}", Server::GetInstance().GetDocumentIndexPath(), document_index_id,
                      epoch.version());
@@ -185,6 +236,7 @@ std::shared_ptr<DocumentIndex> DocumentIndex::LoadIndex(int64_t id, const pb::co
   }
 
   document_index->SetApplyLogId(meta.apply_log_id());
+  document_index->saved_apply_log_id_ = meta.apply_log_id();
 
   DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] load meta finish, epoch({}) apply_id({})", id,
                                  meta.epoch().version(), meta.apply_log_id());
@@ -298,25 +350,26 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     }
   }
 
-  auto bool_result = ffi_index_writer_commit(index_path_);
-  if (!bool_result.result) {
-    std::string err_msg = fmt::format("[document_index.raw][id({})] commit failed, error: {}, error_msg: {}", id_,
-                                      bool_result.error_code, bool_result.error_msg.c_str());
-    DINGO_LOG(ERROR) << err_msg;
-    return butil::Status(pb::error::EINTERNAL, err_msg);
+  int64_t write_seq = write_seq_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+  // build or catch up, commit only, reader is reloaded when switch index.
+  if (!reload_reader) {
+    return Commit();
   }
 
-  if (reload_reader) {
-    bool_result = ffi_index_reader_reload(index_path_);
-    if (!bool_result.result) {
-      std::string err_msg = fmt::format("[document_index.raw][id({})] reload failed, error: {}, error_msg: {}", id_,
-                                        bool_result.error_code, bool_result.error_msg.c_str());
-      DINGO_LOG(ERROR) << err_msg;
-      return butil::Status(pb::error::EINTERNAL, err_msg);
-    }
+  // coalesce with the following writes, commit and reload in background.
+  if (FLAGS_document_index_reader_refresh_interval_ms > 0 && ScheduleRefresh()) {
+    return butil::Status::OK();
   }
 
-  return butil::Status::OK();
+  int64_t apply_log_id = pending_save_apply_log_id_.load(std::memory_order_acquire);
+  auto status = Commit();
+  if (!status.ok()) {
+    return status;
+  }
+  SaveMetaIfNeeded(apply_log_id);
+
+  return ReloadReader(write_seq);
 }
 
 butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
@@ -360,6 +413,160 @@ butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
     return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
+  write_seq_.fetch_add(1, std::memory_order_acq_rel);
+
+  // without background refresh, the delete is committed with the next add or save.
+  if (FLAGS_document_index_reader_refresh_interval_ms > 0) {
+    ScheduleRefresh();
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::Commit() {
+  int64_t write_seq = write_seq_.load(std::memory_order_acquire);
+  if (write_seq <= committed_seq_) {
+    return butil::Status::OK();
+  }
+
+  BvarLatencyGuard bvar_guard(&g_document_index_commit_latency);
+
+  auto bool_result = ffi_index_writer_commit(index_path_);
+  if (!bool_result.result) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] commit failed, error: {}, error_msg: {}", id_,
+                                      bool_result.error_code, bool_result.error_msg.c_str());
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EINTERNAL, err_msg);
+  }
+
+  committed_seq_ = write_seq;
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::ReloadReader(int64_t write_seq) {
+  {
+    BvarLatencyGuard bvar_guard(&g_document_index_reader_reload_latency);
+
+    auto bool_result = ffi_index_reader_reload(index_path_);
+    if (!bool_result.result) {
+      std::string err_msg = fmt::format("[document_index.raw][id({})] reload failed, error: {}, error_msg: {}", id_,
+                                        bool_result.error_code, bool_result.error_msg.c_str());
+      DINGO_LOG(ERROR) << err_msg;
+      return butil::Status(pb::error::EINTERNAL, err_msg);
+    }
+  }
+
+  std::unique_lock<bthread::Mutex> lock(refresh_mutex_);
+  if (write_seq > refreshed_seq_.load(std::memory_order_relaxed)) {
+    refreshed_seq_.store(write_seq, std::memory_order_release);
+  }
+  refresh_cond_.notify_all();
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::Refresh() {
+  int64_t write_seq = 0;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    if (is_destroyed_) {
+      return butil::Status::OK();
+    }
+
+    // the writes of logs not after apply_log_id are done before it is set, so they are in this commit.
+    int64_t apply_log_id = pending_save_apply_log_id_.load(std::memory_order_acquire);
+    auto status = Commit();
+    if (!status.ok()) {
+      return status;
+    }
+    write_seq = committed_seq_;
+
+    SaveMetaIfNeeded(apply_log_id);
+  }
+
+  // reload not block the writes.
+  RWLockReadGuard guard(&rw_lock_);
+  if (is_destroyed_) {
+    return butil::Status::OK();
+  }
+
+  return ReloadReader(write_seq);
+}
+
+bool DocumentIndex::ScheduleRefresh() {
+  if (refresh_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+    return true;
+  }
+
+  // not owned by shared_ptr, can't refresh in background.
+  auto weak_index = weak_from_this();
+  if (weak_index.expired()) {
+    refresh_scheduled_.store(false, std::memory_order_release);
+    return false;
+  }
+
+  // the routine hold weak_ptr, not to delay the index destruction.
+  auto* arg = new std::weak_ptr<DocumentIndex>(std::move(weak_index));
+  bthread_t tid;
+  if (bthread_start_background(&tid, &BTHREAD_ATTR_NORMAL, RefreshRoutine, arg) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] start refresh bthread failed.", id_);
+    delete arg;
+    refresh_scheduled_.store(false, std::memory_order_release);
+    return false;
+  }
+
+  return true;
+}
+
+void* DocumentIndex::RefreshRoutine(void* arg) {
+  std::unique_ptr<std::weak_ptr<DocumentIndex>> weak_index(static_cast<std::weak_ptr<DocumentIndex>*>(arg));
+
+  bthread_usleep(static_cast<int64_t>(FLAGS_document_index_reader_refresh_interval_ms) * 1000);
+
+  auto document_index = weak_index->lock();
+  if (document_index == nullptr) {
+    return nullptr;
+  }
+
+  // the writes after here schedule the next refresh.
+  document_index->refresh_scheduled_.store(false, std::memory_order_release);
+
+  auto status = document_index->Refresh();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] refresh reader failed, error: {}",
+                                    document_index->Id(), status.error_str());
+    // retry later, the writes must be visible finally.
+    document_index->ScheduleRefresh();
+  }
+
+  return nullptr;
+}
+
+butil::Status DocumentIndex::WaitReaderRefreshed(int64_t timeout_ms) {
+  int64_t write_seq = write_seq_.load(std::memory_order_acquire);
+  if (refreshed_seq_.load(std::memory_order_acquire) >= write_seq) {
+    return butil::Status::OK();
+  }
+
+  // the writes without refresh, e.g. build with reload_reader false.
+  if (FLAGS_document_index_reader_refresh_interval_ms == 0 || !ScheduleRefresh()) {
+    return Refresh();
+  }
+
+  int64_t deadline_ms = Helper::TimestampMs() + timeout_ms;
+  std::unique_lock<bthread::Mutex> lock(refresh_mutex_);
+  while (refreshed_seq_.load(std::memory_order_acquire) < write_seq) {
+    int64_t left_ms = deadline_ms - Helper::TimestampMs();
+    if (left_ms <= 0) {
+      std::string err_msg = fmt::format("[document_index.raw][id({})] wait reader refresh timeout, seq({}/{})", id_,
+                                        refreshed_seq_.load(std::memory_order_relaxed), write_seq);
+      DINGO_LOG(WARNING) << err_msg;
+      return butil::Status(pb::error::EINTERNAL, err_msg);
+    }
+    refresh_cond_.wait_for(lock, left_ms * 1000);
+  }
+
   return butil::Status::OK();
 }
 
@@ -422,6 +629,7 @@ butil::Status DocumentIndex::Save(const std::string& /*path*/) {
   // Save need the caller to do LockWrite() and UnlockWrite()
   auto result = ffi_index_writer_commit(index_path_);
   if (result.result) {
+    committed_seq_ = write_seq_.load(std::memory_order_acquire);
     return butil::Status::OK();
   } else {
     std::string err_msg = fmt::format("[document_index.raw][id({})] save failed, error: {}, error_msg: {}", id_,
@@ -642,17 +850,10 @@ int64_t DocumentIndexWrapper::LastBuildEpochVersion() {
 int64_t DocumentIndexWrapper::ApplyLogId() const { return apply_log_id_.load(std::memory_order_acquire); }
 
 void DocumentIndexWrapper::SetApplyLogId(int64_t apply_log_id) {
-  // update inner document index apply log id
-  if (apply_log_id - last_save_apply_log_id_.load(std::memory_order_relaxed) > FLAGS_document_index_save_log_gap) {
-    last_save_apply_log_id_.store(apply_log_id, std::memory_order_relaxed);
-
-    auto document_index = GetOwnDocumentIndex();
-    if (document_index != nullptr) {
-      auto status = document_index->SaveMeta(apply_log_id);
-      if (!status.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] save meta fail.", id_);
-      }
-    }
+  // inner document index persist the apply log id after it is covered by a commit, apply not commit inline.
+  auto document_index = GetOwnDocumentIndex();
+  if (document_index != nullptr) {
+    document_index->SetPendingSaveApplyLogId(apply_log_id);
   }
 
   apply_log_id_.store(apply_log_id, std::memory_order_release);
@@ -1078,16 +1279,53 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
     return butil::Status(pb::error::EDOCUMENT_INDEX_NOT_FOUND, "document index %lu is not ready.", Id());
   }
 
-  bool use_id_filter = false;
-  if (!parameter.document_ids().empty()) {
-    use_id_filter = true;
+  // read-your-writes, the writes applied before search must be visible.
+  if (parameter.read_your_writes()) {
+    auto status = document_index->WaitReaderRefreshed(FLAGS_document_index_read_your_writes_timeout_ms);
+    if (!status.ok()) {
+      return status;
+    }
+    auto sibling_document_index = SiblingDocumentIndex();
+    if (sibling_document_index != nullptr) {
+      status = sibling_document_index->WaitReaderRefreshed(FLAGS_document_index_read_your_writes_timeout_ms);
+      if (!status.ok()) {
+        return status;
+      }
+    }
   }
 
+  // push down filters into index query, evaluated by tantivy.
+  std::vector<std::string> filter_queries;
+  if (!parameter.scalar_filters().empty()) {
+    std::string scalar_query;
+    auto status =
+        DocumentFilter::BuildScalarQuery(index_parameter_, parameter.scalar_filters(), scalar_query);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[document_index.wrapper][id({})] build scalar filter failed, error: {}", Id(),
+                                        status.error_str());
+      return status;
+    }
+    filter_queries.push_back(std::move(scalar_query));
+  }
+
+  bool use_id_filter = false;
   std::vector<uint64_t> alive_ids;
-  for (int64_t doc_id : parameter.document_ids()) {
-    alive_ids.push_back(doc_id);
+  if (!parameter.document_ids().empty()) {
+    std::string id_query;
+    if (DocumentFilter::BuildIdQuery(Helper::PbRepeatedToVector(parameter.document_ids()),
+                                     FLAGS_document_search_id_filter_max_range_num, id_query)) {
+      filter_queries.push_back(std::move(id_query));
+    } else {
+      use_id_filter = true;
+      alive_ids.reserve(parameter.document_ids().size());
+      for (int64_t doc_id : parameter.document_ids()) {
+        alive_ids.push_back(doc_id);
+      }
+    }
   }
 
+  std::string query_string = DocumentFilter::CombineQuery(parameter.query_string(), filter_queries);
+
   std::vector<std::string> column_names;
   for (const auto& column_name : parameter.column_names()) {
     column_names.push_back(column_name);
@@ -1099,14 +1337,14 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
     DINGO_LOG(INFO) << fmt::format("[document_index.wrapper][id({})] search document in sibling document index.", Id());
     std::vector<pb::common::DocumentWithScore> results_1;
     auto status =
-        sibling_document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
+        sibling_document_index->Search(parameter.top_n(), query_string, false, 0, INT64_MAX, use_id_filter,
                                        parameter.query_unlimited(), alive_ids, column_names, results_1);
     if (!status.ok()) {
       return status;
     }
 
     std::vector<pb::common::DocumentWithScore> results_2;
-    status = document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
+    status = document_index->Search(parameter.top_n(), query_string, false, 0, INT64_MAX, use_id_filter,
                                     parameter.query_unlimited(), alive_ids, column_names, results_2);
     if (!status.ok()) {
       return status;
@@ -1128,7 +1366,7 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
         parameter.query_unlimited(), min_document_id, max_document_id);
 
     // use range filter
-    return document_index->Search(parameter.top_n(), parameter.query_string(), true, min_document_id, max_document_id,
+    return document_index->Search(parameter.top_n(), query_string, true, min_document_id, max_document_id,
                                   use_id_filter, parameter.query_unlimited(), alive_ids, column_names, results);
   }
 
@@ -1138,7 +1376,7 @@ butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range
       Id(), DocumentCodec::DebugRange(false, region_range), parameter.query_string(), parameter.top_n(),
       parameter.query_unlimited());
 
-  return document_index->Search(parameter.top_n(), parameter.query_string(), false, 0, INT64_MAX, use_id_filter,
+  return document_index->Search(parameter.top_n(), query_string, false, 0, INT64_MAX, use_id_filter,
                                 parameter.query_unlimited(), alive_ids, column_names, results);
 }
 
@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "bthread/types.h"
 #include "butil/status.h"
 #include "common/runnable.h"
@@ -32,7 +34,9 @@ namespace dingodb {
 // Document index abstract base class.
 // One region own one document index(region_id==document_index_id)
 // But one region can refer other document index when region split.
-class DocumentIndex {
+// Writes are committed and made visible to reader by a background refresh, the refresh coalesces the writes
+// within document_index_reader_refresh_interval_ms, so apply not pay tantivy commit and reader reload per batch.
+class DocumentIndex : public std::enable_shared_from_this<DocumentIndex> {
  public:
   DocumentIndex(int64_t id, const std::string& index_path,
                 const pb::common::DocumentIndexParameter& document_index_parameter,
@@ -66,6 +70,9 @@ class DocumentIndex {
 
   butil::Status Load(const std::string& path);
 
+  // wait until the writes before calling are visible to reader, for read-your-writes search.
+  butil::Status WaitReaderRefreshed(int64_t timeout_ms);
+
   butil::Status Search(uint32_t topk, const std::string& query_string, bool use_range_filter, int64_t start_id,
                        int64_t end_id, bool use_id_filter, bool query_unlimited,
                        const std::vector<uint64_t>& alive_ids,
@@ -83,6 +90,8 @@ class DocumentIndex {
 
   int64_t ApplyLogId() const;
   void SetApplyLogId(int64_t apply_log_id);
+  // apply log id of the applied writes, it is saved to meta after the writes are committed by refresh.
+  void SetPendingSaveApplyLogId(int64_t apply_log_id);
 
   pb::common::RegionEpoch Epoch() const;
   pb::common::Range Range(bool is_encode) const;
@@ -106,6 +115,20 @@ class DocumentIndex {
                                                   const pb::common::DocumentIndexParameter& param);
 
  private:
+  // caller must hold write lock.
+  butil::Status Commit();
+  // caller must hold write lock.
+  butil::Status SaveMetaFile(int64_t apply_log_id);
+  // save meta every document_index_save_log_gap logs, the writes before apply_log_id must be committed.
+  // caller must hold write lock.
+  void SaveMetaIfNeeded(int64_t apply_log_id);
+  butil::Status ReloadReader(int64_t write_seq);
+  // commit and reload reader, then wake up the waiters.
+  butil::Status Refresh();
+  // return false if can't refresh in background, caller should refresh inline.
+  bool ScheduleRefresh();
+  static void* RefreshRoutine(void* arg);
+
   // document index id
   int64_t id_;
 
@@ -114,6 +137,10 @@ class DocumentIndex {
 
   // apply max log id
   std::atomic<int64_t> apply_log_id_;
+  // apply log id waiting to be saved with the next commit
+  std::atomic<int64_t> pending_save_apply_log_id_{0};
+  // apply log id in meta file, protected by rw_lock_
+  int64_t saved_apply_log_id_{0};
 
   pb::common::RegionEpoch epoch_;
   pb::common::Range range_;
@@ -122,6 +149,16 @@ class DocumentIndex {
 
   RWLock rw_lock_;
   bool is_destroyed_{false};
+
+  // sequence of write(add/delete), committed and visible to reader.
+  std::atomic<int64_t> write_seq_{0};
+  int64_t committed_seq_{0};
+  std::atomic<int64_t> refreshed_seq_{0};
+  // only one refresh is pending, the writes before it run are coalesced.
+  std::atomic<bool> refresh_scheduled_{false};
+
+  bthread::Mutex refresh_mutex_;
+  bthread::ConditionVariable refresh_cond_;
 };
 
 using DocumentIndexPtr = std::shared_ptr<DocumentIndex>;
@@ -254,8 +291,6 @@ class DocumentIndexWrapper : public std::enable_shared_from_this<DocumentIndexWr
 
   std::atomic<int64_t> apply_log_id_{0};
 
-  std::atomic<int64_t> last_save_apply_log_id_{0};
-
   std::atomic<int32_t> pending_task_num_;
   // document index loadorbuilding num
   std::atomic<int32_t> loadorbuilding_num_;
@@ -150,6 +150,9 @@ class Engine : public std::enable_shared_from_this<Engine> {
 
       VectorIndexWrapperPtr vector_index;
       pb::common::ScalarSchema scalar_schema;
+
+      // record read stages, may be nullptr
+      TrackerPtr tracker;
     };
 
     virtual butil::Status VectorBatchSearch(std::shared_ptr<VectorReader::Context> ctx,
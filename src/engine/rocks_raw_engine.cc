@@ -904,6 +904,13 @@ rocksdb::DB* RocksRawEngine::InitDB(const std::string& db_path, rocks::ColumnFam
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
     rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(column_family);
+    // mvcc gc by compaction
+    if (cf_name == Constant::kTxnWriteCF) {
+      if (txn_gc_compaction_filter_factory_ == nullptr) {
+        txn_gc_compaction_filter_factory_ = std::make_shared<TxnGcCompactionFilterFactory>();
+      }
+      family_options.compaction_filter_factory = txn_gc_compaction_filter_factory_;
+    }
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -25,6 +25,7 @@
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
+#include "engine/txn_gc_compaction_filter.h"
 #include "proto/common.pb.h"
 #include "proto/store_internal.pb.h"
 #include "rocksdb/convenience.h"
@@ -307,6 +308,7 @@ class RocksRawEngine : public RawEngine {
   std::shared_ptr<rocksdb::DB> db_;
   rocks::ColumnFamilyMap column_families_;
   std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
+  std::shared_ptr<TxnGcCompactionFilterFactory> txn_gc_compaction_filter_factory_;
 
   RawEngine::ReaderPtr reader_;
   RawEngine::WriterPtr writer_;
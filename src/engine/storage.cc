@@ -17,6 +17,7 @@
 #include <climits>
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "document/codec.h"
 #include "engine/raft_store_engine.h"
 #include "engine/snapshot.h"
@@ -50,6 +52,16 @@ namespace dingodb {
 DECLARE_bool(region_enable_auto_split);
 DECLARE_bool(region_enable_auto_merge);
 
+// txn engine read/scan lock merge the in-memory pessimistic locks of region with lock cf.
+static void SetPessimisticLockTable(std::shared_ptr<Context> ctx, store::RegionPtr region = nullptr) {
+  if (region == nullptr) {
+    region = Server::GetInstance().GetRegion(ctx->RegionId());
+  }
+  if (region != nullptr) {
+    ctx->SetPessimisticLockTable(region->PessimisticLockTable());
+  }
+}
+
 Storage::Storage(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Engine> mono_engine,
                  mvcc::TsProviderPtr ts_provider)
     : raft_engine_(raft_engine), mono_engine_(mono_engine), ts_provider_(ts_provider) {}
@@ -1269,6 +1281,7 @@ butil::Status Storage::TxnPessimisticLock(std::shared_ptr<Context> ctx,
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnPessimisticLock mutations size : " << mutations.size()
                    << " primary_lock : " << Helper::StringToHex(primary_lock) << " start_ts : " << start_ts
@@ -1292,6 +1305,7 @@ butil::Status Storage::TxnPessimisticRollback(std::shared_ptr<Context> ctx, stor
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx, region);
 
   DINGO_LOG(DEBUG) << "TxnPessimisticRollback start_ts : " << start_ts << " for_update_ts : " << for_update_ts
                    << " keys size : " << keys.size();
@@ -1318,6 +1332,7 @@ butil::Status Storage::TxnPrewrite(std::shared_ptr<Context> ctx, store::RegionPt
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx, region);
 
   DINGO_LOG(DEBUG) << "TxnPrewrite mutations size : " << mutations.size()
                    << " primary_lock : " << Helper::StringToHex(primary_lock) << " start_ts : " << start_ts
@@ -1342,6 +1357,7 @@ butil::Status Storage::TxnCommit(std::shared_ptr<Context> ctx, store::RegionPtr
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx, region);
 
   DINGO_LOG(DEBUG) << "TxnCommit start_ts : " << start_ts << " commit_ts : " << commit_ts
                    << " keys size : " << keys.size() << ", keys[0]: " << Helper::StringToHex(keys[0]);
@@ -1362,6 +1378,7 @@ butil::Status Storage::TxnCheckTxnStatus(std::shared_ptr<Context> ctx, const std
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnCheckTxnStatus primary_key : " << Helper::StringToHex(primary_key) << " lock_ts : " << lock_ts
                    << " caller_start_ts : " << caller_start_ts << " current_ts : " << current_ts;
@@ -1382,6 +1399,7 @@ butil::Status Storage::TxnCheckSecondaryLocks(std::shared_ptr<Context> ctx, stor
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx, region);
 
   DINGO_LOG(DEBUG) << "TxnCheckSecondaryLocks start_ts : " << start_ts << " keys size : " << keys.size();
 
@@ -1401,6 +1419,7 @@ butil::Status Storage::TxnResolveLock(std::shared_ptr<Context> ctx, int64_t star
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnResolveLock start_ts : " << start_ts << " commit_ts : " << commit_ts
                    << " keys size : " << keys.size();
@@ -1421,6 +1440,7 @@ butil::Status Storage::TxnBatchRollback(std::shared_ptr<Context> ctx, int64_t st
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnBatchRollback keys size : " << keys.size() << ", start_ts: " << start_ts;
 
@@ -1443,6 +1463,7 @@ butil::Status Storage::TxnScanLock(std::shared_ptr<Context> ctx, const pb::strea
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   // after validate leader
   auto stream_meta = req_stream_meta;
@@ -1478,6 +1499,7 @@ butil::Status Storage::TxnHeartBeat(std::shared_ptr<Context> ctx, const std::str
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnHeartBeat primary_lock : " << Helper::StringToHex(primary_lock) << " start_ts : " << start_ts
                    << " advise_lock_ttl : " << advise_lock_ttl;
@@ -1497,6 +1519,7 @@ butil::Status Storage::TxnGc(std::shared_ptr<Context> ctx, int64_t safe_point_ts
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
+  SetPessimisticLockTable(ctx);
 
   DINGO_LOG(DEBUG) << "TxnGc safe_point_ts : " << safe_point_ts;
 
@@ -1703,6 +1726,31 @@ butil::Status Storage::BackupMeta(std::shared_ptr<Context> ctx, store::RegionPtr
                                      storage_backend, compression_type, compression_level, response);
 }
 
+butil::Status Storage::RestoreData(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                   const pb::common::StorageBackend& storage_backend,
+                                   const pb::common::BackupDataFileValueSstMetaGroup& sst_metas) {
+  // the ingest copy the staged files into the engine, so the staged files are useless when the write return.
+  DEFER(TxnEngineHelper::CleanRestoreStagingFiles(storage_backend.local().path(), region->Id()));
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+  auto status = TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, sst_metas, cf_files);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (cf_files.empty()) {
+    return butil::Status::OK();
+  }
+
+  if (BAIDU_LIKELY(ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE)) {
+    return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(cf_files));
+  } else if (ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_MONO_STORE) {
+    return mono_engine_->Write(ctx, WriteDataBuilder::BuildWrite(cf_files));
+  } else {
+    return butil::Status(pb::error::EENGINE_NOT_FOUND, "engine not found");
+  }
+}
+
 butil::Status Storage::ControlConfig(std::shared_ptr<Context> /*ctx*/,
                                      const std::vector<pb::common::ControlConfigVariable>& variables,
                                      dingodb::pb::store::ControlConfigResponse* response) {
@@ -244,6 +244,10 @@ class Storage {
                            const pb::common::CompressionType& compression_type, int32_t compression_level,
                            dingodb::pb::store::BackupMetaResponse* response);
 
+  butil::Status RestoreData(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                            const pb::common::StorageBackend& storage_backend,
+                            const pb::common::BackupDataFileValueSstMetaGroup& sst_metas);
+
   static butil::Status ControlConfig(std::shared_ptr<Context> ctx,
                               const std::vector<pb::common::ControlConfigVariable>& variables,
                               dingodb::pb::store::ControlConfigResponse* response);
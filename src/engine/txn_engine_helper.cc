@@ -23,6 +23,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -40,6 +41,7 @@
 #include "document/codec.h"
 #include "engine/gc_safe_point.h"
 #include "engine/rocks_raw_engine.h"
+#include "engine/txn_lock_wait_manager.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "glog/logging.h"
@@ -67,6 +69,7 @@ DEFINE_int64(gc_delete_batch_count, 32768, "gc delete batch count");
 DEFINE_bool(dingo_log_switch_txn_detail, false, "txn detail log");
 DEFINE_bool(dingo_log_switch_txn_gc_detail, false, "txn gc detail log");
 DEFINE_bool(dingo_log_switch_backup_detail, false, "backup detail log");
+DEFINE_int64(backup_sst_file_max_size, 128 * 1024 * 1024, "backup sst file max size, roll to next file when exceed");
 
 DECLARE_int64(stream_message_max_bytes);
 DECLARE_int64(stream_message_max_limit_size);
@@ -110,6 +113,13 @@ butil::Status TxnReader::GetLockInfo(const std::string &key, pb::store::LockInfo
     return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
   }
 
+  if (pessimistic_lock_table_ != nullptr && pessimistic_lock_table_->Get(key, lock_info)) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is locked in memory, lock_info "
+        << lock_info.ShortDebugString();
+    return butil::Status::OK();
+  }
+
   std::string lock_value;
   auto status =
       reader_->KvGet(Constant::kTxnLockCF, snapshot_, mvcc::Codec::EncodeKey(key, Constant::kLockVer), lock_value);
@@ -964,10 +974,12 @@ using TxnScanLockStreamStatePtr = std::shared_ptr<TxnScanLockStreamState>;
 
 class TxnScanLockStreamState : public StreamState {
  public:
-  TxnScanLockStreamState(IteratorPtr iter) : iter(iter) {}
+  TxnScanLockStreamState(IteratorPtr iter, std::vector<pb::store::LockInfo> &&memory_lock_infos)
+      : iter(iter), memory_lock_infos(std::move(memory_lock_infos)) {}
   ~TxnScanLockStreamState() override = default;
 
-  static TxnScanLockStreamStatePtr New(RawEnginePtr engine, const pb::common::Range &range) {
+  static TxnScanLockStreamStatePtr New(RawEnginePtr engine, PessimisticLockTablePtr pessimistic_lock_table,
+                                       const pb::common::Range &range) {
     IteratorOptions iter_options;
     iter_options.lower_bound = mvcc::Codec::EncodeKey(range.start_key(), Constant::kLockVer);
     iter_options.upper_bound = mvcc::Codec::EncodeKey(range.end_key(), Constant::kLockVer);
@@ -975,13 +987,23 @@ class TxnScanLockStreamState : public StreamState {
     auto iter = engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
     CHECK(iter != nullptr) << "[txn] GetLockInfo NewIterator failed, range: " << Helper::RangeToString(range);
     iter->Seek(iter_options.lower_bound);
-    return std::make_shared<TxnScanLockStreamState>(iter);
+
+    std::vector<pb::store::LockInfo> memory_lock_infos;
+    if (pessimistic_lock_table != nullptr) {
+      memory_lock_infos = pessimistic_lock_table->GetLocks(range.start_key(), range.end_key());
+    }
+
+    return std::make_shared<TxnScanLockStreamState>(iter, std::move(memory_lock_infos));
   }
 
   IteratorPtr iter;
+  // in-memory pessimistic locks are taken at stream start, ordered by key, merged with lock cf.
+  std::vector<pb::store::LockInfo> memory_lock_infos;
+  size_t memory_pos{0};
 };
 
-butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engine, int64_t min_lock_ts,
+butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engine,
+                                            PessimisticLockTablePtr pessimistic_lock_table, int64_t min_lock_ts,
                                             int64_t max_lock_ts, const pb::common::Range &range, int64_t limit,
                                             std::vector<pb::store::LockInfo> &lock_infos, bool &has_more,
                                             std::string &end_scan_key) {
@@ -991,44 +1013,66 @@ butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engin
       << fmt::format("[txn][{}] ScanLockInfo lock_ts: [{},{}] range: {} limit: {}.", stream->StreamId(), min_lock_ts,
                      max_lock_ts, Helper::RangeToString(range), limit);
 
-  auto stream_state = std::dynamic_pointer_cast<TxnScanLockStreamState>(
-      stream->GetOrNewStreamState([&]() -> StreamStatePtr { return TxnScanLockStreamState::New(engine, range); }));
+  auto stream_state =
+      std::dynamic_pointer_cast<TxnScanLockStreamState>(stream->GetOrNewStreamState([&]() -> StreamStatePtr {
+        return TxnScanLockStreamState::New(engine, pessimistic_lock_table, range);
+      }));
   IteratorPtr iter = stream_state->iter;
   CHECK(iter != nullptr) << fmt::format("[txn][{}] Scan stream_state->iter is nullptr.", stream->StreamId());
+  auto &memory_lock_infos = stream_state->memory_lock_infos;
+  auto &memory_pos = stream_state->memory_pos;
 
   auto stop_checker = [&stream](size_t size, size_t bytes) -> bool { return stream->Check(size, bytes); };
   size_t bytes = 0;
-  while (iter->Valid()) {
-    auto lock_value = iter->Value();
-    CHECK(lock_value.length() > 8) << fmt::format(
-        "[txn][{}] invalid lock_value, key: {} min_lock_ts: {} lock_value is less than 8 bytes: {}.",
-        stream->StreamId(), Helper::StringToHex(iter->Key()), min_lock_ts, Helper::StringToHex(lock_value));
-
+  while (iter->Valid() || memory_pos < memory_lock_infos.size()) {
     pb::store::LockInfo lock_info;
-    auto ret = lock_info.ParseFromArray(lock_value.data(), lock_value.size());
-    CHECK(ret) << fmt::format("[txn][{}] parse lock info failed, key: {} lock_value(hex): {}.", stream->StreamId(),
-                              Helper::StringToHex(iter->Key()), Helper::StringToHex(lock_value));
 
-    end_scan_key = lock_info.key();
+    // merge by key, a key is never locked both in memory and lock cf, prefer memory if it happens.
+    std::string memory_lock_key = memory_pos < memory_lock_infos.size()
+                                      ? mvcc::Codec::EncodeKey(memory_lock_infos[memory_pos].key(), Constant::kLockVer)
+                                      : std::string();
+    if (!memory_lock_key.empty() && (!iter->Valid() || memory_lock_key <= iter->Key())) {
+      if (iter->Valid() && memory_lock_key == iter->Key()) {
+        iter->Next();
+      }
+      lock_info = memory_lock_infos[memory_pos++];
 
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-        << fmt::format("[txn][{}] get lock_info lock_ts: {} lock_info: {} iter->key: {} lock_key: {}.",
-                       stream->StreamId(), lock_info.lock_ts(), lock_info.ShortDebugString(),
-                       Helper::StringToHex(iter->Key()), Helper::StringToHex(lock_info.key()));
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+          << fmt::format("[txn][{}] get in-memory lock_info lock_ts: {} lock_info: {}.", stream->StreamId(),
+                         lock_info.lock_ts(), lock_info.ShortDebugString());
+    } else {
+      auto lock_value = iter->Value();
+      CHECK(lock_value.length() > 8) << fmt::format(
+          "[txn][{}] invalid lock_value, key: {} min_lock_ts: {} lock_value is less than 8 bytes: {}.",
+          stream->StreamId(), Helper::StringToHex(iter->Key()), min_lock_ts, Helper::StringToHex(lock_value));
+
+      auto ret = lock_info.ParseFromArray(lock_value.data(), lock_value.size());
+      CHECK(ret) << fmt::format("[txn][{}] parse lock info failed, key: {} lock_value(hex): {}.", stream->StreamId(),
+                                Helper::StringToHex(iter->Key()), Helper::StringToHex(lock_value));
+
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+          << fmt::format("[txn][{}] get lock_info lock_ts: {} lock_info: {} iter->key: {} lock_key: {}.",
+                         stream->StreamId(), lock_info.lock_ts(), lock_info.ShortDebugString(),
+                         Helper::StringToHex(iter->Key()), Helper::StringToHex(lock_info.key()));
+
+      // if lock is not exist, nothing to do
+      if (lock_info.lock_ts() == 0) {
+        DINGO_LOG(WARNING) << fmt::format("[txn][{}] txn_not_found with lock_info empty, iter->key: {}.",
+                                          stream->StreamId(), Helper::StringToHex(iter->Key()));
+        iter->Next();
+        continue;
+      }
 
-    // if lock is not exist, nothing to do
-    if (lock_info.lock_ts() == 0) {
-      DINGO_LOG(WARNING) << fmt::format("[txn][{}] txn_not_found with lock_info empty, iter->key: {}.",
-                                        stream->StreamId(), Helper::StringToHex(iter->Key()));
       iter->Next();
-      continue;
     }
 
+    end_scan_key = lock_info.key();
+
     if (lock_info.lock_ts() < min_lock_ts || lock_info.lock_ts() >= max_lock_ts) {
       DINGO_LOG(WARNING) << fmt::format(
-          "[txn][{}] txn_not_found with lock_info.lock_ts not in range, iter->key:  lock_ts: [{},{}] lock_info: {}.",
-          stream->StreamId(), Helper::StringToHex(iter->Key()), min_lock_ts, max_lock_ts, lock_info.ShortDebugString());
-      iter->Next();
+          "[txn][{}] txn_not_found with lock_info.lock_ts not in range, lock_key: {} lock_ts: [{},{}] lock_info: {}.",
+          stream->StreamId(), Helper::StringToHex(lock_info.key()), min_lock_ts, max_lock_ts,
+          lock_info.ShortDebugString());
       continue;
     }
 
@@ -1048,8 +1092,6 @@ butil::Status TxnEngineHelper::ScanLockInfo(StreamPtr stream, RawEnginePtr engin
           FLAGS_stream_message_max_bytes);
       break;
     }
-
-    iter->Next();
   }
 
   return butil::Status::OK();
@@ -1061,7 +1103,7 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
                                         int64_t start_ts, const std::vector<std::string> &keys,
                                         const std::set<int64_t> &resolved_locks,
                                         pb::store::TxnResultInfo &txn_result_info,
-                                        std::vector<pb::common::KeyValue> &kvs) {
+                                        std::vector<pb::common::KeyValue> &kvs, TrackerPtr tracker) {
   BvarLatencyGuard bvar_guard(&g_txn_batch_get_latency);
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1118,6 +1160,7 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     pb::common::KeyValue kv;
     kv.set_key(key);
 
+    int64_t start_time = Helper::TimestampNs();
     pb::store::LockInfo lock_info;
     auto ret = txn_reader.GetLockInfo(key, lock_info);
     if (!ret.ok()) {
@@ -1126,6 +1169,9 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     }
 
     auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, resolved_locks, txn_result_info);
+    if (tracker) {
+      tracker->AddLockCheckTime(Helper::TimestampNs() - start_time);
+    }
     if (is_lock_conflict) {
       DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
@@ -1156,7 +1202,11 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
         << ", iter_options.upper_bound: " << Helper::StringToHex(iter_options.upper_bound);
 
     // check isolation level and return value
+    start_time = Helper::TimestampNs();
     write_iter->Seek(iter_options.lower_bound);
+    if (tracker) {
+      tracker->AddIteratorSeekTime(Helper::TimestampNs() - start_time);
+    }
     while (write_iter->Valid() && write_iter->Key() < iter_options.upper_bound) {
       if (write_iter->Key().length() <= 8) {
         DINGO_LOG(ERROR) << ", invalid write_key, key: " << Helper::StringToHex(write_iter->Key())
@@ -1274,7 +1324,7 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
                                     const std::set<int64_t> &resolved_locks, bool disable_coprocessor,
                                     const pb::common::CoprocessorV2 &coprocessor,
                                     pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
-                                    bool &has_more, std::string &end_scan_key) {
+                                    bool &has_more, std::string &end_scan_key, TrackerPtr tracker) {
   BvarLatencyGuard bvar_guard(&g_txn_scan_latency);
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
@@ -1297,11 +1347,15 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
   // get or new TxnIterator.
   auto stream_state =
       std::dynamic_pointer_cast<TxnScanStreamState>(stream->GetOrNewStreamState([&]() -> StreamStatePtr {
+        int64_t start_time = Helper::TimestampNs();
         auto iter = std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks);
         auto ret = iter->Init();
         CHECK(ret.ok()) << fmt::format("[txn][{}] Scan init txn_iter failed, start_ts: {} range: {}  status: {}.",
                                        stream->StreamId(), start_ts, Helper::RangeToString(range), ret.error_str());
         iter->Seek(range.start_key());
+        if (tracker) {
+          tracker->AddIteratorSeekTime(Helper::TimestampNs() - start_time);
+        }
         return TxnScanStreamState::New(iter);
       }));
   TxnIteratorPtr iter = stream_state->iter;
@@ -1320,7 +1374,11 @@ butil::Status TxnEngineHelper::Scan(StreamPtr stream, RawEnginePtr raw_engine,
       return status;
     }
 
+    int64_t start_time = Helper::TimestampNs();
     status = txn_coprocessor->Execute(iter, key_only, is_reverse, stop_checker, txn_result_info, kvs, has_more);
+    if (tracker) {
+      tracker->AddCoprocessorTime(Helper::TimestampNs() - start_time);
+    }
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("[txn][{}] Scan coprocessor::Execute failed, error: {}.", stream->StreamId(),
                                       status.error_cstr());
@@ -1393,6 +1451,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   }
 
   std::vector<pb::common::KeyValue> kv_puts_lock;
+  std::vector<pb::store::LockInfo> lock_infos_put;
   auto *response = dynamic_cast<pb::store::TxnPessimisticLockResponse *>(ctx->Response());
   if (response == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticLock, start_ts: {}", ctx->RegionId(), start_ts)
@@ -1401,7 +1460,10 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   }
 
   auto *error = response->mutable_error();
-  TxnReader txn_reader(raw_engine);
+  auto pessimistic_lock_table = ctx->PessimisticLockTable();
+  // a key is never locked both in memory and lock cf, so lock in lock cf is updated by raft write.
+  bool has_lock_in_cf = false;
+  TxnReader txn_reader(raw_engine, pessimistic_lock_table);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticLock, start_ts: {}", ctx->RegionId(), start_ts)
@@ -1475,6 +1537,11 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
           continue;
         } else if (lock_info.for_update_ts() < for_update_ts) {
           // this is a same pessimistic lock with a new for_update_ts, we need to update the lock
+          pb::store::LockInfo mem_lock_info;
+          if (pessimistic_lock_table == nullptr || !pessimistic_lock_table->Get(mutation.key(), mem_lock_info)) {
+            has_lock_in_cf = true;
+          }
+
           pb::common::KeyValue kv;
           kv.set_key(mvcc::Codec::EncodeKey(mutation.key(), Constant::kLockVer));
 
@@ -1487,6 +1554,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
           lock_info.set_extra_data(mutation.value());
           kv.set_value(lock_info.SerializeAsString());
           kv_puts_lock.push_back(kv);
+          lock_infos_put.push_back(lock_info);
 
           if (return_values) {
             pb::store::WriteInfo write_info;
@@ -1592,6 +1660,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
         kv.set_value(lock_info.SerializeAsString());
 
         kv_puts_lock.push_back(kv);
+        lock_infos_put.push_back(lock_info);
         if (return_values) {
           auto ret5 = txn_reader.GetOldValue(mutation.key(), start_ts, true, write_info, kvs);
           if (!ret5.ok()) {
@@ -1628,6 +1697,14 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
     return butil::Status::OK();
   }
 
+  // hold locks in leader memory to save raft write, fall back to lock cf when table is inactive or full.
+  if (pessimistic_lock_table != nullptr && !has_lock_in_cf && pessimistic_lock_table->BatchInsert(lock_infos_put)) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn][region({})] PessimisticLock hold in memory,", ctx->RegionId())
+        << ", lock_count: " << lock_infos_put.size() << ", start_ts: " << start_ts;
+    return butil::Status::OK();
+  }
+
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
@@ -1749,7 +1826,9 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
 
   auto *error = response->mutable_error();
 
-  TxnReader txn_reader(raw_engine);
+  auto pessimistic_lock_table = ctx->PessimisticLockTable();
+  std::vector<std::string> keys_in_memory;
+  TxnReader txn_reader(raw_engine, pessimistic_lock_table);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticRollback, start_ts: {}", region->Id(), start_ts)
@@ -1795,6 +1874,12 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
               << fmt::format("[txn][region({})] PessimisticRollback,", region->Id())
               << ", key: " << Helper::StringToHex(key)
               << " is locked by self, can do rollback, lock_info: " << lock_info.ShortDebugString();
+          pb::store::LockInfo mem_lock_info;
+          if (pessimistic_lock_table != nullptr && pessimistic_lock_table->Get(key, mem_lock_info)) {
+            // lock only in memory, no need raft write
+            keys_in_memory.push_back(key);
+            continue;
+          }
           kv_dels_lock.push_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
           continue;
         } else {
@@ -1837,6 +1922,13 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
     return butil::Status::OK();
   }
 
+  if (!keys_in_memory.empty()) {
+    for (const auto &key : keys_in_memory) {
+      pessimistic_lock_table->Erase(key);
+    }
+    TxnLockWaitManager::GetInstance().WakeUp(keys_in_memory);
+  }
+
   if (kv_dels_lock.empty()) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << fmt::format("[txn][region({})] PessimisticRollback,", region->Id())
@@ -1861,6 +1953,10 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
     return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
   }
 
+  if (ret.ok()) {
+    TxnLockWaitManager::GetInstance().WakeUp(keys);
+  }
+
   return ret;
 }
 
@@ -2421,7 +2517,7 @@ butil::Status TxnEngineHelper::Prewrite(
   }
   auto *error = response->mutable_error();
 
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
@@ -2786,7 +2882,7 @@ butil::Status TxnEngineHelper::Commit(RawEnginePtr raw_engine, std::shared_ptr<E
   }
 
   // create reader and writer
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Commit", region->Id())
@@ -3141,6 +3237,15 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
     return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
   }
 
+  if (ret.ok()) {
+    std::vector<std::string> keys;
+    keys.reserve(lock_infos.size());
+    for (const auto &lock_info : lock_infos) {
+      keys.push_back(lock_info.key());
+    }
+    TxnLockWaitManager::GetInstance().WakeUp(keys);
+  }
+
   return ret;
 }
 
@@ -3178,7 +3283,7 @@ butil::Status TxnEngineHelper::CheckTxnStatus(RawEnginePtr raw_engine, std::shar
   }
 
   // create reader and writer
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] CheckTxnStatus", region->Id()) << ", init txn_reader failed";
@@ -3413,7 +3518,7 @@ butil::Status TxnEngineHelper::BatchRollback(RawEnginePtr raw_engine, std::share
   }
 
   // create reader and writer
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] BatchRollback", region->Id())
@@ -3610,6 +3715,11 @@ butil::Status TxnEngineHelper::DoRollback(RawEnginePtr /*raw_engine*/, std::shar
     return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
   }
 
+  if (ret.ok()) {
+    TxnLockWaitManager::GetInstance().WakeUp(keys_to_rollback_with_data);
+    TxnLockWaitManager::GetInstance().WakeUp(keys_to_rollback_without_data);
+  }
+
   return ret;
 }
 
@@ -3635,7 +3745,7 @@ butil::Status TxnEngineHelper::TxnCheckSecondaryLocks(RawEnginePtr raw_engine, s
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "resolve keys.size() > FLAGS_max_resolve_count");
   }
 
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] CheckSecondaryLocks", region->Id())
@@ -3767,7 +3877,7 @@ butil::Status TxnEngineHelper::ResolveLock(RawEnginePtr raw_engine, std::shared_
   // scan lock_cf to search if transaction with start_ts is exists, if exists, do rollback or commit
   // if not exists, do nothing
   // create reader and writer
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] ResolveLock", region->Id())
@@ -3858,8 +3968,8 @@ butil::Status TxnEngineHelper::ResolveLock(RawEnginePtr raw_engine, std::shared_
     std::vector<pb::store::LockInfo> tmp_lock_infos;
     bool has_more = false;
     std::string end_key{};
-    auto ret = ScanLockInfo(stream, raw_engine, start_ts, start_ts + 1, region->Range(false), 0, tmp_lock_infos,
-                            has_more, end_key);
+    auto ret = ScanLockInfo(stream, raw_engine, ctx->PessimisticLockTable(), start_ts, start_ts + 1,
+                            region->Range(false), 0, tmp_lock_infos, has_more, end_key);
     if (!ret.ok()) {
       DINGO_LOG(FATAL) << fmt::format("[txn][region({})] ResolveLock, ", region->Id())
                        << ", get lock info failed, start_ts: " << start_ts << ", status: " << ret.error_str();
@@ -3957,7 +4067,7 @@ butil::Status TxnEngineHelper::HeartBeat(RawEnginePtr raw_engine, std::shared_pt
   auto *error = response->mutable_error();
   auto *txn_result = response->mutable_txn_result();
 
-  TxnReader txn_reader(raw_engine);
+  TxnReader txn_reader(raw_engine, ctx->PessimisticLockTable());
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] HeartBeat", region->Id())
@@ -4716,6 +4826,7 @@ butil::Status TxnEngineHelper::DoGcForDocumentNonTxn(RawEnginePtr raw_engine, st
 bvar::LatencyRecorder g_txn_check_lock_for_gc_latency("dingo_txn_check_lock_for_gc");
 
 butil::Status TxnEngineHelper::CheckLockForTxnGc(RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot,
+                                                 PessimisticLockTablePtr pessimistic_lock_table,
                                                  const std::string &start_key, const std::string &end_key,
                                                  int64_t safe_point_ts, int64_t region_id, int64_t tenant_id,
                                                  pb::common::RegionType type) {
@@ -4802,6 +4913,23 @@ butil::Status TxnEngineHelper::CheckLockForTxnGc(RawEngine::ReaderPtr reader, st
     total_count++;
   }
 
+  // in-memory pessimistic locks are not in lock cf.
+  if (pessimistic_lock_table != nullptr) {
+    for (const auto &lock_info : pessimistic_lock_table->GetLocks(start_key, end_key)) {
+      if (lock_info.lock_ts() <= safe_point_ts) {
+        DINGO_LOG(ERROR) << fmt::format(
+            "[txn_gc][lock][tenant({})][region({})][type({})][txn] find in-memory lock error. exist lock_ts : {} <= "
+            "safe_point_ts : {}, lock_key: {} lock_info : {}",
+            tenant_id, region_id, pb::common::RegionType_Name(type), lock_info.lock_ts(), safe_point_ts,
+            Helper::StringToHex(lock_info.key()), lock_info.ShortDebugString());
+        lambda_add_error_statics_function();
+        continue;
+      }
+
+      total_count++;
+    }
+  }
+
   std::string s = fmt::format(
       "[txn_gc][lock][tenant({})][region({})][type({})][txn] scan lock column family. start_key : {} end_key : {} "
       "safe_point_ts : {} total : {} success : {} failed : {}",
@@ -5010,8 +5138,8 @@ butil::Status TxnEngineHelper::DoFinalWorkForTxnGc(
   lock_end_key = write_key;
   // optimization . already checked Ignore.
   if (lock_start_key != last_lock_start_key && lock_end_key != last_lock_end_key) {
-    status = CheckLockForTxnGc(reader, snapshot, lock_start_key, lock_end_key, safe_point_ts, ctx->RegionId(),
-                               tenant_id, type);
+    status = CheckLockForTxnGc(reader, snapshot, ctx->PessimisticLockTable(), lock_start_key, lock_end_key,
+                               safe_point_ts, ctx->RegionId(), tenant_id, type);
     if (!status.ok()) {
       std::string s = fmt::format(
           "[txn_gc][lock][tenant({})][region({})][type({})][txn] CheckLockForTxnGc failed. lock_start_key : {} "
@@ -5327,6 +5455,7 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
     ctx->SetIsolationLevel(::dingodb::pb::store::IsolationLevel::ReadCommitted);
     ctx->SetRawEngineType(region_ptr->GetRawEngineType());
     ctx->SetStoreEngineType(region_ptr->GetStoreEngineType());
+    ctx->SetPessimisticLockTable(region_ptr->PessimisticLockTable());
 
     auto writer = storage->GetEngineTxnWriter(ctx->StoreEngineType(), ctx->RawEngineType());
 
@@ -5349,6 +5478,134 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
 }
 
 // backup & restore
+BackupSstFileWriter::BackupSstFileWriter(int64_t region_id, const std::string &dir_path, const std::string &dir_name,
+                                         const std::string &file_prefix, const std::string &cf,
+                                         pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group)
+    : region_id_(region_id),
+      dir_path_(dir_path),
+      dir_name_(dir_name),
+      file_prefix_(file_prefix),
+      cf_(cf),
+      sst_meta_group_(sst_meta_group) {}
+
+BackupSstFileWriter::~BackupSstFileWriter() {
+  // not finished, remove the partial file.
+  if (sst_writer_ != nullptr) {
+    sst_writer_.reset();
+    std::error_code ec;
+    std::filesystem::remove(dir_path_ + "/" + file_name_, ec);
+  }
+}
+
+butil::Status BackupSstFileWriter::Put(std::string_view key, std::string_view value) {
+  if (sst_writer_ == nullptr) {
+    auto status = OpenNextFile();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  auto rocks_status =
+      sst_writer_->Put(rocksdb::Slice(key.data(), key.size()), rocksdb::Slice(value.data(), value.size()));
+  if (!rocks_status.ok()) {
+    std::string s = fmt::format("[backupdata][region({})][cf({})] put sst failed, file : {} key : {} error : {}",
+                                region_id_, cf_, file_name_, Helper::StringToHex(key), rocks_status.ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  ++count_;
+
+  // roll to the next file, so a single region never produce a huge sst file.
+  if (static_cast<int64_t>(sst_writer_->FileSize()) >= FLAGS_backup_sst_file_max_size) {
+    return FinishCurrentFile();
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status BackupSstFileWriter::Finish() {
+  if (sst_writer_ != nullptr) {
+    return FinishCurrentFile();
+  }
+
+  if (count_ == 0) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_backup_detail)
+        << fmt::format("[backupdata][region({})][cf({})] empty. ignore.", region_id_, cf_);
+  }
+
+  return butil::Status::OK();
+}
+
+void BackupSstFileWriter::Discard() {
+  std::error_code ec;
+  if (sst_writer_ != nullptr) {
+    sst_writer_.reset();
+    std::filesystem::remove(dir_path_ + "/" + file_name_, ec);
+  }
+
+  for (const auto &file_name : file_names_) {
+    std::filesystem::remove(dir_path_ + "/" + file_name, ec);
+  }
+  file_names_.clear();
+}
+
+butil::Status BackupSstFileWriter::OpenNextFile() {
+  file_name_ = (file_index_ == 0) ? fmt::format("{}_{}.sst", file_prefix_, cf_)
+                                  : fmt::format("{}_{}_{}.sst", file_prefix_, cf_, file_index_);
+
+  sst_writer_ = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(), options_, nullptr, true);
+  auto rocks_status = sst_writer_->Open(dir_path_ + "/" + file_name_);
+  if (!rocks_status.ok()) {
+    sst_writer_.reset();
+    std::string s = fmt::format("[backupdata][region({})][cf({})] open sst failed, file : {} error : {}", region_id_,
+                                cf_, file_name_, rocks_status.ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status BackupSstFileWriter::FinishCurrentFile() {
+  std::string file_path = dir_path_ + "/" + file_name_;
+
+  rocksdb::ExternalSstFileInfo file_info;
+  auto rocks_status = sst_writer_->Finish(&file_info);
+  sst_writer_.reset();
+  file_names_.push_back(file_name_);
+  if (!rocks_status.ok()) {
+    std::string s = fmt::format("[backupdata][region({})][cf({})] finish sst failed, file : {} error : {}", region_id_,
+                                cf_, file_name_, rocks_status.ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  // the file was just written, so the checksum is calculated from page cache.
+  std::string hash_code;
+  auto status = Helper::CalSha1CodeWithFileEx(file_path, hash_code);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  pb::common::BackupDataFileValueSstMeta *sst_meta = sst_meta_group_->add_backup_data_file_value_sst_metas();
+  sst_meta->set_cf(cf_);
+  sst_meta->set_region_id(region_id_);
+  sst_meta->set_dir_name(dir_name_);
+  sst_meta->set_file_size(file_info.file_size);
+  sst_meta->set_encryption(hash_code);
+  sst_meta->set_file_name(file_name_);
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_backup_detail) << fmt::format(
+      "[backupdata][region({})][cf({})] finish sst file : {} file_size : {} num_entries : {}", region_id_, cf_,
+      file_name_, file_info.file_size, file_info.num_entries);
+
+  ++file_index_;
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                           store::RegionPtr region, const pb::common::RegionType &region_type,
                                           std::string backup_ts, int64_t backup_tso, const std::string &storage_path,
@@ -5371,39 +5628,13 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
 
   bool is_txn = region->IsTxn();
 
-  // txn
-  std::map<std::string, std::string> kv_data;
-  std::map<std::string, std::string> kv_write;
-
-  // non txn
-  std::map<std::string, std::string> kv_default;
-  std::map<std::string, std::string> kv_scalar;
-  std::map<std::string, std::string> kv_table;
-  std::map<std::string, std::string> kv_scalar_speedup;
-
   std::string region_type_name;
-
-  if (region_type == pb::common::RegionType::STORE_REGION && is_txn) {
-    region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::STORE_REGION && !is_txn) {
+  if (region_type == pb::common::RegionType::STORE_REGION) {
     region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                        kv_table, kv_scalar_speedup);
-  } else if (region_type == pb::common::RegionType::INDEX_REGION && is_txn) {
+  } else if (region_type == pb::common::RegionType::INDEX_REGION) {
     region_type_name = Constant::kIndexRegionName;
-    status = DoBackupDataForIndexTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::INDEX_REGION && !is_txn) {
-    region_type_name = Constant::kIndexRegionName;
-    status = DoBackupDataForIndexNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                        kv_table, kv_scalar_speedup);
-  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && is_txn) {
-    region_type_name = Constant::kDocumentRegionName;
-    status = DoBackupDataForDocumentTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && !is_txn) {
+  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION) {
     region_type_name = Constant::kDocumentRegionName;
-    status = DoBackupDataForDocumentNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                           kv_table, kv_scalar_speedup);
   } else {
     std::string s = fmt::format("[backupdata][region({})][region_type({})] BackupData invalid region type and txn",
                                 region->Id(), pb::common::RegionType_Name(region_type), (is_txn ? "true" : "false"));
@@ -5411,11 +5642,6 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
     return butil::Status(pb::error::Errno::ENOT_SUPPORT, s);
   }
 
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
-
   std::string hash_code;
 
   Helper::CalSha1CodeWithString(region->Range().start_key(), hash_code);
@@ -5426,18 +5652,68 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
   std::string backup_file_prefix =
       fmt::format("{}_{}_{}_{}", region->Id(), region->EpochToString(), hash_code, second_timestamp);
 
-  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
-
   int64_t instance_id = Server::GetInstance().Id();
+  std::string dir_name = fmt::format("{}-{}", region_type_name, instance_id);
+  std::string dir_path = storage_backend.local().path() + "/" + dir_name;
+
+  status = PrepareBackupDir(region, region_type, dir_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
 
   if (is_txn) {
-    status = WriteSstFileForTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                                kv_data, kv_write, sst_meta_group);
+    // txn
+    BackupSstFileWriter write_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kTxnWriteCF,
+                                     sst_meta_group);
+    BackupSstFileWriter data_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kTxnDataCF,
+                                    sst_meta_group);
+
+    if (region_type == pb::common::RegionType::STORE_REGION) {
+      status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+    } else if (region_type == pb::common::RegionType::INDEX_REGION) {
+      status = DoBackupDataForIndexTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+    } else {
+      status = DoBackupDataForDocumentTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+    }
+    if (status.ok()) {
+      status = FinishSstFileWriters({&write_writer, &data_writer});
+    }
+    if (!status.ok()) {
+      DiscardSstFileWriters({&write_writer, &data_writer}, sst_meta_group);
+    }
 
   } else {
-    status =
-        WriteSstFileForNonTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                              kv_default, kv_scalar, kv_table, kv_scalar_speedup, sst_meta_group);
+    // non txn
+    BackupSstFileWriter default_writer(
+        region->Id(), dir_path, dir_name, backup_file_prefix,
+        (region_type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF),
+        sst_meta_group);
+    BackupSstFileWriter scalar_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kVectorScalarCF,
+                                      sst_meta_group);
+    BackupSstFileWriter table_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kVectorTableCF,
+                                     sst_meta_group);
+    BackupSstFileWriter scalar_speedup_writer(region->Id(), dir_path, dir_name, backup_file_prefix,
+                                              Constant::kVectorScalarKeySpeedUpCF, sst_meta_group);
+
+    if (region_type == pb::common::RegionType::STORE_REGION) {
+      status = DoBackupDataForStoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                          scalar_writer, table_writer, scalar_speedup_writer);
+    } else if (region_type == pb::common::RegionType::INDEX_REGION) {
+      status = DoBackupDataForIndexNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                          scalar_writer, table_writer, scalar_speedup_writer);
+    } else {
+      status = DoBackupDataForDocumentNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                             scalar_writer, table_writer, scalar_speedup_writer);
+    }
+    if (status.ok()) {
+      status = FinishSstFileWriters({&default_writer, &scalar_writer, &table_writer, &scalar_speedup_writer});
+    }
+    if (!status.ok()) {
+      DiscardSstFileWriters({&default_writer, &scalar_writer, &table_writer, &scalar_speedup_writer}, sst_meta_group);
+    }
   }
 
   if (!status.ok()) {
@@ -5450,8 +5726,8 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
 
 butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                    store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                   int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                                   std::map<std::string, std::string> &kv_write) {
+                                                   int64_t backup_tso, BackupSstFileWriter &data_writer,
+                                                   BackupSstFileWriter &write_writer) {
   int64_t start_time_ms = Helper::TimestampMs();
   int64_t end_time_ms = 0;
   int64_t total_iter_count = 0;
@@ -5542,7 +5818,7 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
       case pb::store::Delete: {
         butil::Status status =
             DoWriteDataAndCheckForTxn(reader, snapshot, region_id, region_type, write_info, write_iter_key,
-                                      write_iter_value, write_key, start_ts, write_ts, kv_data, kv_write);
+                                      write_iter_value, write_key, start_ts, write_ts, data_writer, write_writer);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << status.error_cstr();
           return status;
@@ -5585,8 +5861,8 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
       "[backupdata][region({})][type({})][txn] end region start_key: {} end_key: {} backup_tso "
       ": {} time consuming : {} ms total_data_count : {} total_write_count : {}  total_iter_count : {} ",
       region_id, pb::common::RegionType_Name(region_type), Helper::StringToHex(region_start_key),
-      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), kv_data.size(), kv_write.size(),
-      total_iter_count);
+      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), data_writer.Count(),
+      write_writer.Count(), total_iter_count);
 
   return butil::Status();
 }
@@ -5594,10 +5870,10 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
 butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                       store::RegionPtr region,
                                                       const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                      std::map<std::string, std::string> &kv_default,
-                                                      std::map<std::string, std::string> &kv_scalar,
-                                                      std::map<std::string, std::string> &kv_table,
-                                                      std::map<std::string, std::string> &kv_scalar_speedup) {
+                                                      BackupSstFileWriter &default_writer,
+                                                      BackupSstFileWriter &scalar_writer,
+                                                      BackupSstFileWriter &table_writer,
+                                                      BackupSstFileWriter &scalar_speedup_writer) {
   int64_t start_time_ms = Helper::TimestampMs();
   int64_t end_time_ms = 0;
   int64_t total_delete_count = 0;
@@ -5642,34 +5918,47 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
 
   char prefix = '\0';
   int64_t region_part_id = 0;
+  pb::common::ScalarSchema scalar_schema;
   if (region_type == pb::common::RegionType::INDEX_REGION) {
     prefix = region->GetKeyPrefix();
     region_part_id = region->PartitionId();
+    scalar_schema = region->ScalarSchema();
   }
 
-  auto lambda_emplace_back_function = [&region, &prefix, &region_part_id, &kv_default, &kv_scalar, &kv_table,
-                                       &kv_scalar_speedup, &snapshot, &reader](
-                                          pb::common::RegionType type, std::string_view default_iter_key,
-                                          std::string_view default_iter_value, int64_t vector_id, int64_t default_ts) {
-    // push back to kv_default
-    { kv_default.insert({std::string(default_iter_key), std::string(default_iter_value)}); }
+  // all cf keys are derived from the ordered default key, so they can be appended to sst files directly.
+  auto lambda_write_function = [&prefix, &region_part_id, &scalar_schema, &default_writer, &scalar_writer,
+                                &table_writer, &scalar_speedup_writer, &snapshot,
+                                &reader](pb::common::RegionType type, std::string_view default_iter_key,
+                                         std::string_view default_iter_value, int64_t vector_id,
+                                         int64_t default_ts) -> butil::Status {
+    auto status = default_writer.Put(default_iter_key, default_iter_value);
+    if (!status.ok()) {
+      return status;
+    }
 
     if (type == pb::common::RegionType::INDEX_REGION) {
       std::string scalar_key = std::string(default_iter_key);
       std::string scalar_value;
-      auto status = reader->KvGet(Constant::kVectorScalarCF, snapshot, scalar_key, scalar_value);
+      status = reader->KvGet(Constant::kVectorScalarCF, snapshot, scalar_key, scalar_value);
       if (status.ok()) {
-        kv_scalar.insert({scalar_key, scalar_value});
+        status = scalar_writer.Put(scalar_key, scalar_value);
+        if (!status.ok()) {
+          return status;
+        }
       }
 
       std::string table_key = std::string(default_iter_key);
       std::string table_value;
       status = reader->KvGet(Constant::kVectorTableCF, snapshot, table_key, table_value);
       if (status.ok()) {
-        kv_table.insert({table_key, table_value});
+        status = table_writer.Put(table_key, table_value);
+        if (!status.ok()) {
+          return status;
+        }
       }
 
-      pb::common::ScalarSchema scalar_schema = region->ScalarSchema();
+      // scalar schema fields are not ordered by key, sort the speedup keys of this vector before append.
+      std::map<std::string, std::string> kv_scalar_speedup;
       for (const auto &fields : scalar_schema.fields()) {
         if (fields.enable_speed_up()) {
           std::string scalar_speedup_key =
@@ -5682,7 +5971,16 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
           }
         }
       }
+
+      for (const auto &[scalar_speedup_key, scalar_speedup_value] : kv_scalar_speedup) {
+        status = scalar_speedup_writer.Put(scalar_speedup_key, scalar_speedup_value);
+        if (!status.ok()) {
+          return status;
+        }
+      }
     }
+
+    return butil::Status::OK();
   };
 
   while (default_iter->Valid()) {
@@ -5739,7 +6037,12 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
       case mvcc::ValueFlag::kPutTTL:
         [[fallthrough]];
       case mvcc::ValueFlag::kDelete: {
-        lambda_emplace_back_function(region_type, default_iter_key, default_iter_value, vector_id, default_ts);
+        auto status =
+            lambda_write_function(region_type, default_iter_key, default_iter_value, vector_id, default_ts);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << status.error_cstr();
+          return status;
+        }
         is_continue_scan_in_this_default_key = false;
         break;
       }
@@ -5764,8 +6067,8 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
       ": {} time  consuming : {} ms total_default_count : {} total_scalar_count : {}  total_table_count : {} "
       "total_scalar_speedup_count : {} total_iter_count : {}",
       region_id, pb::common::RegionType_Name(region_type), Helper::StringToHex(region_start_key),
-      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), kv_default.size(),
-      kv_scalar.size(), kv_table.size(), kv_scalar_speedup.size(), total_iter_count);
+      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), default_writer.Count(),
+      scalar_writer.Count(), table_writer.Count(), scalar_speedup_writer.Count(), total_iter_count);
 
   return butil::Status();
 }
@@ -5773,63 +6076,63 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
 butil::Status TxnEngineHelper::DoBackupDataForStoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                        store::RegionPtr region,
                                                        const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                       std::map<std::string, std::string> &kv_data,
-                                                       std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                       BackupSstFileWriter &data_writer,
+                                                       BackupSstFileWriter &write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForStoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_default,
-                                                          std::map<std::string, std::string> &kv_scalar,
-                                                          std::map<std::string, std::string> &kv_table,
-                                                          std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+                                                          BackupSstFileWriter &default_writer,
+                                                          BackupSstFileWriter &scalar_writer,
+                                                          BackupSstFileWriter &table_writer,
+                                                          BackupSstFileWriter &scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForIndexTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                        store::RegionPtr region,
                                                        const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                       std::map<std::string, std::string> &kv_data,
-                                                       std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                       BackupSstFileWriter &data_writer,
+                                                       BackupSstFileWriter &write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForIndexNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_default,
-                                                          std::map<std::string, std::string> &kv_scalar,
-                                                          std::map<std::string, std::string> &kv_table,
-                                                          std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+                                                          BackupSstFileWriter &default_writer,
+                                                          BackupSstFileWriter &scalar_writer,
+                                                          BackupSstFileWriter &table_writer,
+                                                          BackupSstFileWriter &scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForDocumentTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_data,
-                                                          std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                          BackupSstFileWriter &data_writer,
+                                                          BackupSstFileWriter &write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForDocumentNonTxn(
     std::shared_ptr<Context> ctx, RawEnginePtr raw_engine, store::RegionPtr region,
-    const pb::common::RegionType &region_type, int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-    std::map<std::string, std::string> &kv_scalar, std::map<std::string, std::string> &kv_table,
-    std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+    const pb::common::RegionType &region_type, int64_t backup_tso, BackupSstFileWriter &default_writer,
+    BackupSstFileWriter &scalar_writer, BackupSstFileWriter &table_writer,
+    BackupSstFileWriter &scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
     RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot, int64_t region_id,
     const pb::common::RegionType &region_type, const pb::store::WriteInfo &write_info, std::string_view write_iter_key,
     std::string_view write_iter_value, const std::string &write_key, int64_t start_ts, int64_t write_ts,
-    std::map<std::string, std::string> &kv_data, std::map<std::string, std::string> &kv_write) {
+    BackupSstFileWriter &data_writer, BackupSstFileWriter &write_writer) {
   std::string lock_key = mvcc::Codec::EncodeKey(write_key, Constant::kLockVer);
   std::string lock_value;
   butil::Status status = reader->KvGet(Constant::kTxnLockCF, snapshot, lock_key, lock_value);
@@ -5860,14 +6163,23 @@ butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
     return status;
   }
 
-  { kv_write.insert({std::string(write_iter_key), std::string(write_iter_value)}); }
+  status = write_writer.Put(write_iter_key, write_iter_value);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
 
   // try get key from data column family. if not exist , ignore.
+  // data key is encoded by the ordered write key, so it is ordered as well.
   std::string data_key = mvcc::Codec::EncodeKey(write_key, write_info.start_ts());
   std::string data_value;
   status = reader->KvGet(Constant::kTxnDataCF, snapshot, data_key, data_value);
   if (status.ok()) {
-    kv_data.insert({data_key, data_value});
+    status = data_writer.Put(data_key, data_value);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
   } else {
     if (pb::error::Errno::EKEY_NOT_FOUND != status.error_code()) {
       // other error
@@ -5883,134 +6195,148 @@ butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
   return butil::Status();
 }
 
-butil::Status TxnEngineHelper::WriteSstFileForTxn(
-    store::RegionPtr region, int64_t instance_id, const pb::common::RegionType &region_type,
-    const pb::common::StorageBackend &storage_backend, const std::string &backup_file_prefix,
-    const std::string &region_type_name, const std::map<std::string, std::string> &kv_data,
-    const std::map<std::string, std::string> &kv_write, pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
-  butil::Status status;
-
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kTxnWriteCF, kv_write, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
-
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kTxnDataCF, kv_data, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+butil::Status TxnEngineHelper::PrepareBackupDir(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                                const std::string &dir_path) {
+  if (std::filesystem::exists(dir_path)) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir_path, ec)) {
+      std::string s = fmt::format("dir_path : {} is not directory, {}, {}", dir_path, ec.value(), ec.message());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EFILE_NOT_DIRECTORY, s);
+    }
+  } else {
+    bool is_success = Helper::CreateDirectory(dir_path);
+    if (!is_success) {
+      std::string s = fmt::format("[backupdata][region({})][region_type({})] CreateDirectory failed. dir_path : {}",
+                                  region->Id(), pb::common::RegionType_Name(region_type), dir_path);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EBACKUP_CREATE_REMOTE_DIR, s);
+    }
   }
 
   return butil::Status();
 }
 
-butil::Status TxnEngineHelper::WriteSstFileForNonTxn(
-    store::RegionPtr region, int64_t instance_id, const pb::common::RegionType &region_type,
-    const pb::common::StorageBackend &storage_backend, const std::string &backup_file_prefix,
-    const std::string &region_type_name, const std::map<std::string, std::string> &kv_default,
-    const std::map<std::string, std::string> &kv_scalar, const std::map<std::string, std::string> &kv_table,
-    const std::map<std::string, std::string> &kv_scalar_speedup,
-    pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
-  butil::Status status;
-
-  status = DoWriteSstFile(
-      region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-      (region_type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF),
-      kv_default, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
-
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorScalarCF, kv_scalar, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+butil::Status TxnEngineHelper::FinishSstFileWriters(const std::vector<BackupSstFileWriter *> &writers) {
+  for (auto *writer : writers) {
+    auto status = writer->Finish();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
   }
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorTableCF, kv_table, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
+  return butil::Status();
+}
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorScalarKeySpeedUpCF, kv_scalar_speedup, sst_meta_group);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+// the rolled files of a failed region backup are useless, remove them and the metas.
+void TxnEngineHelper::DiscardSstFileWriters(const std::vector<BackupSstFileWriter *> &writers,
+                                            pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
+  for (auto *writer : writers) {
+    writer->Discard();
   }
 
-  return butil::Status();
+  sst_meta_group->Clear();
 }
 
-butil::Status TxnEngineHelper::DoWriteSstFile(store::RegionPtr region, int64_t instance_id,
-                                              const pb::common::RegionType &region_type,
-                                              const pb::common::StorageBackend &storage_backend,
-                                              const std::string &backup_file_prefix,
-                                              const std::string &region_type_name, const std::string &cf,
-                                              const std::map<std::string, std::string> &kvs,
-                                              pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
-  butil::Status status;
-
-  if (kvs.empty()) {
-    std::string s = fmt::format("[backupdata][region({})][region_type({})] empty. ignore.", region->Id(),
-                                pb::common::RegionType_Name(region_type));
-    DINGO_LOG(INFO) << s;
-    return butil::Status();
+butil::Status TxnEngineHelper::PrepareRestoreSstFiles(store::RegionPtr region,
+                                                      const pb::common::StorageBackend &storage_backend,
+                                                      const pb::common::BackupDataFileValueSstMetaGroup &sst_metas,
+                                                      std::map<std::string, std::vector<std::string>> &cf_files) {
+  std::set<std::string> allowed_cfs;
+  if (region->IsTxn()) {
+    allowed_cfs = {Constant::kTxnDataCF, Constant::kTxnWriteCF};
+  } else {
+    allowed_cfs = {Constant::kStoreDataCF, Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF,
+                   Constant::kVectorScalarKeySpeedUpCF};
   }
 
-  rocksdb::Options options;
-  rocks::SstFileWriter sst(options);
-  std::string base_path = storage_backend.local().path();
-  std::string dir_name = fmt::format("{}-{}", region_type_name, instance_id);
-  std::string dir_path = base_path + "/" + dir_name;
+  // leftover of previous restore(e.g. crash before clean), remove it before stage.
+  CleanRestoreStagingFiles(storage_backend.local().path(), region->Id());
 
-  if (std::filesystem::exists(dir_path)) {
-    std::error_code ec;
-    if (!std::filesystem::is_directory(dir_path, ec)) {
-      std::string s = fmt::format("dir_path : {} is not directory, {}, {}", dir_path, ec.value(), ec.message());
+  for (const auto &sst_meta : sst_metas.backup_data_file_value_sst_metas()) {
+    if (allowed_cfs.find(sst_meta.cf()) == allowed_cfs.end()) {
+      std::string s = fmt::format("[restoredata][region({})] cf({}) not match region, file: {}", region->Id(),
+                                  sst_meta.cf(), sst_meta.file_name());
       DINGO_LOG(ERROR) << s;
-      return butil::Status(pb::error::Errno::EFILE_NOT_DIRECTORY, s);
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
     }
-  } else {
-    bool is_success = Helper::CreateDirectory(dir_path);
-    if (!is_success) {
-      std::string s = fmt::format("[backupdata][region({})][region_type({})] CreateDirectory failed. dir_path : {}",
-                                  region->Id(), pb::common::RegionType_Name(region_type), dir_path);
+
+    std::string file_path = storage_backend.local().path() + "/" + sst_meta.dir_name() + "/" + sst_meta.file_name();
+    if (!Helper::IsExistPath(file_path)) {
+      std::string s = fmt::format("[restoredata][region({})] file not exist: {}", region->Id(), file_path);
       DINGO_LOG(ERROR) << s;
-      return butil::Status(pb::error::Errno::EBACKUP_CREATE_REMOTE_DIR, s);
+      return butil::Status(pb::error::Errno::EFILE_NOT_EXIST, s);
     }
-  }
 
-  std::string data_file_name = fmt::format("{}_{}.sst", backup_file_prefix, cf);
-  std::string data_file_path = dir_path + "/" + data_file_name;
-  status = sst.SaveFile(kvs, data_file_path);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
+    int64_t file_size = Helper::GetFileSize(file_path);
+    if (file_size != sst_meta.file_size()) {
+      std::string s = fmt::format("[restoredata][region({})] file size not match, file: {} size: {} expect: {}",
+                                  region->Id(), file_path, file_size, sst_meta.file_size());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EFILE_READ, s);
+    }
+
+    if (!sst_meta.encryption().empty()) {
+      std::string hash_code;
+      auto status = Helper::CalSha1CodeWithFileEx(file_path, hash_code);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
+      }
+      if (hash_code != sst_meta.encryption()) {
+        std::string s = fmt::format("[restoredata][region({})] file sha1 not match, file: {}", region->Id(), file_path);
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(pb::error::Errno::EFILE_READ, s);
+      }
+    }
+
+    // stage file into the region owned directory before propose, the raft log refer to the staged file.
+    // so the ingest don't depend on the backup files, the staged files are removed when the restore request finish.
+    std::string staging_dir = fmt::format("{}/{}", RestoreStagingPath(storage_backend.local().path(), region->Id()),
+                                          sst_meta.dir_name());
+    auto status = Helper::CreateDirectories(staging_dir);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[restoredata][region({})] create staging dir failed, dir: {} error: {}",
+                                      region->Id(), staging_dir, status.error_cstr());
+      return status;
+    }
 
-  int64_t data_file_size = sst.GetSize();
-  std::string data_file_hash_code;
-  status = Helper::CalSha1CodeWithFileEx(data_file_path, data_file_hash_code);
+    std::string staging_file_path = fmt::format("{}/{}", staging_dir, sst_meta.file_name());
+    if (!Helper::Link(file_path, staging_file_path)) {
+      // different file system, fallback to copy.
+      std::error_code ec;
+      if (!std::filesystem::copy_file(file_path, staging_file_path, std::filesystem::copy_options::overwrite_existing,
+                                      ec)) {
+        std::string s = fmt::format("[restoredata][region({})] stage file failed, file: {} staging: {} error: {}",
+                                    region->Id(), file_path, staging_file_path, ec.message());
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(pb::error::Errno::EINTERNAL, s);
+      }
+    }
 
-  pb::common::BackupDataFileValueSstMeta *sst_meta = sst_meta_group->add_backup_data_file_value_sst_metas();
-  sst_meta->set_cf(cf);
-  sst_meta->set_region_id(region->Id());
-  sst_meta->set_dir_name(dir_name);
-  sst_meta->set_file_size(data_file_size);
-  sst_meta->set_encryption(data_file_hash_code);
-  sst_meta->set_file_name(data_file_name);
+    cf_files[sst_meta.cf()].push_back(staging_file_path);
+  }
 
   return butil::Status();
 }
 
+std::string TxnEngineHelper::RestoreStagingPath(const std::string &storage_path, int64_t region_id) {
+  return fmt::format("{}/{}/{}", storage_path, Constant::kRestoreStagingDirName, region_id);
+}
+
+void TxnEngineHelper::CleanRestoreStagingFiles(const std::string &storage_path, int64_t region_id) {
+  std::string staging_path = RestoreStagingPath(storage_path, region_id);
+  if (!Helper::IsExistPath(staging_path)) {
+    return;
+  }
+
+  if (!Helper::RemoveAllFileOrDirectory(staging_path)) {
+    DINGO_LOG(WARNING) << fmt::format("[restoredata][region({})] remove staging dir failed, dir: {}", region_id,
+                                      staging_path);
+  }
+}
+
 butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                           store::RegionPtr region, const pb::common::RegionType &region_type,
                                           std::string backup_ts, int64_t backup_tso, const std::string &storage_path,
@@ -6033,26 +6359,14 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
 
   bool is_txn = region->IsTxn();
 
-  // txn
-  std::map<std::string, std::string> kv_data;
-  std::map<std::string, std::string> kv_write;
-
-  std::string region_type_name;
-
-  if (region_type == pb::common::RegionType::STORE_REGION && is_txn) {
-    region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else {
+  if (region_type != pb::common::RegionType::STORE_REGION || !is_txn) {
     std::string s = fmt::format("[backupmeta][region({})][region_type({})] backupmeta invalid region type and txn",
                                 region->Id(), pb::common::RegionType_Name(region_type), (is_txn ? "true" : "false"));
     DINGO_LOG(ERROR) << s;
     return butil::Status(pb::error::Errno::ENOT_SUPPORT, s);
   }
 
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
+  std::string region_type_name = Constant::kStoreRegionName;
 
   std::string hash_code;
 
@@ -6064,16 +6378,30 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
   std::string backup_file_prefix =
       fmt::format("{}_{}_{}_{}", region->Id(), region->EpochToString(), hash_code, second_timestamp);
 
-  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
-
   int64_t instance_id = Server::GetInstance().Id();
+  std::string dir_name = fmt::format("{}-{}", region_type_name, instance_id);
+  std::string dir_path = storage_backend.local().path() + "/" + dir_name;
 
-  if (is_txn) {
-    status = WriteSstFileForTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                                kv_data, kv_write, sst_meta_group);
+  status = PrepareBackupDir(region, region_type, dir_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
   }
 
+  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
+
+  // txn
+  BackupSstFileWriter write_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kTxnWriteCF,
+                                   sst_meta_group);
+  BackupSstFileWriter data_writer(region->Id(), dir_path, dir_name, backup_file_prefix, Constant::kTxnDataCF,
+                                  sst_meta_group);
+
+  status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+  if (status.ok()) {
+    status = FinishSstFileWriters({&write_writer, &data_writer});
+  }
   if (!status.ok()) {
+    DiscardSstFileWriters({&write_writer, &data_writer}, sst_meta_group);
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
@@ -18,16 +18,22 @@
 #include <sys/stat.h>
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
 #include "common/constant.h"
+#include "common/tracker.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "meta/store_meta_manager.h"
 #include "proto/store.pb.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 
 namespace dingodb {
 
@@ -37,6 +43,10 @@ class TxnReader {
 
   TxnReader(RawEnginePtr raw_engine, SnapshotPtr snapshot) : raw_engine_(raw_engine), snapshot_(snapshot) {}
 
+  // lock is read from in-memory pessimistic lock table first.
+  TxnReader(RawEnginePtr raw_engine, PessimisticLockTablePtr pessimistic_lock_table)
+      : raw_engine_(raw_engine), pessimistic_lock_table_(pessimistic_lock_table) {}
+
   ~TxnReader() = default;
 
   butil::Status Init();
@@ -57,6 +67,7 @@ class TxnReader {
   RawEnginePtr raw_engine_;
   SnapshotPtr snapshot_;
   RawEngine::ReaderPtr reader_;
+  PessimisticLockTablePtr pessimistic_lock_table_;
 
   std::shared_ptr<Iterator> write_iter_;
 };
@@ -125,27 +136,72 @@ class TxnIterator {
 };
 using TxnIteratorPtr = std::shared_ptr<TxnIterator>;
 
+// Stream ordered kvs of one column family into backup sst files, roll to a new file
+// when the current file exceed FLAGS_backup_sst_file_max_size. Every finished file is
+// appended to sst_meta_group with its sha1 checksum.
+class BackupSstFileWriter {
+ public:
+  BackupSstFileWriter(int64_t region_id, const std::string &dir_path, const std::string &dir_name,
+                      const std::string &file_prefix, const std::string &cf,
+                      pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
+  ~BackupSstFileWriter();
+
+  BackupSstFileWriter(const BackupSstFileWriter &) = delete;
+  BackupSstFileWriter &operator=(const BackupSstFileWriter &) = delete;
+
+  // key must be added in ascending order.
+  butil::Status Put(std::string_view key, std::string_view value);
+  butil::Status Finish();
+  // remove all the files written by this writer, include the finished ones.
+  void Discard();
+
+  int64_t Count() const { return count_; }
+  const std::vector<std::string> &FileNames() const { return file_names_; }
+
+ private:
+  butil::Status OpenNextFile();
+  butil::Status FinishCurrentFile();
+
+  int64_t region_id_;
+  std::string dir_path_;
+  std::string dir_name_;
+  std::string file_prefix_;
+  std::string cf_;
+  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group_;
+
+  rocksdb::Options options_;
+  std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
+  std::string file_name_;
+  // finished files
+  std::vector<std::string> file_names_;
+  int64_t file_index_{0};
+  int64_t count_{0};
+};
+
 class TxnEngineHelper {
  public:
   static bool CheckLockConflict(const pb::store::LockInfo &lock_info, pb::store::IsolationLevel isolation_level,
                                 int64_t start_ts, const std::set<int64_t> &resolved_locks,
                                 pb::store::TxnResultInfo &txn_result_info);
 
-  static butil::Status ScanLockInfo(StreamPtr stream, RawEnginePtr raw_engine, int64_t min_lock_ts, int64_t max_lock_ts,
-                                    const pb::common::Range &range, int64_t limit,
+  // scan lock cf and in-memory pessimistic locks of region.
+  static butil::Status ScanLockInfo(StreamPtr stream, RawEnginePtr raw_engine,
+                                    PessimisticLockTablePtr pessimistic_lock_table, int64_t min_lock_ts,
+                                    int64_t max_lock_ts, const pb::common::Range &range, int64_t limit,
                                     std::vector<pb::store::LockInfo> &lock_infos, bool &has_more,
                                     std::string &end_scan_key);
 
   static butil::Status BatchGet(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
                                 int64_t start_ts, const std::vector<std::string> &keys,
                                 const std::set<int64_t> &resolved_locks, pb::store::TxnResultInfo &txn_result_info,
-                                std::vector<pb::common::KeyValue> &kvs);
+                                std::vector<pb::common::KeyValue> &kvs, TrackerPtr tracker = nullptr);
 
   static butil::Status Scan(StreamPtr stream, RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
                             int64_t start_ts, const pb::common::Range &range, int64_t limit, bool key_only,
                             bool is_reverse, const std::set<int64_t> &resolved_locks, bool disable_coprocessor,
                             const pb::common::CoprocessorV2 &coprocessor, pb::store::TxnResultInfo &txn_result_info,
-                            std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_scan_key);
+                            std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_scan_key,
+                            TrackerPtr tracker = nullptr);
 
   // txn write functions
   static butil::Status DoTxnCommit(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
@@ -256,9 +312,9 @@ class TxnEngineHelper {
                                              const std::string &region_start_key, const std::string &region_end_key);
 
   static butil::Status CheckLockForTxnGc(RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot,
-                                         const std::string &start_key, const std::string &end_key,
-                                         int64_t safe_point_ts, int64_t region_id, int64_t tenant_id,
-                                         pb::common::RegionType type);
+                                         PessimisticLockTablePtr pessimistic_lock_table, const std::string &start_key,
+                                         const std::string &end_key, int64_t safe_point_ts, int64_t region_id,
+                                         int64_t tenant_id, pb::common::RegionType type);
 
   static butil::Status RaftEngineWriteForTxnGc(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
                                                const std::vector<std::string> &kv_deletes_lock,
@@ -341,90 +397,79 @@ class TxnEngineHelper {
 
   static butil::Status DoBackupDataCoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                            store::RegionPtr region, const pb::common::RegionType &region_type,
-                                           int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                           std::map<std::string, std::string> &kv_write);
+                                           int64_t backup_tso, BackupSstFileWriter &data_writer,
+                                           BackupSstFileWriter &write_writer);
 
   static butil::Status DoBackupDataCoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                               store::RegionPtr region, const pb::common::RegionType &region_type,
-                                              int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                              std::map<std::string, std::string> &kv_scalar,
-                                              std::map<std::string, std::string> &kv_table,
-                                              std::map<std::string, std::string> &kv_scalar_speedup);
+                                              int64_t backup_tso, BackupSstFileWriter &default_writer,
+                                              BackupSstFileWriter &scalar_writer, BackupSstFileWriter &table_writer,
+                                              BackupSstFileWriter &scalar_speedup_writer);
 
   static butil::Status DoBackupDataForStoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                store::RegionPtr region, const pb::common::RegionType &region_type,
-                                               int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                               std::map<std::string, std::string> &kv_write);
+                                               int64_t backup_tso, BackupSstFileWriter &data_writer,
+                                               BackupSstFileWriter &write_writer);
 
   static butil::Status DoBackupDataForStoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                  std::map<std::string, std::string> &kv_scalar,
-                                                  std::map<std::string, std::string> &kv_table,
-                                                  std::map<std::string, std::string> &kv_scalar_speedup);
+                                                  int64_t backup_tso, BackupSstFileWriter &default_writer,
+                                                  BackupSstFileWriter &scalar_writer,
+                                                  BackupSstFileWriter &table_writer,
+                                                  BackupSstFileWriter &scalar_speedup_writer);
 
   static butil::Status DoBackupDataForIndexTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                store::RegionPtr region, const pb::common::RegionType &region_type,
-                                               int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                               std::map<std::string, std::string> &kv_write);
+                                               int64_t backup_tso, BackupSstFileWriter &data_writer,
+                                               BackupSstFileWriter &write_writer);
 
   static butil::Status DoBackupDataForIndexNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                  std::map<std::string, std::string> &kv_scalar,
-                                                  std::map<std::string, std::string> &kv_table,
-                                                  std::map<std::string, std::string> &kv_scalar_speedup);
+                                                  int64_t backup_tso, BackupSstFileWriter &default_writer,
+                                                  BackupSstFileWriter &scalar_writer,
+                                                  BackupSstFileWriter &table_writer,
+                                                  BackupSstFileWriter &scalar_speedup_writer);
 
   static butil::Status DoBackupDataForDocumentTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                                  std::map<std::string, std::string> &kv_write);
+                                                  int64_t backup_tso, BackupSstFileWriter &data_writer,
+                                                  BackupSstFileWriter &write_writer);
 
   static butil::Status DoBackupDataForDocumentNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                      store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                     int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                     std::map<std::string, std::string> &kv_scalar,
-                                                     std::map<std::string, std::string> &kv_table,
-                                                     std::map<std::string, std::string> &kv_scalar_speedup);
+                                                     int64_t backup_tso, BackupSstFileWriter &default_writer,
+                                                     BackupSstFileWriter &scalar_writer,
+                                                     BackupSstFileWriter &table_writer,
+                                                     BackupSstFileWriter &scalar_speedup_writer);
 
   static butil::Status DoWriteDataAndCheckForTxn(RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot,
                                                  int64_t region_id, const pb::common::RegionType &region_type,
                                                  const pb::store::WriteInfo &write_info,
                                                  std::string_view write_iter_key, std::string_view write_iter_value,
                                                  const std::string &write_key, int64_t start_ts, int64_t write_ts,
-                                                 std::map<std::string, std::string> &kv_data,
-                                                 std::map<std::string, std::string> &kv_write);
-
-  static butil::Status WriteSstFileForTxn(store::RegionPtr region, int64_t instance_id,
-                                          const pb::common::RegionType &region_type,
-                                          const pb::common::StorageBackend &storage_backend,
-                                          const std::string &backup_file_prefix, const std::string &region_type_name,
-                                          const std::map<std::string, std::string> &kv_data,
-                                          const std::map<std::string, std::string> &kv_write,
-                                          pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
-
-  static butil::Status WriteSstFileForNonTxn(store::RegionPtr region, int64_t instance_id,
-                                             const pb::common::RegionType &region_type,
-                                             const pb::common::StorageBackend &storage_backend,
-                                             const std::string &backup_file_prefix, const std::string &region_type_name,
-                                             const std::map<std::string, std::string> &kv_default,
-                                             const std::map<std::string, std::string> &kv_scalar,
-                                             const std::map<std::string, std::string> &kv_table,
-                                             const std::map<std::string, std::string> &kv_scalar_speedup,
-                                             pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
-
-  static butil::Status DoWriteSstFile(store::RegionPtr region, int64_t instance_id,
-                                      const pb::common::RegionType &region_type,
-                                      const pb::common::StorageBackend &storage_backend,
-                                      const std::string &backup_file_prefix, const std::string &region_type_name,
-                                      const std::string &cf, const std::map<std::string, std::string> &kvs,
-                                      pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
+                                                 BackupSstFileWriter &data_writer, BackupSstFileWriter &write_writer);
+
+  static butil::Status PrepareBackupDir(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                        const std::string &dir_path);
+
+  static butil::Status FinishSstFileWriters(const std::vector<BackupSstFileWriter *> &writers);
+  static void DiscardSstFileWriters(const std::vector<BackupSstFileWriter *> &writers,
+                                    pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
 
   static butil::Status BackupMeta(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine, store::RegionPtr region,
                                   const pb::common::RegionType &region_type, std::string backup_ts, int64_t backup_tso,
                                   const std::string &storage_path, const pb::common::StorageBackend &storage_backend,
                                   const pb::common::CompressionType &compression_type, int32_t compression_level,
                                   dingodb::pb::store::BackupMetaResponse *response);
+
+  // check backup sst files(exist, size, sha1), stage them into the region owned directory
+  // and group the staged files by column family for ingest.
+  static butil::Status PrepareRestoreSstFiles(store::RegionPtr region, const pb::common::StorageBackend &storage_backend,
+                                              const pb::common::BackupDataFileValueSstMetaGroup &sst_metas,
+                                              std::map<std::string, std::vector<std::string>> &cf_files);
+  static std::string RestoreStagingPath(const std::string &storage_path, int64_t region_id);
+  // remove the staged files of region, called after ingest finish(success or fail) and before next stage.
+  static void CleanRestoreStagingFiles(const std::string &storage_path, int64_t region_id);
 };
 
 }  // namespace dingodb
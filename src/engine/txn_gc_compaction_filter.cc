@@ -0,0 +1,172 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_gc_compaction_filter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "brpc/reloadable_flags.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/role.h"
+#include "engine/gc_safe_point.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+// partial: only short value versions are dropped, raft gc still run for every region and is the authoritative gc.
+DEFINE_bool(enable_txn_gc_compaction_filter, false,
+            "drop short value txn mvcc versions older than gc safe point by compaction filter, raft gc is still "
+            "needed for long value");
+DEFINE_int64(txn_gc_compaction_filter_safe_point_refresh_s, 10,
+             "txn gc compaction filter refresh cached safe point interval seconds");
+BRPC_VALIDATE_GFLAG(txn_gc_compaction_filter_safe_point_refresh_s, brpc::NonNegativeInteger);
+
+DECLARE_bool(dingo_log_switch_txn_gc_detail);
+
+bvar::Adder<int64_t> txn_gc_compaction_filter_remove_write_count("dingo_txn_gc_compaction_filter_remove_write_count");
+
+// The newest Put/Delete which write_ts <= safe_point_ts is still visible for read at safe_point_ts, so it is kept
+// whatever newer versions exist. Older Put with value in data column family(long value) is excluded, a compaction
+// filter can't delete the data column family with it, so it is left to raft gc, and then the newest Delete must be
+// kept to shadow it.
+rocksdb::CompactionFilter::Decision TxnGcCompactionFilter::FilterV2(int /*level*/, const rocksdb::Slice &key,
+                                                                    ValueType value_type,
+                                                                    const rocksdb::Slice &existing_value,
+                                                                    std::string * /*new_value*/,
+                                                                    std::string * /*skip_until*/) const {
+  if (value_type != ValueType::kValue) {
+    return Decision::kKeep;
+  }
+
+  std::string user_key;
+  int64_t write_ts = 0;
+  if (!mvcc::Codec::DecodeKey(std::string_view(key.data(), key.size()), user_key, write_ts)) {
+    return Decision::kKeep;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(existing_value.data(), existing_value.size())) {
+    return Decision::kKeep;
+  }
+
+  if (user_key != last_user_key_) {
+    last_user_key_ = user_key;
+    is_first_put_or_delete_le_safe_point_ = true;
+  }
+
+  if (write_ts > safe_point_ts_) {
+    return Decision::kKeep;
+  }
+
+  switch (write_info.op()) {
+    case pb::store::Op::Put:
+    case pb::store::Op::Delete: {
+      if (is_first_put_or_delete_le_safe_point_) {
+        is_first_put_or_delete_le_safe_point_ = false;
+        return Decision::kKeep;
+      }
+      if (write_info.op() == pb::store::Op::Put && write_info.short_value().empty()) {
+        return Decision::kKeep;
+      }
+      txn_gc_compaction_filter_remove_write_count << 1;
+      return Decision::kRemove;
+    }
+    case pb::store::Op::Rollback: {
+      txn_gc_compaction_filter_remove_write_count << 1;
+      return Decision::kRemove;
+    }
+    default:
+      return Decision::kKeep;
+  }
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TxnGcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context &context) {
+  if (!FLAGS_enable_txn_gc_compaction_filter) {
+    return nullptr;
+  }
+
+  int64_t safe_point_ts = SafePointTs();
+  if (safe_point_ts <= 0) {
+    return nullptr;
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail)
+      << fmt::format("[txn_gc][compaction_filter] create filter, safe_point_ts: {} full_compaction: {}", safe_point_ts,
+                     context.is_full_compaction);
+
+  return std::make_unique<TxnGcCompactionFilter>(safe_point_ts);
+}
+
+int64_t TxnGcCompactionFilterFactory::SafePointTs() {
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t last_refresh_time_ms = last_refresh_time_ms_.load();
+  // only one compaction refresh it, the others use the cached.
+  if (now_ms - last_refresh_time_ms >= FLAGS_txn_gc_compaction_filter_safe_point_refresh_s * 1000 &&
+      last_refresh_time_ms_.compare_exchange_strong(last_refresh_time_ms, now_ms)) {
+    safe_point_ts_.store(GetSafePointTs());
+  }
+
+  return safe_point_ts_.load();
+}
+
+int64_t TxnGcCompactionFilterFactory::GetSafePointTs() {
+  // index and document region must delete data with index together, they keep raft gc.
+  if (GetRole() != pb::common::ClusterRole::STORE) {
+    return 0;
+  }
+
+  auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
+  if (store_meta_manager == nullptr) {
+    return 0;
+  }
+  auto gc_safe_point_manager = store_meta_manager->GetGCSafePointManager();
+
+  std::set<int64_t> tenant_ids;
+  for (const auto &region : Server::GetInstance().GetAllAliveRegion()) {
+    if (region->IsTxn()) {
+      tenant_ids.insert(region->Definition().tenant_id());
+    }
+  }
+
+  if (tenant_ids.empty()) {
+    return 0;
+  }
+
+  // the write column family is shared by all tenants, use the min safe point.
+  int64_t min_safe_point_ts = INT64_MAX;
+  for (auto tenant_id : tenant_ids) {
+    auto [gc_stop, safe_point_ts] = gc_safe_point_manager->GetGcFlagAndSafePointTs(tenant_id);
+    if (gc_stop) {
+      return 0;
+    }
+    min_safe_point_ts = std::min(min_safe_point_ts, safe_point_ts);
+  }
+
+  return min_safe_point_ts;
+}
+
+}  // namespace dingodb
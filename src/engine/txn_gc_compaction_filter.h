@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rocksdb/compaction_filter.h"
+
+namespace dingodb {
+
+// Drop mvcc versions of write column family which older than gc safe point during compaction.
+// It is a pure decision on the write column family, never write to db. For every user key the newest Put/Delete
+// which write_ts <= safe_point_ts is kept, and only the older versions have no value in data column family are
+// dropped, e.g. short value Put/Delete/Rollback. Puts with data column family value and the newest Delete are left
+// to raft gc, which deletes write and data together and keeps replicas consistent.
+// NOTE: it is only a partial supplement of raft gc, not a replacement. Long values are not handled, so raft gc
+// still scans every txn region whether the filter is enabled or not, and the filter is off by default
+// (enable_txn_gc_compaction_filter). It only shrinks the write column family before raft gc reach it.
+class TxnGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit TxnGcCompactionFilter(int64_t safe_point_ts) : safe_point_ts_(safe_point_ts) {}
+  ~TxnGcCompactionFilter() override = default;
+
+  Decision FilterV2(int level, const rocksdb::Slice &key, ValueType value_type, const rocksdb::Slice &existing_value,
+                    std::string *new_value, std::string *skip_until) const override;
+
+  const char *Name() const override { return "TxnGcCompactionFilter"; }
+
+ private:
+  int64_t safe_point_ts_;
+
+  // filter is called with keys in order within one compaction, so keep the state of current user key.
+  mutable std::string last_user_key_;
+  mutable bool is_first_put_or_delete_le_safe_point_{true};
+};
+
+class TxnGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  TxnGcCompactionFilterFactory() = default;
+  ~TxnGcCompactionFilterFactory() override = default;
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context &context) override;
+
+  const char *Name() const override { return "TxnGcCompactionFilterFactory"; }
+
+  // cached safe point, refresh at most every txn_gc_compaction_filter_safe_point_refresh_s.
+  int64_t SafePointTs();
+
+  // min safe point of all tenants which has region on this store, 0 means gc is not allowed.
+  static int64_t GetSafePointTs();
+
+ private:
+  std::atomic<int64_t> safe_point_ts_{0};
+  std::atomic<int64_t> last_refresh_time_ms_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_  // NOLINT
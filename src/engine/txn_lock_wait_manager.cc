@@ -0,0 +1,296 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_lock_wait_manager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "butil/scoped_lock.h"
+#include "butil/time.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_lock_wait, true, "enable pessimistic lock wait on server side when meet lock conflict");
+DEFINE_int64(txn_lock_wait_max_timeout_ms, 10000, "pessimistic lock wait max timeout");
+DEFINE_int64(txn_lock_wait_wake_up_delay_ms, 20, "delay to wake up the other waiters after the head waiter");
+DEFINE_uint32(txn_lock_wait_max_waiters_per_key, 1024, "max pessimistic lock waiters of a key");
+
+bvar::Adder<int64_t> g_txn_lock_wait_count("dingo_txn_lock_wait_count");
+bvar::Adder<int64_t> g_txn_lock_wait_wake_up_count("dingo_txn_lock_wait_wake_up_count");
+bvar::Adder<int64_t> g_txn_lock_wait_timeout_count("dingo_txn_lock_wait_timeout_count");
+bvar::Adder<int64_t> g_txn_lock_wait_deadlock_count("dingo_txn_lock_wait_deadlock_count");
+
+TxnLockWaitManager& TxnLockWaitManager::GetInstance() {
+  static TxnLockWaitManager instance;
+  return instance;
+}
+
+TxnLockWaitManager::TxnLockWaitManager() { bthread_mutex_init(&mutex_, nullptr); }
+
+TxnLockWaitManager::~TxnLockWaitManager() { bthread_mutex_destroy(&mutex_); }
+
+int64_t TxnLockWaitManager::CalcWaitDeadlineMs(int64_t request_timeout_ms) {
+  // client not set lock wait timeout keep the no wait behavior
+  if (!FLAGS_enable_txn_lock_wait || request_timeout_ms <= 0) {
+    return 0;
+  }
+
+  int64_t timeout_ms = std::min(request_timeout_ms, FLAGS_txn_lock_wait_max_timeout_ms);
+  if (timeout_ms <= 0) {
+    return 0;
+  }
+
+  return Helper::TimestampMs() + timeout_ms;
+}
+
+TxnLockWaitManager::WaitResult TxnLockWaitManager::Wait(const std::string& key, int64_t start_ts, int64_t lock_ts,
+                                                        int64_t timeout_ms, WakeUpCallback callback,
+                                                        std::vector<int64_t>& wait_chain) {
+  if (timeout_ms <= 0 || start_ts == lock_ts) {
+    return WaitResult::kRejected;
+  }
+
+  auto waiter = std::make_shared<Waiter>();
+  waiter->key = key;
+  waiter->start_ts = start_ts;
+  waiter->lock_ts = lock_ts;
+  waiter->callback = std::move(callback);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+
+    if (DetectDeadlock(start_ts, lock_ts, wait_chain)) {
+      g_txn_lock_wait_deadlock_count << 1;
+      DINGO_LOG(WARNING) << fmt::format("[txn.lock_wait] detect deadlock, key: {} start_ts: {} lock_ts: {} chain: {}",
+                                        Helper::StringToHex(key), start_ts, lock_ts, Helper::VectorToString(wait_chain));
+      return WaitResult::kDeadlock;
+    }
+
+    auto& waiters = key_waiters_[key];
+    if (waiters.size() >= FLAGS_txn_lock_wait_max_waiters_per_key) {
+      return WaitResult::kRejected;
+    }
+
+    // timer callback need hold mutex_, so it can't run before waiter is enqueued.
+    auto* timer_arg = new WaiterPtr(waiter);
+    if (bthread_timer_add(&waiter->timer_id, butil::milliseconds_from_now(timeout_ms), &OnWaitTimeout, timer_arg) !=
+        0) {
+      delete timer_arg;
+      if (waiters.empty()) {
+        key_waiters_.erase(key);
+      }
+      return WaitResult::kRejected;
+    }
+    waiter->timer_arg = timer_arg;
+
+    waiters.push_back(waiter);
+    AddWaitForEdge(start_ts, lock_ts);
+    ++waiter_count_;
+  }
+
+  g_txn_lock_wait_count << 1;
+
+  return WaitResult::kWaiting;
+}
+
+void TxnLockWaitManager::WakeUp(const std::vector<std::string>& keys) {
+  for (const auto& key : keys) {
+    WakeUp(key);
+  }
+}
+
+void TxnLockWaitManager::WakeUp(const std::string& key) {
+  WaiterPtr head;
+  bool has_remaining = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = key_waiters_.find(key);
+    if (it == key_waiters_.end()) {
+      return;
+    }
+
+    auto& waiters = it->second;
+    while (!waiters.empty()) {
+      auto waiter = waiters.front();
+      waiters.pop_front();
+      if (!waiter->is_done.exchange(true)) {
+        RemoveWaitForEdge(waiter->start_ts, waiter->lock_ts);
+        --waiter_count_;
+        head = waiter;
+        break;
+      }
+    }
+
+    has_remaining = !waiters.empty();
+    if (!has_remaining) {
+      key_waiters_.erase(it);
+    }
+  }
+
+  if (head != nullptr) {
+    g_txn_lock_wait_wake_up_count << 1;
+    CancelTimer(head);
+    head->callback();
+  }
+
+  if (has_remaining) {
+    bthread_timer_t timer_id;
+    auto* timer_arg = new std::string(key);
+    if (bthread_timer_add(&timer_id, butil::milliseconds_from_now(FLAGS_txn_lock_wait_wake_up_delay_ms),
+                          &OnDelayWakeUp, timer_arg) != 0) {
+      delete timer_arg;
+      WakeUpAll(key);
+    }
+  }
+}
+
+void TxnLockWaitManager::WakeUpAll(const std::string& key) {
+  std::vector<WaiterPtr> woken_waiters;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = key_waiters_.find(key);
+    if (it == key_waiters_.end()) {
+      return;
+    }
+
+    for (auto& waiter : it->second) {
+      if (!waiter->is_done.exchange(true)) {
+        RemoveWaitForEdge(waiter->start_ts, waiter->lock_ts);
+        --waiter_count_;
+        woken_waiters.push_back(waiter);
+      }
+    }
+    key_waiters_.erase(it);
+  }
+
+  // FIFO order
+  for (auto& waiter : woken_waiters) {
+    g_txn_lock_wait_wake_up_count << 1;
+    CancelTimer(waiter);
+    waiter->callback();
+  }
+}
+
+int64_t TxnLockWaitManager::WaiterCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return waiter_count_;
+}
+
+void TxnLockWaitManager::OnWaitTimeout(void* arg) {
+  auto* timer_arg = static_cast<WaiterPtr*>(arg);
+  WaiterPtr waiter = *timer_arg;
+  delete timer_arg;
+
+  if (GetInstance().RemoveWaiter(waiter)) {
+    g_txn_lock_wait_timeout_count << 1;
+    waiter->callback();
+  }
+}
+
+void TxnLockWaitManager::OnDelayWakeUp(void* arg) {
+  auto* key = static_cast<std::string*>(arg);
+  GetInstance().WakeUpAll(*key);
+  delete key;
+}
+
+void TxnLockWaitManager::CancelTimer(WaiterPtr waiter) {
+  // 0 means the timer is cancelled before run, otherwise the timer callback will free the arg.
+  if (bthread_timer_del(waiter->timer_id) == 0) {
+    delete static_cast<WaiterPtr*>(waiter->timer_arg);
+  }
+}
+
+bool TxnLockWaitManager::RemoveWaiter(WaiterPtr waiter) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (waiter->is_done.exchange(true)) {
+    return false;
+  }
+
+  auto it = key_waiters_.find(waiter->key);
+  if (it != key_waiters_.end()) {
+    auto& waiters = it->second;
+    waiters.erase(std::remove(waiters.begin(), waiters.end(), waiter), waiters.end());
+    if (waiters.empty()) {
+      key_waiters_.erase(it);
+    }
+  }
+
+  RemoveWaitForEdge(waiter->start_ts, waiter->lock_ts);
+  --waiter_count_;
+
+  return true;
+}
+
+bool TxnLockWaitManager::DetectDeadlock(int64_t start_ts, int64_t lock_ts, std::vector<int64_t>& wait_chain) {
+  // find a path lock_ts -> ... -> start_ts in wait-for graph, then start_ts -> lock_ts is a cycle.
+  std::unordered_map<int64_t, int64_t> parents;
+  std::vector<int64_t> stack = {lock_ts};
+  parents[lock_ts] = lock_ts;
+
+  while (!stack.empty()) {
+    int64_t ts = stack.back();
+    stack.pop_back();
+
+    if (ts == start_ts) {
+      wait_chain.clear();
+      for (int64_t cur = ts; cur != lock_ts; cur = parents[cur]) {
+        wait_chain.push_back(cur);
+      }
+      wait_chain.push_back(lock_ts);
+      std::reverse(wait_chain.begin(), wait_chain.end());
+      return true;
+    }
+
+    auto it = wait_for_graph_.find(ts);
+    if (it == wait_for_graph_.end()) {
+      continue;
+    }
+    for (const auto& [next_ts, _] : it->second) {
+      if (parents.emplace(next_ts, ts).second) {
+        stack.push_back(next_ts);
+      }
+    }
+  }
+
+  return false;
+}
+
+void TxnLockWaitManager::AddWaitForEdge(int64_t start_ts, int64_t lock_ts) { ++wait_for_graph_[start_ts][lock_ts]; }
+
+void TxnLockWaitManager::RemoveWaitForEdge(int64_t start_ts, int64_t lock_ts) {
+  auto it = wait_for_graph_.find(start_ts);
+  if (it == wait_for_graph_.end()) {
+    return;
+  }
+
+  auto edge_it = it->second.find(lock_ts);
+  if (edge_it != it->second.end() && --edge_it->second <= 0) {
+    it->second.erase(edge_it);
+  }
+  if (it->second.empty()) {
+    wait_for_graph_.erase(it);
+  }
+}
+
+}  // namespace dingodb
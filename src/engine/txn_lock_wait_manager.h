@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
+#define DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bthread/unstable.h"
+
+namespace dingodb {
+
+// Park pessimistic lock requests which meet a lock held by other txn, instead of returning lock conflict
+// to client and letting client backoff and retry.
+// Waiters of a key are woken in FIFO order when the lock is released by commit/rollback, the head waiter
+// is woken at once, the others after txn_lock_wait_wake_up_delay_ms, so the head has the chance to get the lock.
+// A wait-for graph of txns waiting on this store is used to detect deadlock before parking.
+class TxnLockWaitManager {
+ public:
+  using WakeUpCallback = std::function<void()>;
+
+  enum class WaitResult {
+    kWaiting = 0,
+    kDeadlock = 1,
+    kRejected = 2,
+  };
+
+  static TxnLockWaitManager& GetInstance();
+
+  TxnLockWaitManager(const TxnLockWaitManager&) = delete;
+  TxnLockWaitManager& operator=(const TxnLockWaitManager&) = delete;
+
+  // deadline of lock wait from request timeout, capped by txn_lock_wait_max_timeout_ms.
+  // request timeout <= 0 means not wait and return 0.
+  static int64_t CalcWaitDeadlineMs(int64_t request_timeout_ms);
+
+  // Wait the lock of key held by lock_ts is released, callback is invoked once when woken or timeout,
+  // callback should be light, e.g. re-schedule the request.
+  // When deadlock is detected, wait_chain is the txn chain from lock_ts back to start_ts.
+  WaitResult Wait(const std::string& key, int64_t start_ts, int64_t lock_ts, int64_t timeout_ms,
+                  WakeUpCallback callback, std::vector<int64_t>& wait_chain);
+
+  // Lock of keys is released.
+  void WakeUp(const std::string& key);
+  void WakeUp(const std::vector<std::string>& keys);
+
+  int64_t WaiterCount();
+
+ private:
+  TxnLockWaitManager();
+  ~TxnLockWaitManager();
+
+  struct Waiter {
+    std::string key;
+    int64_t start_ts{0};
+    int64_t lock_ts{0};
+    WakeUpCallback callback;
+
+    bthread_timer_t timer_id{0};
+    void* timer_arg{nullptr};
+    std::atomic<bool> is_done{false};
+  };
+  using WaiterPtr = std::shared_ptr<Waiter>;
+
+  static void OnWaitTimeout(void* arg);
+  static void OnDelayWakeUp(void* arg);
+
+  // remove waiter when timeout, return false if it has been woken
+  bool RemoveWaiter(WaiterPtr waiter);
+  void WakeUpAll(const std::string& key);
+  static void CancelTimer(WaiterPtr waiter);
+
+  // need hold mutex_
+  bool DetectDeadlock(int64_t start_ts, int64_t lock_ts, std::vector<int64_t>& wait_chain);
+  void AddWaitForEdge(int64_t start_ts, int64_t lock_ts);
+  void RemoveWaitForEdge(int64_t start_ts, int64_t lock_ts);
+
+  bthread_mutex_t mutex_;
+  std::unordered_map<std::string, std::deque<WaiterPtr>> key_waiters_;
+  // wait-for graph, waiter start_ts -> (lock_ts -> waiter count)
+  std::unordered_map<int64_t, std::unordered_map<int64_t, int32_t>> wait_for_graph_;
+  int64_t waiter_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
@@ -0,0 +1,194 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_pessimistic_lock_table.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+#include "bvar/passive_status.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_pessimistic_lock_table, false, "hold pessimistic lock in leader memory instead of lock cf");
+DEFINE_int64(txn_pessimistic_lock_table_region_max_memory, 2 * 1024 * 1024,
+             "max memory of in-memory pessimistic locks per region");
+DEFINE_int64(txn_pessimistic_lock_table_max_memory, 256 * 1024 * 1024,
+             "max memory of in-memory pessimistic locks of all regions");
+
+// key/value and std::map node overhead
+constexpr int64_t kLockMemoryOverhead = 64;
+
+static std::atomic<int64_t> g_total_memory_size{0};
+
+static int64_t GetTotalMemorySize(void*) { return g_total_memory_size.load(std::memory_order_relaxed); }
+bvar::PassiveStatus<int64_t> g_txn_pessimistic_lock_table_memory("dingo_txn_pessimistic_lock_table_memory",
+                                                                 GetTotalMemorySize, nullptr);
+
+PessimisticLockTable::PessimisticLockTable(int64_t region_id) : region_id_(region_id) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+PessimisticLockTable::~PessimisticLockTable() {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    ClearLocks();
+  }
+  bthread_mutex_destroy(&mutex_);
+}
+
+int64_t PessimisticLockTable::TotalMemorySize() { return g_total_memory_size.load(std::memory_order_relaxed); }
+
+int64_t PessimisticLockTable::LockMemorySize(const pb::store::LockInfo& lock_info) {
+  return lock_info.key().size() + lock_info.ByteSizeLong() + kLockMemoryOverhead;
+}
+
+bool PessimisticLockTable::BatchInsert(const std::vector<pb::store::LockInfo>& lock_infos) {
+  if (!FLAGS_enable_txn_pessimistic_lock_table) {
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (!is_active_) {
+    return false;
+  }
+
+  int64_t delta_size = 0;
+  for (const auto& lock_info : lock_infos) {
+    delta_size += LockMemorySize(lock_info);
+    auto it = locks_.find(lock_info.key());
+    if (it != locks_.end()) {
+      delta_size -= LockMemorySize(it->second);
+    }
+  }
+
+  if (delta_size > 0 && (memory_size_ + delta_size > FLAGS_txn_pessimistic_lock_table_region_max_memory ||
+                         TotalMemorySize() + delta_size > FLAGS_txn_pessimistic_lock_table_max_memory)) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[txn.lock_table][region({})] memory is over budget, region memory: {} total memory: {} lock count: {}",
+        region_id_, memory_size_, TotalMemorySize(), locks_.size());
+    return false;
+  }
+
+  for (const auto& lock_info : lock_infos) {
+    locks_.insert_or_assign(lock_info.key(), lock_info);
+  }
+  memory_size_ += delta_size;
+  g_total_memory_size.fetch_add(delta_size, std::memory_order_relaxed);
+
+  return true;
+}
+
+bool PessimisticLockTable::Get(const std::string& key, pb::store::LockInfo& lock_info) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = locks_.find(key);
+  if (it == locks_.end()) {
+    return false;
+  }
+
+  lock_info = it->second;
+  return true;
+}
+
+void PessimisticLockTable::Erase(const std::string& key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = locks_.find(key);
+  if (it == locks_.end()) {
+    return;
+  }
+
+  int64_t size = LockMemorySize(it->second);
+  memory_size_ -= size;
+  g_total_memory_size.fetch_sub(size, std::memory_order_relaxed);
+  locks_.erase(it);
+}
+
+std::vector<pb::store::LockInfo> PessimisticLockTable::GetAllLocks() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  std::vector<pb::store::LockInfo> lock_infos;
+  lock_infos.reserve(locks_.size());
+  for (const auto& [_, lock_info] : locks_) {
+    lock_infos.push_back(lock_info);
+  }
+
+  return lock_infos;
+}
+
+std::vector<pb::store::LockInfo> PessimisticLockTable::GetLocks(const std::string& start_key,
+                                                                const std::string& end_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  std::vector<pb::store::LockInfo> lock_infos;
+  for (auto it = locks_.lower_bound(start_key); it != locks_.end() && it->first < end_key; ++it) {
+    lock_infos.push_back(it->second);
+  }
+
+  return lock_infos;
+}
+
+bool PessimisticLockTable::IsActive() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return is_active_;
+}
+
+void PessimisticLockTable::SetActive(bool is_active) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (!is_active) {
+    DINGO_LOG_IF(INFO, !locks_.empty()) << fmt::format(
+        "[txn.lock_table][region({})] drop in-memory pessimistic locks, count: {}", region_id_, locks_.size());
+    ClearLocks();
+  }
+  is_active_ = is_active;
+  is_suspended_ = false;
+}
+
+void PessimisticLockTable::Suspend() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_active_) {
+    is_active_ = false;
+    is_suspended_ = true;
+  }
+}
+
+void PessimisticLockTable::Resume() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_suspended_) {
+    is_active_ = true;
+    is_suspended_ = false;
+  }
+}
+
+int64_t PessimisticLockTable::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return locks_.size();
+}
+
+int64_t PessimisticLockTable::MemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return memory_size_;
+}
+
+void PessimisticLockTable::ClearLocks() {
+  g_total_memory_size.fetch_sub(memory_size_, std::memory_order_relaxed);
+  memory_size_ = 0;
+  locks_.clear();
+}
+
+}  // namespace dingodb
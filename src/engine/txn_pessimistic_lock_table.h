@@ -0,0 +1,88 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_PESSIMISTIC_LOCK_TABLE_H_
+#define DINGODB_ENGINE_TXN_PESSIMISTIC_LOCK_TABLE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+class PessimisticLockTable;
+using PessimisticLockTablePtr = std::shared_ptr<PessimisticLockTable>;
+
+// Pessimistic locks of a region held in leader memory instead of lock cf, which save a raft write for each
+// pessimistic lock. The locks are materialized to lock cf by prewrite, or by MaterializePessimisticLocks before
+// leader transfer/split/merge, and they are lost when leader change unexpected, in which case prewrite falls back
+// to check write conflict.
+// Table is only active on leader, insert fail when inactive or over memory budget, then caller must write lock cf.
+class PessimisticLockTable {
+ public:
+  PessimisticLockTable(int64_t region_id);
+  ~PessimisticLockTable();
+
+  PessimisticLockTable(const PessimisticLockTable&) = delete;
+  const PessimisticLockTable& operator=(const PessimisticLockTable&) = delete;
+
+  static PessimisticLockTablePtr New(int64_t region_id) { return std::make_shared<PessimisticLockTable>(region_id); }
+
+  // total memory of all region tables
+  static int64_t TotalMemorySize();
+
+  // all or nothing
+  bool BatchInsert(const std::vector<pb::store::LockInfo>& lock_infos);
+  bool Get(const std::string& key, pb::store::LockInfo& lock_info);
+  // lock cf of key is changed, called when apply raft log.
+  void Erase(const std::string& key);
+
+  std::vector<pb::store::LockInfo> GetAllLocks();
+  // locks of key in [start_key, end_key), ordered by key.
+  std::vector<pb::store::LockInfo> GetLocks(const std::string& start_key, const std::string& end_key);
+
+  bool IsActive();
+  // leader start/stop, transfer/split/merge, drop all locks when inactive.
+  void SetActive(bool is_active);
+  // stop accept new lock and keep the exist locks, used before materialize.
+  void Suspend();
+  // accept new lock again if not changed by SetActive after Suspend.
+  void Resume();
+
+  int64_t Size();
+  int64_t MemorySize();
+
+ private:
+  static int64_t LockMemorySize(const pb::store::LockInfo& lock_info);
+  // need hold mutex_
+  void ClearLocks();
+
+  int64_t region_id_;
+
+  bthread_mutex_t mutex_;
+  bool is_active_{false};
+  bool is_suspended_{false};
+  int64_t memory_size_{0};
+  // user key -> lock
+  std::map<std::string, pb::store::LockInfo> locks_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_PESSIMISTIC_LOCK_TABLE_H_
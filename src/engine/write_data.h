@@ -16,6 +16,7 @@
 #define DINGODB_ENGINE_WRITE_DATA_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +42,7 @@ enum class DatumType {
   kRebuildVectorIndex = 11,
   kSaveRaftSnapshot = 12,
   kTxn = 13,
+  kIngestSst = 14,
 };
 
 class DatumAble {
@@ -414,6 +416,31 @@ struct SaveRaftSnapshotDatum : public DatumAble {
   int64_t region_id;
 };
 
+// Ingest backup sst files, the files locate on the storage shared by all replicas.
+struct IngestSstDatum : public DatumAble {
+  DatumType GetType() override { return DatumType::kIngestSst; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::INGEST_SST);
+    auto* ingest_request = request->mutable_ingest_sst();
+    for (const auto& [cf_name, files] : cf_files) {
+      for (const auto& file : files) {
+        auto* ingest_file = ingest_request->add_files();
+        ingest_file->set_cf_name(cf_name);
+        ingest_file->set_file_path(file);
+      }
+    }
+
+    return request;
+  };
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+};
+
 class WriteData {
  public:
   std::vector<std::shared_ptr<DatumAble>> Datums() const { return datums_; }
@@ -639,6 +666,17 @@ class WriteDataBuilder {
 
     return write_data;
   }
+
+  // IngestSstDatum
+  static std::shared_ptr<WriteData> BuildWrite(const std::map<std::string, std::vector<std::string>>& cf_files) {
+    auto datum = std::make_shared<IngestSstDatum>();
+    datum->cf_files = cf_files;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
 };
 
 }  // namespace dingodb
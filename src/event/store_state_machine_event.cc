@@ -106,6 +106,9 @@ int SmLeaderStartEventListener::OnEvent(std::shared_ptr<Event> event) {
     store_region_meta->UpdateLeaderId(region, Server::GetInstance().Id());
   }
 
+  // in-memory pessimistic locks is only held by leader
+  region->PessimisticLockTable()->SetActive(true);
+
   // trigger heartbeat
   Heartbeat::TriggerStoreHeartbeat({region->Id()});
 
@@ -121,6 +124,9 @@ int SmLeaderStartEventListener::OnEvent(std::shared_ptr<Event> event) {
 int SmLeaderStopEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmLeaderStopEvent>(event);
 
+  // drop in-memory pessimistic locks, prewrite will check write conflict instead
+  the_event->region->PessimisticLockTable()->SetActive(false);
+
   // Invoke handler
   auto handlers = handler_collection_->GetHandlers();
   for (auto& handle : handlers) {
@@ -55,6 +55,9 @@ enum class HandlerType {
   // txn
   kTxn = pb::raft::TXN,
 
+  // restore
+  kIngestSst = pb::raft::INGEST_SST,
+
   // Snapshot
   kSaveSnapshot = 1000,
   kLoadSnapshot = 1001,
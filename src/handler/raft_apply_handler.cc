@@ -23,6 +23,7 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
@@ -36,6 +37,7 @@
 #include "engine/raw_engine.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
 #include "mvcc/codec.h"
@@ -52,6 +54,12 @@ DECLARE_int32(init_election_timeout_ms);
 namespace dingodb {
 DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
 
+DEFINE_int32(ingest_sst_max_retry_times, 30, "max retry times of ingest sst when apply, interval 1s");
+BRPC_VALIDATE_GFLAG(ingest_sst_max_retry_times, brpc::NonNegativeInteger);
+DEFINE_int64(vector_index_evicted_reload_log_gap, 10000,
+             "reload evicted vector index on apply when log gap since its snapshot exceed this");
+BRPC_VALIDATE_GFLAG(vector_index_evicted_reload_log_gap, brpc::NonNegativeInteger);
+
 int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
                        int64_t /*log_id*/) {
@@ -1032,6 +1040,18 @@ int SaveRaftSnapshotHandler::Handle(std::shared_ptr<Context>, store::RegionPtr r
   return 0;
 }
 
+// evicted vector index pin the wal truncation until it is reloaded, but it is only reloaded by search,
+// e.g. leader transfer to other peer then nobody search it, so reload it when the wal is too long.
+static void ReloadEvictedVectorIndexIfNeed(VectorIndexWrapperPtr vector_index_wrapper, int64_t log_id) {
+  if (!vector_index_wrapper->IsEvicted() || log_id == INT64_MAX) {
+    return;
+  }
+
+  if (log_id - vector_index_wrapper->SnapshotLogId() > FLAGS_vector_index_evicted_reload_log_gap) {
+    vector_index_wrapper->ReloadIfEvicted();
+  }
+}
+
 int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                              const pb::raft::Request &req, store::RegionMetricsPtr /*region_metrics*/,
                              int64_t /*term_id*/, int64_t log_id) {
@@ -1139,7 +1159,9 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     auto start_time = Helper::TimestampNs();
     auto writer = engine->Writer();
     status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
-    if (tracker) tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    if (tracker) {
+      tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    }
     if (status.error_code() == pb::error::Errno::EINTERNAL) {
       DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] KvBatchPutAndDelete failed, error: {}", region->Id(),
                                       status.error_str());
@@ -1155,6 +1177,9 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
   bool is_ready = vector_index_wrapper->IsReady();
+  if (!is_ready) {
+    ReloadEvictedVectorIndexIfNeed(vector_index_wrapper, log_id);
+  }
 
   if (is_ready) {
     // Check if the log_id is greater than the ApplyLogIndex of the vector index
@@ -1175,7 +1200,9 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
         auto start_time = Helper::TimestampNs();
         auto status = request.is_update() ? vector_index_wrapper->Upsert(vector_with_ids)
                                           : vector_index_wrapper->Add(vector_with_ids);
-        if (tracker) tracker->SetVectorIndexWriteTime(Helper::TimestampNs() - start_time);
+        if (tracker) {
+          tracker->SetVectorIndexWriteTime(Helper::TimestampNs() - start_time);
+        }
         DINGO_LOG(DEBUG) << fmt::format("[raft.apply][region({})] upsert vector, count: {} cost: {}us", vector_index_id,
                                         vector_with_ids.size(), Helper::TimestampNs() - start_time);
         if (status.ok()) {
@@ -1267,7 +1294,9 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     status = writer->KvBatchPutAndDelete(kv_puts_with_cf, {});
     CHECK(status.error_code() != pb::error::Errno::EINTERNAL) << fmt::format(
         "[raft.apply][region({})] KvBatchPutAndDelete failed, error: {}", region->Id(), status.error_str());
-    if (tracker) tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    if (tracker) {
+      tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    }
   }
 
   if (ctx) {
@@ -1277,13 +1306,19 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
   bool is_ready = vector_index_wrapper->IsReady();
+  if (!is_ready) {
+    ReloadEvictedVectorIndexIfNeed(vector_index_wrapper, log_id);
+  }
+
   if (is_ready && !request.ids().empty()) {
     if (log_id > vector_index_wrapper->ApplyLogId() ||
         region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
       try {
         auto start_time = Helper::TimestampNs();
         auto status = vector_index_wrapper->Delete(Helper::PbRepeatedToVector(request.ids()));
-        if (tracker) tracker->SetVectorIndexWriteTime(Helper::TimestampNs() - start_time);
+        if (tracker) {
+          tracker->SetVectorIndexWriteTime(Helper::TimestampNs() - start_time);
+        }
         if (status.ok()) {
           if (region->GetStoreEngineType() == pb::common::STORE_ENG_RAFT_STORE && log_id != INT64_MAX) {
             vector_index_wrapper->SetApplyLogId(log_id);
@@ -1368,7 +1403,9 @@ int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
     auto start_time = Helper::TimestampNs();
     auto writer = engine->Writer();
     status = writer->KvBatchPutAndDelete(kv_puts_with_cf, {});
-    if (tracker) tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    if (tracker) {
+      tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    }
     if (status.error_code() == pb::error::Errno::EINTERNAL) {
       DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] KvBatchPutAndDelete failed, error: {}", region->Id(),
                                       status.error_str());
@@ -1403,7 +1440,9 @@ int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
         auto start_time = Helper::TimestampNs();
         auto status = request.is_update() ? document_index_wrapper->Upsert(document_with_ids)
                                           : document_index_wrapper->Add(document_with_ids);
-        if (tracker) tracker->SetDocumentIndexWriteTime(Helper::TimestampNs() - start_time);
+        if (tracker) {
+          tracker->SetDocumentIndexWriteTime(Helper::TimestampNs() - start_time);
+        }
         DINGO_LOG(DEBUG) << fmt::format("[raft.apply][region({})] upsert document, count: {} cost: {}ns",
                                         document_index_id, document_with_ids.size(),
                                         Helper::TimestampNs() - start_time);
@@ -1481,7 +1520,9 @@ int DocumentDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
     status = writer->KvBatchPutAndDelete(kv_puts_with_cf, {});
     CHECK(status.error_code() != pb::error::Errno::EINTERNAL) << fmt::format(
         "[raft.apply][region({})] KvBatchPutAndDelete failed, error: {}", region->Id(), status.error_str());
-    if (tracker) tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    if (tracker) {
+      tracker->SetStoreWriteTime(Helper::TimestampNs() - start_time);
+    }
   }
 
   if (ctx) {
@@ -1497,7 +1538,9 @@ int DocumentDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
       try {
         auto start_time = Helper::TimestampNs();
         auto status = document_index_wrapper->Delete(Helper::PbRepeatedToVector(request.ids()));
-        if (tracker) tracker->SetDocumentIndexWriteTime(Helper::TimestampNs() - start_time);
+        if (tracker) {
+          tracker->SetDocumentIndexWriteTime(Helper::TimestampNs() - start_time);
+        }
         DINGO_LOG(DEBUG) << fmt::format("[raft.apply][region({})] delete document, count: {} cost: {}ns",
                                         document_index_id, request.ids().size(), Helper::TimestampNs() - start_time);
         if (status.ok()) {
@@ -1521,6 +1564,88 @@ int DocumentDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
   return 0;
 }
 
+int IngestSstHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                             const pb::raft::Request &req, store::RegionMetricsPtr /*region_metrics*/,
+                             int64_t /*term_id*/, int64_t log_id) {
+  const auto &request = req.ingest_sst();
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+  for (const auto &file : request.files()) {
+    cf_files[file.cf_name()].push_back(file.file_path());
+  }
+
+  // files are copied into the engine, the staged files keep intact.
+  // ingest failure can't be skipped silently, otherwise the replicas diverge, so stall the apply and retry a while.
+  // when retry is exhausted, disable change of the region and fail the request, the region need manual repair.
+  for (const auto &[cf_name, files] : cf_files) {
+    auto start_time = Helper::TimestampMs();
+    for (int retry = 0;; ++retry) {
+      auto status = engine->IngestExternalFile(cf_name, files);
+      if (status.ok()) {
+        break;
+      }
+
+      if (retry >= FLAGS_ingest_sst_max_retry_times) {
+        DINGO_LOG(ERROR) << fmt::format(
+            "[raft.apply][region({})] ingest sst failed after retry({}), disable region change, cf: {} files: {} "
+            "log_id: {} error: {}",
+            region->Id(), retry, cf_name, files.size(), log_id, Helper::PrintStatus(status));
+        GET_STORE_REGION_META->UpdateDisableChange(region, true);
+        if (ctx) {
+          ctx->SetStatus(butil::Status(pb::error::EINTERNAL, "ingest sst failed, error: %s", status.error_cstr()));
+        }
+        return 0;
+      }
+
+      auto region_state = region->State();
+      if (region_state == pb::common::StoreRegionState::DELETING ||
+          region_state == pb::common::StoreRegionState::DELETED ||
+          region_state == pb::common::StoreRegionState::TOMBSTONE) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.apply][region({})] region is {}, abandon ingest sst, cf: {}",
+                                          region->Id(), pb::common::StoreRegionState_Name(region_state), cf_name);
+        if (ctx) {
+          ctx->SetStatus(status);
+        }
+        return 0;
+      }
+
+      DINGO_LOG(ERROR) << fmt::format(
+          "[raft.apply][region({})] ingest sst failed, waiting retry({}), cf: {} files: {} log_id: {} error: {}",
+          region->Id(), retry, cf_name, files.size(), log_id, Helper::PrintStatus(status));
+      bthread_usleep(1000 * 1000);
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[raft.apply][region({})] ingest sst, cf: {} files: {} log_id: {} elapsed: {}ms",
+                                   region->Id(), cf_name, files.size(), log_id, Helper::TimestampMs() - start_time);
+  }
+
+  // save snapshot as soon as possible, so new or lagging peer install the ingested data from snapshot.
+  if (region->GetStoreEngineType() == pb::common::STORE_ENG_RAFT_STORE) {
+    auto raft_engine = Server::GetInstance().GetEngine(region->GetStoreEngineType());
+    if (raft_engine != nullptr) {
+      auto snapshot_ctx = std::make_shared<Context>();
+      auto status = raft_engine->AyncSaveSnapshot(snapshot_ctx, region->Id(), true);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.apply][region({})] save snapshot after ingest sst failed, error: {}",
+                                          region->Id(), Helper::PrintStatus(status));
+      }
+    }
+  }
+
+  // ingested data bypass vector/document index, so rebuild it.
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper != nullptr) {
+    VectorIndexManager::LaunchRebuildVectorIndex(vector_index_wrapper, 0, false, false, true, "ingest sst");
+  }
+
+  auto document_index_wrapper = region->DocumentIndexWrapper();
+  if (document_index_wrapper != nullptr) {
+    DocumentIndexManager::LaunchRebuildDocumentIndex(document_index_wrapper, 0, true, "ingest sst");
+  }
+
+  return 0;
+}
+
 std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   auto handler_collection = std::make_shared<HandlerCollection>();
   handler_collection->Register(std::make_shared<PutHandler>());
@@ -1537,6 +1662,7 @@ std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   handler_collection->Register(std::make_shared<RebuildVectorIndexHandler>());
   handler_collection->Register(std::make_shared<SaveRaftSnapshotHandler>());
   handler_collection->Register(std::make_shared<TxnHandler>());
+  handler_collection->Register(std::make_shared<IngestSstHandler>());
 
   return handler_collection;
 }
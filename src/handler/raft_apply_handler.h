@@ -155,6 +155,15 @@ class DocumentDeleteHandler : public BaseHandler {
              int64_t log_id) override;
 };
 
+// IngestSstRequest
+class IngestSstHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kIngestSst; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
 class TxnHandler : public BaseHandler {
  public:
   HandlerType GetType() override { return HandlerType::kTxn; }
@@ -98,6 +98,28 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
         "[txn][region({})] HandleMultiCfPutAndDelete fail, term: {} apply_log_id: {}, error: {} request: {}.",
         region->Id(), term_id, log_id, status.error_str(), request.ShortDebugString());
   }
+  // lock cf of key is changed, drop the in-memory pessimistic lock
+  auto pessimistic_lock_table = region->PessimisticLockTable();
+  if (pessimistic_lock_table != nullptr && pessimistic_lock_table->Size() > 0) {
+    std::string plain_key;
+    auto lock_puts_it = kv_puts_with_cf.find(Constant::kTxnLockCF);
+    if (lock_puts_it != kv_puts_with_cf.end()) {
+      for (const auto &kv : lock_puts_it->second) {
+        if (mvcc::Codec::DecodeKey(kv.key(), plain_key)) {
+          pessimistic_lock_table->Erase(plain_key);
+        }
+      }
+    }
+    auto lock_deletes_it = kv_deletes_with_cf.find(Constant::kTxnLockCF);
+    if (lock_deletes_it != kv_deletes_with_cf.end()) {
+      for (const auto &key : lock_deletes_it->second) {
+        if (mvcc::Codec::DecodeKey(key, plain_key)) {
+          pessimistic_lock_table->Erase(plain_key);
+        }
+      }
+    }
+  }
+
   auto tracker = ctx ? ctx->Tracker() : nullptr;
 
   // check if need to commit to vector index
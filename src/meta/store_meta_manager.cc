@@ -45,6 +45,9 @@ namespace store {
 Region::Region(int64_t region_id) {
   inner_region_.set_id(region_id);
   bthread_mutex_init(&mutex_, nullptr);
+  pessimistic_lock_table_ = PessimisticLockTable::New(region_id);
+  load_metrics_ = RegionLoadMetrics::New(region_id);
+  PublishDescriptor();
   DINGO_LOG(DEBUG) << fmt::format("[new.Region][id({})]", region_id);
 };
 
@@ -78,6 +81,7 @@ RegionPtr Region::New(const pb::common::RegionDefinition& definition) {
     region->inner_region_.set_region_type(pb::common::STORE_REGION);
   }
   *(region->inner_region_.mutable_definition()) = definition;
+  // SetState will publish descriptor with definition
   region->SetState(pb::common::StoreRegionState::NEW);
 
   return region;
@@ -114,6 +118,18 @@ void Region::DeSerialize(const std::string& data) {
   BAIDU_SCOPED_LOCK(mutex_);
   inner_region_.ParsePartialFromArray(data.data(), data.size());
   state_.store(inner_region_.state());
+  PublishDescriptor();
+}
+
+void Region::PublishDescriptor() {
+  auto descriptor = std::make_shared<RegionDescriptor>();
+  descriptor->epoch = inner_region_.definition().epoch();
+  descriptor->range = inner_region_.definition().range();
+  descriptor->encode_range = mvcc::Codec::EncodeRange(inner_region_.definition().range());
+  descriptor->state = inner_region_.state();
+  descriptor->leader_id = inner_region_.leader_id();
+
+  std::atomic_store_explicit(&descriptor_, RegionDescriptorPtr(std::move(descriptor)), std::memory_order_release);
 }
 
 pb::common::RawEngine Region::GetRawEngineType() {
@@ -127,24 +143,17 @@ pb::common::StorageEngine Region::GetStoreEngineType() {
 }
 
 bool Region::IsTxn() {
-  auto range = Range(false);
-  return Helper::IsExecutorTxn(range.start_key()) || Helper::IsClientTxn(range.start_key());
+  auto descriptor = Descriptor();
+  return Helper::IsExecutorTxn(descriptor->range.start_key()) || Helper::IsClientTxn(descriptor->range.start_key());
 }
 
-bool Region::IsExecutorTxn() {
-  auto range = Range(false);
-  return Helper::IsExecutorTxn(range.start_key());
-}
+bool Region::IsExecutorTxn() { return Helper::IsExecutorTxn(Descriptor()->range.start_key()); }
 
-bool Region::IsClientTxn() {
-  auto range = Range(false);
-  return Helper::IsClientTxn(range.start_key());
-}
+bool Region::IsClientTxn() { return Helper::IsClientTxn(Descriptor()->range.start_key()); }
 
 pb::common::RegionEpoch Region::Epoch(bool lock) {
   if (lock) {
-    BAIDU_SCOPED_LOCK(mutex_);
-    return inner_region_.definition().epoch();
+    return Descriptor()->epoch;
   } else {
     return inner_region_.definition().epoch();
   }
@@ -163,18 +172,22 @@ void Region::SetEpochVersionAndRange(int64_t version, const pb::common::Range& r
   inner_region_.mutable_definition()->mutable_epoch()->set_version(version);
 
   *(inner_region_.mutable_definition()->mutable_range()) = range;
+
+  PublishDescriptor();
 }
 
 void Region::GetEpochAndRange(pb::common::RegionEpoch& epoch, pb::common::Range& range) {
-  BAIDU_SCOPED_LOCK(mutex_);
-  epoch = inner_region_.mutable_definition()->epoch();
-  range = inner_region_.mutable_definition()->range();
+  auto descriptor = Descriptor();
+  epoch = descriptor->epoch;
+  range = descriptor->range;
 }
 
 void Region::SetEpochConfVersion(int64_t version) {
   BAIDU_SCOPED_LOCK(mutex_);
   inner_region_.set_last_change_job_id(inner_region_.last_change_job_id() + 1);
   inner_region_.mutable_definition()->mutable_epoch()->set_conf_version(version);
+
+  PublishDescriptor();
 }
 
 void Region::SetSnapshotEpochVersion(int64_t version) {
@@ -182,22 +195,19 @@ void Region::SetSnapshotEpochVersion(int64_t version) {
   inner_region_.set_snapshot_epoch_version(version);
 }
 
-int64_t Region::LeaderId() {
-  BAIDU_SCOPED_LOCK(mutex_);
-  return inner_region_.leader_id();
-}
+int64_t Region::LeaderId() { return Descriptor()->leader_id; }
 
 void Region::SetLeaderId(int64_t leader_id) {
   BAIDU_SCOPED_LOCK(mutex_);
   inner_region_.set_leader_id(leader_id);
+
+  PublishDescriptor();
 }
 
 pb::common::Range Region::Range(bool is_encode, bool lock) {
   if (lock) {
-    BAIDU_SCOPED_LOCK(mutex_);
-
-    return is_encode ? mvcc::Codec::EncodeRange(inner_region_.definition().range())
-                     : inner_region_.definition().range();
+    auto descriptor = Descriptor();
+    return is_encode ? descriptor->encode_range : descriptor->range;
   } else {
     return is_encode ? mvcc::Codec::EncodeRange(inner_region_.definition().range())
                      : inner_region_.definition().range();
@@ -207,15 +217,11 @@ pb::common::Range Region::Range(bool is_encode, bool lock) {
 std::string Region::RangeToString(bool is_encode) { return Helper::RangeToString(Range(is_encode)); }
 
 bool Region::CheckKeyInRange(const std::string& key) {
-  auto region_range = Range();
-  return key >= region_range.start_key() && key < region_range.end_key();
+  auto descriptor = Descriptor();
+  return key >= descriptor->range.start_key() && key < descriptor->range.end_key();
 }
 
-char Region::GetKeyPrefix() {
-  BAIDU_SCOPED_LOCK(mutex_);
-
-  return Helper::GetKeyPrefix(inner_region_.definition().range().start_key());
-}
+char Region::GetKeyPrefix() { return Helper::GetKeyPrefix(Descriptor()->range.start_key()); }
 
 void Region::SetIndexParameter(const pb::common::IndexParameter& index_parameter) {
   BAIDU_SCOPED_LOCK(mutex_);
@@ -248,6 +254,8 @@ void Region::SetState(pb::common::StoreRegionState state) {
   {
     BAIDU_SCOPED_LOCK(mutex_);
     inner_region_.set_state(state);
+
+    PublishDescriptor();
   }
 }
 
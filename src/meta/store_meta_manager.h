@@ -34,9 +34,11 @@
 #include "common/safe_map.h"
 #include "document/document_index.h"
 #include "engine/gc_safe_point.h"
+#include "engine/txn_pessimistic_lock_table.h"
 #include "meta/meta_reader.h"
 #include "meta/meta_writer.h"
 #include "meta/transform_kv_able.h"
+#include "metrics/region_load_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/node.pb.h"
 #include "proto/raft.pb.h"
@@ -52,6 +54,20 @@ namespace store {
 class Region;
 using RegionPtr = std::shared_ptr<Region>;
 
+// Immutable snapshot of the region meta which request validation depends on.
+// Region republish a new descriptor when epoch/range/state/leader changed, the readers only load the pointer,
+// no region mutex and no protobuf copy.
+struct RegionDescriptor {
+  pb::common::RegionEpoch epoch;
+  // user key range
+  pb::common::Range range;
+  // encode key range
+  pb::common::Range encode_range;
+  pb::common::StoreRegionState state{pb::common::StoreRegionState::NEW};
+  int64_t leader_id{0};
+};
+using RegionDescriptorPtr = std::shared_ptr<const RegionDescriptor>;
+
 // Warp pb region for atomic/metux
 class Region {
  public:
@@ -85,6 +101,9 @@ class Region {
   bool IsExecutorTxn();
   bool IsClientTxn();
 
+  // the returned descriptor is never changed, hold it as long as need a consistent view.
+  RegionDescriptorPtr Descriptor() const { return std::atomic_load_explicit(&descriptor_, std::memory_order_acquire); }
+
   pb::common::RegionEpoch Epoch(bool lock = true);
   std::string EpochToString();
   void SetEpochVersionAndRange(int64_t version, const pb::common::Range& range);
@@ -145,6 +164,10 @@ class Region {
   VectorIndexWrapperPtr VectorIndexWrapper() { return vector_index_wapper_; }
   void SetVectorIndexWrapper(VectorIndexWrapperPtr vector_index_wapper) { vector_index_wapper_ = vector_index_wapper; }
 
+  PessimisticLockTablePtr PessimisticLockTable() { return pessimistic_lock_table_; }
+
+  RegionLoadMetricsPtr LoadMetrics() { return load_metrics_; }
+
   DocumentIndexWrapperPtr DocumentIndexWrapper() { return document_index_wapper_; }
   void SetDocumentIndexWrapper(DocumentIndexWrapperPtr document_index_wapper) {
     document_index_wapper_ = document_index_wapper;
@@ -186,6 +209,9 @@ class Region {
   int64_t TxnAppliedMaxTs() { return txn_applied_max_ts_.load(std::memory_order_acquire); }
 
  private:
+  // need hold mutex_
+  void PublishDescriptor();
+
   bthread_mutex_t mutex_;
   pb::store_internal::Region inner_region_;
   std::atomic<pb::common::StoreRegionState> state_;
@@ -199,10 +225,19 @@ class Region {
   VectorIndexWrapperPtr vector_index_wapper_{nullptr};
   DocumentIndexWrapperPtr document_index_wapper_{nullptr};
 
+  // in-memory pessimistic locks on leader
+  PessimisticLockTablePtr pessimistic_lock_table_{nullptr};
+
+  // read/write load for hotspot scheduling
+  RegionLoadMetricsPtr load_metrics_{nullptr};
+
   // latches is for multi request concurrency control
   Latches latches_;
 
   Statistics statistics_;
+
+  // published by PublishDescriptor, access with std::atomic_load/atomic_store
+  RegionDescriptorPtr descriptor_;
 };
 
 class RaftMeta {
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metrics/region_load_metrics.h"
+
+#include <cstdint>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_load_metrics, true, "enable region read/write load metrics for hotspot scheduling");
+
+// avoid the rates jitter when aggregate too frequently
+constexpr int64_t kMinAggregateIntervalMs = 100;
+
+RegionLoadMetrics::RegionLoadMetrics(int64_t region_id) : region_id_(region_id) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+RegionLoadMetrics::~RegionLoadMetrics() { bthread_mutex_destroy(&mutex_); }
+
+static int64_t CalcRate(int64_t total, int64_t last_total, int64_t interval_ms) {
+  // counters never decrease, but keep safe
+  return total > last_total ? (total - last_total) * 1000 / interval_ms : 0;
+}
+
+bool RegionLoadMetrics::Aggregate(int64_t now_ms) {
+  Stats totals;
+  totals.read_count = read_count_.get_value();
+  totals.read_keys = read_keys_.get_value();
+  totals.read_bytes = read_bytes_.get_value();
+  totals.write_count = write_count_.get_value();
+  totals.write_keys = write_keys_.get_value();
+  totals.write_bytes = write_bytes_.get_value();
+  totals.raft_commit_count = raft_commit_count_.get_value();
+  totals.raft_apply_count = raft_apply_count_.get_value();
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  // first aggregate only take the baseline
+  if (last_aggregate_time_ms_ == 0) {
+    last_aggregate_time_ms_ = now_ms;
+    last_totals_ = totals;
+    return false;
+  }
+
+  int64_t interval_ms = now_ms - last_aggregate_time_ms_;
+  if (interval_ms < kMinAggregateIntervalMs) {
+    return false;
+  }
+
+  rates_.read_count = CalcRate(totals.read_count, last_totals_.read_count, interval_ms);
+  rates_.read_keys = CalcRate(totals.read_keys, last_totals_.read_keys, interval_ms);
+  rates_.read_bytes = CalcRate(totals.read_bytes, last_totals_.read_bytes, interval_ms);
+  rates_.write_count = CalcRate(totals.write_count, last_totals_.write_count, interval_ms);
+  rates_.write_keys = CalcRate(totals.write_keys, last_totals_.write_keys, interval_ms);
+  rates_.write_bytes = CalcRate(totals.write_bytes, last_totals_.write_bytes, interval_ms);
+  rates_.raft_commit_count = CalcRate(totals.raft_commit_count, last_totals_.raft_commit_count, interval_ms);
+  rates_.raft_apply_count = CalcRate(totals.raft_apply_count, last_totals_.raft_apply_count, interval_ms);
+
+  last_aggregate_time_ms_ = now_ms;
+  last_totals_ = totals;
+
+  return true;
+}
+
+RegionLoadMetrics::Stats RegionLoadMetrics::Rates() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return rates_;
+}
+
+std::string RegionLoadMetrics::ToString() {
+  auto rates = Rates();
+  return fmt::format(
+      "region({}) read_qps({}) read_keys({}/s) read_bytes({}/s) write_qps({}) write_keys({}/s) write_bytes({}/s) "
+      "raft_commit({}/s) raft_apply({}/s)",
+      region_id_, rates.read_count, rates.read_keys, rates.read_bytes, rates.write_count, rates.write_keys,
+      rates.write_bytes, rates.raft_commit_count, rates.raft_apply_count);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,125 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_METRICS_REGION_LOAD_METRICS_H_
+#define DINGODB_METRICS_REGION_LOAD_METRICS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bthread/types.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_region_load_metrics);
+
+class RegionLoadMetrics;
+using RegionLoadMetricsPtr = std::shared_ptr<RegionLoadMetrics>;
+
+// Read/write load of a region, used for hotspot scheduling.
+// The handle is created with region and held by the hot path(service/raft commit/raft apply), update only touch
+// the thread local agent of bvar::Adder, no string-keyed lookup and no lock.
+// Aggregate() is called by the crontab periodically, which turn the counters into per second rates.
+class RegionLoadMetrics {
+ public:
+  struct Stats {
+    int64_t read_count{0};
+    int64_t read_keys{0};
+    int64_t read_bytes{0};
+    int64_t write_count{0};
+    int64_t write_keys{0};
+    int64_t write_bytes{0};
+    int64_t raft_commit_count{0};
+    int64_t raft_apply_count{0};
+  };
+
+  RegionLoadMetrics(int64_t region_id);
+  ~RegionLoadMetrics();
+
+  RegionLoadMetrics(const RegionLoadMetrics&) = delete;
+  const RegionLoadMetrics& operator=(const RegionLoadMetrics&) = delete;
+
+  static RegionLoadMetricsPtr New(int64_t region_id) { return std::make_shared<RegionLoadMetrics>(region_id); }
+
+  int64_t RegionId() const { return region_id_; }
+
+  void AddRead(int64_t keys, int64_t bytes) {
+    if (!FLAGS_enable_region_load_metrics) {
+      return;
+    }
+    read_count_ << 1;
+    read_keys_ << keys;
+    read_bytes_ << bytes;
+  }
+
+  void AddWrite(int64_t keys, int64_t bytes) {
+    if (!FLAGS_enable_region_load_metrics) {
+      return;
+    }
+    write_count_ << 1;
+    write_keys_ << keys;
+    write_bytes_ << bytes;
+  }
+
+  // bytes is the serialized size of message, ByteSizeLong() walk the whole message, so only call it when enabled.
+  template <typename Message>
+  void AddRead(int64_t keys, const Message* message) {
+    if (FLAGS_enable_region_load_metrics) {
+      AddRead(keys, static_cast<int64_t>(message->ByteSizeLong()));
+    }
+  }
+
+  template <typename Message>
+  void AddWrite(int64_t keys, const Message* message) {
+    if (FLAGS_enable_region_load_metrics) {
+      AddWrite(keys, static_cast<int64_t>(message->ByteSizeLong()));
+    }
+  }
+
+  void IncRaftCommit() { raft_commit_count_ << 1; }
+  void IncRaftApply() { raft_apply_count_ << 1; }
+
+  // calculate rates since last aggregate, return false if the interval is too short.
+  bool Aggregate(int64_t now_ms);
+
+  // per second rates of last aggregate
+  Stats Rates();
+
+  std::string ToString();
+
+ private:
+  int64_t region_id_;
+
+  bvar::Adder<int64_t> read_count_;
+  bvar::Adder<int64_t> read_keys_;
+  bvar::Adder<int64_t> read_bytes_;
+  bvar::Adder<int64_t> write_count_;
+  bvar::Adder<int64_t> write_keys_;
+  bvar::Adder<int64_t> write_bytes_;
+  bvar::Adder<int64_t> raft_commit_count_;
+  bvar::Adder<int64_t> raft_apply_count_;
+
+  // protect below members
+  bthread_mutex_t mutex_;
+  int64_t last_aggregate_time_ms_{0};
+  Stats last_totals_;
+  Stats rates_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_METRICS_REGION_LOAD_METRICS_H_
@@ -18,10 +18,12 @@
 #include <string>
 
 #include "bvar/bvar.h"
+#include "bvar/latency_recorder.h"
 #include "bvar/multi_dimension.h"
 #include "bvar/reducer.h"
 #include "bvar/status.h"
 #include "common/helper.h"
+#include "metrics/region_load_metrics.h"
 
 namespace dingodb {
 
@@ -31,7 +33,12 @@ class StoreBvarMetrics {
       : leader_switch_time_("dingo_metrics_store_raft_leader_switch_time", {"region"}),
         leader_switch_count_("dingo_metrics_store_raft_leader_switch_count", {"region"}),
         commit_count_per_second_("dingo_metrics_store_raft_commit_count_per_second", {"region"}),
-        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}) {}
+        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}),
+        read_qps_("dingo_metrics_store_region_read_qps", {"region"}),
+        read_bytes_per_second_("dingo_metrics_store_region_read_bytes_per_second", {"region"}),
+        write_qps_("dingo_metrics_store_region_write_qps", {"region"}),
+        write_bytes_per_second_("dingo_metrics_store_region_write_bytes_per_second", {"region"}),
+        latch_wait_time_("dingo_metrics_store_latch_wait_time_us", {"region"}) {}
   ~StoreBvarMetrics() = default;
 
   StoreBvarMetrics(const StoreBvarMetrics&) = delete;
@@ -53,17 +60,21 @@ class StoreBvarMetrics {
     }
   }
 
-  void IncCommitCountPerSecond(std::string region_id) {
-    auto* region_stat = commit_count_per_second_.get_stats({region_id});
-    if (region_stat != nullptr) {
-      *region_stat << 1;
-    }
+  // called by region load metrics aggregator, the hot path update RegionLoadMetrics instead.
+  void UpdateRegionLoad(std::string region_id, const RegionLoadMetrics::Stats& rates) {
+    SetStatsValue(commit_count_per_second_, region_id, rates.raft_commit_count);
+    SetStatsValue(apply_count_per_second_, region_id, rates.raft_apply_count);
+    SetStatsValue(read_qps_, region_id, rates.read_count);
+    SetStatsValue(read_bytes_per_second_, region_id, rates.read_bytes);
+    SetStatsValue(write_qps_, region_id, rates.write_count);
+    SetStatsValue(write_bytes_per_second_, region_id, rates.write_bytes);
   }
 
-  void IncApplyCountPerSecond(std::string region_id) {
-    auto* region_stat = apply_count_per_second_.get_stats({region_id});
+  // only record contended acquire, uncontended acquire is the hot path
+  void UpdateLatchWaitTime(std::string region_id, int64_t time_us) {
+    auto* region_stat = latch_wait_time_.get_stats({region_id});
     if (region_stat != nullptr) {
-      *region_stat << 1;
+      *region_stat << time_us;
     }
   }
 
@@ -80,13 +91,42 @@ class StoreBvarMetrics {
     if (apply_count_per_second_.has_stats({region_id})) {
       apply_count_per_second_.delete_stats({region_id});
     }
+    if (read_qps_.has_stats({region_id})) {
+      read_qps_.delete_stats({region_id});
+    }
+    if (read_bytes_per_second_.has_stats({region_id})) {
+      read_bytes_per_second_.delete_stats({region_id});
+    }
+    if (write_qps_.has_stats({region_id})) {
+      write_qps_.delete_stats({region_id});
+    }
+    if (write_bytes_per_second_.has_stats({region_id})) {
+      write_bytes_per_second_.delete_stats({region_id});
+    }
+    if (latch_wait_time_.has_stats({region_id})) {
+      latch_wait_time_.delete_stats({region_id});
+    }
   }
 
  private:
+  static void SetStatsValue(bvar::MultiDimension<bvar::Status<int64_t>>& metrics, const std::string& region_id,
+                            int64_t value) {
+    auto* region_stat = metrics.get_stats({region_id});
+    if (region_stat != nullptr) {
+      region_stat->set_value(value);
+    }
+  }
+
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_time_;
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_count_;
-  bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> commit_count_per_second_;
-  bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> apply_count_per_second_;
+  // below are per second rates aggregated from RegionLoadMetrics
+  bvar::MultiDimension<bvar::Status<int64_t>> commit_count_per_second_;
+  bvar::MultiDimension<bvar::Status<int64_t>> apply_count_per_second_;
+  bvar::MultiDimension<bvar::Status<int64_t>> read_qps_;
+  bvar::MultiDimension<bvar::Status<int64_t>> read_bytes_per_second_;
+  bvar::MultiDimension<bvar::Status<int64_t>> write_qps_;
+  bvar::MultiDimension<bvar::Status<int64_t>> write_bytes_per_second_;
+  bvar::MultiDimension<bvar::LatencyRecorder> latch_wait_time_;
 };
 
 }  // namespace dingodb
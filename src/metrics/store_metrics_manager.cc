@@ -28,6 +28,7 @@
 #include "config/config_manager.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "metrics/store_bvar_metrics.h"
 #include "mvcc/codec.h"
 #include "mvcc/reader.h"
 #include "proto/common.pb.h"
@@ -737,4 +738,27 @@ void StoreMetricsManager::CollectStoreRegionMetrics() {
   is_collecting_.store(false);
 }
 
-}  // namespace dingodb
\ No newline at end of file
+void StoreMetricsManager::CollectRegionLoadMetrics() {
+  if (is_collecting_region_load_.load()) {
+    DINGO_LOG(WARNING) << "Already exist collecting region load metrics.";
+    return;
+  }
+
+  is_collecting_region_load_.store(true);
+
+  int64_t now_ms = Helper::TimestampMs();
+  auto regions = Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->GetAllRegion();
+  for (const auto& region : regions) {
+    auto load_metrics = region->LoadMetrics();
+    if (load_metrics == nullptr || !load_metrics->Aggregate(now_ms)) {
+      continue;
+    }
+
+    StoreBvarMetrics::GetInstance().UpdateRegionLoad(std::to_string(region->Id()), load_metrics->Rates());
+    DINGO_LOG(DEBUG) << fmt::format("[metrics.region_load] {}", load_metrics->ToString());
+  }
+
+  is_collecting_region_load_.store(false);
+}
+
+}  // namespace dingodb
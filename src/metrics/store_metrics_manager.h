@@ -373,6 +373,7 @@ class StoreMetricsManager {
       : is_collecting_(false),
         is_collecting_store_(false),
         is_collecting_approximate_size_(false),
+        is_collecting_region_load_(false),
         store_metrics_(std::make_shared<StoreMetrics>()),
         region_metrics_(std::make_shared<StoreRegionMetrics>(meta_reader, meta_writer)) {}
   ~StoreMetricsManager() = default;
@@ -385,6 +386,8 @@ class StoreMetricsManager {
   void CollectApproximateSizeMetrics();
   void CollectStoreMetrics();
   void CollectStoreRegionMetrics();
+  // Aggregate region read/write load counters into rates, and export to bvar.
+  void CollectRegionLoadMetrics();
 
   std::shared_ptr<StoreMetrics> GetStoreMetrics() { return store_metrics_; }
   std::shared_ptr<StoreRegionMetrics> GetStoreRegionMetrics() { return region_metrics_; }
@@ -394,6 +397,7 @@ class StoreMetricsManager {
   std::atomic<bool> is_collecting_;
   std::atomic<bool> is_collecting_store_;
   std::atomic<bool> is_collecting_approximate_size_;
+  std::atomic<bool> is_collecting_region_load_;
   std::shared_ptr<StoreMetrics> store_metrics_;
   std::shared_ptr<StoreRegionMetrics> region_metrics_;
 };
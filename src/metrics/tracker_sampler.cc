@@ -0,0 +1,170 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metrics/tracker_sampler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_tracker_sample, true, "enable aggregate tracker stages into latency histograms");
+DEFINE_int32(tracker_sample_interval, 16, "record latency histograms every N requests");
+BRPC_VALIDATE_GFLAG(tracker_sample_interval, brpc::PositiveInteger);
+DEFINE_int32(tracker_slow_request_num, 32, "keep slowest N requests with stage breakdown");
+BRPC_VALIDATE_GFLAG(tracker_slow_request_num, brpc::NonNegativeInteger);
+
+static bool SlowRequestGreater(const TrackerSampler::SlowRequest& lhs, const TrackerSampler::SlowRequest& rhs) {
+  return lhs.metrics.total_rpc_time_ns > rhs.metrics.total_rpc_time_ns;
+}
+
+TrackerSampler::TrackerSampler()
+    : total_latency_("dingo_tracker_request_latency", {"method", "region"}),
+      stage_latency_("dingo_tracker_request_stage_latency", {"method", "stage"}) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+TrackerSampler::~TrackerSampler() { bthread_mutex_destroy(&mutex_); }
+
+TrackerSampler& TrackerSampler::GetInstance() {
+  static TrackerSampler tracker_sampler;
+  return tracker_sampler;
+}
+
+void TrackerSampler::Sample(const std::string& method, int64_t region_id, TrackerPtr tracker) {
+  if (!FLAGS_enable_tracker_sample || tracker == nullptr) {
+    return;
+  }
+
+  const auto& metrics = tracker->GetMetrics();
+  if (sample_count_.fetch_add(1, std::memory_order_relaxed) % FLAGS_tracker_sample_interval == 0) {
+    RecordLatency(method, region_id, metrics);
+  }
+
+  // slow request is not sampled, otherwise the slowest one may be missed.
+  if (metrics.total_rpc_time_ns > slow_threshold_ns_.load(std::memory_order_relaxed)) {
+    RecordSlowRequest(method, region_id, tracker);
+  }
+}
+
+void TrackerSampler::DeleteRegion(int64_t region_id) {
+  std::string region = std::to_string(region_id);
+
+  std::vector<bvar::MultiDimension<bvar::LatencyRecorder>::key_type> labels_values;
+  total_latency_.list_stats(&labels_values);
+  for (const auto& labels_value : labels_values) {
+    if (labels_value.size() == 2 && labels_value.back() == region) {
+      total_latency_.delete_stats(labels_value);
+    }
+  }
+}
+
+void TrackerSampler::RecordLatency(const std::string& method, int64_t region_id, const Tracker::Metrics& metrics) {
+  auto* total_stat = total_latency_.get_stats({method, std::to_string(region_id)});
+  if (total_stat != nullptr) {
+    *total_stat << metrics.total_rpc_time_ns / 1000;
+  }
+
+  // only record the stages which request pass through
+  auto record_stage = [&](const std::string& stage, uint64_t time_ns) {
+    if (time_ns == 0) {
+      return;
+    }
+    auto* stage_stat = stage_latency_.get_stats({method, stage});
+    if (stage_stat != nullptr) {
+      *stage_stat << time_ns / 1000;
+    }
+  };
+
+  record_stage("service_queue", metrics.service_queue_wait_time_ns);
+  record_stage("prepair_commit", metrics.prepair_commit_time_ns);
+  record_stage("raft_commit", metrics.raft_commit_time_ns);
+  record_stage("raft_queue_wait", metrics.raft_queue_wait_time_ns);
+  record_stage("raft_apply", metrics.raft_apply_time_ns);
+  record_stage("store_write", metrics.store_write_time_ns);
+  record_stage("vector_index_write", metrics.vector_index_write_time_ns);
+  record_stage("document_index_write", metrics.document_index_write_time_ns);
+  record_stage("read_store", metrics.read_store_time_ns);
+  record_stage("lock_check", metrics.lock_check_time_ns);
+  record_stage("iterator_seek", metrics.iterator_seek_time_ns);
+  record_stage("coprocessor", metrics.coprocessor_time_ns);
+  record_stage("vector_search", metrics.vector_search_time_ns);
+  record_stage("scalar_filter", metrics.scalar_filter_time_ns);
+}
+
+void TrackerSampler::RecordSlowRequest(const std::string& method, int64_t region_id, TrackerPtr tracker) {
+  size_t max_num = FLAGS_tracker_slow_request_num;
+  if (max_num == 0) {
+    return;
+  }
+
+  SlowRequest slow_request;
+  slow_request.method = method;
+  slow_request.region_id = region_id;
+  slow_request.request_id = tracker->RequestInfo().request_id();
+  slow_request.timestamp_ms = Helper::TimestampMs();
+  slow_request.metrics = tracker->GetMetrics();
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  // the flag may be decreased
+  while (slow_requests_.size() > max_num) {
+    std::pop_heap(slow_requests_.begin(), slow_requests_.end(), SlowRequestGreater);
+    slow_requests_.pop_back();
+  }
+
+  if (slow_requests_.size() == max_num &&
+      slow_request.metrics.total_rpc_time_ns > slow_requests_.front().metrics.total_rpc_time_ns) {
+    std::pop_heap(slow_requests_.begin(), slow_requests_.end(), SlowRequestGreater);
+    slow_requests_.pop_back();
+  }
+
+  if (slow_requests_.size() < max_num) {
+    slow_requests_.push_back(std::move(slow_request));
+    std::push_heap(slow_requests_.begin(), slow_requests_.end(), SlowRequestGreater);
+  }
+
+  // the flag may be increased, so reset threshold when not full
+  slow_threshold_ns_.store(slow_requests_.size() == max_num ? slow_requests_.front().metrics.total_rpc_time_ns : 0,
+                           std::memory_order_relaxed);
+}
+
+std::vector<TrackerSampler::SlowRequest> TrackerSampler::GetSlowRequests() {
+  std::vector<SlowRequest> slow_requests;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    slow_requests = slow_requests_;
+  }
+
+  std::sort(slow_requests.begin(), slow_requests.end(), SlowRequestGreater);
+
+  return slow_requests;
+}
+
+void TrackerSampler::ClearSlowRequests() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  slow_requests_.clear();
+  slow_threshold_ns_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace dingodb
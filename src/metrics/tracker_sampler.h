@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_METRICS_TRACKER_SAMPLER_H_
+#define DINGODB_METRICS_TRACKER_SAMPLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/multi_dimension.h"
+#include "common/tracker.h"
+
+namespace dingodb {
+
+// Aggregate the stages of Tracker into latency histograms when request finish.
+// total latency is keyed by {method, region}, the stats of a region is deleted when the region is deleted.
+// stage latency is keyed by {method, stage} to bound the cardinality, the slowest N requests are kept with
+// full stage breakdown and region for DebugService.
+class TrackerSampler {
+ public:
+  struct SlowRequest {
+    std::string method;
+    int64_t region_id{0};
+    int64_t request_id{0};
+    int64_t timestamp_ms{0};
+    Tracker::Metrics metrics;
+  };
+
+  TrackerSampler();
+  ~TrackerSampler();
+
+  TrackerSampler(const TrackerSampler&) = delete;
+  void operator=(const TrackerSampler&) = delete;
+
+  static TrackerSampler& GetInstance();
+
+  // called by service closure when request finish, tracker total rpc time must be set.
+  void Sample(const std::string& method, int64_t region_id, TrackerPtr tracker);
+
+  // delete total latency stats of the region, called when region is deleted.
+  void DeleteRegion(int64_t region_id);
+
+  // order by total rpc time desc
+  std::vector<SlowRequest> GetSlowRequests();
+  void ClearSlowRequests();
+
+ private:
+  void RecordLatency(const std::string& method, int64_t region_id, const Tracker::Metrics& metrics);
+  void RecordSlowRequest(const std::string& method, int64_t region_id, TrackerPtr tracker);
+
+  std::atomic<uint64_t> sample_count_{0};
+
+  bvar::MultiDimension<bvar::LatencyRecorder> total_latency_;
+  bvar::MultiDimension<bvar::LatencyRecorder> stage_latency_;
+
+  // min total rpc time of slow requests when it is full, fast skip fast requests without lock.
+  std::atomic<uint64_t> slow_threshold_ns_{0};
+
+  bthread_mutex_t mutex_;
+  // min heap by total rpc time
+  std::vector<SlowRequest> slow_requests_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_METRICS_TRACKER_SAMPLER_H_
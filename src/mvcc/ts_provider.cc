@@ -14,6 +14,7 @@
 
 #include "mvcc/ts_provider.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -25,7 +26,7 @@
 #include "glog/logging.h"
 #include "proto/meta.pb.h"
 
-DEFINE_uint32(ts_provider_batch_size, 100, "get tso batch size");
+DEFINE_uint32(ts_provider_batch_size, 100, "get tso batch size, it is min batch size when enable adaptive prefetch");
 DEFINE_uint32(ts_provider_send_retry_num, 8, "send tso request retry num");
 DEFINE_uint32(ts_provider_max_retry_num, 16, "get tso max retry num");
 DEFINE_uint32(ts_provider_renew_max_retry_num, 16, "renew max retry num");
@@ -33,6 +34,12 @@ DEFINE_uint32(ts_provider_renew_max_retry_num, 16, "renew max retry num");
 DEFINE_uint32(ts_provider_clean_dead_interval_ms, 3000, "clean dead interval time");
 DEFINE_uint32(ts_provider_batch_ts_stale_interval_ms, 3000, "batch ts stale interval time");
 
+DEFINE_bool(ts_provider_enable_adaptive_prefetch, true, "enable prefetch BatchTs and adjust batch size by consume rate");
+DEFINE_uint32(ts_provider_max_batch_size, 10000, "max adaptive batch size");
+DEFINE_uint32(ts_provider_batch_cover_ms, 100, "adaptive batch size cover the consumption of this time");
+DEFINE_uint32(ts_provider_prefetch_latency_multiple, 2,
+              "prefetch watermark cover the consumption of this multiple tso latency");
+
 namespace dingodb {
 
 namespace mvcc {
@@ -269,6 +276,17 @@ uint32_t BatchTsList::ActualDeadCount() {
   return count;
 }
 
+int64_t BatchTsList::Remain() {
+  int64_t remain = 0;
+  BatchTs* node = head_.load();
+  while (node) {
+    remain += node->Remain();
+    node = node->next.load();
+  }
+
+  return remain;
+}
+
 std::string BatchTsList::DebugInfo() {
   bool is_valid = head_.load() == tail_.load();
   bool is_dead_valid = dead_head_.load() == dead_tail_.load();
@@ -279,19 +297,33 @@ std::string BatchTsList::DebugInfo() {
 }
 
 bool TsProvider::Init() {
+  batch_size_.store(FLAGS_ts_provider_batch_size, std::memory_order_relaxed);
+  watermark_.store(FLAGS_ts_provider_batch_size / 4, std::memory_order_relaxed);
+
   bool ret = worker_->Init();
   return ret;
 }
 
 int64_t TsProvider::GetTs(int64_t after_ts) {
+  int64_t stall_start_time = 0;
   uint32_t retry_count = 0;
   for (; retry_count < FLAGS_ts_provider_max_retry_num; ++retry_count) {
     int64_t ts = batch_ts_list_->GetTs(after_ts);
     if (ts > 0) {
       get_ts_count_ << 1;
+      if (stall_start_time > 0) {
+        stall_latency_ << Helper::TimestampUs() - stall_start_time;
+      }
+
+      MaybePrefetch();
       return ts;
     }
 
+    if (stall_start_time == 0) {
+      stall_start_time = Helper::TimestampUs();
+      stall_count_ << 1;
+    }
+
     LaunchRenewBatchTs(true);
   }
 
@@ -299,14 +331,81 @@ int64_t TsProvider::GetTs(int64_t after_ts) {
     DINGO_LOG(ERROR) << fmt::format("get ts retry({}) too much.", retry_count);
   }
 
+  if (stall_start_time > 0) {
+    stall_latency_ << Helper::TimestampUs() - stall_start_time;
+  }
   get_ts_fail_count_ << 1;
 
   return 0;
 }
 
+void TsProvider::MaybePrefetch() {
+  if (!FLAGS_ts_provider_enable_adaptive_prefetch) {
+    return;
+  }
+
+  if (is_prefetching_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  if (batch_ts_list_->Remain() >= watermark_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // only one prefetch in flight
+  bool expected = false;
+  if (!is_prefetching_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  auto task = std::make_shared<TakeBatchTsTask>(false, RenewEpoch(), GetSelfPtr(), true);
+  if (!worker_->Execute(task)) {
+    DINGO_LOG(ERROR) << "Launch prefetch batch ts failed.";
+    FinishPrefetch();
+    return;
+  }
+
+  prefetch_count_ << 1;
+}
+
+void TsProvider::AdjustPrefetch(int64_t tso_latency_us) {
+  // smooth by exponential moving average
+  tso_latency_us_ = tso_latency_us_ == 0 ? tso_latency_us : (tso_latency_us_ + tso_latency_us) / 2;
+
+  int64_t now_ms = Helper::TimestampMs();
+  uint64_t get_ts_count = GetTsCount();
+  if (last_adjust_time_ms_ > 0) {
+    int64_t elapsed_ms = std::max(now_ms - last_adjust_time_ms_, static_cast<int64_t>(1));
+    double rate = static_cast<double>(get_ts_count - last_get_ts_count_) / elapsed_ms;
+    consume_rate_ = consume_rate_ == 0 ? rate : (consume_rate_ + rate) / 2;
+  }
+  last_adjust_time_ms_ = now_ms;
+  last_get_ts_count_ = get_ts_count;
+
+  if (!FLAGS_ts_provider_enable_adaptive_prefetch) {
+    batch_size_.store(FLAGS_ts_provider_batch_size, std::memory_order_relaxed);
+    return;
+  }
+
+  uint32_t min_batch_size = FLAGS_ts_provider_batch_size;
+  uint32_t max_batch_size = std::max(FLAGS_ts_provider_max_batch_size, min_batch_size);
+  double expect_batch_size = consume_rate_ * FLAGS_ts_provider_batch_cover_ms;
+  uint32_t batch_size = static_cast<uint32_t>(
+      std::clamp(expect_batch_size, static_cast<double>(min_batch_size), static_cast<double>(max_batch_size)));
+
+  // remain ts should be enough until the prefetch response arrive
+  int64_t watermark = static_cast<int64_t>(consume_rate_ * tso_latency_us_ / 1000 *
+                                           FLAGS_ts_provider_prefetch_latency_multiple);
+  watermark = std::clamp(watermark, static_cast<int64_t>(batch_size / 4), static_cast<int64_t>(batch_size));
+
+  batch_size_.store(batch_size, std::memory_order_relaxed);
+  watermark_.store(watermark, std::memory_order_relaxed);
+}
+
 void TsProvider::RenewBatchTs() {
   for (uint32_t retry_count = 0; retry_count < FLAGS_ts_provider_renew_max_retry_num; ++retry_count) {
-    BatchTs* batch_ts = SendTsoRequest();
+    int64_t start_time = Helper::TimestampUs();
+    BatchTs* batch_ts = SendTsoRequest(batch_size_.load(std::memory_order_relaxed));
     if (batch_ts == nullptr) {
       bthread_usleep(2000);
       continue;
@@ -314,6 +413,7 @@ void TsProvider::RenewBatchTs() {
 
     batch_ts_list_->Push(batch_ts);
     renew_epoch_ << 1;
+    AdjustPrefetch(Helper::TimestampUs() - start_time);
     // clean dead BatchTs
     batch_ts_list_->CleanDead();
     return;
@@ -338,8 +438,9 @@ void TsProvider::LaunchRenewBatchTs(bool is_sync) {
 void TsProvider::TriggerRenewBatchTs() { LaunchRenewBatchTs(false); }
 
 std::string TsProvider::DebugInfo() {
-  return fmt::format("{} ts_count({}/{}) renew({})", batch_ts_list_->DebugInfo(), GetTsCount(), GetTsFailCount(),
-                     RenewEpoch());
+  return fmt::format("{} ts_count({}/{}) renew({}) stall({}) prefetch({}) batch_size({}) watermark({}) remain({})",
+                     batch_ts_list_->DebugInfo(), GetTsCount(), GetTsFailCount(), RenewEpoch(), StallCount(),
+                     PrefetchCount(), BatchSize(), Watermark(), Remain());
 }
 
 // for test
@@ -360,10 +461,10 @@ BatchTs* GenBatchTsForTest() {
   return batch_ts;
 }
 
-BatchTs* TsProvider::SendTsoRequest() {
+BatchTs* TsProvider::SendTsoRequest(uint32_t batch_size) {
   pb::meta::TsoRequest tso_request;
   tso_request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
-  tso_request.set_count(FLAGS_ts_provider_batch_size);
+  tso_request.set_count(batch_size > 0 ? batch_size : FLAGS_ts_provider_batch_size);
 
   pb::meta::TsoResponse tso_response;
   auto status = interaction_->SendRequest(pb::common::ServiceTypeMeta, "TsoService", tso_request, tso_response);
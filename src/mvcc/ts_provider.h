@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/runnable.h"
 #include "common/synchronization.h"
 
@@ -117,6 +119,9 @@ class BatchTsList {
   uint32_t ActualCount();
   uint32_t ActualDeadCount();
 
+  // remain ts of all available BatchTs
+  int64_t Remain();
+
   int64_t ActiveCount() const { return active_count_.load(std::memory_order_relaxed); }
   int64_t DeadCount() const { return dead_count_.load(std::memory_order_relaxed); }
 
@@ -157,11 +162,14 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
       : interaction_(interaction),
         get_ts_count_("dingo_ts_provider_get_ts_count"),
         get_ts_fail_count_("dingo_ts_provider_get_ts_fail_count"),
-        renew_epoch_("dingo_ts_provider_renew_epoch") {
+        renew_epoch_("dingo_ts_provider_renew_epoch"),
+        stall_count_("dingo_ts_provider_stall_count"),
+        stall_latency_("dingo_ts_provider_stall"),
+        prefetch_count_("dingo_ts_provider_prefetch_count") {
     worker_ = Worker::New();
     batch_ts_list_ = BatchTsList::New();
   }
-  ~TsProvider() = default;
+  virtual ~TsProvider() = default;
 
   TsProviderPtr GetSelfPtr() { return shared_from_this(); }
 
@@ -184,6 +192,15 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
 
   int64_t LastPhysical() const { return batch_ts_list_->LastPhysical(); }
 
+  int64_t Remain() { return batch_ts_list_->Remain(); }
+
+  // GetTs have to wait synchronous renew
+  uint64_t StallCount() const { return stall_count_.get_value(); }
+  uint64_t PrefetchCount() const { return prefetch_count_.get_value(); }
+
+  uint32_t BatchSize() const { return batch_size_.load(std::memory_order_relaxed); }
+  int64_t Watermark() const { return watermark_.load(std::memory_order_relaxed); }
+
   void SetMinValidTs(int64_t min_valid_ts) {
     if (batch_ts_list_ != nullptr) {
       batch_ts_list_->SetMinValidTs(min_valid_ts);
@@ -194,14 +211,22 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
 
   std::string DebugInfo();
 
+ protected:
+  // take BatchTs from tso service, virtual for test.
+  virtual BatchTs* SendTsoRequest(uint32_t batch_size);
+
  private:
   friend class TakeBatchTsTask;
 
-  BatchTs* SendTsoRequest();
-
   void RenewBatchTs();
   void LaunchRenewBatchTs(bool is_sync);
 
+  // prefetch next BatchTs asynchronously when remain ts below watermark
+  void MaybePrefetch();
+  void FinishPrefetch() { is_prefetching_.store(false, std::memory_order_release); }
+  // adjust batch size and watermark by consume rate and tso latency, run at worker
+  void AdjustPrefetch(int64_t tso_latency_us);
+
   // manage BatchTs cache
   BatchTsListPtr batch_ts_list_;
 
@@ -216,13 +241,28 @@ class TsProvider : public std::enable_shared_from_this<TsProvider> {
   bvar::Adder<uint64_t> get_ts_fail_count_;
 
   bvar::Adder<uint64_t> renew_epoch_;
+
+  bvar::Adder<uint64_t> stall_count_;
+  bvar::LatencyRecorder stall_latency_;
+  bvar::Adder<uint64_t> prefetch_count_;
+
+  // adaptive prefetch, batch_size_/watermark_ are read by GetTs, others only access at worker.
+  std::atomic<bool> is_prefetching_{false};
+  std::atomic<uint32_t> batch_size_{0};
+  std::atomic<int64_t> watermark_{0};
+
+  // consume ts per ms
+  double consume_rate_{0};
+  double tso_latency_us_{0};
+  int64_t last_adjust_time_ms_{0};
+  uint64_t last_get_ts_count_{0};
 };
 
 // take BatchTs task, run at worker
 class TakeBatchTsTask : public TaskRunnable {
  public:
-  TakeBatchTsTask(bool is_sync, uint64_t renew_num, TsProviderPtr ts_provider)
-      : renew_num_(renew_num), ts_provider_(ts_provider) {
+  TakeBatchTsTask(bool is_sync, uint64_t renew_num, TsProviderPtr ts_provider, bool is_prefetch = false)
+      : renew_num_(renew_num), is_prefetch_(is_prefetch), ts_provider_(ts_provider) {
     if (is_sync) {
       cond_ = std::make_shared<BthreadCond>();
     }
@@ -236,6 +276,10 @@ class TakeBatchTsTask : public TaskRunnable {
       ts_provider_->RenewBatchTs();
     }
 
+    if (is_prefetch_) {
+      ts_provider_->FinishPrefetch();
+    }
+
     Notify();
   }
 
@@ -253,6 +297,7 @@ class TakeBatchTsTask : public TaskRunnable {
 
  private:
   uint64_t renew_num_{0};
+  bool is_prefetch_{false};
   BthreadCondPtr cond_{nullptr};
   TsProviderPtr ts_provider_{nullptr};
 };
@@ -28,7 +28,6 @@
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "log/segment_log_storage.h"
-#include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
 #include "raft/store_state_machine.h"
@@ -56,6 +55,7 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
                    int election_timeout_ms) {
   DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] raft init init_conf: {}", node_id_, init_conf);
   election_timeout_ms_ = election_timeout_ms;
+  load_metrics_ = region->LoadMetrics();
 
   braft::NodeOptions node_options;
   if (node_options.initial_conf.parse_from(init_conf) != 0) {
@@ -141,7 +141,9 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
   task.done = new BaseClosure(ctx, raft_cmd);
   node_->apply(task);
 
-  StoreBvarMetrics::GetInstance().IncCommitCountPerSecond(str_node_id_);
+  if (BAIDU_LIKELY(load_metrics_ != nullptr)) {
+    load_metrics_->IncRaftCommit();
+  }
 
   FAIL_POINT("after_raft_commit");
 
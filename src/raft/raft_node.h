@@ -90,6 +90,8 @@ class RaftNode {
 
   uint32_t election_timeout_ms_;
 
+  RegionLoadMetricsPtr load_metrics_;
+
   std::shared_ptr<BaseStateMachine> fsm_;
   wal::LogStoragePtr log_storage_;
   std::unique_ptr<braft::Node> node_;
@@ -43,6 +43,7 @@ StoreStateMachine::StoreStateMachine(RawEnginePtr engine, store::RegionPtr regio
                                      WorkerSetPtr worker_set)
     : raw_engine_(engine),
       region_(region),
+      load_metrics_(region->LoadMetrics()),
       str_node_id_(std::to_string(region->Id())),
       raft_meta_(raft_meta),
       region_metrics_(region_metrics),
@@ -208,7 +209,7 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
     raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
 
     // bvar metrics
-    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+    load_metrics_->IncRaftApply();
 
     // Persistence applied index
     // If operation is idempotent, it's ok.
@@ -264,7 +265,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
 
       // bvar metrics
-      StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+      load_metrics_->IncRaftApply();
 
       if (applied_index_ % kSaveAppliedIndexStep == 0) {
         Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
@@ -84,6 +84,8 @@ class StoreStateMachine : public BaseStateMachine {
 
   std::string str_node_id_;
   store::RegionPtr region_;
+  // resolved once, on_apply update it per log entry
+  RegionLoadMetricsPtr load_metrics_;
 
   RawEnginePtr raw_engine_;
   EventListenerCollectionPtr listeners_;
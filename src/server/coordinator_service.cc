@@ -690,6 +690,11 @@ void DoStoreHeartbeat(google::protobuf::RpcController * /*controller*/,
 
   // update store metrics
   if (request->has_store_metrics()) {
+    // delta heartbeat is not based on what we have applied, ask store for a full resync
+    if (!coordinator_control->CheckStoreRegionMetricsVersion(request->store_metrics())) {
+      response->set_need_full_region_metrics(true);
+    }
+
     coordinator_control->UpdateStoreMetrics(request->store_metrics(), meta_increment);
 
     // update is_read_only
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -36,6 +37,7 @@
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/tracker_sampler.h"
 #include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -815,6 +817,45 @@ void DebugServiceImpl::Debug(google::protobuf::RpcController* controller,
         truncate_prefix->set_trucate_prefix(trucate_prefix);
       }
     }
+
+  } else if (request->type() == pb::debug::DebugType::STORE_SLOW_REQUEST) {
+    std::set<int64_t> region_ids(request->region_ids().begin(), request->region_ids().end());
+
+    auto slow_requests = TrackerSampler::GetInstance().GetSlowRequests();
+    for (auto& slow_request : slow_requests) {
+      if (!region_ids.empty() && region_ids.count(slow_request.region_id) == 0) {
+        continue;
+      }
+
+      auto* mut_slow_request = response->mutable_slow_request()->add_requests();
+      mut_slow_request->set_method(slow_request.method);
+      mut_slow_request->set_region_id(slow_request.region_id);
+      mut_slow_request->set_request_id(slow_request.request_id);
+      mut_slow_request->set_timestamp_ms(slow_request.timestamp_ms);
+
+      const auto& metrics = slow_request.metrics;
+      auto* time_info = mut_slow_request->mutable_time_info();
+      time_info->set_total_rpc_time_ns(metrics.total_rpc_time_ns);
+      time_info->set_service_queue_wait_time_ns(metrics.service_queue_wait_time_ns);
+      time_info->set_prepair_commit_time_ns(metrics.prepair_commit_time_ns);
+      time_info->set_raft_commit_time_ns(metrics.raft_commit_time_ns);
+      time_info->set_raft_queue_wait_time_ns(metrics.raft_queue_wait_time_ns);
+      time_info->set_raft_apply_time_ns(metrics.raft_apply_time_ns);
+      time_info->set_store_write_time_ns(metrics.store_write_time_ns);
+      time_info->set_vector_index_write_time_ns(metrics.vector_index_write_time_ns);
+      time_info->set_document_index_write_time_ns(metrics.document_index_write_time_ns);
+      time_info->set_read_store_time_ns(metrics.read_store_time_ns);
+      time_info->set_lock_check_time_ns(metrics.lock_check_time_ns);
+      time_info->set_iterator_seek_time_ns(metrics.iterator_seek_time_ns);
+      time_info->set_coprocessor_time_ns(metrics.coprocessor_time_ns);
+      time_info->set_vector_search_time_ns(metrics.vector_search_time_ns);
+      time_info->set_scalar_filter_time_ns(metrics.scalar_filter_time_ns);
+    }
+
+    // start a new window
+    if (request->is_clear()) {
+      TrackerSampler::GetInstance().ClearSlowRequests();
+    }
   }
 }
 
@@ -359,7 +359,10 @@ static void DoVectorSearch(std::shared_ptr<DiskAnnServiceHandle> handle, google:
     vectors.push_back(request->vectors(i));
   }
 
-  status = handle->VectorSearch(ctx, request->vector_index_id(), request->top_n(), request->search_param(), vectors);
+  std::vector<int64_t> filter_vector_ids(request->filter_vector_ids().begin(), request->filter_vector_ids().end());
+
+  status = handle->VectorSearch(ctx, request->vector_index_id(), request->top_n(), request->search_param(), vectors,
+                                filter_vector_ids);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
   }
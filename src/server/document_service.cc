@@ -138,6 +138,8 @@ void DoDocumentBatchQuery(StoragePtr storage, google::protobuf::RpcController* c
     response->add_doucments()->Swap(&document_with_id);
   }
 
+  region->LoadMetrics()->AddRead(response->doucments_size(), response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -263,6 +265,8 @@ void DoDocumentSearch(StoragePtr storage, google::protobuf::RpcController* contr
   for (auto& document_with_score : document_results) {
     *(response->add_document_with_scores()) = document_with_score;
   }
+
+  region->LoadMetrics()->AddRead(response->document_with_scores_size(), response);
 }
 
 void DocumentServiceImpl::DocumentSearch(google::protobuf::RpcController* controller,
@@ -378,6 +382,8 @@ void DoDocumentSearchAll(StoragePtr storage, google::protobuf::RpcController* co
   auto* mut_stream_meta = response->mutable_stream_meta();
   mut_stream_meta->set_stream_id(stream->StreamId());
   mut_stream_meta->set_has_more(has_more);
+
+  region->LoadMetrics()->AddRead(response->document_with_scores_size(), response);
 }
 
 void DocumentServiceImpl::DocumentSearchAll(google::protobuf::RpcController* controller,
@@ -490,6 +496,8 @@ void DoDocumentAdd(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
+  region->LoadMetrics()->AddWrite(request->documents_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(request->context().region_id());
   ctx->SetTracker(tracker);
@@ -601,6 +609,8 @@ void DoDocumentDelete(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
+  region->LoadMetrics()->AddWrite(request->ids_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(request->context().region_id());
   ctx->SetTracker(tracker);
@@ -1171,7 +1181,7 @@ static butil::Status ValidateTxnScanRequestIndex(const pb::store::TxnScanRequest
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -1229,7 +1239,7 @@ void DoTxnScanDocument(StoragePtr storage, google::protobuf::RpcController* cont
   bool has_more = false;
   std::string end_key{};
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
   status = storage->TxnScan(ctx, request->stream_meta(), request->start_ts(), correction_range, request->limit(),
                             request->key_only(), request->is_reverse(), resolved_locks, txn_result_info, kvs, has_more,
                             end_key, !request->has_coprocessor(), request->coprocessor());
@@ -2458,7 +2468,7 @@ static butil::Status ValidateBackupDataRangeRequest(const dingodb::pb::store::Ba
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -2543,6 +2553,13 @@ void DocumentServiceImpl::BackupData(google::protobuf::RpcController* controller
   }
 }
 
+void DocumentServiceImpl::RestoreData(google::protobuf::RpcController* controller,
+                                      const dingodb::pb::store::RestoreDataRequest* request,
+                                      dingodb::pb::store::RestoreDataResponse* response,
+                                      google::protobuf::Closure* done) {
+  ServiceHelper::RestoreData(storage_, write_worker_set_, controller, request, response, done);
+}
+
 static butil::Status ValidateTxnDumpRequest(const pb::store::TxnDumpRequest* request, store::RegionPtr region) {
   // check if region_epoch is match
   auto epoch_ret = ServiceHelper::ValidateRegionEpoch(request->context().region_epoch(), region);
@@ -103,6 +103,9 @@ class DocumentServiceImpl : public pb::document::DocumentService {
   void BackupData(google::protobuf::RpcController* controller, const dingodb::pb::store::BackupDataRequest* request,
                   dingodb::pb::store::BackupDataResponse* response, google::protobuf::Closure* done) override;
 
+  void RestoreData(google::protobuf::RpcController* controller, const dingodb::pb::store::RestoreDataRequest* request,
+                   dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) override;
+
   void SetStorage(StoragePtr storage) { storage_ = storage; }
   void SetReadWorkSet(WorkerSetPtr worker_set) { read_worker_set_ = worker_set; }
   void SetWriteWorkSet(WorkerSetPtr worker_set) { write_worker_set_ = worker_set; }
@@ -147,6 +147,8 @@ void DoVectorBatchQuery(StoragePtr storage, google::protobuf::RpcController* con
     response->add_vectors()->Swap(&vector_with_id);
   }
 
+  region->LoadMetrics()->AddRead(response->vectors_size(), response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -223,7 +225,7 @@ static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::i
     return status;
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -313,6 +315,7 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   ctx->parameter.Swap(mut_request->mutable_parameter());
   ctx->raw_engine_type = region->GetRawEngineType();
   ctx->store_engine_type = region->GetStoreEngineType();
+  ctx->tracker = tracker;
 
   auto scalar_schema = region->ScalarSchema();
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail)
@@ -342,6 +345,8 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   for (auto& vector_result : vector_results) {
     *(response->add_batch_results()) = vector_result;
   }
+
+  region->LoadMetrics()->AddRead(request->vector_with_ids_size(), response);
 }
 
 void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
@@ -406,7 +411,7 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
+  if (!vector_index_wrapper->IsReady() && !vector_index_wrapper->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -525,6 +530,8 @@ void DoVectorAdd(StoragePtr storage, google::protobuf::RpcController* controller
     return;
   }
 
+  region->LoadMetrics()->AddWrite(request->vectors_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(request->context().region_id());
   ctx->SetTracker(tracker);
@@ -605,7 +612,7 @@ static butil::Status ValidateVectorDeleteRequest(StoragePtr storage, const pb::i
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
+  if (!vector_index_wrapper->IsReady() && !vector_index_wrapper->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -641,6 +648,8 @@ void DoVectorDelete(StoragePtr storage, google::protobuf::RpcController* control
     return;
   }
 
+  region->LoadMetrics()->AddWrite(request->ids_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(request->context().region_id());
   ctx->SetTracker(tracker);
@@ -1208,7 +1217,7 @@ static butil::Status ValidateVectorImportRequestForAdd(StoragePtr storage,
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
+  if (!vector_index_wrapper->IsReady() && !vector_index_wrapper->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -1297,7 +1306,7 @@ static butil::Status ValidateVectorImportRequestForDelete(StoragePtr storage,
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
+  if (!vector_index_wrapper->IsReady() && !vector_index_wrapper->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -1987,7 +1996,7 @@ static butil::Status ValidateVectorSearchDebugRequest(StoragePtr storage,
   }
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
+  if (!vector_index_wrapper->IsReady() && !vector_index_wrapper->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -2268,7 +2277,7 @@ static butil::Status ValidateTxnScanRequestIndex(const pb::store::TxnScanRequest
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -2326,7 +2335,7 @@ void DoTxnScanVector(StoragePtr storage, google::protobuf::RpcController* contro
   bool has_more = false;
   std::string end_key{};
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
   status = storage->TxnScan(ctx, request->stream_meta(), request->start_ts(), correction_range, request->limit(),
                             request->key_only(), request->is_reverse(), resolved_locks, txn_result_info, kvs, has_more,
                             end_key, !request->has_coprocessor(), request->coprocessor());
@@ -2433,7 +2442,7 @@ static butil::Status ValidateIndexTxnPessimisticLockRequest(
     return status;
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -2655,7 +2664,7 @@ static butil::Status ValidateIndexTxnPrewriteRequest(StoragePtr storage, const p
     return status;
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -2917,7 +2926,7 @@ static butil::Status ValidateTxnCommitRequest(const pb::store::TxnCommitRequest*
                                      FLAGS_vector_max_request_size));
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -3034,7 +3043,7 @@ static butil::Status VectorValidateTxnCheckTxnStatusRequest(const pb::store::Txn
     return status;
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -3123,7 +3132,7 @@ static butil::Status VectorValidateTxnResolveLockRequest(const pb::store::TxnRes
     }
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -3503,7 +3512,7 @@ static butil::Status VectorValidateTxnGcRequest(const pb::store::TxnGcRequest* r
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "safe_point_ts is 0");
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
+  if (!region->VectorIndexWrapper()->IsReady() && !region->VectorIndexWrapper()->ReloadIfEvicted()) {
     if (region->VectorIndexWrapper()->IsBuildError()) {
       return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
                            fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
@@ -3618,7 +3627,7 @@ static butil::Status ValidateBackupDataRangeRequest(const dingodb::pb::store::Ba
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -3702,6 +3711,12 @@ void IndexServiceImpl::BackupData(google::protobuf::RpcController* controller,
   }
 }
 
+void IndexServiceImpl::RestoreData(google::protobuf::RpcController* controller,
+                                   const dingodb::pb::store::RestoreDataRequest* request,
+                                   dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) {
+  ServiceHelper::RestoreData(storage_, write_worker_set_, controller, request, response, done);
+}
+
 static void DoControlConfig(StoragePtr storage, google::protobuf::RpcController* controller,
                             const dingodb::pb::store::ControlConfigRequest* request,
                             dingodb::pb::store::ControlConfigResponse* response, TrackClosure* done, bool is_sync) {
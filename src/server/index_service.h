@@ -122,6 +122,9 @@ class IndexServiceImpl : public pb::index::IndexService {
   void BackupData(google::protobuf::RpcController* controller, const dingodb::pb::store::BackupDataRequest* request,
                   dingodb::pb::store::BackupDataResponse* response, google::protobuf::Closure* done) override;
 
+  void RestoreData(google::protobuf::RpcController* controller, const dingodb::pb::store::RestoreDataRequest* request,
+                   dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) override;
+
   void ControlConfig(google::protobuf::RpcController* controller, const pb::store::ControlConfigRequest* request,
                      pb::store::ControlConfigResponse* response, google::protobuf::Closure* done) override;
 
@@ -75,12 +75,15 @@ DEFINE_int32(document_operation_parallel_thread_num, 16, "document operation par
 DEFINE_string(pid_file_name, "pid", "pid file name");
 
 DEFINE_int32(omp_num_threads, 1, "omp num threads");
+DEFINE_int32(vector_index_train_thread_num, 2, "vector index train thread num");
+DEFINE_int32(vector_index_train_omp_num_threads, 8, "omp num threads of each vector index train thread");
 
 DEFINE_int32(server_heartbeat_interval_s, 10, "heartbeat interval seconds");
 DEFINE_int32(server_metrics_collect_interval_s, 300, "metrics collect interval seconds");
 DEFINE_int32(server_store_metrics_collect_interval_s, 30, "store metrics collect interval seconds");
 DEFINE_int32(server_approximate_size_metrics_collect_interval_s, 300,
              "approximate size metrics collect interval seconds");
+DEFINE_int32(server_region_load_metrics_collect_interval_s, 10, "region load metrics collect interval seconds");
 DEFINE_int32(scan_scan_interval_s, 30, "scan interval seconds");
 DEFINE_int32(scanv2_scan_interval_s, 30, "scan interval seconds");
 DEFINE_int32(region_split_check_interval_s, 300, "split check interval seconds");
@@ -525,6 +528,18 @@ bool Server::InitCrontabManager() {
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreMetrics(); },
   });
 
+  // Add region load metrics crontab
+  FLAGS_server_region_load_metrics_collect_interval_s =
+      GetInterval(config, "server.region_load_metrics_collect_interval_s",
+                  FLAGS_server_region_load_metrics_collect_interval_s);
+  crontab_configs_.push_back({
+      "REGION_LOAD_METRICS",
+      {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+      FLAGS_server_region_load_metrics_collect_interval_s * 1000,
+      true,
+      [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectRegionLoadMetrics(); },
+  });
+
   // Add store approximate size metrics crontab
   FLAGS_server_approximate_size_metrics_collect_interval_s =
       GetInterval(config, "server.approximate_size_metrics_collect_interval_s",
@@ -857,6 +872,13 @@ bool Server::InitVectorIndexManager() {
         LOG(INFO) << fmt::format("omp max thread num per ancestor: {}", omp_get_max_threads());
       });
 
+  vector_index_train_thread_pool_ =
+      std::make_shared<ThreadPool>("vector_train", FLAGS_vector_index_train_thread_num, []() {
+        omp_set_num_threads(FLAGS_vector_index_train_omp_num_threads);
+
+        LOG(INFO) << fmt::format("train omp max thread num per ancestor: {}", omp_get_max_threads());
+      });
+
   vector_index_manager_ = VectorIndexManager::New();
   return vector_index_manager_->Init();
 }
@@ -1310,6 +1332,8 @@ ThreadPoolPtr Server::GetVectorIndexThreadPool() {
   return vector_index_thread_pool_;
 }
 
+ThreadPoolPtr Server::GetVectorIndexTrainThreadPool() { return vector_index_train_thread_pool_; }
+
 mvcc::TsProviderPtr Server::GetTsProvider() {
   CHECK(ts_provider_ != nullptr) << "ts_provider is nullptr.";
 
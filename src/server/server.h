@@ -236,6 +236,7 @@ class Server {
   std::string GetAllWorkSetPendingTaskCount();
 
   ThreadPoolPtr GetVectorIndexThreadPool();
+  ThreadPoolPtr GetVectorIndexTrainThreadPool();
 
   mvcc::TsProviderPtr GetTsProvider();
 
@@ -378,6 +379,9 @@ class Server {
   // vector index thread pool
   ThreadPoolPtr vector_index_thread_pool_;
 
+  // vector index train thread pool, k-means use more omp threads than the vector operation.
+  ThreadPoolPtr vector_index_train_thread_pool_;
+
   // document index thread pool
   ThreadPoolPtr document_index_thread_pool_;
 
@@ -19,13 +19,16 @@
 #include <string>
 #include <string_view>
 
+#include "brpc/controller.h"
 #include "butil/status.h"
+#include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "google/protobuf/util/json_util.h"
+#include "metrics/store_bvar_metrics.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 #include "vector/codec.h"
@@ -52,11 +55,14 @@ void ServiceHelper::SetError(pb::error::Error* error, int errcode, const std::st
 void ServiceHelper::SetError(pb::error::Error* error, const std::string& errmsg) { error->set_errmsg(errmsg); }
 
 butil::Status ServiceHelper::ValidateRegionEpoch(const pb::common::RegionEpoch& req_epoch, store::RegionPtr region) {
-  if (region->Epoch().conf_version() != req_epoch.conf_version() || region->Epoch().version() != req_epoch.version()) {
+  // compare with one descriptor, not copy epoch
+  auto descriptor = region->Descriptor();
+  const auto& epoch = descriptor->epoch;
+  if (epoch.conf_version() != req_epoch.conf_version() || epoch.version() != req_epoch.version()) {
     return butil::Status(pb::error::Errno::EREGION_VERSION,
                          fmt::format("Region({}) epoch is not match, region_epoch({}_{}) req_epoch({}_{})",
-                                     region->Id(), region->Epoch().conf_version(), region->Epoch().version(),
-                                     req_epoch.conf_version(), req_epoch.version()));
+                                     region->Id(), epoch.conf_version(), epoch.version(), req_epoch.conf_version(),
+                                     req_epoch.version()));
   }
 
   return butil::Status::OK();
@@ -75,8 +81,9 @@ butil::Status ServiceHelper::GetStoreRegionInfo(store::RegionPtr region, pb::err
 
   auto* store_region_info = error->mutable_store_region_info();
   store_region_info->set_region_id(region->Id());
-  *(store_region_info->mutable_current_region_epoch()) = region->Epoch();
-  *(store_region_info->mutable_current_range()) = region->Range(false);
+  auto descriptor = region->Descriptor();
+  *(store_region_info->mutable_current_region_epoch()) = descriptor->epoch;
+  *(store_region_info->mutable_current_range()) = descriptor->range;
   for (const auto& peer : region->Peers()) {
     *(store_region_info->add_peers()) = peer;
   }
@@ -183,7 +190,7 @@ butil::Status ServiceHelper::ValidateRegion(store::RegionPtr region, const std::
   }
 
   // for table region, Range is always equal to Range, so here we can use Range to validate
-  status = ValidateKeyInRange(region->Range(false), keys);
+  status = ValidateKeyInRange(region->Descriptor()->range, keys);
   if (!status.ok()) {
     return status;
   }
@@ -197,7 +204,8 @@ butil::Status ServiceHelper::ValidateIndexRegion(store::RegionPtr region, const
     return status;
   }
 
-  const auto& range = region->Range(false);
+  auto descriptor = region->Descriptor();
+  const auto& range = descriptor->range;
   int64_t min_vector_id = 0, max_vector_id = 0;
   VectorCodec::DecodeRangeToVectorId(false, range, min_vector_id, max_vector_id);
   for (auto vector_id : vector_ids) {
@@ -217,7 +225,8 @@ butil::Status ServiceHelper::ValidateDocumentRegion(store::RegionPtr region, con
     return status;
   }
 
-  const auto& range = region->Range(false);
+  auto descriptor = region->Descriptor();
+  const auto& range = descriptor->range;
   int64_t min_document_id = 0, max_document_id = 0;
   DocumentCodec::DecodeRangeToDocumentId(false, range, min_document_id, max_document_id);
   for (auto document_id : document_ids) {
@@ -258,6 +267,92 @@ butil::Status ServiceHelper::ValidateClusterReadOnly() {
   return butil::Status();
 }
 
+butil::Status ServiceHelper::ValidateRestoreDataRequest(const pb::store::RestoreDataRequest* request,
+                                                        store::RegionPtr region) {
+  // check if region_epoch is match
+  auto status = ValidateRegionEpoch(request->context().region_epoch(), region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ValidateRegionState(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ValidateClusterReadOnly();
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (request->sst_metas().backup_data_file_value_sst_metas().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param sst_metas is empty");
+  }
+
+  return butil::Status();
+}
+
+static void DoRestoreData(StoragePtr storage, google::protobuf::RpcController* controller,
+                          const pb::store::RestoreDataRequest* request, pb::store::RestoreDataResponse* response,
+                          TrackClosure* done, bool is_sync) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  auto region = done->GetRegion();
+
+  auto status = ServiceHelper::ValidateRestoreDataRequest(request, region);
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  // ingest must be proposed by leader
+  status = storage->ValidateLeader(region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  ctx->SetRegionId(request->context().region_id());
+  ctx->SetTracker(tracker);
+  ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetRawEngineType(region->GetRawEngineType());
+  ctx->SetStoreEngineType(region->GetStoreEngineType());
+
+  status = storage->RestoreData(ctx, region, request->storage_backend(), request->sst_metas());
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    if (!is_sync) done->Run();
+  }
+}
+
+void ServiceHelper::RestoreData(StoragePtr storage, WorkerSetPtr worker_set,
+                                google::protobuf::RpcController* controller,
+                                const pb::store::RestoreDataRequest* request, pb::store::RestoreDataResponse* response,
+                                google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure("RestoreData", done, request, response);
+
+  if (BAIDU_UNLIKELY(svr_done->GetRegion() == nullptr)) {
+    brpc::ClosureGuard done_guard(svr_done);
+    return;
+  }
+
+  // Run in queue.
+  auto task = std::make_shared<ServiceTask>([storage, controller, request, response, svr_done]() {
+    DoRestoreData(storage, controller, request, response, svr_done, true);
+  });
+  bool ret = worker_set->ExecuteRR(task);
+  if (BAIDU_UNLIKELY(!ret)) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
 // LatchContextPtr ServiceHelper::LatchesAcquire(store::RegionPtr region, const std::vector<std::string>& keys,
 //                                               bool is_txn) {
 //   auto start_time_us = butil::gettimeofday_us();
@@ -286,17 +381,24 @@ void ServiceHelper::LatchesAcquire(LatchContext& latch_ctx, bool is_txn) {
 
   store::RegionPtr region = latch_ctx.GetRegion();
   bool latch_got = false;
+  bool is_waited = false;
   while (!latch_got) {
     latch_got = region->LatchesAcquire(latch_ctx.GetLock(), latch_ctx.Cid());
     if (!latch_got) {
+      is_waited = true;
       latch_ctx.SyncCond().IncreaseWait();
     }
   }
 
+  int64_t elapsed_time_us = butil::gettimeofday_us() - start_time_us;
   if (is_txn) {
-    g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
+    g_txn_latches_recorder << elapsed_time_us;
   } else {
-    g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
+    g_raw_latches_recorder << elapsed_time_us;
+  }
+
+  if (is_waited) {
+    StoreBvarMetrics::GetInstance().UpdateLatchWaitTime(std::to_string(region->Id()), elapsed_time_us);
   }
 }
 
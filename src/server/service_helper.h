@@ -29,7 +29,9 @@
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/tracker_sampler.h"
 #include "proto/error.pb.h"
+#include "proto/store.pb.h"
 #include "server/server.h"
 namespace dingodb {
 
@@ -82,6 +84,13 @@ class ServiceHelper {
   static butil::Status ValidateIndexRegion(store::RegionPtr region, const std::vector<int64_t>& vector_ids);
   static butil::Status ValidateDocumentRegion(store::RegionPtr region, const std::vector<int64_t>& document_ids);
   static butil::Status ValidateClusterReadOnly();
+  static butil::Status ValidateRestoreDataRequest(const pb::store::RestoreDataRequest* request,
+                                                  store::RegionPtr region);
+
+  // RestoreData is shared by store/index/document service, run in write worker set.
+  static void RestoreData(StoragePtr storage, WorkerSetPtr worker_set, google::protobuf::RpcController* controller,
+                          const pb::store::RestoreDataRequest* request, pb::store::RestoreDataResponse* response,
+                          google::protobuf::Closure* done);
 
   static void LatchesAcquire(LatchContext& latch_ctx, bool is_txn);
   static void LatchesRelease(LatchContext& latch_ctx);
@@ -240,6 +249,7 @@ void ServiceClosure<T, U, need_region>::Run() {
   tracker->SetTotalRpcTime();
   uint64_t elapsed_time = tracker->TotalRpcTime();
   SetPbMessageResponseInfo(response_, tracker);
+  TrackerSampler::GetInstance().Sample(method_name_, region ? region->Id() : 0, tracker);
 
   if (response_->error().errcode() != 0) {
     // Set leader redirect info(pb.Error.leader_location).
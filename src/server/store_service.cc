@@ -31,6 +31,7 @@
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "common/version.h"
+#include "engine/txn_lock_wait_manager.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "gflags/gflags.h"
@@ -121,6 +122,8 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
     response->set_value(kvs[0].value());
   }
 
+  region->LoadMetrics()->AddRead(1, response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -217,6 +220,8 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
 
   Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
 
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -304,6 +309,8 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(1, request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -415,6 +422,8 @@ void DoKvBatchPut(StoragePtr storage, google::protobuf::RpcController* controlle
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->kvs_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -523,6 +532,8 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(1, request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -638,6 +649,8 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->kvs_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -749,6 +762,8 @@ void DoKvBatchDelete(StoragePtr storage, google::protobuf::RpcController* contro
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->keys_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -815,7 +830,7 @@ static butil::Status ValidateKvDeleteRangeRequest(const pb::store::KvDeleteRange
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -849,6 +864,8 @@ void DoKvDeleteRange(StoragePtr storage, google::protobuf::RpcController* contro
     return;
   }
 
+  region->LoadMetrics()->AddWrite(0, request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -857,7 +874,7 @@ void DoKvDeleteRange(StoragePtr storage, google::protobuf::RpcController* contro
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
   status = storage->KvDeleteRange(ctx, correction_range);
   if (BAIDU_UNLIKELY(!status.ok())) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -944,6 +961,8 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(1, request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -1053,6 +1072,8 @@ void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController*
   ServiceHelper::LatchesAcquire(latch_ctx, false);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->kvs_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -1126,7 +1147,7 @@ static butil::Status ValidateKvScanBeginRequest(const dingodb::pb::store::KvScan
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -1169,7 +1190,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   ctx->SetStoreEngineType(region->GetStoreEngineType());
   ctx->SetTs(request->ts());
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
 
   std::vector<pb::common::KeyValue> kvs;  // NOLINT
   std::string scan_id;                    // NOLINT
@@ -1187,6 +1208,8 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   *response->mutable_scan_id() = scan_id;
+
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
 }
 
 void StoreServiceImpl::KvScanBegin(google::protobuf::RpcController* controller,
@@ -1274,6 +1297,8 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
   if (!kvs.empty()) {
     Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
   }
+
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
 }
 
 void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controller,
@@ -1416,7 +1441,7 @@ static butil::Status ValidateKvScanBeginRequestV2(const dingodb::pb::store::KvSc
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -1461,7 +1486,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   ctx->SetStoreEngineType(region->GetStoreEngineType());
   ctx->SetTs(request->ts());
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
 
   std::vector<pb::common::KeyValue> kvs;  // NOLINT
   int64_t scan_id = request->scan_id();
@@ -1479,6 +1504,8 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   }
 
   response->set_scan_id(scan_id);
+
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
 }
 
 void StoreServiceImpl::KvScanBeginV2(google::protobuf::RpcController* controller,
@@ -1569,6 +1596,8 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
   }
 
   response->set_has_more(has_more);
+
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
 }
 
 void StoreServiceImpl::KvScanContinueV2(::google::protobuf::RpcController* controller,
@@ -1723,6 +1752,8 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
   }
   *response->mutable_txn_result() = txn_result_info;
 
+  region->LoadMetrics()->AddRead(1, response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -1770,7 +1801,7 @@ static butil::Status ValidateTxnScanRequest(const pb::store::TxnScanRequest* req
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -1823,7 +1854,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   bool has_more = false;
   std::string end_key{};
 
-  auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
+  auto correction_range = Helper::IntersectRange(region->Descriptor()->range, uniform_range);
   status = storage->TxnScan(ctx, request->stream_meta(), request->start_ts(), correction_range, request->limit(),
                             request->key_only(), request->is_reverse(), resolved_locks, txn_result_info, kvs, has_more,
                             end_key, !request->has_coprocessor(), request->coprocessor());
@@ -1850,6 +1881,8 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   mut_stream_meta->set_stream_id(stream->StreamId());
   mut_stream_meta->set_has_more(has_more);
 
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -1937,7 +1970,81 @@ static butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store:
 
 void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
                           const dingodb::pb::store::TxnPessimisticLockRequest* request,
-                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync) {
+                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync,
+                          WorkerSetPtr worker_set, int64_t lock_wait_deadline_ms);
+
+// Park the request on the first key locked by other txn, it will be re-executed in worker set
+// when the lock is released or wait timeout. Return true if the request is parked.
+static bool WaitTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
+                                   const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                   dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                   WorkerSetPtr worker_set, int64_t lock_wait_deadline_ms) {
+  if (worker_set == nullptr || response->txn_result_size() == 0 || response->error().errcode() != pb::error::OK) {
+    return false;
+  }
+
+  std::string lock_key;
+  int64_t lock_ts = 0;
+  for (const auto& txn_result : response->txn_result()) {
+    // write conflict and others must response to client
+    if (!txn_result.has_locked()) {
+      return false;
+    }
+    if (lock_ts == 0 && txn_result.locked().lock_ts() != request->start_ts()) {
+      lock_key = txn_result.locked().key();
+      lock_ts = txn_result.locked().lock_ts();
+    }
+  }
+  if (lock_ts == 0) {
+    return false;
+  }
+
+  int64_t timeout_ms = lock_wait_deadline_ms - Helper::TimestampMs();
+  if (timeout_ms <= 0) {
+    return false;
+  }
+
+  // once parked the request may be re-executed at any time, so clear response before wait.
+  google::protobuf::RepeatedPtrField<pb::store::TxnResultInfo> txn_results;
+  txn_results.Swap(response->mutable_txn_result());
+
+  std::vector<int64_t> wait_chain;
+  auto result = TxnLockWaitManager::GetInstance().Wait(
+      lock_key, request->start_ts(), lock_ts, timeout_ms,
+      [storage, controller, request, response, done, worker_set, lock_wait_deadline_ms]() {
+        auto task = std::make_shared<ServiceTask>(
+            [storage, controller, request, response, done, worker_set, lock_wait_deadline_ms]() {
+              DoTxnPessimisticLock(storage, controller, request, response, done, true, worker_set,
+                                   lock_wait_deadline_ms);
+            });
+        if (BAIDU_UNLIKELY(!worker_set->ExecuteRR(task))) {
+          brpc::ClosureGuard done_guard(done);
+          ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                                  "WorkerSet queue is full, please wait and retry");
+        }
+      },
+      wait_chain);
+  if (result == TxnLockWaitManager::WaitResult::kWaiting) {
+    return true;
+  }
+
+  response->mutable_txn_result()->Swap(&txn_results);
+  if (result == TxnLockWaitManager::WaitResult::kDeadlock) {
+    auto* deadlock = response->add_txn_result()->mutable_deadlock();
+    deadlock->set_lock_ts(lock_ts);
+    deadlock->set_lock_key(lock_key);
+    for (auto ts : wait_chain) {
+      deadlock->add_wait_chain(ts);
+    }
+  }
+
+  return false;
+}
+
+void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
+                          const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync,
+                          WorkerSetPtr worker_set, int64_t lock_wait_deadline_ms) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(done);
   auto tracker = done->Tracker();
@@ -1963,6 +2070,8 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
   ServiceHelper::LatchesAcquire(latch_ctx, true);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->mutations_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -1985,6 +2094,11 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
     if (!is_sync) done->Run();
+  } else if (is_sync && lock_wait_deadline_ms > 0 &&
+             WaitTxnPessimisticLock(storage, controller, request, response, done, worker_set,
+                                    lock_wait_deadline_ms)) {
+    done_guard.release();
+    return;
   }
   if (request->return_values() && !kvs.empty()) {
     for (const auto& kv : kvs) {
@@ -2004,9 +2118,12 @@ void StoreServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* contr
     return;
   }
 
+  int64_t lock_wait_deadline_ms = TxnLockWaitManager::CalcWaitDeadlineMs(request->lock_wait_timeout_ms());
+
   // Run in queue.
-  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
+  auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done, lock_wait_deadline_ms]() {
+    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true, write_worker_set_,
+                         lock_wait_deadline_ms);
   });
   bool ret = write_worker_set_->ExecuteRR(task);
   if (BAIDU_UNLIKELY(!ret)) {
@@ -2209,6 +2326,8 @@ void DoTxnPrewrite(StoragePtr storage, google::protobuf::RpcController* controll
   ServiceHelper::LatchesAcquire(latch_ctx, true);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->mutations_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -2347,6 +2466,8 @@ void DoTxnCommit(StoragePtr storage, google::protobuf::RpcController* controller
   ServiceHelper::LatchesAcquire(latch_ctx, true);
   DEFER(ServiceHelper::LatchesRelease(latch_ctx));
 
+  region->LoadMetrics()->AddWrite(request->keys_size(), request);
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -2818,6 +2939,8 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
   }
   *response->mutable_txn_result() = txn_result_info;
 
+  region->LoadMetrics()->AddRead(response->kvs_size(), response);
+
   tracker->SetReadStoreTime();
 }
 
@@ -2989,7 +3112,7 @@ static butil::Status ValidateTxnScanLockRequest(const dingodb::pb::store::TxnSca
   req_range.set_start_key(request->start_key());
   req_range.set_end_key(request->end_key());
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -3274,7 +3397,7 @@ static butil::Status ValidateTxnDeleteRangeRequest(const dingodb::pb::store::Txn
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -3366,7 +3489,7 @@ static butil::Status ValidateBackupDataRangeRequest(const dingodb::pb::store::Ba
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -3467,7 +3590,7 @@ static butil::Status ValidateBackupMetaRangeRequest(const dingodb::pb::store::Ba
     return status;
   }
 
-  status = ServiceHelper::ValidateRangeInRange(region->Range(false), req_range);
+  status = ServiceHelper::ValidateRangeInRange(region->Descriptor()->range, req_range);
   if (!status.ok()) {
     return status;
   }
@@ -3551,6 +3674,12 @@ void StoreServiceImpl::BackupMeta(google::protobuf::RpcController* controller,
   }
 }
 
+void StoreServiceImpl::RestoreData(google::protobuf::RpcController* controller,
+                                   const dingodb::pb::store::RestoreDataRequest* request,
+                                   dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) {
+  ServiceHelper::RestoreData(storage_, write_worker_set_, controller, request, response, done);
+}
+
 static void DoControlConfig(StoragePtr storage, google::protobuf::RpcController* controller,
                             const dingodb::pb::store::ControlConfigRequest* request,
                             dingodb::pb::store::ControlConfigResponse* response, TrackClosure* done, bool is_sync) {
@@ -138,6 +138,9 @@ class StoreServiceImpl : public pb::store::StoreService {
   void BackupMeta(google::protobuf::RpcController* controller, const dingodb::pb::store::BackupMetaRequest* request,
                   dingodb::pb::store::BackupMetaResponse* response, google::protobuf::Closure* done) override;
 
+  void RestoreData(google::protobuf::RpcController* controller, const dingodb::pb::store::RestoreDataRequest* request,
+                   dingodb::pb::store::RestoreDataResponse* response, google::protobuf::Closure* done) override;
+
   void ControlConfig(google::protobuf::RpcController* controller, const pb::store::ControlConfigRequest* request,
                      pb::store::ControlConfigResponse* response, google::protobuf::Closure* done) override;
 
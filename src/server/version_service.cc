@@ -669,9 +669,20 @@ void DoWatch(google::protobuf::RpcController* controller, const pb::version::Wat
 
   DINGO_LOG(INFO) << "Receive Watch Request: " << request->ShortDebugString();
 
+  // client attach stream to multiplex persistent key and prefix watches.
+  auto* cntl = static_cast<brpc::Controller*>(controller);
+  if (cntl->has_remote_stream()) {
+    auto ret = kv_control->StreamWatch(*request, cntl);
+    if (!ret.ok()) {
+      response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+      response->mutable_error()->set_errmsg(ret.error_str());
+    }
+    return;
+  }
+
   if (!request->has_one_time_request()) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("only one_time_request is supported now");
+    response->mutable_error()->set_errmsg("only one_time_request is supported without stream");
     return;
   }
 
@@ -1052,13 +1063,14 @@ void VersionServiceProtoImpl::Watch(google::protobuf::RpcController* controller,
     return RedirectResponse(response);
   }
 
-  if (!request->has_one_time_request()) {
+  bool has_stream = static_cast<brpc::Controller*>(controller)->has_remote_stream();
+  if (!has_stream && !request->has_one_time_request()) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("only one_time_request is supported now");
+    response->mutable_error()->set_errmsg("only one_time_request is supported without stream");
     return;
   }
 
-  if (request->one_time_request().key().empty()) {
+  if (!has_stream && request->one_time_request().key().empty()) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
     response->mutable_error()->set_errmsg("key is empty");
     return;
@@ -17,6 +17,7 @@
 #include <sys/types.h>
 
 #include <atomic>
+#include <cstdlib>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -24,6 +25,7 @@
 #include <vector>
 
 #include "butil/compiler_specific.h"
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "butil/time.h"
 #include "common/helper.h"
@@ -53,7 +55,155 @@ DEFINE_int64(store_heartbeat_report_region_multiple, 3,
              "store heartbeat report region multiple, this defines how many times of heartbeat will report "
              "region_metrics once to coordinator");
 
+DEFINE_bool(enable_store_heartbeat_delta_region_metrics, true,
+            "enable store heartbeat only report changed region_metrics since last acknowledged heartbeat");
+DEFINE_int64(store_heartbeat_full_region_metrics_multiple, 10,
+             "store heartbeat full region metrics multiple, this defines how many times of region_metrics report "
+             "will report full region_metrics once to coordinator, others only report changed regions");
+DEFINE_double(store_heartbeat_region_metrics_change_ratio, 0.1,
+              "region row_count/region_size change ratio to report region_metrics in delta heartbeat");
+DEFINE_int64(store_heartbeat_region_load_change_min_qps, 100,
+             "region read/write qps change less than this is ignored in delta heartbeat, avoid idle region jitter");
+
 std::atomic<uint64_t> HeartbeatTask::heartbeat_counter = 0;
+RegionMetricsDeltaTracker HeartbeatTask::region_metrics_delta_tracker;
+
+static uint32_t GenIndexStatusFlags(bool is_stop, bool is_ready, bool is_own_ready, bool is_build_error,
+                                    bool is_rebuild_error, bool is_switching) {
+  return static_cast<uint32_t>(is_stop) | (static_cast<uint32_t>(is_ready) << 1) |
+         (static_cast<uint32_t>(is_own_ready) << 2) | (static_cast<uint32_t>(is_build_error) << 3) |
+         (static_cast<uint32_t>(is_rebuild_error) << 4) | (static_cast<uint32_t>(is_switching) << 5);
+}
+
+RegionMetricsDigest RegionMetricsDigest::Gen(const pb::common::RegionMetrics& region_metrics,
+                                             const pb::common::RegionEpoch& epoch) {
+  RegionMetricsDigest digest;
+  digest.leader_store_id = region_metrics.leader_store_id();
+  digest.store_region_state = region_metrics.store_region_state();
+  digest.conf_version = epoch.conf_version();
+  digest.version = epoch.version();
+  digest.row_count = region_metrics.row_count();
+  digest.region_size = region_metrics.region_size();
+  digest.read_qps = region_metrics.load_metrics().read_qps();
+  digest.write_qps = region_metrics.load_metrics().write_qps();
+
+  const auto& braft_status = region_metrics.braft_status();
+  digest.raft_state = braft_status.raft_state();
+  digest.raft_term = braft_status.term();
+  digest.unhealthy_follower_count = braft_status.unstable_followers_size();
+  for (const auto& [_, follower] : braft_status.stable_followers()) {
+    if (follower.consecutive_error_times() > 10 || follower.installing_snapshot()) {
+      ++digest.unhealthy_follower_count;
+    }
+  }
+
+  if (region_metrics.has_vector_index_status()) {
+    const auto& status = region_metrics.vector_index_status();
+    digest.index_status_flags = GenIndexStatusFlags(status.is_stop(), status.is_ready(), status.is_own_ready(),
+                                                    status.is_build_error(), status.is_rebuild_error(),
+                                                    status.is_switching());
+    digest.index_last_build_epoch_version = status.last_build_epoch_version();
+  } else if (region_metrics.has_document_index_status()) {
+    const auto& status = region_metrics.document_index_status();
+    digest.index_status_flags = GenIndexStatusFlags(status.is_stop(), status.is_ready(), status.is_own_ready(),
+                                                    status.is_build_error(), status.is_rebuild_error(),
+                                                    status.is_switching());
+    digest.index_last_build_epoch_version = status.last_build_epoch_version();
+  }
+
+  return digest;
+}
+
+static bool IsChangedBeyondRatio(int64_t old_value, int64_t new_value, double change_ratio) {
+  if (old_value == new_value) {
+    return false;
+  }
+  if (old_value == 0) {
+    return true;
+  }
+
+  return static_cast<double>(std::abs(new_value - old_value)) > static_cast<double>(std::abs(old_value)) * change_ratio;
+}
+
+static bool IsLoadChanged(int64_t old_value, int64_t new_value, double change_ratio) {
+  return std::abs(new_value - old_value) >= FLAGS_store_heartbeat_region_load_change_min_qps &&
+         IsChangedBeyondRatio(old_value, new_value, change_ratio);
+}
+
+bool RegionMetricsDigest::IsChanged(const RegionMetricsDigest& other, double change_ratio) const {
+  if (leader_store_id != other.leader_store_id || store_region_state != other.store_region_state ||
+      conf_version != other.conf_version || version != other.version || raft_state != other.raft_state ||
+      raft_term != other.raft_term || unhealthy_follower_count != other.unhealthy_follower_count ||
+      index_status_flags != other.index_status_flags ||
+      index_last_build_epoch_version != other.index_last_build_epoch_version) {
+    return true;
+  }
+
+  return IsChangedBeyondRatio(other.row_count, row_count, change_ratio) ||
+         IsChangedBeyondRatio(other.region_size, region_size, change_ratio) ||
+         IsLoadChanged(other.read_qps, read_qps, change_ratio) ||
+         IsLoadChanged(other.write_qps, write_qps, change_ratio);
+}
+
+RegionMetricsDeltaTracker::RegionMetricsDeltaTracker() { bthread_mutex_init(&mutex_, nullptr); }
+
+RegionMetricsDeltaTracker::~RegionMetricsDeltaTracker() { bthread_mutex_destroy(&mutex_); }
+
+bool RegionMetricsDeltaTracker::Begin(int64_t& version, int64_t& base_version) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  version = ++next_version_;
+  base_version = acked_version_;
+
+  uint64_t report_count = report_count_++;
+  if (!FLAGS_enable_store_heartbeat_delta_region_metrics || force_full_ || acked_version_ == 0) {
+    return false;
+  }
+
+  return FLAGS_store_heartbeat_full_region_metrics_multiple > 0 &&
+         report_count % FLAGS_store_heartbeat_full_region_metrics_multiple != 0;
+}
+
+bool RegionMetricsDeltaTracker::IsChanged(int64_t region_id, const RegionMetricsDigest& digest) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = acked_digests_.find(region_id);
+  if (it == acked_digests_.end()) {
+    return true;
+  }
+
+  return digest.IsChanged(it->second, FLAGS_store_heartbeat_region_metrics_change_ratio);
+}
+
+void RegionMetricsDeltaTracker::Commit(int64_t version, bool is_delta,
+                                       std::map<int64_t, RegionMetricsDigest>& reported_digests) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  // a newer report has been acknowledged, this one is stale
+  if (version <= acked_version_) {
+    return;
+  }
+
+  // delta is based on a version which has been dropped by ForceFull
+  if (is_delta && force_full_) {
+    return;
+  }
+
+  if (!is_delta) {
+    acked_digests_.clear();
+  }
+  for (auto& [region_id, digest] : reported_digests) {
+    acked_digests_.insert_or_assign(region_id, digest);
+  }
+
+  acked_version_ = version;
+  force_full_ = false;
+}
+
+void RegionMetricsDeltaTracker::ForceFull() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  force_full_ = true;
+}
 
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
                                        std::vector<int64_t> region_ids, bool is_update_epoch_version) {
@@ -94,6 +244,12 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
                                  Helper::TimestampMs() - start_time)
                   << ", metrics: " << request.mutable_store_metrics()->ShortDebugString();
 
+  // region_metrics_version > 0 means this heartbeat is a full or delta region metrics report
+  bool is_delta_region_metrics = false;
+  int64_t region_metrics_version = 0;
+  int64_t base_region_metrics_version = 0;
+  std::map<int64_t, RegionMetricsDigest> reported_digests;
+
   if (need_report_region_metrics) {
     DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {}", first_start_time,
                                    temp_heartbeat_count);
@@ -103,6 +259,12 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
     std::vector<store::RegionPtr> region_metas;
     if (region_ids.empty()) {
       region_metas = store_meta_manager->GetStoreRegionMeta()->GetAllRegion();
+
+      is_delta_region_metrics =
+          region_metrics_delta_tracker.Begin(region_metrics_version, base_region_metrics_version);
+      request.mutable_store_metrics()->set_is_delta_region_metrics(is_delta_region_metrics);
+      request.mutable_store_metrics()->set_region_metrics_version(region_metrics_version);
+      request.mutable_store_metrics()->set_base_region_metrics_version(base_region_metrics_version);
     } else {
       request.mutable_store_metrics()->set_is_partial_region_metrics(true);
       for (auto region_id : region_ids) {
@@ -132,12 +294,17 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
       tmp_region_metrics.set_id(inner_region.id());
       tmp_region_metrics.set_leader_store_id(inner_region.leader_id());
       tmp_region_metrics.set_store_region_state(inner_region.state());
-      *(tmp_region_metrics.mutable_region_definition()) = inner_region.definition();
 
-      if (BAIDU_LIKELY(FLAGS_raft_snapshot_policy == Constant::kRaftSnapshotPolicyDingo)) {
-        tmp_region_metrics.set_snapshot_epoch_version(INT64_MAX);
-      } else {
-        tmp_region_metrics.set_snapshot_epoch_version(inner_region.snapshot_epoch_version());
+      auto load_metrics = region_meta->LoadMetrics();
+      if (load_metrics != nullptr) {
+        auto rates = load_metrics->Rates();
+        auto* mut_load_metrics = tmp_region_metrics.mutable_load_metrics();
+        mut_load_metrics->set_read_qps(rates.read_count);
+        mut_load_metrics->set_read_keys_per_second(rates.read_keys);
+        mut_load_metrics->set_read_bytes_per_second(rates.read_bytes);
+        mut_load_metrics->set_write_qps(rates.write_count);
+        mut_load_metrics->set_write_keys_per_second(rates.write_keys);
+        mut_load_metrics->set_write_bytes_per_second(rates.write_bytes);
       }
 
       if ((inner_region.state() == pb::common::StoreRegionState::NORMAL ||
@@ -183,12 +350,31 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
         }
       }
 
-      mut_region_metrics_map->insert({inner_region.id(), tmp_region_metrics});
+      // skip unchanged region in delta heartbeat before copying region definition
+      if (region_metrics_version > 0) {
+        auto digest = RegionMetricsDigest::Gen(tmp_region_metrics, inner_region.definition().epoch());
+        if (is_delta_region_metrics && !region_metrics_delta_tracker.IsChanged(inner_region.id(), digest)) {
+          continue;
+        }
+        reported_digests.insert_or_assign(inner_region.id(), digest);
+      }
+
+      *(tmp_region_metrics.mutable_region_definition()) = inner_region.definition();
+
+      if (BAIDU_LIKELY(FLAGS_raft_snapshot_policy == Constant::kRaftSnapshotPolicyDingo)) {
+        tmp_region_metrics.set_snapshot_epoch_version(INT64_MAX);
+      } else {
+        tmp_region_metrics.set_snapshot_epoch_version(inner_region.snapshot_epoch_version());
+      }
+
+      mut_region_metrics_map->insert({inner_region.id(), std::move(tmp_region_metrics)});
     }
 
     DINGO_LOG(INFO) << fmt::format(
-        "[heartbeat.store] start_time({}) request region count({}) size({}) region_ids_count({}), elapsed time({} ms)",
-        first_start_time, mut_region_metrics_map->size(), request.ByteSizeLong(), region_ids.size(),
+        "[heartbeat.store] start_time({}) request region count({}/{}) size({}) region_ids_count({}) delta({}) "
+        "version({}) base_version({}), elapsed time({} ms)",
+        first_start_time, mut_region_metrics_map->size(), region_metas.size(), request.ByteSizeLong(),
+        region_ids.size(), is_delta_region_metrics, region_metrics_version, base_region_metrics_version,
         Helper::TimestampMs() - start_time);
   }
 
@@ -209,12 +395,28 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("[heartbeat.store] start_time({}) store heartbeat failed, error: {}",
                                       first_start_time, Helper::PrintStatus(status));
+    if (region_metrics_version > 0) {
+      region_metrics_delta_tracker.ForceFull();
+    }
     return;
   }
 
   DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) response size({}) elapsed time({} ms)",
                                  first_start_time, response.ByteSizeLong(), Helper::TimestampMs() - start_time);
 
+  if (response.need_full_region_metrics()) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[heartbeat.store] start_time({}) coordinator need full region metrics, version({}) base_version({})",
+        first_start_time, region_metrics_version, base_region_metrics_version);
+    region_metrics_delta_tracker.ForceFull();
+  } else if (region_metrics_version > 0) {
+    if (response.has_error() && response.error().errcode() != pb::error::OK) {
+      region_metrics_delta_tracker.ForceFull();
+    } else {
+      region_metrics_delta_tracker.Commit(region_metrics_version, is_delta_region_metrics, reported_digests);
+    }
+  }
+
   HeartbeatTask::HandleStoreHeartbeatResponse(store_meta_manager, response);
 }
 
@@ -16,18 +16,74 @@
 #define DINGODB_SERVER_HEARTBEAT_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <unordered_map>
 
+#include "bthread/mutex.h"
 #include "common/logging.h"
 #include "common/runnable.h"
 #include "coordinator/coordinator_control.h"
 #include "coordinator/coordinator_interaction.h"
 #include "coordinator/kv_control.h"
 #include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 
 namespace dingodb {
 
+// Digest of the region metrics fields that coordinator cares about,
+// used to decide whether a region need to be carried by a delta heartbeat.
+struct RegionMetricsDigest {
+  int64_t leader_store_id{0};
+  int32_t store_region_state{0};
+  int64_t conf_version{0};
+  int64_t version{0};
+  int32_t raft_state{0};
+  int64_t raft_term{0};
+  int32_t unhealthy_follower_count{0};
+  int64_t row_count{0};
+  int64_t region_size{0};
+  uint32_t index_status_flags{0};
+  int64_t index_last_build_epoch_version{0};
+  int64_t read_qps{0};
+  int64_t write_qps{0};
+
+  static RegionMetricsDigest Gen(const pb::common::RegionMetrics& region_metrics, const pb::common::RegionEpoch& epoch);
+
+  // state/epoch/leader change or row_count/region_size/qps change beyond change_ratio
+  bool IsChanged(const RegionMetricsDigest& other, double change_ratio) const;
+};
+
+// Track the region metrics last acknowledged by coordinator, so heartbeat only carry changed regions.
+// Every region metrics report has a increasing version, a delta report carry the last acknowledged version as base,
+// coordinator will ask for a full report when the base is not what it has applied(heartbeat lost or leader changed).
+class RegionMetricsDeltaTracker {
+ public:
+  RegionMetricsDeltaTracker();
+  ~RegionMetricsDeltaTracker();
+
+  // begin a region metrics report, return true if it is a delta report
+  bool Begin(int64_t& version, int64_t& base_version);
+
+  // whether region need to be reported in delta report
+  bool IsChanged(int64_t region_id, const RegionMetricsDigest& digest);
+
+  // coordinator acknowledged the report
+  void Commit(int64_t version, bool is_delta, std::map<int64_t, RegionMetricsDigest>& reported_digests);
+
+  // heartbeat failed or coordinator asked for a full report
+  void ForceFull();
+
+ private:
+  bthread_mutex_t mutex_;
+  int64_t next_version_{0};
+  int64_t acked_version_{0};
+  uint64_t report_count_{0};
+  bool force_full_{true};
+  std::unordered_map<int64_t, RegionMetricsDigest> acked_digests_;
+};
+
 class HeartbeatTask : public TaskRunnable {
  public:
   HeartbeatTask(std::shared_ptr<CoordinatorInteraction> coordinator_interaction)
@@ -49,6 +105,7 @@ class HeartbeatTask : public TaskRunnable {
                                            const pb::coordinator::StoreHeartbeatResponse& response);
 
   static std::atomic<uint64_t> heartbeat_counter;
+  static RegionMetricsDeltaTracker region_metrics_delta_tracker;
 
  private:
   bool is_update_epoch_version_;
@@ -27,9 +27,11 @@
 #include "common/logging.h"
 #include "common/role.h"
 #include "common/service_access.h"
+#include "common/synchronization.h"
 #include "config/config_helper.h"
 #include "config/config_manager.h"
 #include "engine/raft_store_engine.h"
+#include "engine/write_data.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
@@ -37,11 +39,14 @@
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
+#include "metrics/tracker_sampler.h"
+#include "mvcc/codec.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
+#include "server/service_helper.h"
 #include "vector/codec.h"
 #include "vector/vector_index_hnsw.h"
 
@@ -274,6 +279,7 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
   DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] delete region, delete region metrics", region_id);
   Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics()->DeleteMetrics(region_id);
   StoreBvarMetrics::GetInstance().DeleteMetrics(std::to_string(region_id));
+  TrackerSampler::GetInstance().DeleteRegion(region_id);
 
   // Delete raft meta
   store_meta_manager->GetStoreRaftMeta()->DeleteRaftMeta(region_id);
@@ -514,6 +520,65 @@ butil::Status SplitRegionTask::ValidateSplitRegion(std::shared_ptr<StoreRegionMe
   return butil::Status();
 }
 
+// Write in-memory pessimistic locks to lock cf, before leader transfer/split/merge.
+static butil::Status MaterializePessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region) {
+  auto pessimistic_lock_table = region->PessimisticLockTable();
+  // new pessimistic lock will write lock cf until Resume
+  pessimistic_lock_table->Suspend();
+
+  auto lock_infos = pessimistic_lock_table->GetAllLocks();
+  if (lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  std::vector<std::string> keys;
+  keys.reserve(lock_infos.size());
+  for (const auto& lock_info : lock_infos) {
+    keys.push_back(lock_info.key());
+  }
+
+  LatchContext latch_ctx(region, keys);
+  ServiceHelper::LatchesAcquire(latch_ctx, true);
+  DEFER(ServiceHelper::LatchesRelease(latch_ctx));
+
+  // locks may be prewritten or rollbacked before get latches
+  lock_infos = pessimistic_lock_table->GetAllLocks();
+  if (lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  pb::raft::TxnRaftRequest txn_raft_request;
+  auto* lock_puts = txn_raft_request.mutable_multi_cf_put_and_delete()->add_puts_with_cf();
+  lock_puts->set_cf_name(Constant::kTxnLockCF);
+  for (const auto& lock_info : lock_infos) {
+    auto* kv = lock_puts->add_kvs();
+    kv->set_key(mvcc::Codec::EncodeKey(lock_info.key(), Constant::kLockVer));
+    kv->set_value(lock_info.SerializeAsString());
+  }
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetRegionEpoch(region->Epoch());
+  ctx->SetCfName(Constant::kTxnLockCF);
+  ctx->SetRawEngineType(region->GetRawEngineType());
+  ctx->SetStoreEngineType(region->GetStoreEngineType());
+
+  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] MaterializePessimisticLocks failed, lock_count: {} status: {}",
+                                    region->Id(), lock_infos.size(), ret.error_str());
+    if (ret.error_code() == EPERM) {
+      return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
+    }
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] MaterializePessimisticLocks finish, lock_count: {}", region->Id(),
+                                 lock_infos.size());
+
+  return butil::Status::OK();
+}
+
 butil::Status SplitRegionTask::SplitRegion() {
   auto store_region_meta = GET_STORE_REGION_META;
 
@@ -529,14 +594,24 @@ butil::Status SplitRegionTask::SplitRegion() {
 
   ADD_REGION_CHANGE_RECORD(*region_cmd_);
 
+  auto raft_engine = Server::GetInstance().GetEngine(parent_region->GetStoreEngineType());
+
+  // In-memory pessimistic locks can't follow the split, write them to lock cf first.
+  if (parent_region->IsTxn()) {
+    status = MaterializePessimisticLocks(raft_engine, parent_region);
+    if (!status.ok()) {
+      parent_region->PessimisticLockTable()->Resume();
+      return status;
+    }
+  }
+  DEFER(parent_region->PessimisticLockTable()->Resume());
+
   // Commit raft command
   auto ctx = std::make_shared<Context>();
   ctx->SetRegionId(region_cmd_->split_request().split_from_region_id());
   ctx->SetRegionEpoch(parent_region->Epoch());
-  status = Server::GetInstance()
-               .GetEngine(parent_region->GetStoreEngineType())
-               ->Write(ctx, WriteDataBuilder::BuildWrite(region_cmd_->job_id(), region_cmd_->split_request(),
-                                                         parent_region->Epoch()));
+  status = raft_engine->Write(
+      ctx, WriteDataBuilder::BuildWrite(region_cmd_->job_id(), region_cmd_->split_request(), parent_region->Epoch()));
   DINGO_LOG_IF(ERROR, !status.ok()) << fmt::format("[control.region][region()] commit split command failed, error: {}",
                                                    status.error_str());
 
@@ -881,6 +956,16 @@ butil::Status MergeRegionTask::MergeRegion() {
 
   ADD_REGION_CHANGE_RECORD(*region_cmd_);
 
+  // In-memory pessimistic locks can't follow the merge, write them to lock cf first.
+  if (source_region->IsTxn()) {
+    status = MaterializePessimisticLocks(
+        Server::GetInstance().GetEngine(source_region->GetStoreEngineType()), source_region);
+    if (!status.ok()) {
+      source_region->PessimisticLockTable()->Resume();
+      return status;
+    }
+  }
+
   // Disable region change
   store_region_meta->UpdateTemporaryDisableChange(source_region, true);
   store_region_meta->UpdateTemporaryDisableChange(target_region, true);
@@ -896,6 +981,7 @@ butil::Status MergeRegionTask::MergeRegion() {
   if (!status.ok()) {
     store_region_meta->UpdateTemporaryDisableChange(source_region, false);
     store_region_meta->UpdateTemporaryDisableChange(target_region, false);
+    source_region->PessimisticLockTable()->Resume();
     return status;
   }
   return butil::Status();
@@ -1129,7 +1215,21 @@ butil::Status TransferLeaderTask::TransferLeader(std::shared_ptr<Context>, int64
   }
   auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
   if (raft_store_engine != nullptr) {
-    return raft_store_engine->TransferLeader(region_id, peer);
+    // In-memory pessimistic locks are lost when leader change, write them to lock cf first.
+    auto region = store_meta_manager->GetStoreRegionMeta()->GetRegion(region_id);
+    if (region != nullptr && region->IsTxn()) {
+      status = MaterializePessimisticLocks(raft_store_engine, region);
+      if (!status.ok()) {
+        region->PessimisticLockTable()->Resume();
+        return status;
+      }
+    }
+
+    status = raft_store_engine->TransferLeader(region_id, peer);
+    if (!status.ok() && region != nullptr) {
+      region->PessimisticLockTable()->Resume();
+    }
+    return status;
   }
 
   return butil::Status();
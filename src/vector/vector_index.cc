@@ -23,6 +23,8 @@
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -35,6 +37,7 @@
 #include "simd/hook.h"
 #include "vector/codec.h"
 #include "vector/vector_index_diskann.h"
+#include "vector/vector_index_manager.h"
 #include "vector/vector_index_snapshot_manager.h"
 
 #ifndef ENABLE_SIMD_HOOK
@@ -55,6 +58,15 @@ DEFINE_uint32(vector_read_batch_size_per_task, 1, "vector read batch size per ta
 
 DEFINE_uint32(parallel_log_threshold_time_ms, 5000, "parallel log elapsed time");
 
+DEFINE_int32(vector_index_train_warm_start_niter, 4,
+             "k-means iterations of ivf train warm start from the centroids of parent index, 0 is disable warm start");
+
+DEFINE_int64(vector_index_reload_relaunch_ms, 10000,
+             "relaunch reload evicted vector index if it is still not ready after this time");
+
+bvar::Adder<int64_t> g_vector_index_reload_count("dingo_vector_index_reload_count");
+bvar::LatencyRecorder g_vector_index_reload_latency("dingo_vector_index_reload_latency");
+
 // split VectorWithId set to multi batch
 static void SplitVectorWithId(const std::vector<pb::common::VectorWithId>& vector_with_ids, int batch_size,
                               std::vector<std::vector<pb::common::VectorWithId>>& vector_with_id_batchs) {
@@ -299,14 +311,15 @@ butil::Status VectorIndex::RangeSearchByParallel(
   }
 }
 
-butil::Status VectorIndex::TrainByParallel(std::vector<float>& train_datas) {
+butil::Status VectorIndex::TrainByParallel(std::vector<float>& train_datas, ThreadPoolPtr train_thread_pool) {
   butil::Status status;
 
   DINGO_LOG(INFO) << fmt::format("[vector_index.train][index_id({})] train ready, vector data size({}).", Id(),
                                  train_datas.size());
 
   uint64_t start_time = Helper::TimestampMs();
-  auto task = thread_pool->ExecuteTask([&](void*) { status = Train(train_datas); }, nullptr, 0);
+  auto pool = train_thread_pool != nullptr ? train_thread_pool : thread_pool;
+  auto task = pool->ExecuteTask([&](void*) { status = Train(train_datas); }, nullptr, 0);
 
   task->Join();
 
@@ -609,6 +622,12 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
     ++version_;
 
     ready_.store(true);
+    evicted_.store(false);
+    int64_t reload_launch_time_ms = reload_launch_time_ms_.exchange(0);
+    if (reload_launch_time_ms > 0) {
+      g_vector_index_reload_latency << (Helper::TimestampMs() - reload_launch_time_ms) * 1000;
+    }
+    Touch();
 
     int64_t apply_log_id = ApplyLogId();
     int64_t snapshot_log_id = SnapshotLogId();
@@ -636,6 +655,60 @@ void VectorIndexWrapper::ClearVectorIndex(const std::string& trace) {
   vector_index_ = nullptr;
   share_vector_index_ = nullptr;
   sibling_vector_index_ = nullptr;
+  evicted_.store(false);
+  reload_launch_time_ms_.store(0);
+}
+
+bool VectorIndexWrapper::EvictVectorIndex(const std::string& trace) {
+  {
+    BAIDU_SCOPED_LOCK(vector_index_mutex_);
+
+    if (vector_index_ == nullptr || share_vector_index_ != nullptr || sibling_vector_index_ != nullptr) {
+      DINGO_LOG(INFO) << fmt::format(
+          "[vector_index.wrapper][index_id({})][trace({})] vector index is not evictable, own({}) share({}) "
+          "sibling({}).",
+          Id(), trace, vector_index_ != nullptr, share_vector_index_ != nullptr, sibling_vector_index_ != nullptr);
+      return false;
+    }
+
+    ready_.store(false);
+    vector_index_ = nullptr;
+    evicted_.store(true);
+    reload_launch_time_ms_.store(0);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.wrapper][index_id({})][trace({})] evict vector index, apply_log_id({}) snapshot_log_id({}).", Id(),
+      trace, ApplyLogId(), SnapshotLogId());
+
+  return true;
+}
+
+bool VectorIndexWrapper::ReloadIfEvicted() {
+  if (IsReady()) {
+    return true;
+  }
+  if (!IsEvicted() || IsStop()) {
+    return false;
+  }
+
+  Touch();
+
+  // only the first request launch reload, requests not wait it and retry on not ready error,
+  // so no read/write worker is parked. relaunch if the reload take too long, e.g. it is failed.
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t launch_time_ms = reload_launch_time_ms_.load();
+  if (launch_time_ms > 0 && now_ms - launch_time_ms < FLAGS_vector_index_reload_relaunch_ms) {
+    return IsReady();
+  }
+  if (reload_launch_time_ms_.compare_exchange_strong(launch_time_ms, now_ms)) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] launch reload evicted vector index.", Id());
+    g_vector_index_reload_count << 1;
+    // duplicate load is skipped by loadorbuilding num.
+    VectorIndexManager::LaunchLoadOrBuildVectorIndex(GetSelf(), false, true, 0, "reload evicted");
+  }
+
+  return IsReady();
 }
 
 VectorIndexPtr VectorIndexWrapper::GetOwnVectorIndex() {
@@ -922,6 +995,8 @@ butil::Status VectorIndexWrapper::Add(const std::vector<pb::common::VectorWithId
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  Touch();
+
   // Waiting switch vector index
   int count = 0;
   while (IsSwitchingVectorIndex()) {
@@ -969,6 +1044,8 @@ butil::Status VectorIndexWrapper::Upsert(const std::vector<pb::common::VectorWit
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  Touch();
+
   // Switch vector index wait
   int count = 0;
   while (IsSwitchingVectorIndex()) {
@@ -1016,6 +1093,8 @@ butil::Status VectorIndexWrapper::Delete(const std::vector<int64_t>& delete_ids)
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  Touch();
+
   // Switch vector index wait
   int count = 0;
   while (IsSwitchingVectorIndex()) {
@@ -1116,6 +1195,9 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
+
+  Touch();
+
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
@@ -1177,6 +1259,9 @@ butil::Status VectorIndexWrapper::RangeSearch(std::vector<pb::common::VectorWith
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
+
+  Touch();
+
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/types.h"
@@ -35,6 +36,7 @@
 #include "faiss/impl/IDSelector.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
+#include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_snapshot.h"
 
@@ -69,6 +71,11 @@ class VectorIndex {
     virtual ~FilterFunctor() = default;
     virtual void Build(std::vector<faiss::idx_t>& id_map) {}
     virtual bool Check(int64_t vector_id) = 0;
+
+    // count of vector ids allowed by the filter, -1 means unknown, used to estimate filter selectivity.
+    virtual int64_t AllowedCount() { return -1; }
+    // vector ids allowed by the filter, only valid when AllowedCount() >= 0.
+    virtual void GetAllowedVectorIds(std::vector<int64_t>& /*vector_ids*/) {}
   };
 
   // Range filter
@@ -100,6 +107,14 @@ class VectorIndex {
       return !is_negation_ ? exist : !exist;
     }
 
+    int64_t AllowedCount() override { return !is_negation_ ? static_cast<int64_t>(set.size()) : -1; }
+
+    void GetAllowedVectorIds(std::vector<int64_t>& vector_ids) override {
+      if (!is_negation_) {
+        vector_ids.insert(vector_ids.end(), set.begin(), set.end());
+      }
+    }
+
    private:
     bool is_negation_{false};
   };
@@ -123,6 +138,14 @@ class VectorIndex {
       return !is_negation_ ? exist : !exist;
     }
 
+    int64_t AllowedCount() override { return !is_negation_ ? static_cast<int64_t>(vector_ids_.size()) : -1; }
+
+    void GetAllowedVectorIds(std::vector<int64_t>& vector_ids) override {
+      if (!is_negation_) {
+        vector_ids.insert(vector_ids.end(), vector_ids_.begin(), vector_ids_.end());
+      }
+    }
+
    private:
     bool IsExist(int64_t vector_id) const {
       int64_t begin = 0, end = vector_ids_.size() - 1;
@@ -193,11 +216,20 @@ class VectorIndex {
   virtual void UnlockWrite() = 0;
   virtual butil::Status Train(std::vector<float>& train_datas) = 0;
   virtual butil::Status Train(std::vector<uint8_t>& ) { return butil::Status::OK(); }
-  virtual butil::Status TrainByParallel(std::vector<float>& train_datas);
+  // train in train_thread_pool if set, else in the vector index thread pool.
+  virtual butil::Status TrainByParallel(std::vector<float>& train_datas, ThreadPoolPtr train_thread_pool = nullptr);
   virtual butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) = 0;
   virtual bool NeedToRebuild() = 0;
   virtual bool NeedTrain() { return false; }
   virtual bool IsTrained() { return true; }
+  // max train vector num, more data not improve the train, 0 means no limit.
+  virtual int64_t TrainSampleSize() { return 0; }
+  // centroids of ivf coarse quantizer, used to warm start the train of other index.
+  virtual butil::Status GetCentroids(std::vector<float>& /*centroids*/) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "this vector index do not implement get centroids");
+  }
+  // used and cleared by next train, ignored if not match nlist and dimension.
+  void SetTrainInitCentroids(std::vector<float> centroids) { train_init_centroids = std::move(centroids); }
   virtual bool NeedToSave(int64_t last_save_log_behind) = 0;
   virtual bool SupportSave() { return false; }
   virtual butil::Status Build(const pb::common::Range& /*region_range*/, mvcc::ReaderPtr /*reader*/,
@@ -276,6 +308,9 @@ class VectorIndex {
 
   // vector index thread pool
   ThreadPoolPtr thread_pool;
+
+  // init centroids of next train, e.g. the centroids of parent index after split
+  std::vector<float> train_init_centroids;
 };
 
 using VectorIndexPtr = std::shared_ptr<VectorIndex>;
@@ -375,6 +410,18 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   void UpdateVectorIndex(VectorIndexPtr vector_index, const std::string& trace);
   void ClearVectorIndex(const std::string& trace);
 
+  // Release own vector index to free memory, it can be reloaded from snapshot and catch up wal on demand.
+  // Refuse when share/sibling vector index exist, they are switching by split/merge.
+  bool EvictVectorIndex(const std::string& trace);
+  bool IsEvicted() { return evicted_.load(); }
+  // Launch reload evicted vector index without waiting, the concurrent requests share one reload.
+  // Return true if vector index is ready, otherwise the request should retry later.
+  bool ReloadIfEvicted();
+
+  // Record access time for memory budget eviction.
+  void Touch() { last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed); }
+  int64_t LastAccessTimeMs() { return last_access_time_ms_.load(std::memory_order_relaxed); }
+
   VectorIndexPtr GetOwnVectorIndex();
   VectorIndexPtr GetVectorIndex();
 
@@ -501,6 +548,13 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   // need hold vector index
   std::atomic<bool> is_hold_vector_index_;
+
+  // own vector index is evicted by memory budget
+  std::atomic<bool> evicted_{false};
+  // launch time of reload evicted vector index, 0 is not launched
+  std::atomic<int64_t> reload_launch_time_ms_{0};
+  // last search/write time
+  std::atomic<int64_t> last_access_time_ms_{0};
 };
 
 using VectorIndexWrapperPtr = std::shared_ptr<VectorIndexWrapper>;
@@ -14,13 +14,17 @@
 
 #include "vector/vector_index_diskann.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -69,6 +73,74 @@ DEFINE_bool(diskann_load_sync_internal, false, "diskann load sync internal. defa
 DEFINE_bool(diskann_reset_force_delete_file_internal, true,
             "diskann reset force delete file internal. default is true");
 
+DEFINE_int64(diskann_search_filter_ids_max_num, 100000,
+             "max allowed vector ids pushed down to diskann server, otherwise filter after search");
+BRPC_VALIDATE_GFLAG(diskann_search_filter_ids_max_num, brpc::NonNegativeInteger);
+DEFINE_int64(diskann_search_post_filter_expand_multiple, 10, "filter after search fetch topk * multiple candidates");
+BRPC_VALIDATE_GFLAG(diskann_search_post_filter_expand_multiple, brpc::PositiveInteger);
+DEFINE_int64(diskann_search_post_filter_max_topk, 4096, "filter after search fetch candidates at most");
+BRPC_VALIDATE_GFLAG(diskann_search_post_filter_max_topk, brpc::PositiveInteger);
+DEFINE_bool(diskann_search_filter_bruteforce_fallback, true,
+            "filtered search fall back to brute force when diskann not found enough allowed vectors");
+
+bvar::Adder<int64_t> g_diskann_filter_bruteforce_fallback_count("dingo_diskann_filter_bruteforce_fallback_count");
+
+// intersect the allowed vector ids of filters, return false if any filter allowed ids is unknown or too many.
+static bool GetFilterVectorIds(const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                               std::vector<int64_t>& filter_vector_ids) {
+  for (const auto& filter : filters) {
+    int64_t allowed_count = filter->AllowedCount();
+    if (allowed_count < 0 || allowed_count > FLAGS_diskann_search_filter_ids_max_num) {
+      return false;
+    }
+  }
+
+  bool is_first = true;
+  for (const auto& filter : filters) {
+    std::vector<int64_t> vector_ids;
+    filter->GetAllowedVectorIds(vector_ids);
+    std::sort(vector_ids.begin(), vector_ids.end());
+    vector_ids.erase(std::unique(vector_ids.begin(), vector_ids.end()), vector_ids.end());
+
+    if (is_first) {
+      filter_vector_ids.swap(vector_ids);
+      is_first = false;
+    } else {
+      std::vector<int64_t> intersection;
+      std::set_intersection(filter_vector_ids.begin(), filter_vector_ids.end(), vector_ids.begin(), vector_ids.end(),
+                            std::back_inserter(intersection));
+      filter_vector_ids.swap(intersection);
+    }
+
+    if (filter_vector_ids.empty()) {
+      break;
+    }
+  }
+
+  return true;
+}
+
+// drop the results not allowed by filters, and keep topk.
+static void PostFilterResults(const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, uint32_t topk,
+                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+  for (auto& result : results) {
+    auto* vector_with_distances = result.mutable_vector_with_distances();
+    int keep = 0;
+    for (int i = 0; i < vector_with_distances->size() && keep < static_cast<int>(topk); ++i) {
+      int64_t vector_id = vector_with_distances->Get(i).vector_with_id().id();
+      bool is_allowed = std::all_of(filters.begin(), filters.end(),
+                                    [vector_id](const auto& filter) { return filter->Check(vector_id); });
+      if (is_allowed) {
+        if (keep != i) {
+          vector_with_distances->SwapElements(keep, i);
+        }
+        ++keep;
+      }
+    }
+    vector_with_distances->DeleteSubrange(keep, vector_with_distances->size() - keep);
+  }
+}
+
 VectorIndexDiskANN::VectorIndexDiskANN(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                        const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
                                        ThreadPoolPtr thread_pool)
@@ -215,14 +287,58 @@ butil::Status VectorIndexDiskANN::Search(const std::vector<pb::common::VectorWit
   {
     BvarLatencyGuard bvar_guard(&g_diskann_search_latency);
 
+    // filter with allowed vector ids is pushed down to diskann server,
+    // otherwise fetch more candidates and filter after search.
+    std::vector<int64_t> filter_vector_ids;
+    bool is_post_filter = false;
+    uint32_t search_topk = topk;
     if (!filters.empty()) {
-      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "Search with filter not support in DiskANN!!!");
+      if (GetFilterVectorIds(filters, filter_vector_ids)) {
+        if (filter_vector_ids.empty()) {
+          results.clear();
+          results.resize(vector_with_ids.size());
+          return butil::Status::OK();
+        }
+      } else {
+        is_post_filter = true;
+        search_topk = std::max(static_cast<int64_t>(topk),
+                               std::min(static_cast<int64_t>(topk) * FLAGS_diskann_search_post_filter_expand_multiple,
+                                        FLAGS_diskann_search_post_filter_max_topk));
+      }
     }
 
+    // diskann widen the filtered search up to a limit, the allowed vectors may be not found when they are far from
+    // the query, return not support then vector reader fall back to brute force to get the exact result.
+    auto lambda_filter_result_function = [&]() -> butil::Status {
+      if (is_post_filter) {
+        PostFilterResults(filters, topk, results);
+      }
+
+      if (filters.empty() || !FLAGS_diskann_search_filter_bruteforce_fallback) {
+        return butil::Status::OK();
+      }
+
+      int64_t expect_count = is_post_filter ? static_cast<int64_t>(topk)
+                                            : std::min(static_cast<int64_t>(topk),
+                                                       static_cast<int64_t>(filter_vector_ids.size()));
+      for (const auto& result : results) {
+        if (result.vector_with_distances_size() < expect_count) {
+          g_diskann_filter_bruteforce_fallback_count << 1;
+          std::string s = fmt::format("diskann filtered search found {} less than {}, fall back to brute force, id: {}",
+                                      result.vector_with_distances_size(), expect_count, Id());
+          DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_diskann_detail) << s;
+          results.clear();
+          return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
+        }
+      }
+
+      return butil::Status::OK();
+    };
+
     butil::Status status;
 
     // search rpc
-    status = SendVectorSearchRequestWrapper(vector_with_ids, topk, parameter, results);
+    status = SendVectorSearchRequestWrapper(vector_with_ids, search_topk, parameter, filter_vector_ids, results);
     if (!status.ok() && status.error_code() != pb::error::Errno::EINDEX_NOT_FOUND) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
@@ -238,18 +354,17 @@ butil::Status VectorIndexDiskANN::Search(const std::vector<pb::common::VectorWit
         return status;
       }
     } else {  // ok
-      return butil::Status::OK();
+      return lambda_filter_result_function();
     }
 
     // search again
-    status = SendVectorSearchRequestWrapper(vector_with_ids, topk, parameter, results);
+    status = SendVectorSearchRequestWrapper(vector_with_ids, search_topk, parameter, filter_vector_ids, results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
       return status;
     }
+    return lambda_filter_result_function();
   }
-
-  return butil::Status::OK();
 }
 
 butil::Status VectorIndexDiskANN::RangeSearch(
@@ -1510,7 +1625,8 @@ butil::Status VectorIndexDiskANN::SendVectorSearchRequest(const google::protobuf
 
 butil::Status VectorIndexDiskANN::SendVectorSearchRequestWrapper(
     const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
-    const pb::common::VectorSearchParameter& parameter, std::vector<pb::index::VectorWithDistanceResult>& results) {
+    const pb::common::VectorSearchParameter& parameter, const std::vector<int64_t>& filter_vector_ids,
+    std::vector<pb::index::VectorWithDistanceResult>& results) {
   butil::Status status;
   pb::diskann::VectorSearchRequest vector_search_request;
   pb::diskann::VectorSearchResponse vector_search_response;
@@ -1523,6 +1639,7 @@ butil::Status VectorIndexDiskANN::SendVectorSearchRequestWrapper(
   if (parameter.has_diskann()) {
     vector_search_request.mutable_search_param()->CopyFrom(parameter.diskann());
   }
+  vector_search_request.mutable_filter_vector_ids()->Add(filter_vector_ids.begin(), filter_vector_ids.end());
 
   status = SendVectorSearchRequest(vector_search_request, vector_search_response);
   if (!status.ok()) {
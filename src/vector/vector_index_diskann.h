@@ -152,6 +152,7 @@ class VectorIndexDiskANN : public VectorIndex, public std::enable_shared_from_th
   butil::Status SendVectorSearchRequest(const google::protobuf::Message& request, google::protobuf::Message& response);
   butil::Status SendVectorSearchRequestWrapper(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                uint32_t topk, const pb::common::VectorSearchParameter& parameter,
+                                               const std::vector<int64_t>& filter_vector_ids,
                                                std::vector<pb::index::VectorWithDistanceResult>& results);
   butil::Status SendVectorResetRequest(const google::protobuf::Message& request, google::protobuf::Message& response);
   butil::Status SendVectorResetRequestWrapper(bool delete_data_file, pb::common::DiskANNCoreState& state);
@@ -16,12 +16,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <queue>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -54,6 +57,14 @@ DEFINE_uint32(hnsw_vector_write_batch_size_per_task, 16, "hnsw vector write batc
 DECLARE_uint32(vector_read_batch_size_per_task);
 DECLARE_uint32(parallel_log_threshold_time_ms);
 
+DEFINE_double(hnsw_filter_bruteforce_selectivity, 0.01,
+              "hnsw filtered search use brute force over allowed vector ids when filter selectivity is lower than it");
+DEFINE_double(hnsw_filter_enlarge_ef_selectivity, 0.5,
+              "hnsw filtered search enlarge ef by 1/selectivity when filter selectivity is lower than it");
+DEFINE_uint32(hnsw_filter_max_efsearch, 4096, "hnsw filtered search max enlarged ef");
+DEFINE_uint32(hnsw_range_search_init_topk, 128, "hnsw range search initial topk, double it until out of radius");
+DEFINE_uint32(hnsw_range_search_max_topk, 65536, "hnsw range search max topk");
+
 bvar::LatencyRecorder g_hnsw_upsert_latency("dingo_hnsw_upsert_latency");
 bvar::LatencyRecorder g_hnsw_search_latency("dingo_hnsw_search_latency");
 bvar::LatencyRecorder g_hnsw_range_search_latency("dingo_hnsw_range_search_latency");
@@ -82,6 +93,140 @@ class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
 };
 
+// Filtered search plan, hnswlib check filter for every candidate when traversing graph, which degrades badly
+// when the filter is selective. So brute force over allowed vector ids when selectivity is low, and enlarge ef
+// when selectivity is moderate. Must generate under read lock.
+struct HnswFilterPlan {
+  std::shared_ptr<HnswRangeFilterFunctor> hnsw_filter;
+  double selectivity{1.0};
+
+  bool is_bruteforce{false};
+  std::vector<hnswlib::tableint> candidate_internal_ids;
+};
+
+static HnswFilterPlan GenHnswFilterPlan(hnswlib::HierarchicalNSW<float>* hnsw_index,
+                                        const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                        uint32_t topk) {
+  HnswFilterPlan plan;
+  if (filters.empty()) {
+    return plan;
+  }
+  plan.hnsw_filter = std::make_shared<HnswRangeFilterFunctor>(filters);
+
+  int64_t live_count = static_cast<int64_t>(hnsw_index->getCurrentElementCount()) -
+                       static_cast<int64_t>(hnsw_index->getDeletedCount());
+  if (live_count <= 0) {
+    return plan;
+  }
+
+  // the most selective filter with explicit vector ids
+  std::shared_ptr<VectorIndex::FilterFunctor> min_filter;
+  int64_t min_allowed_count = -1;
+  for (const auto& filter : filters) {
+    int64_t allowed_count = filter->AllowedCount();
+    if (allowed_count >= 0 && (min_allowed_count < 0 || allowed_count < min_allowed_count)) {
+      min_allowed_count = allowed_count;
+      min_filter = filter;
+    }
+  }
+  if (min_filter == nullptr) {
+    return plan;
+  }
+
+  plan.selectivity = std::min(1.0, static_cast<double>(min_allowed_count) / static_cast<double>(live_count));
+  if (plan.selectivity > FLAGS_hnsw_filter_bruteforce_selectivity && min_allowed_count > topk) {
+    return plan;
+  }
+
+  std::vector<int64_t> allowed_vector_ids;
+  min_filter->GetAllowedVectorIds(allowed_vector_ids);
+
+  // writer hold write lock, so label_lookup_ is stable under read lock.
+  plan.candidate_internal_ids.reserve(allowed_vector_ids.size());
+  for (auto vector_id : allowed_vector_ids) {
+    if (!(*plan.hnsw_filter)(vector_id)) {
+      continue;
+    }
+    auto it = hnsw_index->label_lookup_.find(vector_id);
+    if (it == hnsw_index->label_lookup_.end() || hnsw_index->isMarkedDeleted(it->second)) {
+      continue;
+    }
+    plan.candidate_internal_ids.push_back(it->second);
+  }
+  plan.is_bruteforce = true;
+
+  return plan;
+}
+
+// enlarge search topk, hnswlib use max(ef, k) as ef, so filtered search still get enough candidates.
+static uint32_t GetFilterSearchTopk(const HnswFilterPlan& plan, uint32_t topk) {
+  if (plan.hnsw_filter == nullptr || plan.selectivity >= FLAGS_hnsw_filter_enlarge_ef_selectivity) {
+    return topk;
+  }
+
+  double search_topk = std::ceil(static_cast<double>(topk) / std::max(plan.selectivity, 1e-6));
+  search_topk = std::min(search_topk, static_cast<double>(FLAGS_hnsw_filter_max_efsearch));
+  return std::max(topk, static_cast<uint32_t>(search_topk));
+}
+
+static std::priority_queue<std::pair<float, hnswlib::labeltype>> BruteForceSearchKnn(
+    hnswlib::HierarchicalNSW<float>* hnsw_index, const float* query,
+    const std::vector<hnswlib::tableint>& candidate_internal_ids, uint32_t topk) {
+  std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+  for (auto internal_id : candidate_internal_ids) {
+    float distance =
+        hnsw_index->fstdistfunc_(query, hnsw_index->getDataByInternalId(internal_id), hnsw_index->dist_func_param_);
+    if (result.size() < topk) {
+      result.emplace(distance, hnsw_index->getExternalLabel(internal_id));
+    } else if (distance < result.top().first) {
+      result.pop();
+      result.emplace(distance, hnsw_index->getExternalLabel(internal_id));
+    }
+  }
+
+  return result;
+}
+
+static void BruteForceRangeSearch(hnswlib::HierarchicalNSW<float>* hnsw_index, const float* query, float radius,
+                                  const std::vector<hnswlib::tableint>& candidate_internal_ids,
+                                  std::vector<std::pair<float, hnswlib::labeltype>>& range_result) {
+  for (auto internal_id : candidate_internal_ids) {
+    float distance =
+        hnsw_index->fstdistfunc_(query, hnsw_index->getDataByInternalId(internal_id), hnsw_index->dist_func_param_);
+    if (distance < radius) {
+      range_result.emplace_back(distance, hnsw_index->getExternalLabel(internal_id));
+    }
+  }
+}
+
+// Search by graph with doubled topk until the farthest result is out of radius.
+static void GraphRangeSearch(hnswlib::HierarchicalNSW<float>* hnsw_index, const float* query, float radius,
+                             HnswRangeFilterFunctor* hnsw_filter,
+                             std::vector<std::pair<float, hnswlib::labeltype>>& range_result) {
+  size_t element_count = hnsw_index->getCurrentElementCount();
+  size_t max_topk = std::max(static_cast<size_t>(1), std::min(element_count,
+                                                               static_cast<size_t>(FLAGS_hnsw_range_search_max_topk)));
+  size_t topk = std::min(max_topk, static_cast<size_t>(std::max(FLAGS_hnsw_range_search_init_topk, 1U)));
+
+  for (;;) {
+    auto result = hnsw_index->searchKnn(query, topk, hnsw_filter);
+
+    bool is_exhausted = result.size() < topk || topk >= max_topk;
+    bool is_farthest_in_radius = !result.empty() && result.top().first < radius;
+    if (is_exhausted || !is_farthest_in_radius) {
+      while (!result.empty()) {
+        if (result.top().first < radius) {
+          range_result.push_back(result.top());
+        }
+        result.pop();
+      }
+      return;
+    }
+
+    topk = std::min(topk * 2, max_topk);
+  }
+}
+
 template <typename Function>
 inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size_t start, size_t end,
                         uint32_t batch_size, bool is_priority, Function fn) {
@@ -412,8 +557,6 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     return butil::Status::OK();
   };
 
-  auto hnsw_filter = filters.empty() ? nullptr : std::make_shared<HnswRangeFilterFunctor>(filters);
-
   BvarLatencyGuard bvar_guard(&g_hnsw_search_latency);
   RWLockReadGuard guard(&rw_lock_);
 
@@ -421,13 +564,28 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     hnsw_index_->setEf(search_parameter.hnsw().efsearch());
   }
 
+  auto filter_plan = GenHnswFilterPlan(hnsw_index_, filters, topk);
+  uint32_t search_topk = GetFilterSearchTopk(filter_plan, topk);
+
+  auto lambda_search_function = [this, &filter_plan, topk, search_topk](const float* query) {
+    if (filter_plan.is_bruteforce) {
+      return BruteForceSearchKnn(hnsw_index_, query, filter_plan.candidate_internal_ids, topk);
+    }
+
+    auto result = hnsw_index_->searchKnn(query, search_topk, filter_plan.hnsw_filter.get());
+    while (result.size() > topk) {
+      result.pop();
+    }
+    return result;
+  };
+
   if (!normalize_) {
     ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true,
                 [&](size_t row) {
                   std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
                   try {
-                    result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
+                    result = lambda_search_function(data.get() + dimension_ * row);
                   } catch (std::runtime_error& e) {
                     std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
                     LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -450,7 +608,7 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
           std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
           try {
-            result = hnsw_index_->searchKnn(norm_array.data(), topk, hnsw_filter.get());
+            result = lambda_search_function(norm_array.data());
           } catch (std::runtime_error& e) {
             std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
             LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -478,12 +636,105 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/,
-                                           float /*radius*/,
-                                           const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& /*filters*/,
-                                           bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
-                                           std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
-  return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "RangeSearch not support in Hnsw!!!");
+butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                                           const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                           bool reconstruct, const pb::common::VectorSearchParameter& search_parameter,
+                                           std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  if (vector_index_type != pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
+  }
+
+  if (search_parameter.hnsw().efsearch() < 0 || search_parameter.hnsw().efsearch() > 1024) {
+    std::string s = fmt::format("efsearch is illegal, {}, must between 0 and 1024", search_parameter.hnsw().efsearch());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // hnsw distance of inner_product/cosine is 1 - ip, same as the distance returned by flat range search,
+  // so radius can be compared with hnsw distance directly for all metric types.
+  results.resize(vector_with_ids.size());
+  std::vector<butil::Status> statuses(vector_with_ids.size(), butil::Status::OK());
+
+  BvarLatencyGuard bvar_guard(&g_hnsw_range_search_latency);
+  RWLockReadGuard guard(&rw_lock_);
+
+  if (search_parameter.hnsw().efsearch() > 0) {
+    hnsw_index_->setEf(search_parameter.hnsw().efsearch());
+  }
+
+  auto filter_plan = GenHnswFilterPlan(hnsw_index_, filters, FLAGS_hnsw_range_search_init_topk);
+
+  ParallelFor(
+      thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
+        const float* query = vector_with_ids[row].vector().float_values().data();
+        std::vector<float> norm_array;
+        if (normalize_) {
+          norm_array.resize(dimension_);
+          VectorIndexUtils::NormalizeVectorForHnsw(const_cast<float*>(query), dimension_,  // NOLINT
+                                                   norm_array.data());
+          query = norm_array.data();
+        }
+
+        std::vector<std::pair<float, hnswlib::labeltype>> range_result;
+        try {
+          if (filter_plan.is_bruteforce) {
+            BruteForceRangeSearch(hnsw_index_, query, radius, filter_plan.candidate_internal_ids, range_result);
+          } else {
+            GraphRangeSearch(hnsw_index_, query, radius, filter_plan.hnsw_filter.get(), range_result);
+          }
+        } catch (std::runtime_error& e) {
+          std::string s = fmt::format("parallel range search vector failed, error: {}", e.what());
+          LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+          statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+          return;
+        }
+
+        std::sort(range_result.begin(), range_result.end());
+
+        for (const auto& [distance, label] : range_result) {
+          auto* vector_with_distance = results[row].add_vector_with_distances();
+          vector_with_distance->set_distance(distance);
+          vector_with_distance->set_metric_type(this->vector_index_parameter.hnsw_parameter().metric_type());
+
+          auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+          vector_with_id->set_id(label);
+          vector_with_id->mutable_vector()->set_dimension(dimension_);
+          vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+
+          // force reconstruct false when normalize
+          if (reconstruct && !normalize_) {
+            try {
+              std::vector<float> data = hnsw_index_->getDataByLabel<float>(label);
+              for (auto& value : data) {
+                vector_with_id->mutable_vector()->add_float_values(value);
+              }
+            } catch (std::exception& e) {
+              std::string s = fmt::format("getDataByLabel failed, label: {}  err: {}", label, e.what());
+              LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+              statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+              return;
+            }
+          }
+        }
+      });
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
 }
 
 void VectorIndexHnsw::LockWrite() { rw_lock_.LockWrite(); }
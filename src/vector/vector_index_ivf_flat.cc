@@ -48,6 +48,9 @@
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
+
+DECLARE_int32(vector_index_train_warm_start_niter);
+
 DEFINE_int64(ivf_flat_need_save_count, 10000, "ivf flat need save count");
 
 bvar::LatencyRecorder g_ivf_flat_upsert_latency("dingo_ivf_flat_upsert_latency");
@@ -690,6 +693,16 @@ butil::Status VectorIndexIvfFlat<T, U>::Train(std::vector<float>& train_datas) {
     }
   }
 
+  if (!train_init_centroids.empty()) {
+    if constexpr (std::is_same<T, faiss::Index>::value) {
+      auto status = VectorIndexUtils::TrainIvfQuantizer(index_.get(), train_datas.data(), data_size,
+                                                        train_init_centroids, FLAGS_vector_index_train_warm_start_niter);
+      DINGO_LOG(INFO) << fmt::format("[vector_index.ivf_flat][id({})] warm start train quantizer, error: {} {}", Id(),
+                                     status.error_code(), status.error_str());
+    }
+    train_init_centroids.clear();
+  }
+
   try {
     if constexpr (std::is_same<T, faiss::Index>::value) {
       index_->train(data_size, train_datas.data());
@@ -782,6 +795,40 @@ bool VectorIndexIvfFlat<T, U>::IsTrained() {
   return IsTrainedImpl();
 }
 
+template <typename T, typename U>
+int64_t VectorIndexIvfFlat<T, U>::TrainSampleSize() {
+  if constexpr (std::is_same<T, faiss::Index>::value) {
+    // faiss clustering subsample to this size too
+    return faiss::ClusteringParameters().max_points_per_centroid * nlist_org_;
+  } else {
+    return 0;
+  }
+}
+
+template <typename T, typename U>
+butil::Status VectorIndexIvfFlat<T, U>::GetCentroids(std::vector<float>& centroids) {
+  if constexpr (std::is_same<T, faiss::Index>::value) {
+    RWLockReadGuard guard(&rw_lock_);
+
+    if (BAIDU_UNLIKELY(!IsTrainedImpl())) {
+      return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "not train");
+    }
+
+    // quantizer_ is null when loaded from file, the index own it.
+    auto* quantizer = index_->quantizer;
+    if (quantizer == nullptr || quantizer->ntotal != index_->nlist) {
+      return butil::Status(pb::error::Errno::EINTERNAL, "quantizer centroids not match nlist");
+    }
+
+    centroids.resize(index_->nlist * dimension_);
+    quantizer->reconstruct_n(0, index_->nlist, centroids.data());
+
+    return butil::Status::OK();
+  } else {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "binary ivf flat not support get centroids");
+  }
+}
+
 template <typename T, typename U>
 bool VectorIndexIvfFlat<T, U>::NeedToSave(int64_t last_save_log_behind) {
   RWLockReadGuard guard(&rw_lock_);
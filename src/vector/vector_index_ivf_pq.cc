@@ -357,6 +357,10 @@ butil::Status VectorIndexIvfPq::Train(std::vector<float>& train_datas) {
   // init index
   Init();
 
+  // only used by ivf pq, flat not need train
+  std::vector<float> init_centroids;
+  init_centroids.swap(train_init_centroids);
+
   butil::Status status;
   switch (inner_index_type_) {
     case IndexTypeInIvfPq::kFlat: {
@@ -372,6 +376,9 @@ butil::Status VectorIndexIvfPq::Train(std::vector<float>& train_datas) {
       break;
     }
     case IndexTypeInIvfPq::kIvfPq: {
+      if (!init_centroids.empty()) {
+        index_raw_ivf_pq_->SetTrainInitCentroids(std::move(init_centroids));
+      }
       status = index_raw_ivf_pq_->Train(train_datas);
       if (!status.ok()) {
         Reset();
@@ -447,6 +454,27 @@ bool VectorIndexIvfPq::IsTrained() {
   return IsTrainedImpl();
 }
 
+int64_t VectorIndexIvfPq::TrainSampleSize() {
+  // same as the threshold of choosing ivf pq in Train, so the sample not change the inner index type.
+  faiss::ClusteringParameters clustering_parameters;
+  faiss::ProductQuantizer pq = faiss::ProductQuantizer(dimension_, nsubvector_, nbits_per_idx_);
+  return std::max(clustering_parameters.max_points_per_centroid * nlist_,
+                  pq.cp.max_points_per_centroid * (1UL << nbits_per_idx_));
+}
+
+butil::Status VectorIndexIvfPq::GetCentroids(std::vector<float>& centroids) {
+  RWLockReadGuard guard(&rw_lock_);
+  if (BAIDU_UNLIKELY(!IsTrainedImpl())) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "not train");
+  }
+
+  if (inner_index_type_ != IndexTypeInIvfPq::kIvfPq) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "inner flat index not have centroids");
+  }
+
+  return index_raw_ivf_pq_->GetCentroids(centroids);
+}
+
 bool VectorIndexIvfPq::NeedToSave(int64_t last_save_log_behind) {
   RWLockReadGuard guard(&rw_lock_);
   if (BAIDU_UNLIKELY(!IsTrainedImpl())) {
@@ -14,17 +14,21 @@
 
 #include "vector/vector_index_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
 #include "bvar/reducer.h"
+#include "bvar/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -45,6 +49,7 @@
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_snapshot.h"
 #include "vector/vector_index_snapshot_manager.h"
+#include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
@@ -56,6 +61,20 @@ DEFINE_int32(vector_fast_background_worker_num, 8, "vector index fast background
 DEFINE_int64(vector_fast_build_log_gap, 50, "vector index fast build log gap");
 DEFINE_int64(vector_pull_snapshot_min_log_gap, 66, "vector index pull snapshot min log gap");
 DEFINE_int64(vector_max_background_task_count, 32, "vector index max background task count");
+DEFINE_bool(vector_index_train_sample, true, "vector index reservoir sample the train data while scanning region");
+
+DECLARE_int32(vector_index_train_warm_start_niter);
+
+DEFINE_int64(vector_index_memory_budget_mb, 0,
+             "store vector index memory budget, evict cold vector index when exceed it, 0 is disable");
+BRPC_VALIDATE_GFLAG(vector_index_memory_budget_mb, brpc::NonNegativeInteger);
+DEFINE_int32(vector_index_memory_low_watermark_percent, 80, "evict vector index until memory under percent of budget");
+BRPC_VALIDATE_GFLAG(vector_index_memory_low_watermark_percent, brpc::PositiveInteger);
+DEFINE_int64(vector_index_evict_min_idle_s, 300, "vector index not searched or written in seconds can be evicted");
+BRPC_VALIDATE_GFLAG(vector_index_evict_min_idle_s, brpc::NonNegativeInteger);
+
+bvar::Status<int64_t> g_vector_index_resident_memory("dingo_vector_index_resident_memory", 0);
+bvar::Adder<int64_t> g_vector_index_evict_count("dingo_vector_index_evict_count");
 
 std::string RebuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.rebuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
@@ -236,6 +255,49 @@ void SaveVectorIndexTask::Run() {
   }
 }
 
+std::string EvictVectorIndexTask::Trace() {
+  return fmt::format("[vector_index.evict][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
+                     Helper::FormatMsTime(start_time_), trace_);
+}
+
+void EvictVectorIndexTask::Run() {
+  DINGO_LOG(INFO) << fmt::format("[vector_index.evict][index_id({})][trace({})] run, pending tasks({}) wait_time({}).",
+                                 vector_index_wrapper_->Id(), trace_, vector_index_wrapper_->PendingTaskNum(),
+                                 Helper::TimestampMs() - start_time_);
+
+  ON_SCOPE_EXIT([&]() { vector_index_wrapper_->DecPendingTaskNum(); });
+
+  auto region = Server::GetInstance().GetRegion(vector_index_wrapper_->Id());
+  if (region == nullptr) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.evict][index_id({})][trace({})] not found region.",
+                                      vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  // state maybe changed on queue, e.g. split/merge/load, self is the only pending task.
+  if (!VectorIndexManager::IsEvictableVectorIndex(region, vector_index_wrapper_, 1) ||
+      Helper::TimestampMs() - vector_index_wrapper_->LastAccessTimeMs() < FLAGS_vector_index_evict_min_idle_s * 1000) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.evict][index_id({})][trace({})] vector index not evictable, gave up.",
+                                   vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  // Evicted vector index is reloaded from snapshot and catch up wal, save it first to shorten the catch up.
+  if (vector_index_wrapper_->SnapshotLogId() < vector_index_wrapper_->ApplyLogId()) {
+    auto status = VectorIndexManager::SaveVectorIndex(vector_index_wrapper_, trace_);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.evict][index_id({})][trace({})] save vector index failed, gave up evict, error: {}",
+          vector_index_wrapper_->Id(), trace_, Helper::PrintStatus(status));
+      return;
+    }
+  }
+
+  if (vector_index_wrapper_->EvictVectorIndex(trace_)) {
+    g_vector_index_evict_count << 1;
+  }
+}
+
 std::string LoadOrBuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.loadorbuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), job_id_, trace_);
@@ -925,6 +987,23 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
 
   // build if need
   if (vector_index->NeedTrain() && !vector_index->IsTrained()) {
+    // warm start from the parent index after split, or the old index when rebuild.
+    if (FLAGS_vector_index_train_warm_start_niter > 0) {
+      for (const auto& source_vector_index :
+           {vector_index_wrapper->ShareVectorIndex(), vector_index_wrapper->GetOwnVectorIndex()}) {
+        std::vector<float> centroids;
+        if (source_vector_index != nullptr &&
+            source_vector_index->VectorIndexType() == vector_index->VectorIndexType() &&
+            source_vector_index->GetCentroids(centroids).ok()) {
+          DINGO_LOG(INFO) << fmt::format(
+              "[vector_index.build][index_id({})][trace({})] train warm start from vector index({}) centroids.",
+              vector_index_id, trace, source_vector_index->Id());
+          vector_index->SetTrainInitCentroids(std::move(centroids));
+          break;
+        }
+      }
+    }
+
     auto status = TrainForBuild(vector_index, reader, encode_range);
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.build][index_id({})][trace({})] Train finish, elapsed_time: {}ms error: {} {}", vector_index_id,
@@ -1358,9 +1437,154 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
     }
   }
 
+  return EvictColdVectorIndex();
+}
+
+bool VectorIndexManager::IsEvictableVectorIndex(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper,
+                                                int32_t max_pending_task_num) {
+  // Only raft store has snapshot and wal to reload, diskann manage memory itself.
+  if (region->State() != pb::common::NORMAL || region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE) {
+    return false;
+  }
+  if (!vector_index_wrapper->IsReady() || vector_index_wrapper->IsStop() ||
+      vector_index_wrapper->IsSwitchingVectorIndex() ||
+      vector_index_wrapper->PendingTaskNum() > max_pending_task_num) {
+    return false;
+  }
+  if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN ||
+      !vector_index_wrapper->SupportSave()) {
+    return false;
+  }
+
+  // temp hold is set when rebuild/load for split/merge, the index must be kept until region take it over.
+  if (vector_index_wrapper->IsTempHoldVectorIndex()) {
+    return false;
+  }
+  // follower index is not searched, an evicted one would not be reloaded and pin the wal truncation.
+  if (!Server::GetInstance().IsLeader(region->Id())) {
+    return false;
+  }
+  return vector_index_wrapper->ShareVectorIndex() == nullptr && vector_index_wrapper->SiblingVectorIndex() == nullptr;
+}
+
+std::vector<int64_t> VectorIndexManager::PickEvictVectorIndex(std::vector<EvictCandidate> candidates,
+                                                              int64_t budget_memory_size, int64_t target_memory_size,
+                                                              int64_t now_ms, int64_t min_idle_ms) {
+  int64_t total_memory_size = 0;
+  for (const auto& candidate : candidates) {
+    total_memory_size += candidate.memory_size;
+  }
+  if (total_memory_size <= budget_memory_size) {
+    return {};
+  }
+
+  std::sort(candidates.begin(), candidates.end(), [](const EvictCandidate& a, const EvictCandidate& b) {
+    return a.last_access_time_ms < b.last_access_time_ms;
+  });
+
+  std::vector<int64_t> victims;
+  for (const auto& candidate : candidates) {
+    if (total_memory_size <= target_memory_size) {
+      break;
+    }
+    if (!candidate.evictable || now_ms - candidate.last_access_time_ms < min_idle_ms) {
+      continue;
+    }
+
+    victims.push_back(candidate.id);
+    total_memory_size -= candidate.memory_size;
+  }
+
+  return victims;
+}
+
+butil::Status VectorIndexManager::EvictColdVectorIndex() {
+  auto regions = Server::GetInstance().GetAllAliveRegion();
+
+  std::vector<std::pair<store::RegionPtr, VectorIndexWrapperPtr>> vector_indexes;
+  // vector index shared by split child or merge target, evict it not free memory.
+  std::unordered_set<VectorIndex*> referenced_vector_indexes;
+  for (const auto& region : regions) {
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr) {
+      continue;
+    }
+    auto share_vector_index = vector_index_wrapper->ShareVectorIndex();
+    if (share_vector_index != nullptr) {
+      referenced_vector_indexes.insert(share_vector_index.get());
+    }
+    auto sibling_vector_index = vector_index_wrapper->SiblingVectorIndex();
+    if (sibling_vector_index != nullptr) {
+      referenced_vector_indexes.insert(sibling_vector_index.get());
+    }
+    vector_indexes.emplace_back(region, vector_index_wrapper);
+  }
+
+  std::vector<EvictCandidate> candidates;
+  int64_t total_memory_size = 0;
+  for (const auto& [region, vector_index_wrapper] : vector_indexes) {
+    auto own_vector_index = vector_index_wrapper->GetOwnVectorIndex();
+    if (own_vector_index == nullptr || !vector_index_wrapper->IsReady()) {
+      continue;
+    }
+    int64_t memory_size = 0;
+    auto status = vector_index_wrapper->GetMemorySize(memory_size);
+    if (!status.ok()) {
+      continue;
+    }
+    total_memory_size += memory_size;
+
+    bool evictable = IsEvictableVectorIndex(region, vector_index_wrapper, 0) &&
+                     referenced_vector_indexes.count(own_vector_index.get()) == 0;
+    candidates.push_back(
+        {vector_index_wrapper->Id(), memory_size, vector_index_wrapper->LastAccessTimeMs(), evictable});
+  }
+  g_vector_index_resident_memory.set_value(total_memory_size);
+
+  int64_t budget_memory_size = FLAGS_vector_index_memory_budget_mb * 1024 * 1024;
+  if (budget_memory_size <= 0) {
+    return butil::Status::OK();
+  }
+  int64_t target_memory_size =
+      budget_memory_size * std::min(FLAGS_vector_index_memory_low_watermark_percent, 100) / 100;
+
+  auto victims = PickEvictVectorIndex(std::move(candidates), budget_memory_size, target_memory_size,
+                                      Helper::TimestampMs(), FLAGS_vector_index_evict_min_idle_s * 1000);
+  if (victims.empty()) {
+    if (total_memory_size > budget_memory_size) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.evict] resident memory({}) exceed budget({}), but not found evictable vector index.",
+          total_memory_size, budget_memory_size);
+    }
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.evict] resident memory({}) exceed budget({}), evict vector index({}).",
+                                 total_memory_size, budget_memory_size, Helper::VectorToString(victims));
+
+  for (auto vector_index_id : victims) {
+    auto region = Server::GetInstance().GetRegion(vector_index_id);
+    if (region == nullptr || region->VectorIndexWrapper() == nullptr) {
+      continue;
+    }
+    LaunchEvictVectorIndex(region->VectorIndexWrapper(), "memory budget");
+  }
+
   return butil::Status::OK();
 }
 
+void VectorIndexManager::LaunchEvictVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace) {
+  assert(vector_index_wrapper != nullptr);
+
+  auto task = std::make_shared<EvictVectorIndexTask>(vector_index_wrapper, trace);
+  if (!Server::GetInstance().GetVectorIndexManager()->ExecuteTask(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.launch][index_id({})][trace({})] Launch evict vector index failed",
+                                    vector_index_wrapper->Id(), trace);
+  } else {
+    vector_index_wrapper->IncPendingTaskNum();
+  }
+}
+
 // range is encode range
 butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvcc::ReaderPtr reader,
                                                 const pb::common::Range& encode_range) {
@@ -1369,16 +1593,23 @@ butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvc
   auto iter = reader->NewIterator(Constant::kVectorDataCF, 0, options);
   CHECK(iter != nullptr) << fmt::format("[vector_index.build][index_id({})] NewIterator failed.", vector_index->Id());
 
-  std::vector<float> train_vectors;
-  train_vectors.reserve(100000 * vector_index->GetDimension());  // todo opt
+  // k-means not need all data, sample it in one pass instead of holding the whole region in memory.
+  int32_t dimension = vector_index->GetDimension();
+  int64_t sample_size = FLAGS_vector_index_train_sample ? vector_index->TrainSampleSize() : 0;
+  VectorTrainDataSampler sampler(dimension, sample_size, vector_index->Id());
   for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
+    int64_t pos = sampler.Next();
+    if (pos < 0) {
+      continue;
+    }
+
     pb::common::VectorWithId vector;
 
     std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
     CHECK(vector.mutable_vector()->ParseFromString(value)) << "parse vector pb failed.";
 
     if (vector.vector().value_type() == pb::common::ValueType::FLOAT) {
-      if (vector.vector().float_values_size() <= 0) {
+      if (vector.vector().float_values_size() != dimension) {
         DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] vector float_values_size error.",
                                           vector_index->Id());
         continue;
@@ -1387,20 +1618,23 @@ butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvc
       if (vector.vector().binary_values_size() <= 0) {
         DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] vector binary_values_size error.",
                                           vector_index->Id());
-        continue;
       }
+      continue;
     } else {
       DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] not support {} .", vector_index->Id(),
                                         pb::common::ValueType_Name(vector.vector().value_type()));
       continue;
     }
 
-    train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
-                         vector.vector().float_values().end());
+    sampler.Put(pos, vector.vector().float_values().data());
   }
 
+  DINGO_LOG(INFO) << fmt::format("[vector_index.build][index_id({})] train sample {}/{} vectors, sample size({}).",
+                                 vector_index->Id(), sampler.Size(), sampler.SeenCount(), sample_size);
+
+  auto& train_vectors = sampler.Data();
   if (!train_vectors.empty()) {
-    auto status = vector_index->TrainByParallel(train_vectors);
+    auto status = vector_index->TrainByParallel(train_vectors, Server::GetInstance().GetVectorIndexTrainThreadPool());
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("[vector_index.build][index_id({})] train failed, error: {}", vector_index->Id(),
                                       status.error_str());
@@ -141,6 +141,27 @@ class BuildVectorIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+// Evict vector index task, save snapshot if behind and release own vector index.
+class EvictVectorIndexTask : public TaskRunnable {
+ public:
+  EvictVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace)
+      : vector_index_wrapper_(vector_index_wrapper), trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~EvictVectorIndexTask() override = default;
+
+  std::string Type() override { return "EVICT_VECTOR_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
 // Manage vector index, e.g. build/rebuild/save/load vector index.
 class VectorIndexManager {
  public:
@@ -174,6 +195,23 @@ class VectorIndexManager {
 
   static butil::Status ScrubVectorIndex();
 
+  struct EvictCandidate {
+    int64_t id;
+    int64_t memory_size;
+    int64_t last_access_time_ms;
+    bool evictable;
+  };
+  // Pick the least recently used candidates idle more than min_idle_ms, until the resident memory not more than
+  // target_memory_size. Pick nothing when resident memory not more than budget.
+  static std::vector<int64_t> PickEvictVectorIndex(std::vector<EvictCandidate> candidates, int64_t budget_memory_size,
+                                                   int64_t target_memory_size, int64_t now_ms, int64_t min_idle_ms);
+  // Evict cold vector index when resident memory exceed budget, reload them on demand.
+  static butil::Status EvictColdVectorIndex();
+  // Launch evict vector index at execute queue.
+  static void LaunchEvictVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
+  static bool IsEvictableVectorIndex(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper,
+                                     int32_t max_pending_task_num);
+
   static bvar::Adder<uint64_t> bvar_vector_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_save_task_running_num;
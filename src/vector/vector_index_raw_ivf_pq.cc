@@ -45,6 +45,8 @@
 
 namespace dingodb {
 
+DECLARE_int32(vector_index_train_warm_start_niter);
+
 DEFINE_int64(ivf_pq_need_save_count, 10000, "ivf pq need save count");
 
 VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
@@ -483,6 +485,14 @@ butil::Status VectorIndexRawIvfPq::Train(std::vector<float>& train_datas) {
     }
   }
 
+  if (!train_init_centroids.empty()) {
+    auto status = VectorIndexUtils::TrainIvfQuantizer(index_.get(), train_datas.data(), data_size,
+                                                      train_init_centroids, FLAGS_vector_index_train_warm_start_niter);
+    DINGO_LOG(INFO) << fmt::format("[vector_index.raw_ivf_pq][id({})] warm start train quantizer, error: {} {}", Id(),
+                                   status.error_code(), status.error_str());
+    train_init_centroids.clear();
+  }
+
   try {
     index_->train(data_size, train_datas.data());
     if (!index_->is_trained) {
@@ -530,6 +540,32 @@ bool VectorIndexRawIvfPq::IsTrained() {
   return IsTrainedImpl();
 }
 
+int64_t VectorIndexRawIvfPq::TrainSampleSize() {
+  faiss::ClusteringParameters clustering_parameters;
+  faiss::ProductQuantizer pq = faiss::ProductQuantizer(dimension_, nsubvector_, nbits_per_idx_);
+  return std::max(clustering_parameters.max_points_per_centroid * nlist_,
+                  pq.cp.max_points_per_centroid * (1UL << nbits_per_idx_));
+}
+
+butil::Status VectorIndexRawIvfPq::GetCentroids(std::vector<float>& centroids) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  if (BAIDU_UNLIKELY(!IsTrainedImpl())) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "not train");
+  }
+
+  // quantizer_ is null when loaded from file, the index own it.
+  auto* quantizer = index_->quantizer;
+  if (quantizer == nullptr || quantizer->ntotal != index_->nlist) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "quantizer centroids not match nlist");
+  }
+
+  centroids.resize(index_->nlist * dimension_);
+  quantizer->reconstruct_n(0, index_->nlist, centroids.data());
+
+  return butil::Status::OK();
+}
+
 bool VectorIndexRawIvfPq::NeedToSave(int64_t last_save_log_behind) {
   RWLockReadGuard guard(&rw_lock_);
 
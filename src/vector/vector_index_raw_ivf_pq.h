@@ -106,6 +106,8 @@ class VectorIndexRawIvfPq : public VectorIndex {
   bool NeedToRebuild() override;
   bool NeedTrain() override { return true; }
   bool IsTrained() override;
+  int64_t TrainSampleSize() override;
+  butil::Status GetCentroids(std::vector<float>& centroids) override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
  private:
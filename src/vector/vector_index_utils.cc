@@ -18,9 +18,11 @@
 #include <climits>
 #include <cstdint>
 #include <memory>
+#include <random>
 #include <set>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,6 +30,8 @@
 #include "common/constant.h"
 #include "common/logging.h"
 #include "coprocessor/utils.h"
+#include "faiss/Clustering.h"
+#include "faiss/IndexIVF.h"
 #include "faiss/MetricType.h"
 #include "faiss/utils/extra_distances-inl.h"
 #include "fmt/core.h"
@@ -36,6 +40,7 @@
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "simd/hook.h"
 
 namespace dingodb {
 
@@ -646,6 +651,84 @@ butil::Status VectorIndexUtils::FillSearchResult(const std::vector<pb::common::V
   return butil::Status::OK();
 }
 
+butil::Status VectorIndexUtils::RefineSearchResult(
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk, pb::common::MetricType metric_type,
+    faiss::idx_t dimension, const std::unordered_map<int64_t, std::vector<float>>& exact_vectors,
+    std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (metric_type != pb::common::METRIC_TYPE_L2 && metric_type != pb::common::METRIC_TYPE_INNER_PRODUCT &&
+      metric_type != pb::common::METRIC_TYPE_COSINE) {
+    std::string s = fmt::format("refine not support metric_type: {}", pb::common::MetricType_Name(metric_type));
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+  }
+  if (results.size() != vector_with_ids.size()) {
+    std::string s = fmt::format("refine result size({}) not match query size({})", results.size(),
+                                vector_with_ids.size());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EINTERNAL, s);
+  }
+
+  std::vector<float> query(dimension);
+  std::vector<float> candidate_vectors;
+  std::vector<float> distances;
+  std::vector<pb::common::VectorWithDistance*> candidates;
+  for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+    const auto& float_values = vector_with_ids[row].vector().float_values();
+    if (float_values.size() != dimension) {
+      return butil::Status(pb::error::EVECTOR_INVALID,
+                           fmt::format("query dimension({}) not match({})", float_values.size(), dimension));
+    }
+    std::copy(float_values.begin(), float_values.end(), query.begin());
+    if (metric_type == pb::common::METRIC_TYPE_COSINE) {
+      NormalizeVectorForFaiss(query.data(), dimension);
+    }
+
+    // gather candidate vectors continuously, compute distance in batch.
+    auto& result = results[row];
+    candidates.clear();
+    candidate_vectors.clear();
+    for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
+      auto it = exact_vectors.find(vector_with_distance.vector_with_id().id());
+      if (it == exact_vectors.end() || static_cast<faiss::idx_t>(it->second.size()) != dimension) {
+        continue;
+      }
+      candidates.push_back(&vector_with_distance);
+      candidate_vectors.insert(candidate_vectors.end(), it->second.begin(), it->second.end());
+    }
+
+    distances.resize(candidates.size());
+    if (metric_type == pb::common::METRIC_TYPE_L2) {
+      fvec_L2sqr_ny(distances.data(), query.data(), candidate_vectors.data(), dimension, candidates.size());
+    } else {
+      fvec_inner_products_ny(distances.data(), query.data(), candidate_vectors.data(), dimension, candidates.size());
+      for (auto& distance : distances) {
+        distance = 1.0F - distance;
+      }
+    }
+
+    std::vector<uint32_t> order(candidates.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    uint32_t keep_size = std::min(static_cast<uint32_t>(order.size()), topk);
+    std::partial_sort(order.begin(), order.begin() + keep_size, order.end(), [&](uint32_t lhs, uint32_t rhs) {
+      return distances[lhs] != distances[rhs]
+                 ? distances[lhs] < distances[rhs]
+                 : candidates[lhs]->vector_with_id().id() < candidates[rhs]->vector_with_id().id();
+    });
+
+    pb::index::VectorWithDistanceResult refined_result;
+    for (uint32_t i = 0; i < keep_size; ++i) {
+      auto* vector_with_distance = refined_result.add_vector_with_distances();
+      vector_with_distance->Swap(candidates[order[i]]);
+      vector_with_distance->set_distance(distances[order[i]]);
+    }
+    result.Swap(&refined_result);
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status VectorIndexUtils::FillRangeSearchResult(
     const std::unique_ptr<faiss::RangeSearchResult>& range_search_result, pb::common::MetricType metric_type,
     faiss::idx_t dimension, std::vector<pb::index::VectorWithDistanceResult>& results) {
@@ -685,6 +768,73 @@ butil::Status VectorIndexUtils::FillRangeSearchResult(
   return butil::Status::OK();
 }
 
+butil::Status VectorIndexUtils::TrainIvfQuantizer(faiss::IndexIVF* index, const float* train_datas, size_t data_size,
+                                                  const std::vector<float>& init_centroids, int32_t niter) {
+  if (init_centroids.size() != index->nlist * index->d) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("init centroids size({}) not match nlist({}) * dimension({})", init_centroids.size(),
+                                     index->nlist, index->d));
+  }
+  if (data_size < index->nlist) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("train data size({}) less than nlist({})", data_size, index->nlist));
+  }
+
+  // keep spherical of inner product
+  faiss::ClusteringParameters clustering_parameters = index->cp;
+  clustering_parameters.niter = std::max(niter, 1);
+  faiss::Clustering clustering(index->d, index->nlist, clustering_parameters);
+  // input centroids are the initialization of k-means, they are updated as frozen_centroids is false.
+  clustering.centroids = init_centroids;
+
+  try {
+    index->quantizer->reset();
+    clustering.train(data_size, train_datas, *index->quantizer);
+  } catch (std::exception& e) {
+    index->quantizer->reset();
+    return butil::Status(pb::error::EINTERNAL, fmt::format("train ivf quantizer exception: {}", e.what()));
+  }
+
+  if (index->quantizer->ntotal != index->nlist) {
+    index->quantizer->reset();
+    return butil::Status(pb::error::EINTERNAL, fmt::format("train ivf quantizer failed, centroids num({}) not match",
+                                                           index->quantizer->ntotal));
+  }
+
+  return butil::Status::OK();
+}
+
+VectorTrainDataSampler::VectorTrainDataSampler(faiss::idx_t dimension, int64_t capacity, uint64_t seed)
+    : dimension_(dimension), capacity_(capacity), rng_(seed) {
+  if (capacity_ > 0) {
+    datas_.reserve(capacity_ * dimension_);
+  }
+}
+
+int64_t VectorTrainDataSampler::Next() {
+  ++seen_count_;
+  if (capacity_ <= 0 || size_ < capacity_) {
+    return size_;
+  }
+
+  std::uniform_int_distribution<int64_t> distribution(0, seen_count_ - 1);
+  int64_t pos = distribution(rng_);
+  return pos < capacity_ ? pos : -1;
+}
+
+void VectorTrainDataSampler::Put(int64_t pos, const float* vector) {
+  if (pos < 0 || pos > size_) {
+    return;
+  }
+
+  if (pos == size_) {
+    datas_.insert(datas_.end(), vector, vector + dimension_);
+    ++size_;
+  } else {
+    std::copy(vector, vector + dimension_, datas_.begin() + pos * dimension_);
+  }
+}
+
 butil::Status VectorIndexUtils::CheckVectorIndexParameterCompatibility(const pb::common::VectorIndexParameter& source,
                                                                        const pb::common::VectorIndexParameter& target) {
   if (source.vector_index_type() != target.vector_index_type()) {
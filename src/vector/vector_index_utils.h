@@ -17,6 +17,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <random>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -24,6 +26,7 @@
 #include "common/threadpool.h"
 #include "faiss/Index.h"
 #include "faiss/IndexBinary.h"
+#include "faiss/IndexIVF.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
@@ -204,6 +207,19 @@ class VectorIndexUtils {
   static butil::Status FillRangeSearchResult(const std::unique_ptr<faiss::RangeSearchResult>& range_search_result,
                                              pb::common::MetricType metric_type, faiss::idx_t dimension,
                                              std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // re-rank the approximate candidates with exact distance and keep topk, the candidates without exact vector are
+  // dropped. exact_vectors must be normalized for cosine.
+  static butil::Status RefineSearchResult(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                          pb::common::MetricType metric_type, faiss::idx_t dimension,
+                                          const std::unordered_map<int64_t, std::vector<float>>& exact_vectors,
+                                          std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // train the coarse quantizer of ivf from init centroids, a few k-means iterations are enough to adapt them to the
+  // train data. after this the quantizer is trained, IndexIVF::train skip it and only train the residual.
+  static butil::Status TrainIvfQuantizer(faiss::IndexIVF* index, const float* train_datas, size_t data_size,
+                                         const std::vector<float>& init_centroids, int32_t niter);
+
   static butil::Status CheckVectorIndexParameterCompatibility(const pb::common::VectorIndexParameter& source,
                                                               const pb::common::VectorIndexParameter& target);
   static butil::Status ValidateVectorIndexParameter(const pb::common::VectorIndexParameter& vector_index_parameter);
@@ -226,6 +242,32 @@ class VectorIndexUtils {
                                                 bool& is_need);  // NOLINT
 };
 
+// Reservoir sampling(algorithm R) of the train data in one pass scan, every scanned vector has the same probability
+// capacity/seen to be kept, so it's not need to hold all vectors of the region in memory.
+class VectorTrainDataSampler {
+ public:
+  // capacity <= 0 means keep all vectors.
+  VectorTrainDataSampler(faiss::idx_t dimension, int64_t capacity, uint64_t seed);
+  ~VectorTrainDataSampler() = default;
+
+  // decide the position of the next scanned vector, -1 means skip it, so the caller can skip decoding it.
+  int64_t Next();
+  // put the vector to the position return by Next().
+  void Put(int64_t pos, const float* vector);
+
+  int64_t SeenCount() const { return seen_count_; }
+  int64_t Size() const { return size_; }
+  std::vector<float>& Data() { return datas_; }
+
+ private:
+  faiss::idx_t dimension_;
+  int64_t capacity_;
+  int64_t seen_count_{0};
+  int64_t size_{0};
+  std::mt19937_64 rng_;
+  std::vector<float> datas_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_VECTOR_INDEX_UTILS_H_
@@ -17,18 +17,23 @@
 #include <algorithm>
 #include <cstdint>
 #include <deque>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "coprocessor/coprocessor_scalar.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "coprocessor/utils.h"
@@ -54,9 +59,14 @@ namespace dingodb {
 DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
 DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
 DEFINE_bool(dingo_log_switch_scalar_speed_up_detail, false, "scalar speed up log");
+DEFINE_int32(vector_index_ivf_pq_refine_factor, 1,
+             "ivf pq search topk*factor candidates and re-rank them with exact distance, 1 is disable");
+BRPC_VALIDATE_GFLAG(vector_index_ivf_pq_refine_factor, brpc::PositiveInteger);
+DEFINE_int32(vector_index_ivf_pq_max_refine_factor, 64, "ivf pq max refine factor");
 
 bvar::LatencyRecorder g_bruteforce_search_latency("dingo_bruteforce_search_latency");
 bvar::LatencyRecorder g_bruteforce_range_search_latency("dingo_bruteforce_range_search_latency");
+bvar::LatencyRecorder g_ivf_pq_refine_latency("dingo_vector_index_ivf_pq_refine_latency");
 
 DECLARE_bool(dingo_log_switch_coprocessor_scalar_detail);
 
@@ -87,7 +97,7 @@ butil::Status VectorReader::SearchVector(
     int64_t ts, int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
     const pb::common::ScalarSchema& scalar_schema,
-    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, TrackerPtr tracker) {
   if (vector_with_ids.empty()) {
     DINGO_LOG(WARNING) << "Empty vector with ids";
     return butil::Status();
@@ -134,6 +144,7 @@ butil::Status VectorReader::SearchVector(
         return status;
       }
 
+      int64_t start_time = Helper::TimestampNs();
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
@@ -160,6 +171,9 @@ butil::Status VectorReader::SearchVector(
         }
         vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
       }
+      if (tracker) {
+        tracker->AddScalarFilterTime(Helper::TimestampNs() - start_time);
+      }
 
     } else {  //! parameter.has_vector_coprocessor() && vector_with_ids[0].scalar_data().scalar_data_size() != 0
       top_n *= 10;
@@ -170,6 +184,7 @@ butil::Status VectorReader::SearchVector(
         return status;
       }
 
+      int64_t start_time = Helper::TimestampNs();
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
@@ -195,6 +210,9 @@ butil::Status VectorReader::SearchVector(
         }
         vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
       }
+      if (tracker) {
+        tracker->AddScalarFilterTime(Helper::TimestampNs() - start_time);
+      }
     }
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
     butil::Status status = DoVectorSearchForVectorIdPreFilter(vector_index, vector_with_ids, parameter, region_range,
@@ -422,8 +440,13 @@ butil::Status VectorReader::CompareVectorScalarDataWithCoprocessor(
 butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                               std::vector<pb::index::VectorWithDistanceResult>& results) {  // NOLINT
   // Search vectors by vectors
+  int64_t start_time = Helper::TimestampNs();
   auto status = SearchVector(ctx->ts, ctx->partition_id, ctx->vector_index, ctx->region_range, ctx->vector_with_ids,
-                             ctx->parameter, ctx->scalar_schema, results);
+                             ctx->parameter, ctx->scalar_schema, results, ctx->tracker);
+  if (ctx->tracker) {
+    // scalar post filter is recorded separately
+    ctx->tracker->AddVectorSearchTime(Helper::TimestampNs() - start_time - ctx->tracker->ScalarFilterTime());
+  }
   if (!status.ok()) {
     return status;
   }
@@ -1542,6 +1565,7 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
                                          vector_with_distance_results);
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(INFO) << "RangeSearch vector index not support, try brute force, id: " << vector_index->Id();
+        vector_with_distance_results.clear();
         return BruteForceRangeSearch(vector_index, vector_with_ids, radius, region_range, filters, with_vector_data,
                                      parameter, vector_with_distance_results);
       } else if (!status.ok()) {
@@ -1550,10 +1574,33 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
         return status;
       }
     } else {
-      status = vector_index->Search(vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
-                                    vector_with_distance_results);
+      // pq distance is approximate, search more candidates and re-rank them with exact distance.
+      uint32_t refine_factor = 1;
+      if (vector_index->SubType() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+        refine_factor = parameter.ivf_pq().refine_factor() > 0 ? parameter.ivf_pq().refine_factor()
+                                                                : FLAGS_vector_index_ivf_pq_refine_factor;
+        refine_factor = std::min(refine_factor, static_cast<uint32_t>(FLAGS_vector_index_ivf_pq_max_refine_factor));
+      }
+
+      if (refine_factor > 1) {
+        std::vector<pb::index::VectorWithDistanceResult> candidate_results;
+        status = vector_index->Search(vector_with_ids, topk * refine_factor, region_range, filters, with_vector_data,
+                                      parameter, candidate_results);
+        if (status.ok()) {
+          status = RefineSearchResult(vector_index, region_range, vector_with_ids, topk, candidate_results);
+        }
+        if (status.ok()) {
+          std::move(candidate_results.begin(), candidate_results.end(),
+                    std::back_inserter(vector_with_distance_results));
+        }
+      } else {
+        status = vector_index->Search(vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
+                                      vector_with_distance_results);
+      }
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(DEBUG) << "Search vector index not support, try brute force, id: " << vector_index->Id();
+        // drop the partial results of vector index, brute force append to it
+        vector_with_distance_results.clear();
         return BruteForceSearch(vector_index, vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
                                 vector_with_distance_results);
       } else if (!status.ok()) {
@@ -1567,6 +1614,47 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
   return butil::Status::OK();
 }
 
+butil::Status VectorReader::RefineSearchResult(VectorIndexWrapperPtr vector_index,
+                                               const pb::common::Range& region_range,
+                                               const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                               uint32_t topk,
+                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  BvarLatencyGuard bvar_guard(&g_ivf_pq_refine_latency);
+
+  auto metric_type = vector_index->GetMetricType();
+  int64_t partition_id = VectorCodec::UnPackagePartitionId(region_range.start_key());
+
+  // the candidates of queries are overlapped, read every exact vector once.
+  std::unordered_map<int64_t, std::vector<float>> exact_vectors;
+  for (const auto& result : results) {
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      int64_t vector_id = vector_with_distance.vector_with_id().id();
+      if (exact_vectors.find(vector_id) != exact_vectors.end()) {
+        continue;
+      }
+
+      pb::common::VectorWithId vector_with_id;
+      auto status = QueryVectorWithId(0, region_range, partition_id, vector_id, true, vector_with_id);
+      if (!status.ok()) {
+        if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+          // deleted after search, drop it
+          continue;
+        }
+        return status;
+      }
+
+      auto& exact_vector = exact_vectors[vector_id];
+      exact_vector.assign(vector_with_id.vector().float_values().begin(), vector_with_id.vector().float_values().end());
+      if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE && !exact_vector.empty()) {
+        VectorIndexUtils::NormalizeVectorForFaiss(exact_vector.data(), exact_vector.size());
+      }
+    }
+  }
+
+  return VectorIndexUtils::RefineSearchResult(vector_with_ids, topk, metric_type, vector_index->GetDimension(),
+                                              exact_vectors, results);
+}
+
 // DistanceResult
 // This class is used for priority queue to merge the search result from many batch scan data from raw engine.
 class DistanceResult {
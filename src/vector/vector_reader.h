@@ -91,7 +91,8 @@ class VectorReader {
                              const std::vector<pb::common::VectorWithId>& vector_with_ids,
                              const pb::common::VectorSearchParameter& parameter,
                              const pb::common::ScalarSchema& scalar_schema,
-                             std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+                             std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
+                             TrackerPtr tracker = nullptr);
 
   butil::Status QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                       std::vector<std::string> selected_scalar_keys,
@@ -181,12 +182,19 @@ class VectorReader {
   static butil::Status SetVectorIndexIdsFilter(bool is_negation, bool is_sorted, std::vector<int64_t>& vector_ids,
                                                std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters);
 
+ public:
   butil::Status SearchAndRangeSearchWrapper(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
       const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, uint32_t topk,  // NOLINT
       std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters);
 
+ private:
+  // re-rank the candidates of ivf pq with the exact vectors from vector data cf.
+  butil::Status RefineSearchResult(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                   const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                   std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status BruteForceSearch(VectorIndexWrapperPtr vector_index,
                                  const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
                                  const pb::common::Range& region_range,
@@ -0,0 +1,175 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bench_env.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/role.h"
+#include "config/config_manager.h"
+#include "config/yaml_config.h"
+#include "event/store_state_machine_event.h"
+#include "fmt/core.h"
+#include "metrics/store_metrics_manager.h"
+#include "mvcc/ts_provider.h"
+
+namespace dingodb {
+
+namespace bench {
+
+DEFINE_string(bench_path, "./dingodb_bench", "bench data path, removed after bench");
+DEFINE_int32(bench_value_size, 256, "bench value size");
+DEFINE_int32(bench_key_count, 100000, "bench preload key count");
+
+static const std::vector<std::string> kAllCFs = {Constant::kStoreDataCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
+                                                 Constant::kTxnWriteCF, Constant::kStoreMetaCF};
+
+static const int64_t kTxnRegionId = 1001;
+
+static std::string GenYamlConfig() {
+  return fmt::format(
+      "cluster:\n"
+      "  name: dingodb\n"
+      "  instance_id: 12345\n"
+      "  coordinators: 127.0.0.1:19190\n"
+      "  keyring: TO_BE_CONTINUED\n"
+      "server:\n"
+      "  host: 127.0.0.1\n"
+      "  port: 23000\n"
+      "log:\n"
+      "  path: {}/log\n"
+      "store:\n"
+      "  path: {}/db\n",
+      FLAGS_bench_path, FLAGS_bench_path);
+}
+
+BenchEnv& BenchEnv::GetInstance() {
+  static BenchEnv bench_env;
+  return bench_env;
+}
+
+bool BenchEnv::Init() {
+  Helper::RemoveAllFileOrDirectory(FLAGS_bench_path);
+  Helper::CreateDirectories(FLAGS_bench_path + "/db");
+
+  config_ = std::make_shared<YamlConfig>();
+  if (config_->Load(GenYamlConfig()) != 0) {
+    DINGO_LOG(ERROR) << "[bench] load config fail.";
+    return false;
+  }
+  SetRole("store");
+  ConfigManager::GetInstance().Register(GetRoleName(), config_);
+
+  rocks_engine_ = std::make_shared<RocksRawEngine>();
+  if (!rocks_engine_->Init(config_, kAllCFs)) {
+    DINGO_LOG(ERROR) << "[bench] init rocks engine fail.";
+    return false;
+  }
+
+  bdb_engine_ = std::make_shared<BdbRawEngine>();
+  if (!bdb_engine_->Init(config_, {})) {
+    DINGO_LOG(ERROR) << "[bench] init bdb engine fail.";
+    return false;
+  }
+
+  auto ts_provider = mvcc::TsProvider::New(nullptr);
+  if (!ts_provider->Init()) {
+    DINGO_LOG(ERROR) << "[bench] init ts provider fail.";
+    return false;
+  }
+
+  auto meta_reader = std::make_shared<MetaReader>(rocks_engine_);
+  auto meta_writer = std::make_shared<MetaWriter>(rocks_engine_);
+  auto store_meta_manager = std::make_shared<StoreMetaManager>(meta_reader, meta_writer);
+  if (!store_meta_manager->Init()) {
+    DINGO_LOG(ERROR) << "[bench] init store meta manager fail.";
+    return false;
+  }
+
+  auto store_metrics_manager = std::make_shared<StoreMetricsManager>(meta_reader, meta_writer);
+  if (!store_metrics_manager->Init()) {
+    DINGO_LOG(ERROR) << "[bench] init store metrics manager fail.";
+    return false;
+  }
+
+  auto listener_factory = std::make_shared<StoreSmEventListenerFactory>();
+  mono_engine_ = std::make_shared<MonoStoreEngine>(rocks_engine_, bdb_engine_, listener_factory->Build(), ts_provider,
+                                                   store_meta_manager, store_metrics_manager);
+  if (!mono_engine_->Init(config_)) {
+    DINGO_LOG(ERROR) << "[bench] init mono engine fail.";
+    return false;
+  }
+
+  // txn region cover all bench keys
+  pb::common::RegionDefinition definition;
+  definition.set_id(kTxnRegionId);
+  definition.mutable_range()->set_start_key(std::string(1, Constant::kClientTxn));
+  definition.mutable_range()->set_end_key(Helper::PrefixNext(std::string(1, Constant::kClientTxn)));
+  txn_region_ = store::Region::New(definition);
+  txn_region_->SetState(pb::common::StoreRegionState::NORMAL);
+  store_meta_manager->GetStoreRegionMeta()->AddRegion(txn_region_);
+  store_metrics_manager->GetStoreRegionMetrics()->AddMetrics(StoreRegionMetrics::NewMetrics(kTxnRegionId));
+
+  return true;
+}
+
+void BenchEnv::Destroy() {
+  if (rocks_engine_ != nullptr) {
+    rocks_engine_->Close();
+  }
+  if (bdb_engine_ != nullptr) {
+    bdb_engine_->Close();
+  }
+
+  Helper::RemoveAllFileOrDirectory(FLAGS_bench_path);
+}
+
+RawEnginePtr BenchEnv::GetRawEngine(int64_t raw_engine_type) {
+  if (raw_engine_type == pb::common::RawEngine::RAW_ENG_BDB) {
+    return bdb_engine_;
+  }
+
+  return rocks_engine_;
+}
+
+void LatencyCollector::Report(benchmark::State& state) {
+  if (latencies_ns_.empty()) {
+    return;
+  }
+
+  std::sort(latencies_ns_.begin(), latencies_ns_.end());
+  auto percentile = [&](double ratio) -> double {
+    size_t pos = std::min(latencies_ns_.size() - 1, static_cast<size_t>(latencies_ns_.size() * ratio));
+    return static_cast<double>(latencies_ns_[pos]) / 1000;
+  };
+
+  state.counters["p50_us"] = benchmark::Counter(percentile(0.50), benchmark::Counter::kAvgThreads);
+  state.counters["p99_us"] = benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+  state.counters["p999_us"] = benchmark::Counter(percentile(0.999), benchmark::Counter::kAvgThreads);
+}
+
+std::string GenKey(const std::string& prefix, int64_t index) { return fmt::format("{}{:016}", prefix, index); }
+
+std::string GenValue(int32_t size) { return std::string(size, 'v'); }
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_BENCH_ENV_H_
+#define DINGODB_BENCH_BENCH_ENV_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "config/config.h"
+#include "engine/bdb_raw_engine.h"
+#include "engine/mono_store_engine.h"
+#include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+namespace bench {
+
+DECLARE_string(bench_path);
+DECLARE_int32(bench_value_size);
+DECLARE_int32(bench_key_count);
+
+// Local engines shared by all benchmarks, no cluster and no raft.
+// The mono store engine stands in for raft engine, it apply write directly to raw engine.
+class BenchEnv {
+ public:
+  static BenchEnv& GetInstance();
+
+  bool Init();
+  void Destroy();
+
+  std::shared_ptr<RocksRawEngine> GetRocksEngine() { return rocks_engine_; }
+  std::shared_ptr<BdbRawEngine> GetBdbEngine() { return bdb_engine_; }
+  std::shared_ptr<MonoStoreEngine> GetMonoEngine() { return mono_engine_; }
+
+  // raw engine by pb::common::RawEngine
+  RawEnginePtr GetRawEngine(int64_t raw_engine_type);
+
+  store::RegionPtr GetTxnRegion() { return txn_region_; }
+
+  // increasing ts for txn
+  int64_t NextTs() { return ts_.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+  BenchEnv() = default;
+
+  std::shared_ptr<Config> config_;
+
+  std::shared_ptr<RocksRawEngine> rocks_engine_;
+  std::shared_ptr<BdbRawEngine> bdb_engine_;
+  std::shared_ptr<MonoStoreEngine> mono_engine_;
+
+  store::RegionPtr txn_region_;
+
+  std::atomic<int64_t> ts_{1000};
+};
+
+// Record latency of every operation in one benchmark thread, report percentiles as counters.
+class LatencyCollector {
+ public:
+  LatencyCollector() { latencies_ns_.reserve(1024 * 1024); }
+
+  void Add(int64_t latency_ns) { latencies_ns_.push_back(latency_ns); }
+
+  // set p50_us/p99_us/p999_us counters, averaged by threads
+  void Report(benchmark::State& state);
+
+ private:
+  std::vector<int64_t> latencies_ns_;
+};
+
+std::string GenKey(const std::string& prefix, int64_t index);
+std::string GenValue(int32_t size);
+
+}  // namespace bench
+
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCH_BENCH_ENV_H_
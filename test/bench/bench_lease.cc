@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "coordinator/lease_timer_wheel.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+namespace bench {
+
+DEFINE_int64(bench_lease_count, 1000000, "bench lease count in lease timer wheel");
+DEFINE_int64(bench_lease_max_ttl_ms, 300000, "bench lease ttl is random in [1s, max_ttl_ms]");
+
+static const int64_t kLeaseTickMs = 100;
+
+// leases with random ttl, deadline is relative to time 0
+static std::unique_ptr<LeaseTimerWheel> BuildLeaseTimerWheel(uint32_t shard_num) {
+  auto wheel = std::make_unique<LeaseTimerWheel>(shard_num, kLeaseTickMs, 0);
+
+  std::mt19937_64 rng(FLAGS_bench_lease_count);
+  std::uniform_int_distribution<int64_t> ttl_dist(1000, FLAGS_bench_lease_max_ttl_ms);
+  for (int64_t lease_id = 1; lease_id <= FLAGS_bench_lease_count; ++lease_id) {
+    wheel->Add(lease_id, ttl_dist(rng));
+  }
+
+  return wheel;
+}
+
+// arg0: shard num
+static void BM_LeaseRenew(benchmark::State& state) {
+  static std::unique_ptr<LeaseTimerWheel> wheel;
+  if (state.thread_index() == 0) {
+    wheel = BuildLeaseTimerWheel(state.range(0));
+  }
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> lease_dist(1, FLAGS_bench_lease_count);
+  std::uniform_int_distribution<int64_t> ttl_dist(1000, FLAGS_bench_lease_max_ttl_ms);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(wheel->Renew(lease_dist(rng), ttl_dist(rng)));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    wheel.reset();
+  }
+}
+
+// arg0: shard num
+// advance the wheel until all leases expired, every iteration is a full round.
+static void BM_LeaseExpire(benchmark::State& state) {
+  int64_t expired_count = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto wheel = BuildLeaseTimerWheel(state.range(0));
+    state.ResumeTiming();
+
+    // advance like lease task, 1s per round
+    for (int64_t now_ms = 0; wheel->Size() > 0; now_ms += 1000) {
+      expired_count += wheel->Advance(now_ms).size();
+    }
+
+    state.PauseTiming();
+    wheel.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(expired_count);
+}
+
+BENCHMARK(BM_LeaseRenew)->ArgNames({"shard"})->Arg(1)->Arg(32)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_LeaseExpire)->ArgNames({"shard"})->Arg(1)->Arg(32)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,154 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_env.h"
+#include "benchmark/benchmark.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "mvcc/reader.h"
+
+namespace dingodb {
+
+namespace bench {
+
+DEFINE_int32(bench_mvcc_key_count, 10000, "bench mvcc preload plain key count, every key has multiple versions");
+
+static std::string MvccKeyPrefix(int64_t version_depth) { return fmt::format("m{}_", version_depth); }
+
+// load FLAGS_bench_mvcc_key_count plain keys once for each version depth, version ts is [1, version_depth]
+static void PreloadMvccKvs(int64_t version_depth) {
+  static std::mutex mutex;
+  static std::set<int64_t> loaded_depths;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  if (loaded_depths.count(version_depth) > 0) {
+    return;
+  }
+
+  auto writer = BenchEnv::GetInstance().GetRocksEngine()->Writer();
+  std::string prefix = MvccKeyPrefix(version_depth);
+  std::string plain_value = GenValue(FLAGS_bench_value_size);
+
+  std::vector<pb::common::KeyValue> kvs;
+  for (int64_t i = 0; i < FLAGS_bench_mvcc_key_count; ++i) {
+    std::string plain_key = GenKey(prefix, i);
+    for (int64_t ts = 1; ts <= version_depth; ++ts) {
+      pb::common::KeyValue kv;
+      kv.set_key(mvcc::Codec::EncodeKey(plain_key, ts));
+      mvcc::Codec::PackageValue(mvcc::ValueFlag::kPut, plain_value, *kv.mutable_value());
+      kvs.push_back(std::move(kv));
+    }
+
+    if (kvs.size() >= 1024) {
+      CHECK(writer->KvBatchPut(Constant::kStoreDataCF, kvs).ok());
+      kvs.clear();
+    }
+  }
+  if (!kvs.empty()) {
+    CHECK(writer->KvBatchPut(Constant::kStoreDataCF, kvs).ok());
+  }
+
+  loaded_depths.insert(version_depth);
+}
+
+// arg0: version depth
+static void BM_MvccKvGet(benchmark::State& state) {
+  int64_t version_depth = state.range(0);
+  PreloadMvccKvs(version_depth);
+
+  auto reader = mvcc::KvReader::New(BenchEnv::GetInstance().GetRocksEngine()->Reader());
+  std::string prefix = MvccKeyPrefix(version_depth);
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> key_dist(0, FLAGS_bench_mvcc_key_count - 1);
+  std::uniform_int_distribution<int64_t> ts_dist(1, version_depth);
+
+  LatencyCollector collector;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    std::string plain_key = GenKey(prefix, key_dist(rng));
+    std::string plain_value;
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = reader->KvGet(Constant::kStoreDataCF, ts_dist(rng), plain_key, plain_value);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    bytes += plain_key.size() + plain_value.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+// arg0: version depth, arg1: scan plain key count
+// scan at latest ts, so every plain key need skip the old versions.
+static void BM_MvccKvScan(benchmark::State& state) {
+  int64_t version_depth = state.range(0);
+  int64_t scan_count = state.range(1);
+  PreloadMvccKvs(version_depth);
+
+  auto reader = mvcc::KvReader::New(BenchEnv::GetInstance().GetRocksEngine()->Reader());
+  std::string prefix = MvccKeyPrefix(version_depth);
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> dist(0, std::max(FLAGS_bench_mvcc_key_count - scan_count, 1L) - 1);
+
+  LatencyCollector collector;
+  int64_t items = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    int64_t start_index = dist(rng);
+    std::string plain_start_key = GenKey(prefix, start_index);
+    std::string plain_end_key = GenKey(prefix, start_index + scan_count);
+    std::vector<pb::common::KeyValue> plain_kvs;
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = reader->KvScan(Constant::kStoreDataCF, version_depth, plain_start_key, plain_end_key, plain_kvs);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    items += plain_kvs.size();
+    for (const auto& kv : plain_kvs) {
+      bytes += kv.key().size() + kv.value().size();
+    }
+  }
+
+  state.SetItemsProcessed(items);
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+BENCHMARK(BM_MvccKvGet)->ArgNames({"depth"})->Arg(1)->Arg(8)->Arg(64)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_MvccKvScan)->ArgNames({"depth", "count"})->ArgsProduct({{1, 8, 64}, {10, 100}})->UseRealTime();
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,178 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_env.h"
+#include "benchmark/benchmark.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+namespace bench {
+
+static const std::string kRawKeyPrefix = "r";
+
+// load FLAGS_bench_key_count keys once for each raw engine
+static void PreloadRawKvs(int64_t raw_engine_type) {
+  static std::mutex mutex;
+  static std::set<int64_t> loaded_engines;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  if (loaded_engines.count(raw_engine_type) > 0) {
+    return;
+  }
+
+  auto writer = BenchEnv::GetInstance().GetRawEngine(raw_engine_type)->Writer();
+  std::vector<pb::common::KeyValue> kvs;
+  for (int64_t i = 0; i < FLAGS_bench_key_count; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(GenKey(kRawKeyPrefix, i));
+    kv.set_value(GenValue(FLAGS_bench_value_size));
+    kvs.push_back(std::move(kv));
+    if (kvs.size() >= 1024) {
+      CHECK(writer->KvBatchPut(Constant::kStoreDataCF, kvs).ok());
+      kvs.clear();
+    }
+  }
+  if (!kvs.empty()) {
+    CHECK(writer->KvBatchPut(Constant::kStoreDataCF, kvs).ok());
+  }
+
+  loaded_engines.insert(raw_engine_type);
+}
+
+// arg0: raw engine type
+static void BM_RawKvPut(benchmark::State& state) {
+  auto writer = BenchEnv::GetInstance().GetRawEngine(state.range(0))->Writer();
+  std::string prefix = fmt::format("w{}_", state.thread_index());
+  std::string value = GenValue(FLAGS_bench_value_size);
+
+  LatencyCollector collector;
+  int64_t index = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    pb::common::KeyValue kv;
+    kv.set_key(GenKey(prefix, index++));
+    kv.set_value(value);
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = writer->KvPut(Constant::kStoreDataCF, kv);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    bytes += kv.key().size() + kv.value().size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+// arg0: raw engine type
+static void BM_RawKvGet(benchmark::State& state) {
+  PreloadRawKvs(state.range(0));
+  auto reader = BenchEnv::GetInstance().GetRawEngine(state.range(0))->Reader();
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> dist(0, FLAGS_bench_key_count - 1);
+
+  LatencyCollector collector;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    std::string key = GenKey(kRawKeyPrefix, dist(rng));
+    std::string value;
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = reader->KvGet(Constant::kStoreDataCF, key, value);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    bytes += key.size() + value.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+// arg0: raw engine type, arg1: scan key count
+static void BM_RawKvScan(benchmark::State& state) {
+  PreloadRawKvs(state.range(0));
+  auto reader = BenchEnv::GetInstance().GetRawEngine(state.range(0))->Reader();
+  int64_t scan_count = state.range(1);
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> dist(0, std::max(FLAGS_bench_key_count - scan_count, 1L) - 1);
+
+  LatencyCollector collector;
+  int64_t items = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    int64_t start_index = dist(rng);
+    std::string start_key = GenKey(kRawKeyPrefix, start_index);
+    std::string end_key = GenKey(kRawKeyPrefix, start_index + scan_count);
+    std::vector<pb::common::KeyValue> kvs;
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = reader->KvScan(Constant::kStoreDataCF, start_key, end_key, kvs);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    items += kvs.size();
+    for (const auto& kv : kvs) {
+      bytes += kv.key().size() + kv.value().size();
+    }
+  }
+
+  state.SetItemsProcessed(items);
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+BENCHMARK(BM_RawKvPut)
+    ->ArgNames({"engine"})
+    ->Arg(pb::common::RAW_ENG_ROCKSDB)
+    ->Arg(pb::common::RAW_ENG_BDB)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+BENCHMARK(BM_RawKvGet)
+    ->ArgNames({"engine"})
+    ->Arg(pb::common::RAW_ENG_ROCKSDB)
+    ->Arg(pb::common::RAW_ENG_BDB)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+BENCHMARK(BM_RawKvScan)
+    ->ArgNames({"engine", "count"})
+    ->ArgsProduct({{pb::common::RAW_ENG_ROCKSDB, pb::common::RAW_ENG_BDB}, {10, 100, 1000}})
+    ->UseRealTime();
+
+}  // namespace bench
+
+}  // namespace dingodb
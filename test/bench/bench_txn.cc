@@ -0,0 +1,278 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_env.h"
+#include "benchmark/benchmark.h"
+#include "common/constant.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+namespace bench {
+
+static const int64_t kBenchLockTtl = INT64_MAX;
+
+// txn key must be in txn region, so prefix with client txn prefix
+static std::string TxnKeyPrefix(const std::string& tag) { return fmt::format("{}{}_", Constant::kClientTxn, tag); }
+
+static butil::Status Prewrite(const std::vector<std::string>& keys, const std::string& value, int64_t start_ts) {
+  auto& env = BenchEnv::GetInstance();
+
+  pb::store::TxnPrewriteResponse response;
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(env.GetTxnRegion()->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&response);
+
+  std::vector<pb::store::Mutation> mutations;
+  std::vector<int64_t> pessimistic_checks;
+  std::map<int64_t, int64_t> for_update_ts_checks;
+  std::map<int64_t, std::string> lock_extra_datas;
+  for (int64_t i = 0; i < keys.size(); ++i) {
+    pb::store::Mutation mutation;
+    mutation.set_op(pb::store::Op::Put);
+    mutation.set_key(keys[i]);
+    mutation.set_value(value);
+    mutations.push_back(std::move(mutation));
+
+    pessimistic_checks.push_back(0);
+    for_update_ts_checks.insert_or_assign(i, 0);
+    lock_extra_datas.insert_or_assign(i, "");
+  }
+
+  auto status = TxnEngineHelper::Prewrite(env.GetRocksEngine(), env.GetMonoEngine(), ctx, env.GetTxnRegion(),
+                                          mutations, keys[0], start_ts, kBenchLockTtl, keys.size(), false, 0, 0,
+                                          pessimistic_checks, for_update_ts_checks, lock_extra_datas, {});
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.has_error() || response.txn_result_size() > 0) {
+    return butil::Status(pb::error::EINTERNAL, "prewrite conflict");
+  }
+
+  return butil::Status::OK();
+}
+
+static butil::Status Commit(const std::vector<std::string>& keys, int64_t start_ts, int64_t commit_ts) {
+  auto& env = BenchEnv::GetInstance();
+
+  pb::store::TxnCommitResponse response;
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(env.GetTxnRegion()->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&response);
+
+  auto status = TxnEngineHelper::Commit(env.GetRocksEngine(), env.GetMonoEngine(), ctx, env.GetTxnRegion(), start_ts,
+                                        commit_ts, keys);
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.has_error() || response.has_txn_result()) {
+    return butil::Status(pb::error::EINTERNAL, "commit fail");
+  }
+
+  return butil::Status::OK();
+}
+
+// release the locks of a prewrite only txn, so the keys can be prewritten again by the next run.
+static butil::Status Rollback(const std::vector<std::string>& keys, int64_t start_ts) {
+  auto& env = BenchEnv::GetInstance();
+
+  pb::store::TxnBatchRollbackResponse response;
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(env.GetTxnRegion()->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetResponse(&response);
+
+  auto status = TxnEngineHelper::BatchRollback(env.GetRocksEngine(), env.GetMonoEngine(), ctx, start_ts, keys);
+  if (!status.ok()) {
+    return status;
+  }
+  // error and txn_result are always created by rollback, check their content.
+  if (response.error().errcode() != pb::error::OK || response.txn_result().ByteSizeLong() > 0) {
+    return butil::Status(pb::error::EINTERNAL, "rollback fail");
+  }
+
+  return butil::Status::OK();
+}
+
+static std::vector<std::string> GenTxnKeys(const std::string& prefix, int64_t& index, int64_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    keys.push_back(GenKey(prefix, index++));
+  }
+  return keys;
+}
+
+// commit FLAGS_bench_key_count keys once for batch get
+static void PreloadTxnKvs() {
+  static std::once_flag once_flag;
+
+  std::call_once(once_flag, []() {
+    auto& env = BenchEnv::GetInstance();
+    std::string prefix = TxnKeyPrefix("g");
+    std::string value = GenValue(FLAGS_bench_value_size);
+
+    int64_t index = 0;
+    while (index < FLAGS_bench_key_count) {
+      auto keys = GenTxnKeys(prefix, index, std::min(static_cast<int64_t>(FLAGS_bench_key_count) - index, 256L));
+      int64_t start_ts = env.NextTs();
+      CHECK(Prewrite(keys, value, start_ts).ok());
+      CHECK(Commit(keys, start_ts, env.NextTs()).ok());
+    }
+  });
+}
+
+// arg0: mutation count of one txn, the txn is rolled back out of timing.
+static void BM_TxnPrewrite(benchmark::State& state) {
+  auto& env = BenchEnv::GetInstance();
+  int64_t batch_size = state.range(0);
+  std::string prefix = TxnKeyPrefix(fmt::format("p{}", state.thread_index()));
+  std::string value = GenValue(FLAGS_bench_value_size);
+
+  LatencyCollector collector;
+  int64_t index = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto keys = GenTxnKeys(prefix, index, batch_size);
+    int64_t start_ts = env.NextTs();
+    state.ResumeTiming();
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = Prewrite(keys, value, start_ts);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    bytes += batch_size * (keys[0].size() + value.size());
+
+    state.PauseTiming();
+    status = Rollback(keys, start_ts);
+    state.ResumeTiming();
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+// arg0: mutation count of one txn, latency is the whole two phase commit
+static void BM_TxnPrewriteCommit(benchmark::State& state) {
+  auto& env = BenchEnv::GetInstance();
+  int64_t batch_size = state.range(0);
+  std::string prefix = TxnKeyPrefix(fmt::format("c{}", state.thread_index()));
+  std::string value = GenValue(FLAGS_bench_value_size);
+
+  LatencyCollector collector;
+  int64_t index = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto keys = GenTxnKeys(prefix, index, batch_size);
+    int64_t start_ts = env.NextTs();
+    state.ResumeTiming();
+
+    int64_t start_time = Helper::TimestampNs();
+    auto status = Prewrite(keys, value, start_ts);
+    if (status.ok()) {
+      status = Commit(keys, start_ts, env.NextTs());
+    }
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    bytes += batch_size * (keys[0].size() + value.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+// arg0: key count of one batch get
+static void BM_TxnBatchGet(benchmark::State& state) {
+  PreloadTxnKvs();
+
+  auto& env = BenchEnv::GetInstance();
+  int64_t batch_size = state.range(0);
+  std::string prefix = TxnKeyPrefix("g");
+
+  std::mt19937_64 rng(state.thread_index());
+  std::uniform_int_distribution<int64_t> dist(0, FLAGS_bench_key_count - 1);
+
+  LatencyCollector collector;
+  int64_t items = 0;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<std::string> keys;
+    keys.reserve(batch_size);
+    for (int64_t i = 0; i < batch_size; ++i) {
+      keys.push_back(GenKey(prefix, dist(rng)));
+    }
+    int64_t start_ts = env.NextTs();
+    state.ResumeTiming();
+
+    pb::store::TxnResultInfo txn_result_info;
+    std::vector<pb::common::KeyValue> kvs;
+    int64_t start_time = Helper::TimestampNs();
+    auto status = TxnEngineHelper::BatchGet(env.GetRocksEngine(), pb::store::IsolationLevel::SnapshotIsolation,
+                                            start_ts, keys, {}, txn_result_info, kvs);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    items += kvs.size();
+    for (const auto& kv : kvs) {
+      bytes += kv.key().size() + kv.value().size();
+    }
+  }
+
+  state.SetItemsProcessed(items);
+  state.SetBytesProcessed(bytes);
+  collector.Report(state);
+}
+
+BENCHMARK(BM_TxnPrewrite)->ArgNames({"batch"})->Arg(1)->Arg(16)->Arg(128)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_TxnPrewriteCommit)->ArgNames({"batch"})->Arg(1)->Arg(16)->Arg(128)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_TxnBatchGet)->ArgNames({"batch"})->Arg(1)->Arg(16)->Arg(128)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,583 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bench_vector_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_env.h"
+#include "benchmark/benchmark.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/threadpool.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+#include "vector_dataset.h"
+
+namespace dingodb {
+
+namespace bench {
+
+DEFINE_string(bench_vector_base_path, "", "vector dataset base file, .fvecs/.bvecs/.hdf5, empty means skip");
+DEFINE_string(bench_vector_query_path, "", "vector dataset query file, .fvecs/.bvecs, ignored for hdf5");
+DEFINE_string(bench_vector_groundtruth_path, "",
+              "vector dataset groundtruth file, .ivecs, ignored for hdf5, computed by flat index if empty");
+DEFINE_int64(bench_vector_base_count, 0, "load first N base vectors, 0 means all");
+DEFINE_int64(bench_vector_query_count, 1000, "load first N query vectors, 0 means all");
+DEFINE_int64(bench_vector_train_count, 0, "train ivf index with first N base vectors, 0 means all");
+DEFINE_string(bench_vector_metric, "L2", "metric type, L2/IP/COSINE");
+DEFINE_int32(bench_vector_topk, 10, "search topk, recall is recall@topk");
+DEFINE_string(bench_vector_index_types, "FLAT,HNSW,IVF_FLAT,IVF_PQ", "index types to bench");
+DEFINE_string(bench_vector_threads, "1,4,16", "search threads sweep");
+DEFINE_string(bench_vector_filter_ratios, "1.0,0.1,0.01",
+              "ratio of vector ids allowed by synthetic id selector sweep, 1.0 means no filter");
+
+// build/search parameter sweeps
+DEFINE_string(bench_vector_hnsw_nlinks, "16,32", "hnsw nlinks sweep");
+DEFINE_string(bench_vector_hnsw_efconstruction, "200", "hnsw efconstruction sweep");
+DEFINE_string(bench_vector_hnsw_efsearch, "16,64,256", "hnsw efsearch sweep");
+DEFINE_string(bench_vector_ivf_ncentroids, "1024", "ivf_flat/ivf_pq ncentroids sweep");
+DEFINE_string(bench_vector_ivf_nprobe, "1,8,32", "ivf_flat/ivf_pq nprobe sweep");
+DEFINE_string(bench_vector_ivf_pq_nsubvector, "16", "ivf_pq nsubvector sweep, must divide dimension");
+DEFINE_int32(bench_vector_ivf_pq_nbits_per_idx, 8, "ivf_pq nbits per idx");
+
+DEFINE_int32(bench_vector_build_thread_num, 8, "vector index thread pool size for build");
+
+namespace {
+
+struct BuildParam {
+  std::string type;
+  int64_t nlinks{0};
+  int64_t efconstruction{0};
+  int64_t ncentroids{0};
+  int64_t nsubvector{0};
+
+  std::string Name() const {
+    if (type == "HNSW") {
+      return fmt::format("{}/nlinks:{}/efc:{}", type, nlinks, efconstruction);
+    } else if (type == "IVF_FLAT") {
+      return fmt::format("{}/nlist:{}", type, ncentroids);
+    } else if (type == "IVF_PQ") {
+      return fmt::format("{}/nlist:{}/m:{}", type, ncentroids, nsubvector);
+    }
+    return type;
+  }
+};
+
+struct SearchParam {
+  int64_t efsearch{0};
+  int64_t nprobe{0};
+
+  std::string Name() const {
+    if (efsearch > 0) {
+      return fmt::format("/ef:{}", efsearch);
+    } else if (nprobe > 0) {
+      return fmt::format("/nprobe:{}", nprobe);
+    }
+    return "";
+  }
+};
+
+// synthetic id selector and groundtruth under the selector
+struct FilterEntry {
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  std::vector<std::vector<int64_t>> groundtruth;
+};
+
+}  // namespace
+
+static std::vector<int64_t> ParseInt64List(const std::string& str) {
+  std::vector<int64_t> values;
+  Helper::SplitString(str, ',', values);
+  return values;
+}
+
+static std::vector<double> ParseDoubleList(const std::string& str) {
+  std::vector<std::string> strs;
+  Helper::SplitString(str, ',', strs);
+
+  std::vector<double> values;
+  for (const auto& s : strs) {
+    values.push_back(Helper::StringToDouble(s));
+  }
+  return values;
+}
+
+static pb::common::MetricType ParseMetricType(const std::string& str) {
+  if (str == "IP") {
+    return pb::common::METRIC_TYPE_INNER_PRODUCT;
+  } else if (str == "COSINE") {
+    return pb::common::METRIC_TYPE_COSINE;
+  }
+  return pb::common::METRIC_TYPE_L2;
+}
+
+static pb::common::VectorWithId ToVectorWithId(int64_t id, const float* data, int32_t dimension) {
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(id);
+  vector_with_id.mutable_vector()->set_dimension(dimension);
+  vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+  vector_with_id.mutable_vector()->mutable_float_values()->Add(data, data + dimension);
+  return vector_with_id;
+}
+
+// Hold dataset, the index under bench and the groundtruth, shared by all vector benchmarks.
+// Benchmarks are registered grouped by build parameter, so only keep the latest built index to save memory.
+class VectorIndexBench {
+ public:
+  static VectorIndexBench& GetInstance() {
+    static VectorIndexBench instance;
+    return instance;
+  }
+
+  butil::Status Init() {
+    metric_type_ = ParseMetricType(FLAGS_bench_vector_metric);
+    thread_pool_ = std::make_shared<ThreadPool>("bench_vector_index", FLAGS_bench_vector_build_thread_num);
+
+    dataset_ = VectorDataset::New();
+    auto status = dataset_->Load(FLAGS_bench_vector_base_path, FLAGS_bench_vector_query_path,
+                                 FLAGS_bench_vector_groundtruth_path, FLAGS_bench_vector_base_count,
+                                 FLAGS_bench_vector_query_count);
+    if (!status.ok()) {
+      return status;
+    }
+
+    queries_.reserve(dataset_->QueryCount());
+    for (int64_t row = 0; row < dataset_->QueryCount(); ++row) {
+      queries_.push_back(ToVectorWithId(0, dataset_->QueryVector(row), dataset_->Dimension()));
+    }
+
+    return butil::Status::OK();
+  }
+
+  VectorDatasetPtr Dataset() { return dataset_; }
+  const pb::common::VectorWithId& Query(int64_t row) { return queries_[row % queries_.size()]; }
+
+  struct BuiltIndex {
+    VectorIndexPtr index;
+    int64_t build_time_ms{0};
+    int64_t memory_size{0};
+  };
+
+  butil::Status GetOrBuildIndex(const BuildParam& build_param, BuiltIndex& built_index) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    std::string name = build_param.Name();
+    if (name != built_name_) {
+      built_index_.index = nullptr;
+      built_name_.clear();
+
+      auto status = BuildIndex(build_param, built_index_);
+      if (!status.ok()) {
+        return status;
+      }
+      built_name_ = name;
+    }
+
+    built_index = built_index_;
+    return butil::Status::OK();
+  }
+
+  butil::Status GetOrBuildFilter(double filter_ratio, std::shared_ptr<FilterEntry>& filter_entry) {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = filter_entries_.find(filter_ratio);
+    if (it != filter_entries_.end()) {
+      filter_entry = it->second;
+      return butil::Status::OK();
+    }
+
+    filter_entry = std::make_shared<FilterEntry>();
+    if (filter_ratio < 1.0) {
+      // fixed seed, so every index see the same selector
+      std::mt19937_64 rng(static_cast<uint64_t>(filter_ratio * 1000000));
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      std::vector<int64_t> vector_ids;
+      for (int64_t row = 0; row < dataset_->BaseCount(); ++row) {
+        if (dist(rng) < filter_ratio) {
+          vector_ids.push_back(VectorDataset::RowToVectorId(row));
+        }
+      }
+      filter_entry->filters.push_back(std::make_shared<VectorIndex::ConcreteFilterFunctor>(vector_ids));
+    }
+
+    if (filter_ratio >= 1.0 && !dataset_->GroundTruth().empty()) {
+      filter_entry->groundtruth = dataset_->GroundTruth();
+    } else {
+      auto status = ComputeGroundTruth(filter_entry->filters, filter_entry->groundtruth);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+
+    filter_entries_[filter_ratio] = filter_entry;
+    return butil::Status::OK();
+  }
+
+ private:
+  VectorIndexBench() = default;
+
+  pb::common::VectorIndexParameter GenIndexParameter(const BuildParam& build_param) {
+    int32_t dimension = dataset_->Dimension();
+
+    pb::common::VectorIndexParameter index_parameter;
+    if (build_param.type == "HNSW") {
+      index_parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_HNSW);
+      auto* hnsw_parameter = index_parameter.mutable_hnsw_parameter();
+      hnsw_parameter->set_dimension(dimension);
+      hnsw_parameter->set_metric_type(metric_type_);
+      hnsw_parameter->set_efconstruction(build_param.efconstruction);
+      hnsw_parameter->set_nlinks(build_param.nlinks);
+      hnsw_parameter->set_max_elements(dataset_->BaseCount());
+    } else if (build_param.type == "IVF_FLAT") {
+      index_parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_IVF_FLAT);
+      auto* ivf_flat_parameter = index_parameter.mutable_ivf_flat_parameter();
+      ivf_flat_parameter->set_dimension(dimension);
+      ivf_flat_parameter->set_metric_type(metric_type_);
+      ivf_flat_parameter->set_ncentroids(build_param.ncentroids);
+    } else if (build_param.type == "IVF_PQ") {
+      index_parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_IVF_PQ);
+      auto* ivf_pq_parameter = index_parameter.mutable_ivf_pq_parameter();
+      ivf_pq_parameter->set_dimension(dimension);
+      ivf_pq_parameter->set_metric_type(metric_type_);
+      ivf_pq_parameter->set_ncentroids(build_param.ncentroids);
+      ivf_pq_parameter->set_nsubvector(build_param.nsubvector);
+      ivf_pq_parameter->set_nbits_per_idx(FLAGS_bench_vector_ivf_pq_nbits_per_idx);
+    } else {
+      index_parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_FLAT);
+      auto* flat_parameter = index_parameter.mutable_flat_parameter();
+      flat_parameter->set_dimension(dimension);
+      flat_parameter->set_metric_type(metric_type_);
+    }
+
+    return index_parameter;
+  }
+
+  VectorIndexPtr NewIndex(const BuildParam& build_param) {
+    static const pb::common::Range kRange;
+    static const pb::common::RegionEpoch kEpoch;
+
+    auto index_parameter = GenIndexParameter(build_param);
+    switch (index_parameter.vector_index_type()) {
+      case pb::common::VECTOR_INDEX_TYPE_HNSW:
+        return VectorIndexFactory::NewHnsw(1, index_parameter, kEpoch, kRange, thread_pool_);
+      case pb::common::VECTOR_INDEX_TYPE_IVF_FLAT:
+        return VectorIndexFactory::NewIvfFlat(1, index_parameter, kEpoch, kRange, thread_pool_);
+      case pb::common::VECTOR_INDEX_TYPE_IVF_PQ:
+        return VectorIndexFactory::NewIvfPq(1, index_parameter, kEpoch, kRange, thread_pool_);
+      default:
+        return VectorIndexFactory::NewFlat(1, index_parameter, kEpoch, kRange, thread_pool_);
+    }
+  }
+
+  butil::Status BuildIndex(const BuildParam& build_param, BuiltIndex& built_index) {
+    int64_t start_time = Helper::TimestampMs();
+
+    auto index = NewIndex(build_param);
+    if (index == nullptr) {
+      return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR, fmt::format("new index {} fail", build_param.Name()));
+    }
+
+    if (index->NeedTrain()) {
+      int64_t train_count = FLAGS_bench_vector_train_count > 0
+                                ? std::min(FLAGS_bench_vector_train_count, dataset_->BaseCount())
+                                : dataset_->BaseCount();
+      std::vector<float> train_datas(dataset_->BaseData().begin(),
+                                     dataset_->BaseData().begin() + train_count * dataset_->Dimension());
+      auto status = index->Train(train_datas);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+
+    auto status = AddAll(index);
+    if (!status.ok()) {
+      return status;
+    }
+
+    built_index.index = index;
+    built_index.build_time_ms = Helper::TimestampMs() - start_time;
+    built_index.memory_size = 0;
+    index->GetMemorySize(built_index.memory_size);
+
+    DINGO_LOG(INFO) << fmt::format("[bench] build vector index {} finish, elapsed time({}ms) memory({}).",
+                                   build_param.Name(), built_index.build_time_ms, built_index.memory_size);
+
+    return butil::Status::OK();
+  }
+
+  butil::Status AddAll(VectorIndexPtr index) {
+    const int64_t kBatchSize = 10000;
+
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    vector_with_ids.reserve(kBatchSize);
+    for (int64_t row = 0; row < dataset_->BaseCount(); ++row) {
+      vector_with_ids.push_back(
+          ToVectorWithId(VectorDataset::RowToVectorId(row), dataset_->BaseVector(row), dataset_->Dimension()));
+      if (vector_with_ids.size() >= kBatchSize || row + 1 == dataset_->BaseCount()) {
+        auto status = index->Add(vector_with_ids);
+        if (!status.ok()) {
+          return status;
+        }
+        vector_with_ids.clear();
+      }
+    }
+
+    return butil::Status::OK();
+  }
+
+  // exact topk by flat index, flat index is kept for all filters.
+  butil::Status ComputeGroundTruth(const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                   std::vector<std::vector<int64_t>>& groundtruth) {
+    if (flat_index_ == nullptr) {
+      BuildParam build_param;
+      build_param.type = "FLAT";
+      BuiltIndex built_index;
+      auto status = BuildIndex(build_param, built_index);
+      if (!status.ok()) {
+        return status;
+      }
+      flat_index_ = built_index.index;
+    }
+
+    const int64_t kBatchSize = 1000;
+    pb::common::VectorSearchParameter parameter;
+    int64_t query_count = queries_.size();
+    for (int64_t start = 0; start < query_count; start += kBatchSize) {
+      int64_t end = std::min(start + kBatchSize, query_count);
+      std::vector<pb::common::VectorWithId> batch_queries(queries_.begin() + start, queries_.begin() + end);
+
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      auto status = flat_index_->Search(batch_queries, FLAGS_bench_vector_topk, filters, false, parameter, results);
+      if (!status.ok()) {
+        return status;
+      }
+
+      for (const auto& result : results) {
+        auto& vector_ids = groundtruth.emplace_back();
+        for (const auto& vector_with_distance : result.vector_with_distances()) {
+          vector_ids.push_back(vector_with_distance.vector_with_id().id());
+        }
+      }
+    }
+
+    return butil::Status::OK();
+  }
+
+  pb::common::MetricType metric_type_;
+  ThreadPoolPtr thread_pool_;
+
+  VectorDatasetPtr dataset_;
+  std::vector<pb::common::VectorWithId> queries_;
+
+  std::mutex mutex_;
+
+  std::string built_name_;
+  BuiltIndex built_index_;
+
+  VectorIndexPtr flat_index_;
+  // filter ratio -> filter entry
+  std::map<double, std::shared_ptr<FilterEntry>> filter_entries_;
+};
+
+// one iteration is one query, recall is recall@topk of the queries run by this thread.
+static void BM_VectorSearch(benchmark::State& state, BuildParam build_param, SearchParam search_param,
+                            double filter_ratio) {
+  auto& bench = VectorIndexBench::GetInstance();
+
+  VectorIndexBench::BuiltIndex built_index;
+  auto status = bench.GetOrBuildIndex(build_param, built_index);
+  if (!status.ok()) {
+    state.SkipWithError(status.error_cstr());
+    return;
+  }
+
+  std::shared_ptr<FilterEntry> filter_entry;
+  status = bench.GetOrBuildFilter(filter_ratio, filter_entry);
+  if (!status.ok()) {
+    state.SkipWithError(status.error_cstr());
+    return;
+  }
+
+  pb::common::VectorSearchParameter parameter;
+  parameter.set_top_n(FLAGS_bench_vector_topk);
+  if (search_param.efsearch > 0) {
+    parameter.mutable_hnsw()->set_efsearch(search_param.efsearch);
+  }
+  if (search_param.nprobe > 0) {
+    parameter.mutable_ivf_flat()->set_nprobe(search_param.nprobe);
+    parameter.mutable_ivf_pq()->set_nprobe(search_param.nprobe);
+  }
+
+  int64_t query_count = bench.Dataset()->QueryCount();
+  int64_t row = state.thread_index() * query_count / state.threads();
+
+  LatencyCollector collector;
+  int64_t hit_count = 0;
+  int64_t expect_count = 0;
+  for (auto _ : state) {
+    const auto& query = bench.Query(row);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+
+    int64_t start_time = Helper::TimestampNs();
+    status = built_index.index->Search({query}, FLAGS_bench_vector_topk, filter_entry->filters, false, parameter,
+                                       results);
+    collector.Add(Helper::TimestampNs() - start_time);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+
+    state.PauseTiming();
+    const auto& groundtruth = filter_entry->groundtruth[row % query_count];
+    int64_t expect_size =
+        std::min(static_cast<int64_t>(groundtruth.size()), static_cast<int64_t>(FLAGS_bench_vector_topk));
+    std::set<int64_t> expect_ids(groundtruth.begin(), groundtruth.begin() + expect_size);
+    if (!results.empty()) {
+      for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+        hit_count += expect_ids.count(vector_with_distance.vector_with_id().id());
+      }
+    }
+    expect_count += expect_size;
+    ++row;
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["recall"] = benchmark::Counter(
+      expect_count > 0 ? static_cast<double>(hit_count) / expect_count : 0.0, benchmark::Counter::kAvgThreads);
+  state.counters["build_ms"] = benchmark::Counter(built_index.build_time_ms, benchmark::Counter::kAvgThreads);
+  state.counters["memory"] = benchmark::Counter(built_index.memory_size, benchmark::Counter::kAvgThreads,
+                                                benchmark::Counter::OneK::kIs1024);
+  collector.Report(state);
+}
+
+static std::vector<std::pair<BuildParam, std::vector<SearchParam>>> GenSweeps(const std::string& type,
+                                                                               int32_t dimension) {
+  std::vector<std::pair<BuildParam, std::vector<SearchParam>>> sweeps;
+
+  if (type == "FLAT") {
+    BuildParam build_param;
+    build_param.type = type;
+    sweeps.emplace_back(build_param, std::vector<SearchParam>{SearchParam()});
+
+  } else if (type == "HNSW") {
+    std::vector<SearchParam> search_params;
+    for (auto efsearch : ParseInt64List(FLAGS_bench_vector_hnsw_efsearch)) {
+      SearchParam search_param;
+      search_param.efsearch = efsearch;
+      search_params.push_back(search_param);
+    }
+
+    for (auto nlinks : ParseInt64List(FLAGS_bench_vector_hnsw_nlinks)) {
+      for (auto efconstruction : ParseInt64List(FLAGS_bench_vector_hnsw_efconstruction)) {
+        BuildParam build_param;
+        build_param.type = type;
+        build_param.nlinks = nlinks;
+        build_param.efconstruction = efconstruction;
+        sweeps.emplace_back(build_param, search_params);
+      }
+    }
+
+  } else if (type == "IVF_FLAT" || type == "IVF_PQ") {
+    std::vector<SearchParam> search_params;
+    for (auto nprobe : ParseInt64List(FLAGS_bench_vector_ivf_nprobe)) {
+      SearchParam search_param;
+      search_param.nprobe = nprobe;
+      search_params.push_back(search_param);
+    }
+
+    std::vector<int64_t> nsubvectors = {0};
+    if (type == "IVF_PQ") {
+      nsubvectors = ParseInt64List(FLAGS_bench_vector_ivf_pq_nsubvector);
+    }
+
+    for (auto ncentroids : ParseInt64List(FLAGS_bench_vector_ivf_ncentroids)) {
+      for (auto nsubvector : nsubvectors) {
+        if (type == "IVF_PQ" && (nsubvector <= 0 || dimension % nsubvector != 0)) {
+          DINGO_LOG(WARNING) << fmt::format("[bench] skip ivf_pq nsubvector({}), dimension({}) not divisible.",
+                                            nsubvector, dimension);
+          continue;
+        }
+
+        BuildParam build_param;
+        build_param.type = type;
+        build_param.ncentroids = ncentroids;
+        build_param.nsubvector = nsubvector;
+        sweeps.emplace_back(build_param, search_params);
+      }
+    }
+
+  } else {
+    // bruteforce need raw engine, diskann need diskann server, binary index need binary dataset.
+    DINGO_LOG(WARNING) << fmt::format("[bench] not support bench vector index type {}.", type);
+  }
+
+  return sweeps;
+}
+
+bool RegisterVectorIndexBenchmarks() {
+  if (FLAGS_bench_vector_base_path.empty()) {
+    return true;
+  }
+
+  auto& bench = VectorIndexBench::GetInstance();
+  auto status = bench.Init();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[bench] init vector index bench fail, error: {}", status.error_str());
+    return false;
+  }
+
+  std::vector<std::string> types;
+  Helper::SplitString(FLAGS_bench_vector_index_types, ',', types);
+  auto threads = ParseInt64List(FLAGS_bench_vector_threads);
+  auto filter_ratios = ParseDoubleList(FLAGS_bench_vector_filter_ratios);
+
+  // grouped by build parameter, every index is built only once.
+  for (const auto& type : types) {
+    for (const auto& [build_param, search_params] : GenSweeps(type, bench.Dataset()->Dimension())) {
+      for (const auto& search_param : search_params) {
+        for (auto filter_ratio : filter_ratios) {
+          std::string name = fmt::format("BM_VectorSearch/{}{}/filter:{}", build_param.Name(), search_param.Name(),
+                                         filter_ratio);
+          auto* bm = benchmark::RegisterBenchmark(name.c_str(), BM_VectorSearch, build_param, search_param,
+                                                  filter_ratio);
+          for (auto thread_num : threads) {
+            bm->Threads(thread_num);
+          }
+          bm->UseRealTime()->Unit(benchmark::kMicrosecond);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,30 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_BENCH_VECTOR_INDEX_H_
+#define DINGODB_BENCH_BENCH_VECTOR_INDEX_H_
+
+namespace dingodb {
+
+namespace bench {
+
+// Register vector index recall/QPS benchmarks by dataset and parameter sweep flags,
+// must be called after parse flags, do nothing when --bench_vector_base_path is empty.
+bool RegisterVectorIndexBenchmarks();
+
+}  // namespace bench
+
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCH_BENCH_VECTOR_INDEX_H_
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "bench_env.h"
+#include "bench_vector_index.h"
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+// e.g. ./dingodb_bench --benchmark_filter=BM_Txn --bench_value_size=1024
+//      ./dingodb_bench --benchmark_filter=BM_VectorSearch --bench_vector_base_path=./sift_base.fvecs
+//        --bench_vector_query_path=./sift_query.fvecs --bench_vector_groundtruth_path=./sift_groundtruth.ivecs
+int main(int argc, char** argv) {
+  // benchmark consume its own flags first, the rest flags belong to gflags.
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (!dingodb::bench::BenchEnv::GetInstance().Init()) {
+    std::cerr << "init bench env fail." << '\n';
+    return -1;
+  }
+
+  if (!dingodb::bench::RegisterVectorIndexBenchmarks()) {
+    std::cerr << "register vector index benchmarks fail." << '\n';
+    return -1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  dingodb::bench::BenchEnv::GetInstance().Destroy();
+
+  return 0;
+}
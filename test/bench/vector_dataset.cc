@@ -0,0 +1,268 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector_dataset.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+#ifdef ENABLE_HDF5
+#include "hdf5.h"
+#endif
+
+namespace dingodb {
+
+namespace bench {
+
+static bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+butil::Status VectorDataset::Load(const std::string& base_path, const std::string& query_path,
+                                  const std::string& groundtruth_path, int64_t max_base_count,
+                                  int64_t max_query_count) {
+  if (EndsWith(base_path, ".hdf5")) {
+#ifdef ENABLE_HDF5
+    return LoadHdf5(base_path, max_base_count, max_query_count);
+#else
+    return butil::Status(pb::error::ENOT_SUPPORT, "not build with hdf5, not support load hdf5 dataset");
+#endif
+  }
+
+  int32_t element_size = 0;
+  if (EndsWith(base_path, ".fvecs")) {
+    element_size = sizeof(float);
+  } else if (EndsWith(base_path, ".bvecs")) {
+    element_size = sizeof(uint8_t);
+  } else {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("unknown dataset format, {}", base_path));
+  }
+
+  auto status = ReadVecs(base_path, element_size, max_base_count, dimension_, base_data_, base_count_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  int32_t query_dimension = 0;
+  status = ReadVecs(query_path, element_size, max_query_count, query_dimension, query_data_, query_count_);
+  if (!status.ok()) {
+    return status;
+  }
+  if (query_dimension != dimension_) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("query dimension({}) not match base dimension({})", query_dimension, dimension_));
+  }
+
+  // groundtruth of the whole base is invalid when base is truncated, it should be computed by flat index.
+  if (!groundtruth_path.empty() && max_base_count <= 0) {
+    status = ReadIvecs(groundtruth_path, query_count_, groundtruth_);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[bench] load dataset {} finish, dimension({}) base({}) query({}) groundtruth({}).",
+                                 base_path, dimension_, base_count_, query_count_, groundtruth_.size());
+
+  return butil::Status::OK();
+}
+
+// format: every row is int32 dimension + dimension * element
+butil::Status VectorDataset::ReadVecs(const std::string& path, int32_t element_size, int64_t max_count,
+                                      int32_t& dimension, std::vector<float>& data, int64_t& count) {
+  std::ifstream reader(path, std::ios::binary);
+  if (!reader.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} fail", path));
+  }
+
+  reader.read(reinterpret_cast<char*>(&dimension), sizeof(int32_t));
+  if (reader.gcount() != sizeof(int32_t) || dimension <= 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("read dimension from {} fail", path));
+  }
+
+  reader.seekg(0, std::ios::end);
+  int64_t row_size = sizeof(int32_t) + static_cast<int64_t>(dimension) * element_size;
+  count = static_cast<int64_t>(reader.tellg()) / row_size;
+  if (max_count > 0) {
+    count = std::min(count, max_count);
+  }
+  reader.seekg(0, std::ios::beg);
+
+  data.resize(count * dimension);
+  std::vector<char> buffer(row_size);
+  for (int64_t row = 0; row < count; ++row) {
+    reader.read(buffer.data(), row_size);
+    if (reader.gcount() != row_size) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("read row {} from {} fail", row, path));
+    }
+
+    float* output = data.data() + row * dimension;
+    const char* input = buffer.data() + sizeof(int32_t);
+    if (element_size == sizeof(float)) {
+      memcpy(output, input, dimension * sizeof(float));
+    } else {
+      for (int32_t i = 0; i < dimension; ++i) {
+        output[i] = static_cast<float>(static_cast<uint8_t>(input[i]));
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorDataset::ReadIvecs(const std::string& path, int64_t max_count,
+                                       std::vector<std::vector<int64_t>>& ids) {
+  std::ifstream reader(path, std::ios::binary);
+  if (!reader.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} fail", path));
+  }
+
+  for (int64_t row = 0; row < max_count; ++row) {
+    int32_t dimension = 0;
+    reader.read(reinterpret_cast<char*>(&dimension), sizeof(int32_t));
+    if (reader.gcount() != sizeof(int32_t)) {
+      break;
+    }
+
+    std::vector<int32_t> row_ids(dimension);
+    reader.read(reinterpret_cast<char*>(row_ids.data()), dimension * sizeof(int32_t));
+    if (reader.gcount() != dimension * sizeof(int32_t)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("read row {} from {} fail", row, path));
+    }
+
+    auto& vector_ids = ids.emplace_back();
+    vector_ids.reserve(dimension);
+    for (auto row_id : row_ids) {
+      vector_ids.push_back(RowToVectorId(row_id));
+    }
+  }
+
+  if (ids.size() != max_count) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("groundtruth count({}) not match query count({})", ids.size(), max_count));
+  }
+
+  return butil::Status::OK();
+}
+
+#ifdef ENABLE_HDF5
+
+static butil::Status ReadHdf5Dataset(hid_t file, const std::string& name, hid_t mem_type, int64_t max_rows,
+                                     int64_t& rows, int64_t& cols, void* (*resize)(void*, int64_t), void* output) {
+  hid_t dataset = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+  if (dataset < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open hdf5 dataset {} fail", name));
+  }
+
+  hid_t file_space = H5Dget_space(dataset);
+  hsize_t dims[2] = {0, 0};
+  if (H5Sget_simple_extent_ndims(file_space) != 2) {
+    H5Sclose(file_space);
+    H5Dclose(dataset);
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("hdf5 dataset {} is not 2 dimensions", name));
+  }
+  H5Sget_simple_extent_dims(file_space, dims, nullptr);
+
+  rows = max_rows > 0 ? std::min(static_cast<int64_t>(dims[0]), max_rows) : static_cast<int64_t>(dims[0]);
+  cols = static_cast<int64_t>(dims[1]);
+
+  // only read the first rows
+  hsize_t offset[2] = {0, 0};
+  hsize_t count[2] = {static_cast<hsize_t>(rows), dims[1]};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+  hid_t mem_space = H5Screate_simple(2, count, nullptr);
+
+  void* buffer = resize(output, rows * cols);
+  herr_t ret = H5Dread(dataset, mem_type, mem_space, file_space, H5P_DEFAULT, buffer);
+
+  H5Sclose(mem_space);
+  H5Sclose(file_space);
+  H5Dclose(dataset);
+
+  if (ret < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read hdf5 dataset {} fail", name));
+  }
+
+  return butil::Status::OK();
+}
+
+// ann-benchmarks layout: train(base), test(query), neighbors(groundtruth row number)
+butil::Status VectorDataset::LoadHdf5(const std::string& path, int64_t max_base_count, int64_t max_query_count) {
+  hid_t file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open hdf5 file {} fail", path));
+  }
+
+  auto resize_float = [](void* output, int64_t size) -> void* {
+    auto* data = static_cast<std::vector<float>*>(output);
+    data->resize(size);
+    return data->data();
+  };
+  auto resize_int64 = [](void* output, int64_t size) -> void* {
+    auto* data = static_cast<std::vector<int64_t>*>(output);
+    data->resize(size);
+    return data->data();
+  };
+
+  int64_t cols = 0;
+  auto status =
+      ReadHdf5Dataset(file, "train", H5T_NATIVE_FLOAT, max_base_count, base_count_, cols, resize_float, &base_data_);
+  if (status.ok()) {
+    dimension_ = static_cast<int32_t>(cols);
+    status = ReadHdf5Dataset(file, "test", H5T_NATIVE_FLOAT, max_query_count, query_count_, cols, resize_float,
+                             &query_data_);
+  }
+  if (status.ok() && cols != dimension_) {
+    status = butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("query dimension({}) not match base dimension({})", cols, dimension_));
+  }
+
+  // groundtruth of the whole base is invalid when base is truncated
+  if (status.ok() && max_base_count <= 0) {
+    std::vector<int64_t> neighbors;
+    int64_t rows = 0;
+    status = ReadHdf5Dataset(file, "neighbors", H5T_NATIVE_INT64, query_count_, rows, cols, resize_int64, &neighbors);
+    if (status.ok()) {
+      groundtruth_.resize(rows);
+      for (int64_t row = 0; row < rows; ++row) {
+        for (int64_t col = 0; col < cols; ++col) {
+          groundtruth_[row].push_back(RowToVectorId(neighbors[row * cols + col]));
+        }
+      }
+    }
+  }
+
+  H5Fclose(file);
+
+  if (status.ok()) {
+    DINGO_LOG(INFO) << fmt::format("[bench] load dataset {} finish, dimension({}) base({}) query({}) groundtruth({}).",
+                                   path, dimension_, base_count_, query_count_, groundtruth_.size());
+  }
+
+  return status;
+}
+
+#endif  // ENABLE_HDF5
+
+}  // namespace bench
+
+}  // namespace dingodb
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_VECTOR_DATASET_H_
+#define DINGODB_BENCH_VECTOR_DATASET_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+namespace bench {
+
+class VectorDataset;
+using VectorDatasetPtr = std::shared_ptr<VectorDataset>;
+
+// Standard ann dataset on local file, e.g. SIFT/GIST(fvecs/bvecs/ivecs) and ann-benchmarks GloVe(hdf5).
+// fvecs/bvecs: base and query are separate files, groundtruth is ivecs file and is optional.
+// hdf5: base/query/groundtruth are dataset train/test/neighbors of the same file, need build with hdf5.
+// bvecs value is converted to float.
+// vector id is the row number plus 1, because vector id 0 is invalid.
+class VectorDataset {
+ public:
+  static VectorDatasetPtr New() { return std::make_shared<VectorDataset>(); }
+
+  butil::Status Load(const std::string& base_path, const std::string& query_path, const std::string& groundtruth_path,
+                     int64_t max_base_count, int64_t max_query_count);
+
+  int32_t Dimension() const { return dimension_; }
+  int64_t BaseCount() const { return base_count_; }
+  int64_t QueryCount() const { return query_count_; }
+
+  const std::vector<float>& BaseData() const { return base_data_; }
+  const float* BaseVector(int64_t row) const { return base_data_.data() + row * dimension_; }
+  const float* QueryVector(int64_t row) const { return query_data_.data() + row * dimension_; }
+
+  // groundtruth vector ids of each query, order by distance, empty when groundtruth file is not given.
+  const std::vector<std::vector<int64_t>>& GroundTruth() const { return groundtruth_; }
+
+  static int64_t RowToVectorId(int64_t row) { return row + 1; }
+
+ private:
+  static butil::Status ReadVecs(const std::string& path, int32_t element_size, int64_t max_count, int32_t& dimension,
+                                std::vector<float>& data, int64_t& count);
+  static butil::Status ReadIvecs(const std::string& path, int64_t max_count, std::vector<std::vector<int64_t>>& ids);
+
+#ifdef ENABLE_HDF5
+  butil::Status LoadHdf5(const std::string& path, int64_t max_base_count, int64_t max_query_count);
+#endif
+
+  int32_t dimension_{0};
+
+  int64_t base_count_{0};
+  std::vector<float> base_data_;
+
+  int64_t query_count_{0};
+  std::vector<float> query_data_;
+
+  std::vector<std::vector<int64_t>> groundtruth_;
+};
+
+}  // namespace bench
+
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCH_VECTOR_DATASET_H_
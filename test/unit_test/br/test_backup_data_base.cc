@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "br/backup_data_base.h"
+#include "butil/status.h"
+#include "proto/error.pb.h"
+
+class BrBackupDataBaseTest : public testing::Test {
+ protected:
+  static std::shared_ptr<br::BackupDataBase> NewBackupDataBase() {
+    return std::make_shared<br::BackupDataBase>(nullptr, nullptr, nullptr, nullptr, "2024-12-31 14:39:00 +08:00", 0,
+                                                "local://./backup", "./backup", "backup_data_base_test");
+  }
+};
+
+TEST_F(BrBackupDataBaseTest, LastErrorFirstWins) {
+  auto backup_data_base = NewBackupDataBase();
+  EXPECT_TRUE(backup_data_base->GetLastError().ok());
+
+  backup_data_base->SetLastError(butil::Status(dingodb::pb::error::EINTERNAL, "first"));
+  backup_data_base->SetLastError(butil::Status(dingodb::pb::error::ENOT_SUPPORT, "second"));
+
+  auto status = backup_data_base->GetLastError();
+  EXPECT_EQ(dingodb::pb::error::EINTERNAL, status.error_code());
+  EXPECT_EQ("first", status.error_str());
+}
+
+TEST_F(BrBackupDataBaseTest, LastErrorConcurrent) {
+  auto backup_data_base = NewBackupDataBase();
+
+  std::vector<std::thread> threads;
+  threads.reserve(8);
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([backup_data_base, i]() {
+      for (int j = 0; j < 1000; ++j) {
+        backup_data_base->SetLastError(butil::Status(dingodb::pb::error::EINTERNAL, "worker " + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto status = backup_data_base->GetLastError();
+  EXPECT_EQ(dingodb::pb::error::EINTERNAL, status.error_code());
+  EXPECT_EQ(0, status.error_str().find("worker "));
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(backup_sst_file_max_size);
+
+const std::string kBackupSstDirPath = "./unit_test_backup_sst_file_writer";
+const std::string kBackupSstDirName = "region";
+
+class BackupSstFileWriterTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { Helper::CreateDirectories(kBackupSstDirPath); }
+
+  static void TearDownTestSuite() { Helper::RemoveAllFileOrDirectory(kBackupSstDirPath); }
+
+  void SetUp() override {
+    old_max_size_ = FLAGS_backup_sst_file_max_size;
+    // roll to the next file whenever a data block is flushed
+    FLAGS_backup_sst_file_max_size = 1;
+  }
+
+  void TearDown() override { FLAGS_backup_sst_file_max_size = old_max_size_; }
+
+  static std::string FilePath(const std::string& file_name) { return kBackupSstDirPath + "/" + file_name; }
+
+  static butil::Status PutKvs(BackupSstFileWriter& writer, int count) {
+    std::string value(8192, 'v');
+    for (int i = 0; i < count; ++i) {
+      auto status = writer.Put(fmt::format("key_{:04}", i), value);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return butil::Status::OK();
+  }
+
+  int64_t old_max_size_{0};
+};
+
+TEST_F(BackupSstFileWriterTest, RollFiles) {
+  pb::common::BackupDataFileValueSstMetaGroup sst_meta_group;
+  BackupSstFileWriter writer(1001, kBackupSstDirPath, kBackupSstDirName, "roll", Constant::kStoreDataCF,
+                             &sst_meta_group);
+
+  ASSERT_TRUE(PutKvs(writer, 10).ok());
+  ASSERT_TRUE(writer.Finish().ok());
+
+  EXPECT_EQ(10, writer.Count());
+  ASSERT_GT(sst_meta_group.backup_data_file_value_sst_metas_size(), 1);
+  ASSERT_EQ(sst_meta_group.backup_data_file_value_sst_metas_size(), static_cast<int>(writer.FileNames().size()));
+  for (const auto& sst_meta : sst_meta_group.backup_data_file_value_sst_metas()) {
+    EXPECT_EQ(Constant::kStoreDataCF, sst_meta.cf());
+    EXPECT_EQ(kBackupSstDirName, sst_meta.dir_name());
+    EXPECT_TRUE(Helper::IsExistPath(FilePath(sst_meta.file_name())));
+    EXPECT_EQ(Helper::GetFileSize(FilePath(sst_meta.file_name())), sst_meta.file_size());
+  }
+}
+
+TEST_F(BackupSstFileWriterTest, DiscardOnFailure) {
+  pb::common::BackupDataFileValueSstMetaGroup sst_meta_group;
+  BackupSstFileWriter writer(1002, kBackupSstDirPath, kBackupSstDirName, "discard", Constant::kStoreDataCF,
+                             &sst_meta_group);
+
+  ASSERT_TRUE(PutKvs(writer, 6).ok());
+  auto file_names = writer.FileNames();
+  ASSERT_FALSE(file_names.empty());
+
+  // key out of order
+  ASSERT_FALSE(writer.Put("key_0000", "value").ok());
+
+  TxnEngineHelper::DiscardSstFileWriters({&writer}, &sst_meta_group);
+
+  EXPECT_EQ(0, sst_meta_group.backup_data_file_value_sst_metas_size());
+  EXPECT_TRUE(writer.FileNames().empty());
+  for (const auto& file_name : file_names) {
+    EXPECT_FALSE(Helper::IsExistPath(FilePath(file_name)));
+  }
+  for (const auto& entry : std::filesystem::directory_iterator(kBackupSstDirPath)) {
+    EXPECT_EQ(std::string::npos, entry.path().filename().string().find("discard")) << entry.path();
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,38 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "br/restore.h"
+
+class BrRestoreTest : public testing::Test {
+ protected:
+  static constexpr int kLogicalBits = 18;
+};
+
+TEST_F(BrRestoreTest, CalcAdvanceTsoPhysical) {
+  int64_t backup_physical = 1735627140000;
+  int64_t backup_tso = (backup_physical << kLogicalBits) + 100;
+
+  // current tso already past backup tso
+  EXPECT_EQ(0, br::Restore::CalcAdvanceTsoPhysical(backup_tso, backup_tso + 1));
+  EXPECT_EQ(0, br::Restore::CalcAdvanceTsoPhysical(backup_tso, (backup_physical + 10) << kLogicalBits));
+
+  // current tso fall behind backup tso, e.g. restore to a new cluster
+  EXPECT_EQ(backup_physical + 1, br::Restore::CalcAdvanceTsoPhysical(backup_tso, backup_tso));
+  EXPECT_EQ(backup_physical + 1, br::Restore::CalcAdvanceTsoPhysical(backup_tso, 0));
+  EXPECT_EQ(backup_physical + 1, br::Restore::CalcAdvanceTsoPhysical(backup_tso, backup_physical << kLogicalBits));
+}
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
@@ -120,20 +121,27 @@ TEST(DingoLatchTest, wakeup_by_multi_cmds) {
   auto acquired_b = latches.Acquire(&lock_b, cid_b);
   EXPECT_EQ(acquired_b, true);
 
-  // c acquire lock failed, cause a occupied slot 3
+  // hashes are acquired in slot order, c is blocked by the holder of its first key, a for k3 or b for k4.
+  bool is_k3_first = latches.SlotLess(dingodb::Lock::Hash("k3"), dingodb::Lock::Hash("k4"));
+  auto* first_lock = is_k3_first ? &lock_a : &lock_b;
+  auto* second_lock = is_k3_first ? &lock_b : &lock_a;
+  uint64_t first_cid = is_k3_first ? cid_a : cid_b;
+  uint64_t second_cid = is_k3_first ? cid_b : cid_a;
+
+  // c acquire lock failed, cause the first key is occupied
   auto acquired_c = latches.Acquire(&lock_c, cid_c);
   EXPECT_EQ(acquired_c, false);
 
-  // a release lock, and get wakeup list
-  auto wakeup = latches.Release(&lock_a, cid_a, std::nullopt);
+  // first holder release lock, and get wakeup list
+  auto wakeup = latches.Release(first_lock, first_cid, std::nullopt);
   EXPECT_EQ(wakeup[0], cid_c);
 
-  // c acquire lock failed again, cause b occupied slot 4
+  // c acquire lock failed again, cause the second key is occupied
   acquired_c = latches.Acquire(&lock_c, cid_c);
   EXPECT_EQ(acquired_c, false);
 
-  // b release lock, and get wakeup list
-  wakeup = latches.Release(&lock_b, cid_b, std::nullopt);
+  // second holder release lock, and get wakeup list
+  wakeup = latches.Release(second_lock, second_cid, std::nullopt);
   EXPECT_EQ(wakeup[0], cid_c);
 
   // finally c acquire lock success
@@ -194,6 +202,15 @@ void CheckLatchHolder(dingodb::Latches* latches, const std::string& key, std::op
   auto* slot = latches->GetSlot(hash);
   BAIDU_SCOPED_LOCK(slot->mutex);
   std::optional<uint64_t> actual_holder = slot->latch.GetFirstReqByHash(hash);
+
+  // slot is held by fast path, holder is not in latch.waiting
+  uint64_t owner = slot->owner.load();
+  if (owner != dingodb::Slot::kSlotFree && owner != dingodb::Slot::kSlotInflated) {
+    auto* lock = reinterpret_cast<dingodb::Lock*>(owner);
+    if (std::find(lock->requiredHashes.begin(), lock->requiredHashes.end(), hash) != lock->requiredHashes.end()) {
+      actual_holder = lock->owner;
+    }
+  }
   assert(actual_holder == expected_holder_cid);
 }
 
@@ -201,6 +218,9 @@ bool IsLatchesEmpty(dingodb::Latches* latches) {
   for (uint64_t i = 0; i < latches->slots_size; ++i) {
     auto* slot = latches->GetSlot(i);
     BAIDU_SCOPED_LOCK(slot->mutex);
+    if (slot->owner.load() != dingodb::Slot::kSlotFree) {
+      return false;
+    }
     const auto& waiting = slot->latch.waiting;
     if (!waiting.empty()) {
       return false;
@@ -397,4 +417,38 @@ TEST(DingoLatchTest, partially_releasing) {
   TestPartiallyReleasingImpl(64);
   TestPartiallyReleasingImpl(4);
   TestPartiallyReleasingImpl(2);
-}
\ No newline at end of file
+}
+
+TEST(DingoLatchTest, batch_acquire_same_slot) {
+  // all keys are in one slot
+  dingodb::Latches latches(1);
+
+  dingodb::Lock lock_a({"k1", "k2", "k3"});
+  dingodb::Lock lock_b({"k2"});
+  dingodb::Lock lock_c({"k4"});
+  uint64_t cid_a = 1;
+  uint64_t cid_b = 2;
+  uint64_t cid_c = 3;
+
+  // a hold the slot by fast path
+  EXPECT_EQ(latches.Acquire(&lock_a, cid_a), true);
+  EXPECT_EQ(latches.GetSlot(0)->owner.load(), reinterpret_cast<uint64_t>(&lock_a));
+
+  // b inflate the slot and wait a
+  EXPECT_EQ(latches.Acquire(&lock_b, cid_b), false);
+  EXPECT_EQ(latches.GetSlot(0)->owner.load(), dingodb::Slot::kSlotInflated);
+  CheckLatchHolder(&latches, "k1", cid_a);
+  CheckLatchHolder(&latches, "k2", cid_a);
+  CheckLatchHolder(&latches, "k3", cid_a);
+
+  // c has no conflict key with a
+  EXPECT_EQ(latches.Acquire(&lock_c, cid_c), true);
+
+  auto wakeup = latches.Release(&lock_a, cid_a, std::nullopt);
+  EXPECT_EQ(wakeup, std::vector<uint64_t>{cid_b});
+  EXPECT_EQ(latches.Acquire(&lock_b, cid_b), true);
+
+  EXPECT_EQ(latches.Release(&lock_b, cid_b, std::nullopt).empty(), true);
+  EXPECT_EQ(latches.Release(&lock_c, cid_c, std::nullopt).empty(), true);
+  EXPECT_EQ(IsLatchesEmpty(&latches), true);
+}
@@ -0,0 +1,266 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "document/codec.h"
+#include "document/document_filter.h"
+#include "document/document_index_factory.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+const std::string kDocumentFilterTestIndexPath = "./document_filter_test_index";
+
+static pb::common::ScalarSchema GenScalarSchema() {
+  pb::common::ScalarSchema scalar_schema;
+  auto* field = scalar_schema.add_fields();
+  field->set_key("text");
+  field->set_field_type(pb::common::ScalarFieldType::STRING);
+  field = scalar_schema.add_fields();
+  field->set_key("i64");
+  field->set_field_type(pb::common::ScalarFieldType::INT64);
+  field = scalar_schema.add_fields();
+  field->set_key("bool");
+  field->set_field_type(pb::common::ScalarFieldType::BOOL);
+  return scalar_schema;
+}
+
+// text is raw tokenizer, exact match.
+static pb::common::DocumentIndexParameter GenIndexParameter() {
+  pb::common::DocumentIndexParameter index_parameter;
+  *index_parameter.mutable_scalar_schema() = GenScalarSchema();
+  index_parameter.set_json_parameter(
+      R"({"text": {"tokenizer": {"type": "raw"}}, "i64": {"tokenizer": {"type": "i64"}},)"
+      R"( "bool": {"tokenizer": {"type": "bool"}}})");
+  return index_parameter;
+}
+
+static void AddFilter(google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter>& filters,
+                      const std::string& key, pb::common::DocumentFilterOp op,
+                      const std::vector<pb::common::DocumentValue>& values) {
+  auto* filter = filters.Add();
+  filter->set_key(key);
+  filter->set_op(op);
+  for (const auto& value : values) {
+    *filter->add_values() = value;
+  }
+}
+
+static pb::common::DocumentValue Int64Value(int64_t data) {
+  pb::common::DocumentValue value;
+  value.set_field_type(pb::common::ScalarFieldType::INT64);
+  value.mutable_field_value()->set_long_data(data);
+  return value;
+}
+
+static pb::common::DocumentValue StringValue(const std::string& data) {
+  pb::common::DocumentValue value;
+  value.set_field_type(pb::common::ScalarFieldType::STRING);
+  value.mutable_field_value()->set_string_data(data);
+  return value;
+}
+
+TEST(DocumentFilterTest, BuildIdQuery) {
+  std::string query;
+  EXPECT_FALSE(DocumentFilter::BuildIdQuery({}, 64, query));
+
+  EXPECT_TRUE(DocumentFilter::BuildIdQuery({7}, 64, query));
+  EXPECT_EQ("row_id: IN [7]", query);
+
+  EXPECT_TRUE(DocumentFilter::BuildIdQuery({3, 1, 2, 2}, 64, query));
+  EXPECT_EQ("(row_id: >= 1 AND row_id: <= 3)", query);
+
+  EXPECT_TRUE(DocumentFilter::BuildIdQuery({12, 5, 1, 2, 3, 9, 11}, 64, query));
+  EXPECT_EQ("((row_id: >= 1 AND row_id: <= 3) OR (row_id: >= 11 AND row_id: <= 12) OR row_id: IN [5 9])", query);
+
+  // too many ranges, keep id list
+  EXPECT_FALSE(DocumentFilter::BuildIdQuery({12, 5, 1, 2, 3, 9, 11}, 3, query));
+}
+
+TEST(DocumentFilterTest, BuildScalarQuery) {
+  auto index_parameter = GenIndexParameter();
+
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_GE, {Int64Value(1003)});
+    AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_LT, {Int64Value(1008)});
+    AddFilter(filters, "text", pb::common::DocumentFilterOp::FILTER_OP_IN,
+              {StringValue("hello world"), StringValue(R"(say "hi")")});
+
+    std::string query;
+    ASSERT_TRUE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+    EXPECT_EQ(R"(i64: >= 1003 AND i64: < 1008 AND (text:"hello world" OR text:"say \"hi\""))", query);
+  }
+
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_IN,
+              {Int64Value(1), Int64Value(2), Int64Value(-3)});
+
+    std::string query;
+    ASSERT_TRUE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+    EXPECT_EQ("i64: IN [1 2 -3]", query);
+  }
+
+  // not in schema
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "f64", pb::common::DocumentFilterOp::FILTER_OP_EQ, {Int64Value(1)});
+    std::string query;
+    EXPECT_FALSE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+  }
+
+  // type not match
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_EQ, {StringValue("1")});
+    std::string query;
+    EXPECT_FALSE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+  }
+
+  // range on text
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "text", pb::common::DocumentFilterOp::FILTER_OP_GT, {StringValue("a")});
+    std::string query;
+    EXPECT_FALSE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+  }
+
+  // EQ on tokenized text is contains, not equal
+  {
+    auto tokenized_index_parameter = index_parameter;
+    tokenized_index_parameter.set_json_parameter(R"({"text": {"tokenizer": {"type": "chinese"}}})");
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "text", pb::common::DocumentFilterOp::FILTER_OP_EQ, {StringValue("hello")});
+    std::string query;
+    EXPECT_FALSE(DocumentFilter::BuildScalarQuery(tokenized_index_parameter, filters, query).ok());
+  }
+}
+
+TEST(DocumentFilterTest, BuildScalarQueryDatetime) {
+  auto index_parameter = GenIndexParameter();
+  auto* field = index_parameter.mutable_scalar_schema()->add_fields();
+  field->set_key("datetime");
+  field->set_field_type(pb::common::ScalarFieldType::DATETIME);
+
+  auto datetime_value = [](const std::string& data) {
+    pb::common::DocumentValue value;
+    value.set_field_type(pb::common::ScalarFieldType::DATETIME);
+    value.mutable_field_value()->set_datetime_data(data);
+    return value;
+  };
+
+  {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "datetime", pb::common::DocumentFilterOp::FILTER_OP_GE,
+              {datetime_value("2024-01-02T03:04:05Z")});
+    AddFilter(filters, "datetime", pb::common::DocumentFilterOp::FILTER_OP_LT,
+              {datetime_value("2024-01-02T03:04:05.123+08:00")});
+    std::string query;
+    ASSERT_TRUE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok());
+    EXPECT_EQ("datetime: >= 2024-01-02T03:04:05Z AND datetime: < 2024-01-02T03:04:05.123+08:00", query);
+  }
+
+  // not rfc3339, e.g. inject query syntax
+  for (const auto& data : {"", "2024-01-02", "2024-01-02T03:04:05Z)OR(text:a", "2024-01-02T03:04:05Z\tOR"}) {
+    google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+    AddFilter(filters, "datetime", pb::common::DocumentFilterOp::FILTER_OP_GE, {datetime_value(data)});
+    std::string query;
+    EXPECT_FALSE(DocumentFilter::BuildScalarQuery(index_parameter, filters, query).ok()) << data;
+  }
+}
+
+TEST(DocumentFilterTest, CombineQuery) {
+  EXPECT_EQ("discover", DocumentFilter::CombineQuery("discover", {}));
+  EXPECT_EQ("discover", DocumentFilter::CombineQuery("discover", {""}));
+  EXPECT_EQ("(discover of) AND (i64: >= 1) AND (row_id: IN [7])",
+            DocumentFilter::CombineQuery("discover of", {"i64: >= 1", "row_id: IN [7]"}));
+
+  // empty query string, only filter
+  EXPECT_EQ("(i64: >= 1)", DocumentFilter::CombineQuery("", {"i64: >= 1"}));
+  EXPECT_EQ("(i64: >= 1) AND (row_id: IN [7])", DocumentFilter::CombineQuery("", {"i64: >= 1", "row_id: IN [7]"}));
+  EXPECT_EQ("", DocumentFilter::CombineQuery("", {}));
+}
+
+TEST(DocumentFilterTest, SearchWithFilter) {
+  std::filesystem::remove_all(kDocumentFilterTestIndexPath);
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, TokenizerType> column_tokenizer_parameter;
+  column_tokenizer_parameter["text"] = TokenizerType::kTokenizerTypeText;
+  column_tokenizer_parameter["i64"] = TokenizerType::kTokenizerTypeI64;
+  column_tokenizer_parameter["bool"] = TokenizerType::kTokenizerTypeBool;
+  ASSERT_TRUE(DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                              error_message));
+
+  pb::common::DocumentIndexParameter document_index_parameter;
+  *document_index_parameter.mutable_scalar_schema() = GenScalarSchema();
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  pb::common::RegionEpoch region_epoch;
+  pb::common::Range range;
+  auto document_index = DocumentIndexFactory::CreateIndex(1, kDocumentFilterTestIndexPath, document_index_parameter,
+                                                          region_epoch, range, true);
+  ASSERT_TRUE(document_index != nullptr);
+
+  std::vector<pb::common::DocumentWithId> document_with_ids;
+  for (int64_t i = 1; i <= 10; ++i) {
+    pb::common::DocumentWithId document_with_id;
+    document_with_id.set_id(i);
+    auto* document_data = document_with_id.mutable_document()->mutable_document_data();
+    (*document_data)["text"] = StringValue("filter document " + std::to_string(i));
+    (*document_data)["i64"] = Int64Value(1000 + i);
+    pb::common::DocumentValue bool_value;
+    bool_value.set_field_type(pb::common::ScalarFieldType::BOOL);
+    bool_value.mutable_field_value()->set_bool_data(i % 2 == 0);
+    (*document_data)["bool"] = bool_value;
+    document_with_ids.push_back(document_with_id);
+  }
+  ASSERT_TRUE(document_index->Add(document_with_ids, true).ok());
+  ASSERT_TRUE(document_index->WaitReaderRefreshed(5000).ok());
+
+  google::protobuf::RepeatedPtrField<pb::common::DocumentScalarFilter> filters;
+  AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_GE, {Int64Value(1003)});
+  AddFilter(filters, "i64", pb::common::DocumentFilterOp::FILTER_OP_LE, {Int64Value(1008)});
+  std::string scalar_query;
+  ASSERT_TRUE(DocumentFilter::BuildScalarQuery(document_index_parameter, filters, scalar_query).ok());
+
+  std::string id_query;
+  ASSERT_TRUE(DocumentFilter::BuildIdQuery({1, 2, 3, 4, 5, 8, 9}, 64, id_query));
+
+  // 3,4,5,8
+  std::vector<pb::common::DocumentWithScore> results;
+  auto query_string = DocumentFilter::CombineQuery("filter", {scalar_query, id_query});
+  auto status = document_index->Search(100, query_string, false, 0, INT64_MAX, false, false, {}, {}, results);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  std::vector<int64_t> result_ids;
+  for (const auto& result : results) {
+    result_ids.push_back(result.document_with_id().id());
+  }
+  std::sort(result_ids.begin(), result_ids.end());
+  EXPECT_EQ(std::vector<int64_t>({3, 4, 5, 8}), result_ids);
+
+  std::filesystem::remove_all(kDocumentFilterTestIndexPath);
+}
+
+}  // namespace dingodb
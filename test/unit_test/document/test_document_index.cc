@@ -22,6 +22,11 @@
 #include "butil/status.h"
 #include "document/codec.h"
 #include "document/document_index_factory.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+DECLARE_int32(document_index_reader_refresh_interval_ms);
+}  // namespace dingodb
 
 static size_t log_level = 1;
 
@@ -140,6 +145,10 @@ TEST(DingoDocumentIndexTest, test_default_create) {
   std::cout << "status: " << ret.error_code() << ", " << ret.error_str() << '\n';
   EXPECT_EQ(ret.ok(), true);
 
+  // reader is refreshed in background
+  ret = document_index->WaitReaderRefreshed(5000);
+  EXPECT_EQ(ret.ok(), true);
+
   {
     std::vector<dingodb::pb::common::DocumentWithScore> results;
     ret = document_index->Search(5, "discover", false, 0, INT64_MAX, false, false, {}, {}, results);
@@ -246,6 +255,10 @@ TEST(DingoDocumentIndexTest, test_load_or_create) {
   std::cout << "status: " << ret.error_code() << ", " << ret.error_str() << '\n';
   EXPECT_EQ(ret.ok(), true);
 
+  // reader is refreshed in background
+  ret = document_index->WaitReaderRefreshed(5000);
+  EXPECT_EQ(ret.ok(), true);
+
   {
     std::vector<dingodb::pb::common::DocumentWithScore> results;
     ret = document_index->Search(5, "discover", false, 0, INT64_MAX, false, false, {}, {}, results);
@@ -409,6 +422,10 @@ TEST(DingoDocumentIndexTest, test_upsert) {
   std::cout << "status: " << ret.error_code() << ", " << ret.error_str() << '\n';
   EXPECT_EQ(ret.ok(), true);
 
+  // reader is refreshed in background
+  ret = document_index->WaitReaderRefreshed(5000);
+  EXPECT_EQ(ret.ok(), true);
+
   // do upsert
   {
     document_with_ids.clear();
@@ -440,6 +457,9 @@ TEST(DingoDocumentIndexTest, test_upsert) {
     auto ret = document_index->Upsert(document_with_ids, true);
     std::cout << "status: " << ret.error_code() << ", " << ret.error_str() << '\n';
     EXPECT_EQ(ret.ok(), true);
+
+    ret = document_index->WaitReaderRefreshed(5000);
+    EXPECT_EQ(ret.ok(), true);
   }
 
   {
@@ -519,4 +539,75 @@ TEST(DingoDocumentIndexTest, test_upsert) {
     EXPECT_EQ(ret.ok(), true);
     EXPECT_EQ(results.size(), 0);
   }
-}
\ No newline at end of file
+}
+
+TEST(DingoDocumentIndexTest, test_async_refresh) {
+  std::filesystem::remove_all(kDocumentIndexTestIndexPath);
+  std::string index_path{kDocumentIndexTestIndexPath};
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, dingodb::TokenizerType> column_tokenizer_parameter;
+
+  dingodb::pb::common::DocumentIndexParameter document_index_parameter;
+  auto* text_field = document_index_parameter.mutable_scalar_schema()->add_fields();
+  text_field->set_key("text");
+  text_field->set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+  column_tokenizer_parameter["text"] = dingodb::TokenizerType::kTokenizerTypeText;
+
+  ASSERT_TRUE(dingodb::DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                                       error_message));
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  dingodb::pb::common::RegionEpoch region_epoch;
+  dingodb::pb::common::Range range;
+
+  auto document_index =
+      dingodb::DocumentIndexFactory::CreateIndex(1, index_path, document_index_parameter, region_epoch, range, true);
+  ASSERT_TRUE(document_index != nullptr);
+
+  auto gen_documents = [](int64_t start_id, int64_t count) {
+    std::vector<dingodb::pb::common::DocumentWithId> document_with_ids;
+    for (int64_t id = start_id; id < start_id + count; ++id) {
+      dingodb::pb::common::DocumentWithId document_with_id;
+      document_with_id.set_id(id);
+      dingodb::pb::common::DocumentValue document_value;
+      document_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+      document_value.mutable_field_value()->set_string_data("refresh document " + std::to_string(id));
+      document_with_id.mutable_document()->mutable_document_data()->insert({"text", document_value});
+      document_with_ids.push_back(document_with_id);
+    }
+    return document_with_ids;
+  };
+
+  // inline commit and reload, visible at once
+  dingodb::FLAGS_document_index_reader_refresh_interval_ms = 0;
+  auto ret = document_index->Add(gen_documents(1, 10), true);
+  EXPECT_EQ(ret.ok(), true);
+  {
+    std::vector<dingodb::pb::common::DocumentWithScore> results;
+    ret = document_index->Search(100, "refresh", false, 0, INT64_MAX, false, false, {}, {}, results);
+    EXPECT_EQ(ret.ok(), true);
+    EXPECT_EQ(results.size(), 10);
+  }
+
+  // small batches are coalesced, and visible after refresh
+  dingodb::FLAGS_document_index_reader_refresh_interval_ms = 50;
+  for (int64_t i = 0; i < 10; ++i) {
+    ret = document_index->Add(gen_documents(11 + i * 5, 5), true);
+    EXPECT_EQ(ret.ok(), true);
+  }
+  ret = document_index->Delete({1, 2});
+  EXPECT_EQ(ret.ok(), true);
+
+  ret = document_index->WaitReaderRefreshed(5000);
+  EXPECT_EQ(ret.ok(), true);
+  {
+    std::vector<dingodb::pb::common::DocumentWithScore> results;
+    ret = document_index->Search(100, "refresh", false, 0, INT64_MAX, false, false, {}, {}, results);
+    EXPECT_EQ(ret.ok(), true);
+    EXPECT_EQ(results.size(), 58);
+  }
+
+  dingodb::FLAGS_document_index_reader_refresh_interval_ms = 100;
+}
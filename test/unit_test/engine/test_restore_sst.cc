@@ -0,0 +1,193 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+const std::string kRestoreRootPath = "./unit_test_restore_sst";
+const std::string kRestoreLogPath = kRestoreRootPath + "/log";
+const std::string kRestoreStorePath = kRestoreRootPath + "/db";
+const std::string kRestoreBackupPath = kRestoreRootPath + "/backup";
+const std::string kRestoreDirName = "region";
+
+const std::string kRestoreYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kRestoreLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kRestoreStorePath + "\n";
+
+class RestoreSstTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kRestoreStorePath);
+    Helper::CreateDirectories(kRestoreBackupPath + "/" + kRestoreDirName);
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kRestoreYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {Constant::kStoreDataCF}));
+
+    pb::common::RegionDefinition definition;
+    definition.set_id(1001);
+    definition.mutable_range()->set_start_key("wa");
+    definition.mutable_range()->set_end_key("wz");
+    region = store::Region::New(definition);
+
+    storage_backend.mutable_local()->set_path(kRestoreBackupPath);
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRestoreRootPath);
+  }
+
+  // write a backup sst file and return its meta.
+  static pb::common::BackupDataFileValueSstMetaGroup WriteBackupSst(const std::string& file_name,
+                                                                    const std::map<std::string, std::string>& kvs) {
+    std::string file_path = kRestoreBackupPath + "/" + kRestoreDirName + "/" + file_name;
+    auto writer = RocksRawEngine::NewSstFileWriter();
+    EXPECT_TRUE(writer->SaveFile(kvs, file_path).ok());
+
+    std::string hash_code;
+    EXPECT_TRUE(Helper::CalSha1CodeWithFileEx(file_path, hash_code).ok());
+
+    pb::common::BackupDataFileValueSstMetaGroup sst_metas;
+    auto* sst_meta = sst_metas.add_backup_data_file_value_sst_metas();
+    sst_meta->set_cf(Constant::kStoreDataCF);
+    sst_meta->set_region_id(region->Id());
+    sst_meta->set_dir_name(kRestoreDirName);
+    sst_meta->set_file_name(file_name);
+    sst_meta->set_file_size(Helper::GetFileSize(file_path));
+    sst_meta->set_encryption(hash_code);
+
+    return sst_metas;
+  }
+
+  inline static std::shared_ptr<RocksRawEngine> engine;
+  inline static store::RegionPtr region;
+  inline static pb::common::StorageBackend storage_backend;
+};
+
+TEST_F(RestoreSstTest, StageAndIngest) {
+  auto sst_metas = WriteBackupSst("stage.sst", {{"wb001", "value001"}, {"wb002", "value002"}});
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+  auto status = TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, sst_metas, cf_files);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(1, cf_files[Constant::kStoreDataCF].size());
+
+  // ingest refer to the staged file, not the backup file.
+  const auto& staged_file = cf_files[Constant::kStoreDataCF][0];
+  EXPECT_EQ(0, staged_file.find(TxnEngineHelper::RestoreStagingPath(kRestoreBackupPath, region->Id())));
+  EXPECT_TRUE(Helper::IsExistPath(staged_file));
+
+  // backup files removed, replay still can ingest the staged file.
+  Helper::RemoveAllFileOrDirectory(kRestoreBackupPath + "/" + kRestoreDirName);
+  status = engine->IngestExternalFile(Constant::kStoreDataCF, cf_files[Constant::kStoreDataCF]);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  status = engine->IngestExternalFile(Constant::kStoreDataCF, cf_files[Constant::kStoreDataCF]);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  std::string value;
+  ASSERT_TRUE(engine->Reader()->KvGet(Constant::kStoreDataCF, "wb001", value).ok());
+  EXPECT_EQ("value001", value);
+  ASSERT_TRUE(engine->Reader()->KvGet(Constant::kStoreDataCF, "wb002", value).ok());
+  EXPECT_EQ("value002", value);
+
+  // staged files are removed when the restore finish.
+  TxnEngineHelper::CleanRestoreStagingFiles(kRestoreBackupPath, region->Id());
+  EXPECT_FALSE(Helper::IsExistPath(TxnEngineHelper::RestoreStagingPath(kRestoreBackupPath, region->Id())));
+
+  Helper::CreateDirectories(kRestoreBackupPath + "/" + kRestoreDirName);
+}
+
+TEST_F(RestoreSstTest, CleanLeftoverStaging) {
+  std::string staging_path = TxnEngineHelper::RestoreStagingPath(kRestoreBackupPath, region->Id());
+  std::string leftover_dir = staging_path + "/leftover";
+  ASSERT_TRUE(Helper::CreateDirectories(leftover_dir).ok());
+  std::ofstream(leftover_dir + "/leftover.sst") << "leftover";
+
+  auto sst_metas = WriteBackupSst("clean.sst", {{"wd001", "value001"}});
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+  auto status = TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, sst_metas, cf_files);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(1, cf_files[Constant::kStoreDataCF].size());
+
+  // leftover of previous restore is removed before stage.
+  EXPECT_FALSE(Helper::IsExistPath(leftover_dir));
+  EXPECT_TRUE(Helper::IsExistPath(cf_files[Constant::kStoreDataCF][0]));
+
+  TxnEngineHelper::CleanRestoreStagingFiles(kRestoreBackupPath, region->Id());
+  EXPECT_FALSE(Helper::IsExistPath(staging_path));
+}
+
+TEST_F(RestoreSstTest, RejectInvalidSst) {
+  auto sst_metas = WriteBackupSst("invalid.sst", {{"wc001", "value001"}});
+
+  std::map<std::string, std::vector<std::string>> cf_files;
+
+  // size not match
+  auto invalid_metas = sst_metas;
+  invalid_metas.mutable_backup_data_file_value_sst_metas(0)->set_file_size(1);
+  EXPECT_FALSE(TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, invalid_metas, cf_files).ok());
+
+  // sha1 not match
+  invalid_metas = sst_metas;
+  invalid_metas.mutable_backup_data_file_value_sst_metas(0)->set_encryption("0000");
+  EXPECT_FALSE(TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, invalid_metas, cf_files).ok());
+
+  // cf not allowed for raw region
+  invalid_metas = sst_metas;
+  invalid_metas.mutable_backup_data_file_value_sst_metas(0)->set_cf(Constant::kTxnWriteCF);
+  EXPECT_FALSE(TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, invalid_metas, cf_files).ok());
+
+  // file not exist
+  invalid_metas = sst_metas;
+  invalid_metas.mutable_backup_data_file_value_sst_metas(0)->set_file_name("not_exist.sst");
+  EXPECT_FALSE(TxnEngineHelper::PrepareRestoreSstFiles(region, storage_backend, invalid_metas, cf_files).ok());
+
+  EXPECT_TRUE(cf_files.empty());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "engine/txn_gc_compaction_filter.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+class TxnGcCompactionFilterTest : public testing::Test {
+ protected:
+  static std::string WriteKey(const std::string& key, int64_t commit_ts) {
+    return mvcc::Codec::EncodeKey(key, commit_ts);
+  }
+
+  static std::string WriteValue(pb::store::Op op, int64_t start_ts, const std::string& short_value = "") {
+    pb::store::WriteInfo write_info;
+    write_info.set_op(op);
+    write_info.set_start_ts(start_ts);
+    write_info.set_short_value(short_value);
+    return write_info.SerializeAsString();
+  }
+
+  static bool Filter(const TxnGcCompactionFilter& filter, const std::string& key, const std::string& value) {
+    std::string new_value;
+    std::string skip_until;
+    return filter.FilterV2(0, key, rocksdb::CompactionFilter::ValueType::kValue, value, &new_value, &skip_until) ==
+           rocksdb::CompactionFilter::Decision::kRemove;
+  }
+};
+
+TEST_F(TxnGcCompactionFilterTest, KeepNewestVersionBeforeSafePoint) {
+  TxnGcCompactionFilter filter(100);
+
+  // versions of one key are ordered from new to old.
+  EXPECT_FALSE(Filter(filter, WriteKey("key1", 120), WriteValue(pb::store::Op::Put, 110)));
+  EXPECT_FALSE(Filter(filter, WriteKey("key1", 90), WriteValue(pb::store::Op::Put, 80)));
+  // value in data column family, left to raft gc.
+  EXPECT_FALSE(Filter(filter, WriteKey("key1", 70), WriteValue(pb::store::Op::Put, 60)));
+  EXPECT_TRUE(Filter(filter, WriteKey("key1", 50), WriteValue(pb::store::Op::Put, 40, "short")));
+  EXPECT_TRUE(Filter(filter, WriteKey("key1", 30), WriteValue(pb::store::Op::Rollback, 30)));
+
+  // next key reset state.
+  EXPECT_FALSE(Filter(filter, WriteKey("key2", 90), WriteValue(pb::store::Op::Put, 80, "short")));
+  EXPECT_TRUE(Filter(filter, WriteKey("key2", 70), WriteValue(pb::store::Op::Put, 60, "short")));
+}
+
+TEST_F(TxnGcCompactionFilterTest, NewestDeleteKept) {
+  TxnGcCompactionFilter filter(100);
+
+  EXPECT_FALSE(Filter(filter, WriteKey("key1", 90), WriteValue(pb::store::Op::Delete, 80)));
+  EXPECT_TRUE(Filter(filter, WriteKey("key1", 70), WriteValue(pb::store::Op::Delete, 65)));
+  EXPECT_TRUE(Filter(filter, WriteKey("key1", 50), WriteValue(pb::store::Op::Put, 40, "short")));
+  EXPECT_FALSE(Filter(filter, WriteKey("key1", 30), WriteValue(pb::store::Op::Put, 20)));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+
+#include "proto/common.pb.h"
+#include "store/heartbeat.h"
+
+class HeartbeatDeltaTest : public testing::Test {};
+
+static dingodb::pb::common::RegionMetrics GenRegionMetrics(int64_t leader_store_id, int64_t row_count) {
+  dingodb::pb::common::RegionMetrics region_metrics;
+  region_metrics.set_id(1001);
+  region_metrics.set_leader_store_id(leader_store_id);
+  region_metrics.set_store_region_state(dingodb::pb::common::StoreRegionState::NORMAL);
+  region_metrics.set_row_count(row_count);
+  region_metrics.set_region_size(row_count * 100);
+  return region_metrics;
+}
+
+TEST_F(HeartbeatDeltaTest, DigestIsChanged) {
+  dingodb::pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  auto digest = dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(1, 1000), epoch);
+
+  // small row_count change is under threshold
+  EXPECT_FALSE(dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(1, 1050), epoch).IsChanged(digest, 0.1));
+  EXPECT_TRUE(dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(1, 1200), epoch).IsChanged(digest, 0.1));
+
+  // leader change
+  EXPECT_TRUE(dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(2, 1000), epoch).IsChanged(digest, 0.1));
+
+  // epoch change
+  epoch.set_version(2);
+  EXPECT_TRUE(dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(1, 1000), epoch).IsChanged(digest, 0.1));
+}
+
+TEST_F(HeartbeatDeltaTest, DigestLoadIsChanged) {
+  dingodb::pb::common::RegionEpoch epoch;
+
+  auto region_metrics = GenRegionMetrics(1, 1000);
+  region_metrics.mutable_load_metrics()->set_write_qps(1000);
+  auto digest = dingodb::RegionMetricsDigest::Gen(region_metrics, epoch);
+
+  // idle region jitter is ignored
+  auto idle_metrics = GenRegionMetrics(1, 1000);
+  idle_metrics.mutable_load_metrics()->set_read_qps(10);
+  idle_metrics.mutable_load_metrics()->set_write_qps(1000);
+  EXPECT_FALSE(dingodb::RegionMetricsDigest::Gen(idle_metrics, epoch).IsChanged(digest, 0.1));
+
+  // hot region
+  region_metrics.mutable_load_metrics()->set_write_qps(5000);
+  EXPECT_TRUE(dingodb::RegionMetricsDigest::Gen(region_metrics, epoch).IsChanged(digest, 0.1));
+}
+
+TEST_F(HeartbeatDeltaTest, TrackerVersion) {
+  dingodb::RegionMetricsDeltaTracker tracker;
+  dingodb::pb::common::RegionEpoch epoch;
+  auto digest = dingodb::RegionMetricsDigest::Gen(GenRegionMetrics(1, 1000), epoch);
+
+  // first report is always full
+  int64_t version = 0;
+  int64_t base_version = 0;
+  EXPECT_FALSE(tracker.Begin(version, base_version));
+  EXPECT_EQ(1, version);
+  EXPECT_EQ(0, base_version);
+  EXPECT_TRUE(tracker.IsChanged(1001, digest));
+
+  std::map<int64_t, dingodb::RegionMetricsDigest> reported_digests = {{1001, digest}};
+  tracker.Commit(version, false, reported_digests);
+  EXPECT_FALSE(tracker.IsChanged(1001, digest));
+
+  // next report is delta based on acknowledged version
+  EXPECT_TRUE(tracker.Begin(version, base_version));
+  EXPECT_EQ(2, version);
+  EXPECT_EQ(1, base_version);
+
+  // lost heartbeat force a full report
+  tracker.ForceFull();
+  EXPECT_FALSE(tracker.Begin(version, base_version));
+  EXPECT_EQ(3, version);
+  EXPECT_EQ(1, base_version);
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "coordinator/kv_watch_hub.h"
+
+namespace dingodb {
+
+class KvWatchIndexTest : public testing::Test {};
+
+static KvWatcherPtr GenWatcher(int64_t id, const std::string& key, bool is_prefix) {
+  auto watcher = std::make_shared<KvWatcher>();
+  watcher->id = id;
+  watcher->key = key;
+  watcher->is_prefix = is_prefix;
+  return watcher;
+}
+
+static std::vector<int64_t> MatchIds(KvWatchIndex& index, const std::string& key) {
+  std::vector<int64_t> ids;
+  for (auto& watcher : index.Match(key)) {
+    ids.push_back(watcher->id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+TEST_F(KvWatchIndexTest, Match) {
+  KvWatchIndex index(8, 4);
+
+  // short prefix in short shard, others in sharded trie
+  index.Add(GenWatcher(1, "ab", true));
+  index.Add(GenWatcher(2, "abcd", true));
+  index.Add(GenWatcher(3, "abcdef", true));
+  index.Add(GenWatcher(4, "abcdef", false));
+  index.Add(GenWatcher(5, "abc", false));
+  index.Add(GenWatcher(6, "xyz1", true));
+  EXPECT_EQ(6, index.WatcherCount());
+
+  EXPECT_EQ(std::vector<int64_t>({1, 2, 3, 4}), MatchIds(index, "abcdef"));
+  EXPECT_EQ(std::vector<int64_t>({1, 2, 3}), MatchIds(index, "abcdefg"));
+  EXPECT_EQ(std::vector<int64_t>({1, 2}), MatchIds(index, "abcdx"));
+  EXPECT_EQ(std::vector<int64_t>({1, 5}), MatchIds(index, "abc"));
+  EXPECT_EQ(std::vector<int64_t>({1}), MatchIds(index, "ab"));
+  EXPECT_EQ(std::vector<int64_t>({6}), MatchIds(index, "xyz123"));
+  EXPECT_TRUE(MatchIds(index, "a").empty());
+  EXPECT_TRUE(MatchIds(index, "xyz").empty());
+}
+
+TEST_F(KvWatchIndexTest, Remove) {
+  KvWatchIndex index(8, 4);
+
+  auto watcher1 = GenWatcher(1, "abcd", true);
+  auto watcher2 = GenWatcher(2, "abcdef", false);
+  index.Add(watcher1);
+  index.Add(watcher2);
+
+  index.Remove(watcher2);
+  EXPECT_EQ(1, index.WatcherCount());
+  EXPECT_EQ(std::vector<int64_t>({1}), MatchIds(index, "abcdef"));
+
+  // remove again is ignored
+  index.Remove(watcher2);
+  EXPECT_EQ(1, index.WatcherCount());
+
+  index.Remove(watcher1);
+  EXPECT_EQ(0, index.WatcherCount());
+  EXPECT_TRUE(MatchIds(index, "abcdef").empty());
+
+  // pruned node can be added again
+  index.Add(watcher2);
+  EXPECT_EQ(std::vector<int64_t>({2}), MatchIds(index, "abcdef"));
+}
+
+static pb::version::Event GenEvent(pb::version::Event::EventType type, const std::string& key, int64_t revision) {
+  pb::version::Event event;
+  event.set_type(type);
+  event.mutable_kv()->mutable_kv()->set_key(key);
+  event.mutable_kv()->set_mod_revision(revision);
+  return event;
+}
+
+static std::vector<int64_t> EventRevisions(const std::vector<pb::version::Event>& events) {
+  std::vector<int64_t> revisions;
+  for (const auto& event : events) {
+    revisions.push_back(event.kv().mod_revision());
+  }
+  return revisions;
+}
+
+TEST(KvWatchStreamTest, FilterBufferedEvents) {
+  const auto kPut = pb::version::Event::EventType::Event_EventType_PUT;
+  const auto kDelete = pb::version::Event::EventType::Event_EventType_DELETE;
+
+  // PUT x@10, DEL x@11, PUT y@12 are applied while replay, replay only see y@12.
+  std::vector<pb::version::Event> buffered_events = {GenEvent(kPut, "x", 10), GenEvent(kDelete, "x", 11),
+                                                     GenEvent(kPut, "y", 12)};
+  std::vector<pb::version::Event> replay_events = {GenEvent(kPut, "y", 12)};
+
+  auto events = KvWatchStream::FilterBufferedEvents(replay_events, buffered_events);
+  EXPECT_EQ(std::vector<int64_t>({10, 11}), EventRevisions(events));
+  EXPECT_EQ(kDelete, events[1].type());
+
+  // events after replay are all kept
+  buffered_events.push_back(GenEvent(kPut, "y", 13));
+  buffered_events.push_back(GenEvent(kDelete, "y", 14));
+  events = KvWatchStream::FilterBufferedEvents(replay_events, buffered_events);
+  EXPECT_EQ(std::vector<int64_t>({10, 11, 13, 14}), EventRevisions(events));
+
+  // nothing replayed, e.g. no_put_event
+  events = KvWatchStream::FilterBufferedEvents({}, buffered_events);
+  EXPECT_EQ(5, events.size());
+}
+
+TEST(KvWatchStreamTest, MergeSyncEvents) {
+  const auto kPut = pb::version::Event::EventType::Event_EventType_PUT;
+  const auto kDelete = pb::version::Event::EventType::Event_EventType_DELETE;
+
+  // PUT x@10, DEL x@11, PUT y@12 are applied while replay, replay see y@12 and z@5.
+  std::vector<pb::version::Event> buffered_events = {GenEvent(kPut, "x", 10), GenEvent(kDelete, "x", 11),
+                                                     GenEvent(kPut, "y", 12), GenEvent(kPut, "y", 12)};
+  std::vector<pb::version::Event> replay_events = {GenEvent(kPut, "y", 12), GenEvent(kPut, "z", 5)};
+
+  // the watcher see one sequence in global revision order, y@12 only once.
+  auto events = KvWatchStream::MergeSyncEvents(replay_events, buffered_events);
+  EXPECT_EQ(std::vector<int64_t>({5, 10, 11, 12}), EventRevisions(events));
+  EXPECT_EQ("z", events[0].kv().kv().key());
+  EXPECT_EQ(kDelete, events[2].type());
+  EXPECT_EQ("y", events[3].kv().kv().key());
+
+  // replay only
+  events = KvWatchStream::MergeSyncEvents(replay_events, {});
+  EXPECT_EQ(std::vector<int64_t>({5, 12}), EventRevisions(events));
+}
+
+}  // namespace dingodb
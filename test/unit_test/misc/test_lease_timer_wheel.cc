@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "coordinator/lease_timer_wheel.h"
+
+namespace dingodb {
+
+class LeaseTimerWheelTest : public testing::Test {};
+
+static std::vector<int64_t> Sorted(std::vector<int64_t> lease_ids) {
+  std::sort(lease_ids.begin(), lease_ids.end());
+  return lease_ids;
+}
+
+TEST_F(LeaseTimerWheelTest, Expire) {
+  LeaseTimerWheel wheel(4, 100, 0);
+
+  wheel.Add(1, 1000);
+  wheel.Add(2, 3000);
+  // cross level 1 and level 2
+  wheel.Add(3, 100 * 64 * 10);
+  wheel.Add(4, 100 * 64 * 64 * 3);
+  EXPECT_EQ(4, wheel.Size());
+
+  EXPECT_TRUE(wheel.Advance(900).empty());
+  EXPECT_EQ(std::vector<int64_t>({1}), wheel.Advance(1000));
+  EXPECT_TRUE(wheel.Advance(2900).empty());
+  EXPECT_EQ(std::vector<int64_t>({2}), wheel.Advance(3050));
+  EXPECT_TRUE(wheel.Advance(100 * 64 * 10 - 100).empty());
+  EXPECT_EQ(std::vector<int64_t>({3}), wheel.Advance(100 * 64 * 10));
+  EXPECT_TRUE(wheel.Advance(100 * 64 * 64 * 3 - 100).empty());
+  EXPECT_EQ(std::vector<int64_t>({4}), wheel.Advance(100 * 64 * 64 * 3));
+  EXPECT_EQ(0, wheel.Size());
+}
+
+TEST_F(LeaseTimerWheelTest, RenewAndRemove) {
+  LeaseTimerWheel wheel(4, 100, 0);
+
+  wheel.Add(1, 1000);
+  wheel.Add(2, 1000);
+  wheel.Add(3, 1000);
+
+  EXPECT_TRUE(wheel.Renew(1, 5000));
+  // shorten deadline
+  EXPECT_TRUE(wheel.Renew(2, 500));
+  EXPECT_FALSE(wheel.Renew(4, 5000));
+  wheel.Remove(3);
+
+  EXPECT_EQ(std::vector<int64_t>({2}), wheel.Advance(500));
+  EXPECT_TRUE(wheel.Advance(4900).empty());
+  EXPECT_EQ(std::vector<int64_t>({1}), wheel.Advance(5000));
+  EXPECT_EQ(0, wheel.Size());
+}
+
+TEST_F(LeaseTimerWheelTest, AddDueAndClear) {
+  LeaseTimerWheel wheel(4, 100, 10000);
+
+  // already due, expire at next tick
+  wheel.Add(1, 5000);
+  wheel.Add(2, 20000);
+  EXPECT_EQ(std::vector<int64_t>({1}), wheel.Advance(10100));
+
+  // readd after expired
+  wheel.Add(1, 11000);
+  EXPECT_EQ(Sorted({1, 2}), Sorted(wheel.Advance(30000)));
+
+  wheel.Add(3, 40000);
+  wheel.Clear(30000);
+  EXPECT_EQ(0, wheel.Size());
+  EXPECT_TRUE(wheel.Advance(50000).empty());
+}
+
+}  // namespace dingodb
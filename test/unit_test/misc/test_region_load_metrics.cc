@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "metrics/region_load_metrics.h"
+
+class RegionLoadMetricsTest : public testing::Test {};
+
+TEST_F(RegionLoadMetricsTest, Aggregate) {
+  auto load_metrics = dingodb::RegionLoadMetrics::New(1001);
+
+  // first aggregate only take the baseline
+  load_metrics->AddRead(10, 1000);
+  EXPECT_FALSE(load_metrics->Aggregate(10000));
+  EXPECT_EQ(0, load_metrics->Rates().read_count);
+
+  // update from multiple threads
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&load_metrics]() {
+      for (int j = 0; j < 500; ++j) {
+        load_metrics->AddRead(2, 100);
+        load_metrics->AddWrite(1, 200);
+        load_metrics->IncRaftCommit();
+        load_metrics->IncRaftApply();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // too short interval
+  EXPECT_FALSE(load_metrics->Aggregate(10010));
+
+  // 2000 requests in 2 seconds
+  EXPECT_TRUE(load_metrics->Aggregate(12000));
+  auto rates = load_metrics->Rates();
+  EXPECT_EQ(1000, rates.read_count);
+  EXPECT_EQ(2000, rates.read_keys);
+  EXPECT_EQ(100000, rates.read_bytes);
+  EXPECT_EQ(1000, rates.write_count);
+  EXPECT_EQ(1000, rates.write_keys);
+  EXPECT_EQ(200000, rates.write_bytes);
+  EXPECT_EQ(1000, rates.raft_commit_count);
+  EXPECT_EQ(1000, rates.raft_apply_count);
+
+  // idle region
+  EXPECT_TRUE(load_metrics->Aggregate(13000));
+  EXPECT_EQ(0, load_metrics->Rates().read_count);
+  EXPECT_EQ(0, load_metrics->Rates().write_bytes);
+}
+
+TEST_F(RegionLoadMetricsTest, Disabled) {
+  struct Message {
+    int64_t ByteSizeLong() const {
+      ++byte_size_count;
+      return 100;
+    }
+    mutable int byte_size_count{0};
+  };
+
+  auto load_metrics = dingodb::RegionLoadMetrics::New(1002);
+  EXPECT_FALSE(load_metrics->Aggregate(10000));
+
+  Message message;
+  load_metrics->AddRead(1, &message);
+  load_metrics->AddWrite(1, &message);
+  EXPECT_EQ(2, message.byte_size_count);
+
+  // message size is not calculated when disabled
+  dingodb::FLAGS_enable_region_load_metrics = false;
+  load_metrics->AddRead(1, &message);
+  load_metrics->AddWrite(1, &message);
+  load_metrics->AddRead(1, 100);
+  dingodb::FLAGS_enable_region_load_metrics = true;
+  EXPECT_EQ(2, message.byte_size_count);
+
+  EXPECT_TRUE(load_metrics->Aggregate(11000));
+  EXPECT_EQ(1, load_metrics->Rates().read_count);
+  EXPECT_EQ(100, load_metrics->Rates().read_bytes);
+  EXPECT_EQ(1, load_metrics->Rates().write_count);
+  EXPECT_EQ(100, load_metrics->Rates().write_bytes);
+}
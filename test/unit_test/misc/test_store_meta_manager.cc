@@ -41,4 +41,39 @@ TEST_F(StoreRegionMetaTest, AddRegion) {
   auto region = store_region_mata->GetRegion(1001);
   EXPECT_NE(nullptr, region);
   EXPECT_EQ(1001, region->Id());
-}
\ No newline at end of file
+}
+
+TEST_F(StoreRegionMetaTest, RegionDescriptor) {
+  dingodb::pb::common::RegionDefinition definition;
+  definition.set_id(1002);
+  definition.mutable_epoch()->set_conf_version(1);
+  definition.mutable_epoch()->set_version(1);
+  definition.mutable_range()->set_start_key("a");
+  definition.mutable_range()->set_end_key("c");
+  auto region = dingodb::store::Region::New(definition);
+
+  auto old_descriptor = region->Descriptor();
+  EXPECT_EQ(1, old_descriptor->epoch.version());
+  EXPECT_EQ("a", old_descriptor->range.start_key());
+  EXPECT_EQ(dingodb::pb::common::StoreRegionState::NEW, old_descriptor->state);
+
+  dingodb::pb::common::Range range;
+  range.set_start_key("a");
+  range.set_end_key("b");
+  region->SetEpochVersionAndRange(2, range);
+  region->SetState(dingodb::pb::common::StoreRegionState::NORMAL);
+  region->SetLeaderId(1001);
+
+  // old descriptor is immutable
+  EXPECT_EQ(1, old_descriptor->epoch.version());
+  EXPECT_EQ("c", old_descriptor->range.end_key());
+
+  auto descriptor = region->Descriptor();
+  EXPECT_EQ(2, descriptor->epoch.version());
+  EXPECT_EQ("b", descriptor->range.end_key());
+  EXPECT_EQ(dingodb::pb::common::StoreRegionState::NORMAL, descriptor->state);
+  EXPECT_EQ(1001, descriptor->leader_id);
+  EXPECT_EQ(region->Range(true).start_key(), descriptor->encode_range.start_key());
+  EXPECT_TRUE(region->CheckKeyInRange("a1"));
+  EXPECT_FALSE(region->CheckKeyInRange("b1"));
+}
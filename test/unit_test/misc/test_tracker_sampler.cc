@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "common/tracker.h"
+#include "gflags/gflags.h"
+#include "metrics/tracker_sampler.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_int32(tracker_slow_request_num);
+
+class TrackerSamplerTest : public testing::Test {
+ protected:
+  void SetUp() override { TrackerSampler::GetInstance().ClearSlowRequests(); }
+  void TearDown() override { TrackerSampler::GetInstance().ClearSlowRequests(); }
+};
+
+static TrackerPtr GenTracker(int64_t request_id, uint64_t lock_check_time_ns) {
+  pb::common::RequestInfo request_info;
+  request_info.set_request_id(request_id);
+  auto tracker = Tracker::New(request_info);
+  tracker->AddLockCheckTime(lock_check_time_ns);
+  tracker->AddLockCheckTime(lock_check_time_ns);
+  tracker->SetTotalRpcTime();
+  return tracker;
+}
+
+TEST_F(TrackerSamplerTest, SlowestRequests) {
+  int32_t old_slow_request_num = FLAGS_tracker_slow_request_num;
+  FLAGS_tracker_slow_request_num = 3;
+
+  auto& sampler = TrackerSampler::GetInstance();
+  std::vector<TrackerPtr> trackers;
+  for (int i = 1; i <= 10; ++i) {
+    trackers.push_back(GenTracker(i, i * 1000));
+  }
+  // total rpc time is increasing with request id
+  uint64_t max_total_time_ns = 0;
+  for (auto& tracker : trackers) {
+    max_total_time_ns = std::max(max_total_time_ns, tracker->TotalRpcTime());
+    sampler.Sample("TxnBatchGet", 1001, tracker);
+  }
+
+  auto slow_requests = sampler.GetSlowRequests();
+  ASSERT_EQ(3, slow_requests.size());
+  EXPECT_EQ(max_total_time_ns, slow_requests[0].metrics.total_rpc_time_ns);
+  for (size_t i = 1; i < slow_requests.size(); ++i) {
+    EXPECT_GE(slow_requests[i - 1].metrics.total_rpc_time_ns, slow_requests[i].metrics.total_rpc_time_ns);
+  }
+  for (auto& slow_request : slow_requests) {
+    EXPECT_EQ("TxnBatchGet", slow_request.method);
+    EXPECT_EQ(1001, slow_request.region_id);
+    // stage is accumulated
+    EXPECT_EQ(slow_request.request_id * 2000, slow_request.metrics.lock_check_time_ns);
+  }
+
+  sampler.ClearSlowRequests();
+  EXPECT_TRUE(sampler.GetSlowRequests().empty());
+
+  FLAGS_tracker_slow_request_num = old_slow_request_num;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,143 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/helper.h"
+#include "coordinator/tso_control.h"
+#include "google/protobuf/stubs/callback.h"
+#include "proto/error.pb.h"
+#include "proto/meta.pb.h"
+
+namespace dingodb {
+
+class TsoControlTest : public testing::Test {
+ protected:
+  struct Request {
+    pb::meta::TsoRequest request;
+    pb::meta::TsoResponse response;
+    GenTsoTask task;
+  };
+
+  static std::vector<std::unique_ptr<Request>> GenRequests(const std::vector<int64_t>& counts,
+                                                           std::vector<int>& done_order) {
+    std::vector<std::unique_ptr<Request>> requests;
+    for (int i = 0; i < static_cast<int>(counts.size()); ++i) {
+      auto request = std::make_unique<Request>();
+      request->request.set_op_type(pb::meta::OP_GEN_TSO);
+      request->request.set_count(counts[i]);
+      request->task.request = &request->request;
+      request->task.response = &request->response;
+      request->task.done = google::protobuf::NewCallback(&RecordDone, &done_order, i);
+      requests.push_back(std::move(request));
+    }
+    return requests;
+  }
+
+  static std::vector<GenTsoTask*> GetTasks(std::vector<std::unique_ptr<Request>>& requests) {
+    std::vector<GenTsoTask*> tasks;
+    for (auto& request : requests) {
+      tasks.push_back(&request->task);
+    }
+    return tasks;
+  }
+
+  static void UpdateTso(TsoControl& tso_control, int64_t physical) {
+    pb::meta::TsoRequest request;
+    request.set_op_type(pb::meta::OP_UPDATE_TSO);
+    request.mutable_current_timestamp()->set_physical(physical);
+    request.set_save_physical(physical + 3000);
+    pb::meta::TsoResponse response;
+    tso_control.UpdateTso(request, &response);
+    ASSERT_EQ(pb::error::OK, response.error().errcode());
+  }
+
+ private:
+  static void RecordDone(std::vector<int>* done_order, int index) { done_order->push_back(index); }
+};
+
+TEST_F(TsoControlTest, GenTsoBatchInOrder) {
+  TsoControl tso_control;
+  UpdateTso(tso_control, 1735627140000);
+
+  std::vector<int> done_order;
+  auto requests = GenRequests({2, 1, 3, 0}, done_order);
+  // error is set before queued, e.g. not leader
+  requests[1]->response.mutable_error()->set_errcode(pb::error::ERAFT_NOTLEADER);
+
+  auto tasks = GetTasks(requests);
+  tso_control.GenTsoBatch(tasks);
+
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), done_order);
+
+  EXPECT_EQ(pb::error::OK, requests[0]->response.error().errcode());
+  EXPECT_EQ(pb::error::ERAFT_NOTLEADER, requests[1]->response.error().errcode());
+  EXPECT_FALSE(requests[1]->response.has_start_timestamp());
+  EXPECT_EQ(pb::error::OK, requests[2]->response.error().errcode());
+  EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS, requests[3]->response.error().errcode());
+
+  // continuous range split by count
+  const auto& first = requests[0]->response.start_timestamp();
+  const auto& second = requests[2]->response.start_timestamp();
+  EXPECT_EQ(first.physical(), second.physical());
+  EXPECT_EQ(first.logical() + 2, second.logical());
+  EXPECT_EQ(3, requests[2]->response.count());
+}
+
+TEST_F(TsoControlTest, GenTsoBatchRetryNotReady) {
+  TsoControl tso_control;
+
+  // timestamp is not ready, keep the tasks unreplied for next batch.
+  std::vector<int> done_order;
+  auto requests = GenRequests({1, 2, 1}, done_order);
+  requests[2]->response.mutable_error()->set_errcode(pb::error::ERAFT_NOTLEADER);
+  auto tasks = GetTasks(requests);
+
+  EXPECT_FALSE(tso_control.GenTsoBatch(tasks, false));
+  EXPECT_TRUE(done_order.empty());
+
+  // timestamp is ready, all tasks are replied in order.
+  UpdateTso(tso_control, 1735627140000);
+  EXPECT_TRUE(tso_control.GenTsoBatch(tasks, false));
+
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), done_order);
+  EXPECT_EQ(pb::error::OK, requests[0]->response.error().errcode());
+  EXPECT_EQ(pb::error::OK, requests[1]->response.error().errcode());
+  EXPECT_EQ(pb::error::ERAFT_NOTLEADER, requests[2]->response.error().errcode());
+  EXPECT_EQ(requests[0]->response.start_timestamp().logical() + 1,
+            requests[1]->response.start_timestamp().logical());
+}
+
+TEST_F(TsoControlTest, GenTsoBatchNotWait) {
+  TsoControl tso_control;
+
+  // timestamp is not ready at the last try, reply retry later instead of waiting in consumer.
+  std::vector<int> done_order;
+  auto requests = GenRequests({1, 1}, done_order);
+  auto tasks = GetTasks(requests);
+
+  int64_t start_time = Helper::TimestampMs();
+  tso_control.GenTsoBatch(tasks);
+  EXPECT_LT(Helper::TimestampMs() - start_time, 1000);
+
+  EXPECT_EQ(std::vector<int>({0, 1}), done_order);
+  EXPECT_EQ(pb::error::ERETRY_LATER, requests[0]->response.error().errcode());
+  EXPECT_EQ(pb::error::ERETRY_LATER, requests[1]->response.error().errcode());
+}
+
+}  // namespace dingodb
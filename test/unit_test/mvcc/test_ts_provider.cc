@@ -18,6 +18,7 @@
 #include <chrono>
 #include <cstdint>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -26,8 +27,13 @@
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "mvcc/ts_provider.h"
 
+DECLARE_uint32(ts_provider_batch_size);
+DECLARE_uint32(ts_provider_max_batch_size);
+DECLARE_bool(ts_provider_enable_adaptive_prefetch);
+
 namespace dingodb {
 
 const uint32_t kBatchTsSzie = 100;
@@ -86,6 +92,26 @@ TEST_F(BatchTsListTest, SingleThread) {
   EXPECT_EQ(1, batch_ts_list.ActualCount());
 }
 
+TEST_F(BatchTsListTest, Remain) {
+  mvcc::BatchTsList batch_ts_list;
+  EXPECT_EQ(0, batch_ts_list.Remain());
+
+  int push_size = 3;
+  for (int i = 0; i < push_size; ++i) {
+    batch_ts_list.Push(GenBatchTs());
+  }
+  EXPECT_EQ(push_size * kBatchTsSzie, batch_ts_list.Remain());
+
+  int get_size = kBatchTsSzie + 10;
+  for (int i = 0; i < get_size; ++i) {
+    ASSERT_GT(batch_ts_list.GetTs(), 0);
+  }
+  EXPECT_EQ(push_size * kBatchTsSzie - get_size, batch_ts_list.Remain());
+
+  batch_ts_list.Flush();
+  EXPECT_EQ(0, batch_ts_list.Remain());
+}
+
 TEST_F(BatchTsListTest, MultiThread) {
   mvcc::BatchTsList batch_ts_list;
 
@@ -236,6 +262,97 @@ class TsProviderTest : public testing::Test {
   void TearDown() override {}
 };
 
+// take BatchTs from local instead of tso service.
+class LocalTsProvider : public mvcc::TsProvider {
+ public:
+  LocalTsProvider() : mvcc::TsProvider(nullptr) {}
+
+  uint32_t LastBatchSize() const { return last_batch_size_.load(); }
+
+ protected:
+  mvcc::BatchTs* SendTsoRequest(uint32_t batch_size) override {
+    last_batch_size_.store(batch_size);
+    auto* batch_ts = mvcc::BatchTs::New(physical_, logical_, batch_size);
+    logical_ += batch_size;
+    return batch_ts;
+  }
+
+ private:
+  int64_t physical_{Helper::TimestampMs()};
+  int64_t logical_{0};
+  std::atomic<uint32_t> last_batch_size_{0};
+};
+
+static void WaitRenewEpoch(std::shared_ptr<LocalTsProvider> ts_provider, uint64_t renew_epoch) {
+  for (int i = 0; i < 1000 && ts_provider->RenewEpoch() < renew_epoch; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_GE(ts_provider->RenewEpoch(), renew_epoch);
+}
+
+TEST_F(TsProviderTest, PrefetchBelowWatermark) {
+  ASSERT_TRUE(FLAGS_ts_provider_enable_adaptive_prefetch);
+  ASSERT_EQ(100U, FLAGS_ts_provider_batch_size);
+
+  auto ts_provider = std::make_shared<LocalTsProvider>();
+  ASSERT_TRUE(ts_provider->Init());
+  ASSERT_EQ(25, ts_provider->Watermark());
+
+  // first GetTs stall on synchronous renew
+  ASSERT_GT(ts_provider->GetTs(), 0);
+  EXPECT_EQ(1U, ts_provider->StallCount());
+  EXPECT_EQ(99, ts_provider->Remain());
+
+  // remain not below watermark, no prefetch
+  for (int i = 0; i < 74; ++i) {
+    ASSERT_GT(ts_provider->GetTs(), 0);
+  }
+  EXPECT_EQ(25, ts_provider->Remain());
+  EXPECT_EQ(0U, ts_provider->PrefetchCount());
+
+  // remain below watermark, prefetch next BatchTs asynchronously
+  ASSERT_GT(ts_provider->GetTs(), 0);
+  EXPECT_EQ(1U, ts_provider->PrefetchCount());
+  WaitRenewEpoch(ts_provider, 2);
+  EXPECT_EQ(24 + 100, ts_provider->Remain());
+
+  // consume the prefetched ts without stall
+  for (int i = 0; i < 124; ++i) {
+    ASSERT_GT(ts_provider->GetTs(), 0);
+  }
+  EXPECT_EQ(1U, ts_provider->StallCount());
+}
+
+TEST_F(TsProviderTest, AdaptiveBatchSize) {
+  ASSERT_TRUE(FLAGS_ts_provider_enable_adaptive_prefetch);
+
+  auto ts_provider = std::make_shared<LocalTsProvider>();
+  ASSERT_TRUE(ts_provider->Init());
+  EXPECT_EQ(FLAGS_ts_provider_batch_size, ts_provider->BatchSize());
+
+  // fast consumption, batch size grow
+  for (int i = 0; i < 200000; ++i) {
+    ASSERT_GT(ts_provider->GetTs(), 0);
+  }
+  uint32_t grown_batch_size = ts_provider->BatchSize();
+  EXPECT_GT(grown_batch_size, FLAGS_ts_provider_batch_size);
+  EXPECT_LE(grown_batch_size, FLAGS_ts_provider_max_batch_size);
+  EXPECT_GE(ts_provider->Watermark(), grown_batch_size / 4);
+  EXPECT_GT(ts_provider->LastBatchSize(), FLAGS_ts_provider_batch_size);
+
+  // slow consumption, batch size shrink to min
+  for (int i = 0; i < 40; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_GT(ts_provider->GetTs(), 0);
+
+    uint64_t renew_epoch = ts_provider->RenewEpoch();
+    ts_provider->TriggerRenewBatchTs();
+    WaitRenewEpoch(ts_provider, renew_epoch + 1);
+  }
+  EXPECT_LT(ts_provider->BatchSize(), grown_batch_size);
+  EXPECT_EQ(FLAGS_ts_provider_batch_size, ts_provider->BatchSize());
+}
+
 TEST_F(TsProviderTest, GetTs) {
   GTEST_SKIP() << "skip long time run.";
 
@@ -277,4 +394,4 @@ TEST_F(TsProviderTest, GetTs) {
   }
 }
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "common/helper.h"
+#include "engine/txn_lock_wait_manager.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_int64(txn_lock_wait_max_timeout_ms);
+
+class TxnLockWaitManagerTest : public testing::Test {};
+
+TEST_F(TxnLockWaitManagerTest, DetectDeadlock) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  std::atomic<int> woken_count = 0;
+  std::vector<int64_t> wait_chain;
+
+  // txn 100 wait txn 200, txn 200 wait txn 300
+  EXPECT_EQ(TxnLockWaitManager::WaitResult::kWaiting,
+            manager.Wait("deadlock_key_a", 100, 200, 10000, [&woken_count]() { ++woken_count; }, wait_chain));
+  EXPECT_EQ(TxnLockWaitManager::WaitResult::kWaiting,
+            manager.Wait("deadlock_key_b", 200, 300, 10000, [&woken_count]() { ++woken_count; }, wait_chain));
+
+  // txn 300 wait txn 100 is a deadlock
+  EXPECT_EQ(TxnLockWaitManager::WaitResult::kDeadlock,
+            manager.Wait("deadlock_key_c", 300, 100, 10000, [&woken_count]() { ++woken_count; }, wait_chain));
+  EXPECT_EQ(std::vector<int64_t>({100, 200, 300}), wait_chain);
+
+  manager.WakeUp(std::vector<std::string>{"deadlock_key_a", "deadlock_key_b"});
+  EXPECT_EQ(2, woken_count.load());
+  EXPECT_EQ(0, manager.WaiterCount());
+
+  // no deadlock after the waiters leave
+  EXPECT_EQ(TxnLockWaitManager::WaitResult::kWaiting,
+            manager.Wait("deadlock_key_c", 300, 100, 10000, [&woken_count]() { ++woken_count; }, wait_chain));
+  manager.WakeUp("deadlock_key_c");
+  EXPECT_EQ(3, woken_count.load());
+}
+
+TEST_F(TxnLockWaitManagerTest, WakeUpInOrder) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  std::vector<int64_t> woken_txns;
+  bthread::Mutex mutex;
+  std::vector<int64_t> wait_chain;
+  for (int64_t start_ts = 1001; start_ts <= 1003; ++start_ts) {
+    EXPECT_EQ(TxnLockWaitManager::WaitResult::kWaiting, manager.Wait(
+                                                            "order_key", start_ts, 1000, 10000,
+                                                            [&woken_txns, &mutex, start_ts]() {
+                                                              std::lock_guard<bthread::Mutex> guard(mutex);
+                                                              woken_txns.push_back(start_ts);
+                                                            },
+                                                            wait_chain));
+  }
+
+  // head waiter is woken at once, the others later
+  manager.WakeUp("order_key");
+  {
+    std::lock_guard<bthread::Mutex> guard(mutex);
+    EXPECT_EQ(std::vector<int64_t>({1001}), woken_txns);
+  }
+
+  bthread_usleep(500 * 1000);
+  {
+    std::lock_guard<bthread::Mutex> guard(mutex);
+    EXPECT_EQ(std::vector<int64_t>({1001, 1002, 1003}), woken_txns);
+  }
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+TEST_F(TxnLockWaitManagerTest, WaitTimeout) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  std::atomic<int> woken_count = 0;
+  std::vector<int64_t> wait_chain;
+  EXPECT_EQ(TxnLockWaitManager::WaitResult::kWaiting,
+            manager.Wait("timeout_key", 2001, 2000, 50, [&woken_count]() { ++woken_count; }, wait_chain));
+
+  bthread_usleep(500 * 1000);
+  EXPECT_EQ(1, woken_count.load());
+  EXPECT_EQ(0, manager.WaiterCount());
+
+  // wake up after timeout is no-op
+  manager.WakeUp("timeout_key");
+  EXPECT_EQ(1, woken_count.load());
+}
+
+TEST_F(TxnLockWaitManagerTest, CalcWaitDeadlineMs) {
+  // not set or invalid, not wait
+  EXPECT_EQ(0, TxnLockWaitManager::CalcWaitDeadlineMs(0));
+  EXPECT_EQ(0, TxnLockWaitManager::CalcWaitDeadlineMs(-1));
+
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t deadline_ms = TxnLockWaitManager::CalcWaitDeadlineMs(100);
+  EXPECT_GE(deadline_ms, now_ms + 100);
+  EXPECT_LT(deadline_ms, now_ms + 100 + 1000);
+
+  // capped by max timeout
+  now_ms = Helper::TimestampMs();
+  deadline_ms = TxnLockWaitManager::CalcWaitDeadlineMs(FLAGS_txn_lock_wait_max_timeout_ms * 10);
+  EXPECT_GE(deadline_ms, now_ms + FLAGS_txn_lock_wait_max_timeout_ms);
+  EXPECT_LT(deadline_ms, now_ms + FLAGS_txn_lock_wait_max_timeout_ms + 1000);
+}
+
+}  // namespace dingodb
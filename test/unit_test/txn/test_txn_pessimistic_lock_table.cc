@@ -0,0 +1,241 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/stream.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "engine/txn_pessimistic_lock_table.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+const std::string kLockTableRootPath = "./unit_test_pessimistic_lock_table";
+const std::string kLockTableLogPath = kLockTableRootPath + "/log";
+const std::string kLockTableStorePath = kLockTableRootPath + "/db";
+
+const std::string kLockTableYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLockTableLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kLockTableStorePath + "\n";
+
+DECLARE_bool(enable_txn_pessimistic_lock_table);
+DECLARE_int64(txn_pessimistic_lock_table_region_max_memory);
+
+class PessimisticLockTableTest : public testing::Test {
+ protected:
+  void SetUp() override { FLAGS_enable_txn_pessimistic_lock_table = true; }
+  void TearDown() override { FLAGS_enable_txn_pessimistic_lock_table = false; }
+};
+
+static pb::store::LockInfo GenLockInfo(const std::string& key, int64_t start_ts) {
+  pb::store::LockInfo lock_info;
+  lock_info.set_primary_lock("primary_key");
+  lock_info.set_key(key);
+  lock_info.set_lock_ts(start_ts);
+  lock_info.set_for_update_ts(start_ts);
+  lock_info.set_lock_ttl(3000);
+  lock_info.set_lock_type(pb::store::Op::Lock);
+  return lock_info;
+}
+
+TEST_F(PessimisticLockTableTest, InsertAndErase) {
+  auto table = PessimisticLockTable::New(1001);
+
+  // inactive table is only for follower
+  EXPECT_FALSE(table->BatchInsert({GenLockInfo("key1", 100)}));
+
+  table->SetActive(true);
+  EXPECT_TRUE(table->BatchInsert({GenLockInfo("key1", 100), GenLockInfo("key2", 100)}));
+  EXPECT_EQ(2, table->Size());
+  EXPECT_GT(table->MemorySize(), 0);
+
+  pb::store::LockInfo lock_info;
+  EXPECT_TRUE(table->Get("key1", lock_info));
+  EXPECT_EQ(100, lock_info.lock_ts());
+  EXPECT_FALSE(table->Get("key3", lock_info));
+
+  table->Erase("key1");
+  EXPECT_FALSE(table->Get("key1", lock_info));
+  EXPECT_EQ(1, table->Size());
+
+  // leader stop drop all locks
+  table->SetActive(false);
+  EXPECT_EQ(0, table->Size());
+  EXPECT_EQ(0, table->MemorySize());
+}
+
+TEST_F(PessimisticLockTableTest, MemoryBudget) {
+  auto table = PessimisticLockTable::New(1002);
+  table->SetActive(true);
+
+  int64_t old_max_memory = FLAGS_txn_pessimistic_lock_table_region_max_memory;
+  FLAGS_txn_pessimistic_lock_table_region_max_memory = 1024;
+
+  std::vector<pb::store::LockInfo> lock_infos;
+  for (int i = 0; i < 100; ++i) {
+    lock_infos.push_back(GenLockInfo("key" + std::to_string(i), 100));
+  }
+  // all or nothing
+  EXPECT_FALSE(table->BatchInsert(lock_infos));
+  EXPECT_EQ(0, table->Size());
+
+  FLAGS_txn_pessimistic_lock_table_region_max_memory = old_max_memory;
+  EXPECT_TRUE(table->BatchInsert(lock_infos));
+  EXPECT_EQ(100, table->Size());
+}
+
+TEST_F(PessimisticLockTableTest, SuspendAndResume) {
+  auto table = PessimisticLockTable::New(1003);
+  table->SetActive(true);
+  EXPECT_TRUE(table->BatchInsert({GenLockInfo("key1", 100)}));
+
+  // suspend keep exist locks for materialize
+  table->Suspend();
+  EXPECT_FALSE(table->BatchInsert({GenLockInfo("key2", 100)}));
+  EXPECT_EQ(1, table->GetAllLocks().size());
+
+  table->Resume();
+  EXPECT_TRUE(table->BatchInsert({GenLockInfo("key2", 100)}));
+
+  // leader stop after suspend, resume is no-op
+  table->Suspend();
+  table->SetActive(false);
+  table->Resume();
+  EXPECT_FALSE(table->IsActive());
+}
+
+TEST_F(PessimisticLockTableTest, GetLocks) {
+  auto table = PessimisticLockTable::New(1004);
+  table->SetActive(true);
+  EXPECT_TRUE(table->BatchInsert({GenLockInfo("key1", 100), GenLockInfo("key3", 100), GenLockInfo("key5", 100)}));
+
+  auto lock_infos = table->GetLocks("key2", "key5");
+  ASSERT_EQ(1, lock_infos.size());
+  EXPECT_EQ("key3", lock_infos[0].key());
+
+  lock_infos = table->GetLocks("key1", "key6");
+  ASSERT_EQ(3, lock_infos.size());
+  EXPECT_EQ("key1", lock_infos[0].key());
+  EXPECT_EQ("key5", lock_infos[2].key());
+
+  EXPECT_TRUE(table->GetLocks("key6", "key9").empty());
+}
+
+class PessimisticLockScanTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kLockTableStorePath);
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kLockTableYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF}));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kLockTableRootPath);
+  }
+
+  void SetUp() override { FLAGS_enable_txn_pessimistic_lock_table = true; }
+  void TearDown() override { FLAGS_enable_txn_pessimistic_lock_table = false; }
+
+  static void PutLockCf(const pb::store::LockInfo& lock_info) {
+    pb::common::KeyValue kv;
+    kv.set_key(mvcc::Codec::EncodeKey(lock_info.key(), Constant::kLockVer));
+    kv.set_value(lock_info.SerializeAsString());
+    ASSERT_TRUE(engine->Writer()->KvPut(Constant::kTxnLockCF, kv).ok());
+  }
+
+  inline static std::shared_ptr<RocksRawEngine> engine;
+};
+
+TEST_F(PessimisticLockScanTest, ScanLockInfoMergeMemoryLocks) {
+  PutLockCf(GenLockInfo("wkey2", 100));
+  PutLockCf(GenLockInfo("wkey4", 200));
+
+  auto table = PessimisticLockTable::New(1005);
+  table->SetActive(true);
+  EXPECT_TRUE(table->BatchInsert({GenLockInfo("wkey1", 100), GenLockInfo("wkey3", 300), GenLockInfo("wkey9", 100)}));
+
+  pb::common::Range range;
+  range.set_start_key("wkey0");
+  range.set_end_key("wkey5");
+
+  // all locks in range, ordered by key
+  std::vector<pb::store::LockInfo> lock_infos;
+  bool has_more = false;
+  std::string end_key;
+  auto status = TxnEngineHelper::ScanLockInfo(Stream::New(1000), engine, table, 0, INT64_MAX, range, 0, lock_infos,
+                                              has_more, end_key);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(4, lock_infos.size());
+  EXPECT_EQ("wkey1", lock_infos[0].key());
+  EXPECT_EQ("wkey2", lock_infos[1].key());
+  EXPECT_EQ("wkey3", lock_infos[2].key());
+  EXPECT_EQ("wkey4", lock_infos[3].key());
+  EXPECT_FALSE(has_more);
+
+  // filter by lock_ts, e.g. resolve lock of one txn
+  lock_infos.clear();
+  status = TxnEngineHelper::ScanLockInfo(Stream::New(1000), engine, table, 100, 101, range, 0, lock_infos, has_more,
+                                         end_key);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(2, lock_infos.size());
+  EXPECT_EQ("wkey1", lock_infos[0].key());
+  EXPECT_EQ("wkey2", lock_infos[1].key());
+
+  // stream continue from where it stop, no lock is returned twice
+  auto stream = Stream::New(3);
+  lock_infos.clear();
+  status = TxnEngineHelper::ScanLockInfo(stream, engine, table, 0, INT64_MAX, range, 0, lock_infos, has_more, end_key);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(3, lock_infos.size());
+  EXPECT_TRUE(has_more);
+
+  std::vector<pb::store::LockInfo> more_lock_infos;
+  status = TxnEngineHelper::ScanLockInfo(stream, engine, table, 0, INT64_MAX, range, 0, more_lock_infos, has_more,
+                                         end_key);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(1, more_lock_infos.size());
+  EXPECT_EQ("wkey4", more_lock_infos[0].key());
+}
+
+}  // namespace dingodb
@@ -23,6 +23,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "butil/status.h"
@@ -625,11 +626,11 @@ TEST_F(DiskANNCoreTest, Search) {
     std::vector<pb::common::Vector> vectors;
     std::vector<pb::index::VectorWithDistanceResult> results;
 
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
   }
 
@@ -649,21 +650,21 @@ TEST_F(DiskANNCoreTest, Search) {
     uint32_t top_n = 0;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -684,21 +685,21 @@ TEST_F(DiskANNCoreTest, Search) {
     uint32_t top_n = 20;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -719,24 +720,59 @@ TEST_F(DiskANNCoreTest, Search) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
+
+  // filter ids and search list size
+  {
+    std::vector<pb::common::Vector> vectors;
+    for (int i = 0; i < data_base_size; i++) {
+      pb::common::Vector vector;
+      vector.set_dimension(dimension);
+      vector.set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      for (int j = 0; j < dimension; j++) {
+        vector.add_float_values(data_base[i * dimension + j]);
+      }
+
+      vectors.push_back(vector);
+    }
+
+    std::unordered_set<uint64_t> filter_ids;
+    for (int i = 0; i < data_base_size; i += 2) {
+      filter_ids.insert(i);
+    }
+
+    uint32_t top_n = 3;
+    pb::common::SearchDiskAnnParam search_param;
+    search_param.set_search_list_size(50);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, &filter_ids, nullptr, results, state);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(results.size(), vectors.size());
+    for (const auto& result : results) {
+      EXPECT_LE(result.vector_with_distances_size(), top_n);
+      for (const auto& vector_with_distance : result.vector_with_distances()) {
+        EXPECT_EQ(filter_ids.count(vector_with_distance.vector_with_id().id()), 1);
+      }
+    }
+    results.clear();
+  }
 }
 
 TEST_F(DiskANNCoreTest, Add) {
@@ -793,7 +829,7 @@ TEST_F(DiskANNCoreTest, SearchCompare) {
     pb::common::SearchDiskAnnParam search_param;
 
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, disk_ann_core_l2_results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, disk_ann_core_l2_results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     // DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     // for (size_t i = 0; i < results.size(); i++) {
@@ -801,7 +837,7 @@ TEST_F(DiskANNCoreTest, SearchCompare) {
     // }
     // results.clear();
 
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, disk_ann_core_ip_results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, disk_ann_core_ip_results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     // DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     // for (size_t i = 0; i < results.size(); i++) {
@@ -809,7 +845,7 @@ TEST_F(DiskANNCoreTest, SearchCompare) {
     // }
     // results.clear();
 
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, disk_ann_core_cosine_results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, disk_ann_core_cosine_results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     // results.clear();
   }
@@ -992,21 +1028,21 @@ TEST_F(DiskANNCoreTest, SearchAgain) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -1166,7 +1202,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     EXPECT_EQ(results.size(), data_base_size);
     results.clear();
@@ -1176,7 +1212,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
       threads.emplace_back([top_n, search_param, vectors, disk_ann_core = disk_ann_core_l2]() {
         std::vector<pb::index::VectorWithDistanceResult> results;
         DiskANNCoreState state;
-        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, results, state);
+        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
         EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
         EXPECT_EQ(results.size(), data_base_size);
       });
@@ -1188,7 +1224,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
 
     threads.clear();
 
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     EXPECT_EQ(results.size(), data_base_size);
     results.clear();
@@ -1197,7 +1233,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
       threads.emplace_back([top_n, search_param, vectors, disk_ann_core = disk_ann_core_ip]() {
         std::vector<pb::index::VectorWithDistanceResult> results;
         DiskANNCoreState state;
-        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, results, state);
+        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
         EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
         EXPECT_EQ(results.size(), data_base_size);
       });
@@ -1209,7 +1245,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
 
     threads.clear();
 
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     EXPECT_EQ(results.size(), data_base_size);
     results.clear();
@@ -1218,7 +1254,7 @@ TEST_F(DiskANNCoreTest, ResetAndInitAndTryLoad) {
       threads.emplace_back([top_n, search_param, vectors, disk_ann_core = disk_ann_core_cosine]() {
         std::vector<pb::index::VectorWithDistanceResult> results;
         DiskANNCoreState state;
-        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, results, state);
+        butil::Status ok = disk_ann_core->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
         EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
         EXPECT_EQ(results.size(), data_base_size);
       });
@@ -249,21 +249,21 @@ TEST_F(DiskANNCoreStressTest, Search) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_l2->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_ip->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_core_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_core_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, results, state);
+    ok = disk_ann_core_cosine->Search(top_n, search_param, vectors, nullptr, nullptr, results, state);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
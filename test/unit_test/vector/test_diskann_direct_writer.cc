@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "diskann/diskann_direct_writer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_bool(diskann_import_direct_io);
+DECLARE_int32(diskann_import_buffer_size_kb);
+
+class DiskANNDirectWriterTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { std::filesystem::create_directories(kPath); }
+  static void TearDownTestSuite() { std::filesystem::remove_all(kPath); }
+
+  static inline std::string kPath = "./diskann_direct_writer_test";
+};
+
+static void WriteAndCheck(const std::string& path) {
+  DiskANNDirectWriter writer;
+  ASSERT_TRUE(writer.Open(path, sizeof(uint32_t) * 2).ok());
+
+  // cross several buffers, and the tail is unaligned
+  uint32_t count = 3001;
+  uint32_t dim = 3;
+  std::vector<float> data;
+  for (uint32_t i = 0; i < count; ++i) {
+    float vector[3] = {static_cast<float>(i), static_cast<float>(i) + 0.5F, -static_cast<float>(i)};
+    data.insert(data.end(), vector, vector + dim);
+    ASSERT_TRUE(writer.Append(vector, sizeof(vector)).ok());
+  }
+  EXPECT_EQ(sizeof(uint32_t) * 2 + data.size() * sizeof(float), writer.Size());
+
+  uint32_t header[2] = {count, dim};
+  ASSERT_TRUE(writer.Finish(header, sizeof(header)).ok());
+  EXPECT_FALSE(writer.IsOpen());
+
+  std::ifstream reader(path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(reader)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(sizeof(header) + data.size() * sizeof(float), content.size());
+  EXPECT_EQ(0, memcmp(content.data(), header, sizeof(header)));
+  EXPECT_EQ(0, memcmp(content.data() + sizeof(header), data.data(), data.size() * sizeof(float)));
+}
+
+TEST_F(DiskANNDirectWriterTest, DirectWrite) {
+  FLAGS_diskann_import_direct_io = true;
+  FLAGS_diskann_import_buffer_size_kb = 4;
+
+  WriteAndCheck(kPath + "/direct.bin");
+
+  FLAGS_diskann_import_buffer_size_kb = 8 * 1024;
+}
+
+TEST_F(DiskANNDirectWriterTest, BufferedWrite) {
+  FLAGS_diskann_import_direct_io = false;
+  FLAGS_diskann_import_buffer_size_kb = 4;
+
+  WriteAndCheck(kPath + "/buffered.bin");
+
+  FLAGS_diskann_import_direct_io = true;
+  FLAGS_diskann_import_buffer_size_kb = 8 * 1024;
+}
+
+TEST_F(DiskANNDirectWriterTest, NotOpen) {
+  DiskANNDirectWriter writer;
+  float value = 1.0F;
+  EXPECT_FALSE(writer.Append(&value, sizeof(value)).ok());
+  EXPECT_FALSE(writer.Finish(&value, sizeof(value)).ok());
+}
+
+}  // namespace dingodb
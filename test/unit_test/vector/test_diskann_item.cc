@@ -283,11 +283,11 @@ TEST_F(DiskANNItemTest, SetNoData) {
     std::vector<pb::index::VectorWithDistanceResult> results;
     int64_t ts = 0;
 
-    status = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_IS_NO_DATA);
-    status = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_IS_NO_DATA);
-    status = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_IS_NO_DATA);
   }
 
@@ -756,11 +756,11 @@ TEST_F(DiskANNItemTest, Search) {
     std::vector<pb::common::Vector> vectors;
     std::vector<pb::index::VectorWithDistanceResult> results;
 
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
   }
 
@@ -792,21 +792,21 @@ TEST_F(DiskANNItemTest, Search) {
     uint32_t top_n = 0;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -827,21 +827,21 @@ TEST_F(DiskANNItemTest, Search) {
     uint32_t top_n = 20;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -862,21 +862,21 @@ TEST_F(DiskANNItemTest, Search) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -976,21 +976,21 @@ TEST_F(DiskANNItemTest, SearchAgain) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -1090,11 +1090,11 @@ TEST_F(DiskANNItemTest, FakeBuilded) {
     std::vector<pb::index::VectorWithDistanceResult> results;
     int64_t ts = 0;
 
-    status = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
-    status = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
-    status = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    status = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(status.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1187,13 +1187,13 @@ TEST_F(DiskANNItemTest, Misc) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1301,13 +1301,13 @@ TEST_F(DiskANNItemTest, Misc) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1367,21 +1367,21 @@ TEST_F(DiskANNItemTest, Misc) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -1419,13 +1419,13 @@ TEST_F(DiskANNItemTest, MiscSync) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1533,13 +1533,13 @@ TEST_F(DiskANNItemTest, MiscSync) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1575,21 +1575,21 @@ TEST_F(DiskANNItemTest, MiscSync) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -1627,13 +1627,13 @@ TEST_F(DiskANNItemTest, MiscTryLoadSync) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
 
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EDISKANN_NOT_LOAD);
   }
 
@@ -1668,21 +1668,21 @@ TEST_F(DiskANNItemTest, MiscTryLoadSync) {
     uint32_t top_n = 3;
     pb::common::SearchDiskAnnParam search_param;
     std::vector<pb::index::VectorWithDistanceResult> results;
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_l2 results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_l2 result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     DINGO_LOG(INFO) << "disk_ann_item_ip results size: " << results.size();
     for (size_t i = 0; i < results.size(); i++) {
       DINGO_LOG(INFO) << "disk_ann_item_ip result: " << i << " " << results[i].DebugString();
     }
     results.clear();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
     results.clear();
   }
@@ -451,7 +451,7 @@ TEST_F(DiskANNItemAnnTest, Search) {
   std::vector<pb::index::VectorWithDistanceResult> results;
   {
     auto start = lambda_time_now_function();
-    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_l2->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     auto end = lambda_time_now_function();
 
     DINGO_LOG(INFO) << OutputCostString("l2", "Search", lambda_time_diff_microseconds_function(start, end));
@@ -464,7 +464,7 @@ TEST_F(DiskANNItemAnnTest, Search) {
   results.clear();
   {
     auto start = lambda_time_now_function();
-    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_ip->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     auto end = lambda_time_now_function();
 
     DINGO_LOG(INFO) << OutputCostString("ip", "Search", lambda_time_diff_microseconds_function(start, end));
@@ -477,7 +477,7 @@ TEST_F(DiskANNItemAnnTest, Search) {
   results.clear();
   {
     auto start = lambda_time_now_function();
-    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, results, ts);
+    ok = disk_ann_item_cosine->Search(ctx, top_n, search_param, vectors, {}, results, ts);
     auto end = lambda_time_now_function();
 
     DINGO_LOG(INFO) << OutputCostString("cosine", "Search", lambda_time_diff_microseconds_function(start, end));
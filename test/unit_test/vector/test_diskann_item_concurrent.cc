@@ -326,7 +326,7 @@ TEST_F(DiskANNItemConcurrentTest, Search) {
       uint32_t top_n = 3;
       pb::common::SearchDiskAnnParam search_param;
       std::vector<pb::index::VectorWithDistanceResult> results;
-      status = disk_concurrent_items[k]->Search(ctx, top_n, search_param, vectors, results, ts);
+      status = disk_concurrent_items[k]->Search(ctx, top_n, search_param, vectors, {}, results, ts);
       EXPECT_EQ(status.error_code(), pb::error::Errno::OK);
     }));
   }
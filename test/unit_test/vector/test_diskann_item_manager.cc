@@ -211,4 +211,30 @@ TEST_F(DiskANNItemManagerTest, Import) {
   }
 }
 
+TEST_F(DiskANNItemManagerTest, ApportionNodeCache) {
+  using Demand = DiskANNItemManager::NodeCacheDemand;
+
+  // even part 200, load part 800 split 3:1:0
+  auto num_nodes = DiskANNItemManager::ApportionNodeCache(1000, 0.2, {Demand{300, 10, 1000}, Demand{100, 10, 1000},
+                                                                      Demand{0, 10, 1000}});
+  EXPECT_EQ(std::vector<int64_t>({66, 26, 6}), num_nodes);
+
+  // capped share is given to others
+  num_nodes = DiskANNItemManager::ApportionNodeCache(1000, 0.2, {Demand{300, 10, 5}, Demand{100, 10, 1000},
+                                                                 Demand{0, 10, 1000}});
+  EXPECT_EQ(std::vector<int64_t>({5, 85, 9}), num_nodes);
+
+  // budget is enough for all
+  num_nodes = DiskANNItemManager::ApportionNodeCache(100000, 0.2, {Demand{3, 10, 5}, Demand{1, 10, 7}});
+  EXPECT_EQ(std::vector<int64_t>({5, 7}), num_nodes);
+
+  // no load, and invalid demand
+  num_nodes = DiskANNItemManager::ApportionNodeCache(1000, 0.0, {Demand{0, 10, 1000}, Demand{0, 0, 1000},
+                                                                 Demand{0, 10, 0}});
+  EXPECT_EQ(std::vector<int64_t>({100, 0, 0}), num_nodes);
+
+  num_nodes = DiskANNItemManager::ApportionNodeCache(0, 0.2, {Demand{1, 10, 1000}});
+  EXPECT_EQ(std::vector<int64_t>({0}), num_nodes);
+}
+
 }  // namespace dingodb
@@ -140,6 +140,75 @@ TEST_F(VectorIndexWrapperTest, Add_Sibling) {
   EXPECT_EQ(1499, count);
 }
 
+static pb::common::VectorIndexParameter GenHnswParameter(int dimension) {
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(1000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(2);
+  return index_parameter;
+}
+
+TEST_F(VectorIndexWrapperTest, EvictVectorIndex) {
+  int64_t id = 2;
+  auto index_parameter = GenHnswParameter(16);
+
+  auto vector_index =
+      VectorIndexFactory::NewHnsw(id, index_parameter, GenEpoch(10), GenRange(1, 1000), vector_index_thread_pool);
+  auto other_vector_index =
+      VectorIndexFactory::NewHnsw(id, index_parameter, GenEpoch(10), GenRange(1000, 2000), vector_index_thread_pool);
+
+  auto vector_index_wrapper = VectorIndexWrapper::New(id, index_parameter);
+  vector_index_wrapper->SetIsTempHoldVectorIndex(true);
+  vector_index_wrapper->UpdateVectorIndex(vector_index, "unit test");
+  ASSERT_TRUE(vector_index_wrapper->IsReady());
+
+  // split/merge in progress, not evictable
+  vector_index_wrapper->SetSiblingVectorIndex(other_vector_index);
+  EXPECT_FALSE(vector_index_wrapper->EvictVectorIndex("unit test"));
+  EXPECT_TRUE(vector_index_wrapper->IsReady());
+  vector_index_wrapper->SetSiblingVectorIndex(nullptr);
+
+  vector_index_wrapper->SetShareVectorIndex(other_vector_index);
+  EXPECT_FALSE(vector_index_wrapper->EvictVectorIndex("unit test"));
+  EXPECT_TRUE(vector_index_wrapper->IsReady());
+  EXPECT_FALSE(vector_index_wrapper->IsEvicted());
+  vector_index_wrapper->SetShareVectorIndex(nullptr);
+
+  EXPECT_TRUE(vector_index_wrapper->EvictVectorIndex("unit test"));
+  EXPECT_TRUE(vector_index_wrapper->IsEvicted());
+  EXPECT_FALSE(vector_index_wrapper->IsReady());
+  EXPECT_EQ(nullptr, vector_index_wrapper->GetOwnVectorIndex());
+
+  // nothing to evict
+  EXPECT_FALSE(vector_index_wrapper->EvictVectorIndex("unit test"));
+
+  // reload done
+  vector_index_wrapper->UpdateVectorIndex(vector_index, "unit test");
+  EXPECT_TRUE(vector_index_wrapper->IsReady());
+  EXPECT_FALSE(vector_index_wrapper->IsEvicted());
+}
+
+TEST_F(VectorIndexWrapperTest, ReloadIfEvicted) {
+  int64_t id = 3;
+  auto index_parameter = GenHnswParameter(16);
+
+  // not evicted, e.g. building, nothing to reload
+  auto vector_index_wrapper = VectorIndexWrapper::New(id, index_parameter);
+  EXPECT_FALSE(vector_index_wrapper->IsReady());
+  EXPECT_FALSE(vector_index_wrapper->ReloadIfEvicted());
+  EXPECT_FALSE(vector_index_wrapper->IsEvicted());
+
+  // ready, not reload
+  auto vector_index =
+      VectorIndexFactory::NewHnsw(id, index_parameter, GenEpoch(10), GenRange(1, 1000), vector_index_thread_pool);
+  vector_index_wrapper->SetIsTempHoldVectorIndex(true);
+  vector_index_wrapper->UpdateVectorIndex(vector_index, "unit test");
+  EXPECT_TRUE(vector_index_wrapper->ReloadIfEvicted());
+}
+
 static void MergeSearchResult(uint32_t topk, pb::index::VectorWithDistanceResult& input_1,
                               pb::index::VectorWithDistanceResult& input_2,
                               pb::index::VectorWithDistanceResult& results) {
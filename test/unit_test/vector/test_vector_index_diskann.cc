@@ -759,7 +759,7 @@ TEST_F(VectorIndexDiskannTest, Search) {
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
   }
 
-  // filter not support
+  // filter with allowed vector ids
   {
     pb::common::VectorWithId vector_with_id;
     vector_with_id.set_id(0 + data_base_size);
@@ -782,12 +782,23 @@ TEST_F(VectorIndexDiskannTest, Search) {
 
     auto flat_list_filter_functor = std::make_shared<VectorIndex::ConcreteFilterFunctor>(vector_ids);
 
+    auto lambda_check_results_function = [&]() {
+      for (const auto& result : results) {
+        for (const auto& vector_with_distance : result.vector_with_distances()) {
+          EXPECT_TRUE(flat_list_filter_functor->Check(vector_with_distance.vector_with_id().id()));
+        }
+      }
+    };
+
     ok = vector_index_diskann_l2->Search(vector_with_ids, topk, {flat_list_filter_functor}, false, {}, results);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EVECTOR_NOT_SUPPORT);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    lambda_check_results_function();
     ok = vector_index_diskann_ip->Search(vector_with_ids, topk, {flat_list_filter_functor}, false, {}, results);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EVECTOR_NOT_SUPPORT);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    lambda_check_results_function();
     ok = vector_index_diskann_cosine->Search(vector_with_ids, topk, {flat_list_filter_functor}, false, {}, results);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EVECTOR_NOT_SUPPORT);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    lambda_check_results_function();
   }
 
   // ok
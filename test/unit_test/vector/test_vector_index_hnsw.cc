@@ -608,4 +608,91 @@ TEST_F(VectorIndexHnswTest, EfSearchCosine) {
   }
 }
 
+TEST_F(VectorIndexHnswTest, RangeSearchCosine) {
+  butil::Status ok;
+
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(0);
+  vector_with_id.mutable_vector()->set_dimension(dimension);
+  vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+  for (size_t i = 0; i < dimension; i++) {
+    vector_with_id.mutable_vector()->add_float_values(data_base[i + dimension]);
+  }
+  std::vector<pb::common::VectorWithId> vector_with_ids = {vector_with_id};
+
+  // all vectors
+  {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_hnsw->RangeSearch(vector_with_ids, 10.0f, {}, false, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].vector_with_distances_size(), data_base_size);
+
+    for (int i = 1; i < results[0].vector_with_distances_size(); ++i) {
+      EXPECT_LE(results[0].vector_with_distances(i - 1).distance(), results[0].vector_with_distances(i).distance());
+    }
+  }
+
+  // nearest is itself
+  {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_hnsw->RangeSearch(vector_with_ids, 1e-5, {}, false, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_GE(results[0].vector_with_distances_size(), 1);
+    EXPECT_LT(results[0].vector_with_distances_size(), data_base_size);
+    EXPECT_EQ(results[0].vector_with_distances(0).vector_with_id().id(), 1);
+  }
+}
+
+TEST_F(VectorIndexHnswTest, SelectiveFilterSearchCosine) {
+  butil::Status ok;
+
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(0);
+  vector_with_id.mutable_vector()->set_dimension(dimension);
+  vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+  for (size_t i = 0; i < dimension; i++) {
+    vector_with_id.mutable_vector()->add_float_values(data_base[i]);
+  }
+  std::vector<pb::common::VectorWithId> vector_with_ids = {vector_with_id};
+
+  // allowed ids less than topk, brute force over allowed ids
+  {
+    std::vector<int64_t> vector_ids = {3, 7};
+    auto filter = std::make_shared<VectorIndex::SortFilterFunctor>(vector_ids);
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_hnsw->Search(vector_with_ids, 5, {filter}, false, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_EQ(results[0].vector_with_distances_size(), 2);
+    for (const auto &vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_TRUE(vector_with_distance.vector_with_id().id() == 3 || vector_with_distance.vector_with_id().id() == 7);
+    }
+
+    results.clear();
+    ok = vector_index_hnsw->RangeSearch(vector_with_ids, 10.0f, {filter}, false, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].vector_with_distances_size(), 2);
+  }
+
+  // negation filter has no explicit allowed ids, search by graph
+  {
+    std::vector<int64_t> vector_ids = {3, 7};
+    auto filter = std::make_shared<VectorIndex::SortFilterFunctor>(vector_ids, true);
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_hnsw->Search(vector_with_ids, data_base_size, {filter}, false, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].vector_with_distances_size(), data_base_size - 2);
+    for (const auto &vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_NE(vector_with_distance.vector_with_id().id(), 3);
+      EXPECT_NE(vector_with_distance.vector_with_id().id(), 7);
+    }
+  }
+}
+
 }  // namespace dingodb
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "vector/vector_index_manager.h"
+
+namespace dingodb {
+
+class VectorIndexManagerTest : public testing::Test {
+ protected:
+  static constexpr int64_t kNowMs = 1000000;
+  static constexpr int64_t kMinIdleMs = 1000;
+};
+
+TEST_F(VectorIndexManagerTest, PickEvictVectorIndexUnderBudget) {
+  std::vector<VectorIndexManager::EvictCandidate> candidates = {
+      {1, 100, 0, true},
+      {2, 100, 0, true},
+  };
+
+  EXPECT_TRUE(VectorIndexManager::PickEvictVectorIndex(candidates, 200, 100, kNowMs, kMinIdleMs).empty());
+}
+
+TEST_F(VectorIndexManagerTest, PickEvictVectorIndexLru) {
+  std::vector<VectorIndexManager::EvictCandidate> candidates = {
+      {1, 100, kNowMs - 5000, true},
+      // least recently used, but not evictable
+      {2, 100, kNowMs - 9000, false},
+      {3, 100, kNowMs - 8000, true},
+      {4, 100, kNowMs - 7000, true},
+      // hot
+      {5, 100, kNowMs - 10, true},
+  };
+
+  // 500 -> 300
+  auto victims = VectorIndexManager::PickEvictVectorIndex(candidates, 400, 300, kNowMs, kMinIdleMs);
+  EXPECT_EQ(std::vector<int64_t>({3, 4}), victims);
+
+  // 500 -> 0, hot and not evictable are kept
+  victims = VectorIndexManager::PickEvictVectorIndex(candidates, 400, 0, kNowMs, kMinIdleMs);
+  EXPECT_EQ(std::vector<int64_t>({3, 4, 1}), victims);
+}
+
+}  // namespace dingodb
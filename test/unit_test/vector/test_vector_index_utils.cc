@@ -24,9 +24,12 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "butil/status.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexIVFFlat.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -4846,4 +4849,154 @@ TEST_F(VectorIndexUtilsTest, NormalizeVectorForHnsw) {
   }
 }
 
+TEST_F(VectorIndexUtilsTest, RefineSearchResult) {
+  constexpr uint32_t kDimension = 2;
+
+  std::vector<pb::common::VectorWithId> vector_with_ids(1);
+  vector_with_ids[0].mutable_vector()->add_float_values(0.0F);
+  vector_with_ids[0].mutable_vector()->add_float_values(0.0F);
+
+  auto gen_results = [](const std::vector<int64_t>& ids) {
+    std::vector<pb::index::VectorWithDistanceResult> results(1);
+    for (auto id : ids) {
+      auto* vector_with_distance = results[0].add_vector_with_distances();
+      vector_with_distance->mutable_vector_with_id()->set_id(id);
+      vector_with_distance->set_distance(0.0F);
+    }
+    return results;
+  };
+
+  std::unordered_map<int64_t, std::vector<float>> exact_vectors;
+  exact_vectors[1] = {3.0F, 0.0F};
+  exact_vectors[2] = {1.0F, 0.0F};
+  exact_vectors[3] = {0.0F, 2.0F};
+  // id 4 is deleted
+
+  // l2, re-order by exact distance and truncate to topk
+  {
+    auto results = gen_results({1, 2, 3, 4});
+    auto status = VectorIndexUtils::RefineSearchResult(vector_with_ids, 2, pb::common::MetricType::METRIC_TYPE_L2,
+                                                       kDimension, exact_vectors, results);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ASSERT_EQ(2, results[0].vector_with_distances_size());
+    EXPECT_EQ(2, results[0].vector_with_distances(0).vector_with_id().id());
+    EXPECT_FLOAT_EQ(1.0F, results[0].vector_with_distances(0).distance());
+    EXPECT_EQ(3, results[0].vector_with_distances(1).vector_with_id().id());
+    EXPECT_FLOAT_EQ(4.0F, results[0].vector_with_distances(1).distance());
+  }
+
+  // inner product, distance is 1 - ip
+  {
+    std::vector<pb::common::VectorWithId> ip_vector_with_ids(1);
+    ip_vector_with_ids[0].mutable_vector()->add_float_values(1.0F);
+    ip_vector_with_ids[0].mutable_vector()->add_float_values(0.0F);
+
+    auto results = gen_results({3, 2, 4, 1});
+    auto status = VectorIndexUtils::RefineSearchResult(ip_vector_with_ids, 10,
+                                                       pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, kDimension,
+                                                       exact_vectors, results);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ASSERT_EQ(3, results[0].vector_with_distances_size());
+    EXPECT_EQ(1, results[0].vector_with_distances(0).vector_with_id().id());
+    EXPECT_FLOAT_EQ(-2.0F, results[0].vector_with_distances(0).distance());
+    EXPECT_EQ(2, results[0].vector_with_distances(1).vector_with_id().id());
+    EXPECT_EQ(3, results[0].vector_with_distances(2).vector_with_id().id());
+    EXPECT_FLOAT_EQ(1.0F, results[0].vector_with_distances(2).distance());
+  }
+
+  // result size not match query size
+  {
+    auto results = gen_results({1});
+    results.emplace_back();
+    auto status = VectorIndexUtils::RefineSearchResult(vector_with_ids, 2, pb::common::MetricType::METRIC_TYPE_L2,
+                                                       kDimension, exact_vectors, results);
+    EXPECT_FALSE(status.ok());
+  }
+}
+
+TEST_F(VectorIndexUtilsTest, VectorTrainDataSampler) {
+  constexpr faiss::idx_t kDimension = 2;
+
+  // no limit, keep all
+  {
+    VectorTrainDataSampler sampler(kDimension, 0, 1);
+    for (int i = 0; i < 100; ++i) {
+      float vector[kDimension] = {static_cast<float>(i), static_cast<float>(i)};
+      sampler.Put(sampler.Next(), vector);
+    }
+    EXPECT_EQ(100, sampler.Size());
+    EXPECT_EQ(100, sampler.SeenCount());
+    EXPECT_EQ(99.0F, sampler.Data()[99 * kDimension]);
+  }
+
+  // keep capacity, and every vector has the same chance
+  {
+    constexpr int64_t kCapacity = 1000;
+    constexpr int64_t kCount = 100000;
+    VectorTrainDataSampler sampler(kDimension, kCapacity, 1);
+    for (int64_t i = 0; i < kCount; ++i) {
+      int64_t pos = sampler.Next();
+      if (pos < 0) {
+        continue;
+      }
+      float vector[kDimension] = {static_cast<float>(i), static_cast<float>(i)};
+      sampler.Put(pos, vector);
+    }
+    EXPECT_EQ(kCapacity, sampler.Size());
+    EXPECT_EQ(kCount, sampler.SeenCount());
+    ASSERT_EQ(kCapacity * kDimension, sampler.Data().size());
+
+    int64_t tail_count = 0;
+    for (int64_t i = 0; i < kCapacity; ++i) {
+      if (sampler.Data()[i * kDimension] >= kCount / 2) {
+        ++tail_count;
+      }
+    }
+    EXPECT_GT(tail_count, kCapacity * 4 / 10);
+    EXPECT_LT(tail_count, kCapacity * 6 / 10);
+  }
+}
+
+TEST_F(VectorIndexUtilsTest, TrainIvfQuantizer) {
+  constexpr faiss::idx_t kDimension = 8;
+  constexpr faiss::idx_t kNlist = 4;
+  constexpr faiss::idx_t kDataSize = 2000;
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+  std::vector<float> train_datas(kDataSize * kDimension);
+  for (auto& elem : train_datas) {
+    elem = distrib(rng);
+  }
+
+  faiss::IndexFlatL2 cold_quantizer(kDimension);
+  faiss::IndexIVFFlat cold_index(&cold_quantizer, kDimension, kNlist);
+  cold_index.train(kDataSize, train_datas.data());
+  ASSERT_TRUE(cold_index.is_trained);
+
+  std::vector<float> init_centroids(kNlist * kDimension);
+  cold_quantizer.reconstruct_n(0, kNlist, init_centroids.data());
+
+  faiss::IndexFlatL2 quantizer(kDimension);
+  faiss::IndexIVFFlat index(&quantizer, kDimension, kNlist);
+
+  // not match nlist
+  auto status = VectorIndexUtils::TrainIvfQuantizer(&index, train_datas.data(), kDataSize,
+                                                    std::vector<float>(kDimension), 4);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(0, quantizer.ntotal);
+
+  status = VectorIndexUtils::TrainIvfQuantizer(&index, train_datas.data(), kDataSize, init_centroids, 4);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  EXPECT_EQ(kNlist, quantizer.ntotal);
+
+  // quantizer is trained, index train skip it
+  index.train(kDataSize, train_datas.data());
+  EXPECT_TRUE(index.is_trained);
+  EXPECT_EQ(kNlist, quantizer.ntotal);
+
+  index.add(kDataSize, train_datas.data());
+  EXPECT_EQ(kDataSize, index.ntotal);
+}
+
 }  // namespace dingodb
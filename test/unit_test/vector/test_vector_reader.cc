@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <memory>
 #include <random>
+#include <set>
 #include <vector>
 
 #include "butil/status.h"
@@ -24,11 +25,14 @@
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "mvcc/codec.h"
 #include "mvcc/reader.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "server/server.h"
 #include "vector/codec.h"
 #include "vector/vector_index_factory.h"
+#include "vector/vector_index_flat.h"
 #include "vector/vector_reader.h"
 
 namespace dingodb {
@@ -113,6 +117,30 @@ class VectorIndexReaderTest : public testing::Test {
   inline static VectorIndexWrapperPtr vector_index;
 };
 
+// mock a vector index which return partial hits and ask for brute force, like filtered diskann search.
+class ShortVectorIndexFlat : public VectorIndexFlat {
+ public:
+  using VectorIndexFlat::VectorIndexFlat;
+
+  butil::Status Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override {
+    auto status = VectorIndexFlat::Search(vector_with_ids, topk, filters, reconstruct, parameter, results);
+    if (!status.ok()) {
+      return status;
+    }
+
+    for (auto& result : results) {
+      while (result.vector_with_distances_size() > 1) {
+        result.mutable_vector_with_distances()->RemoveLast();
+      }
+    }
+
+    return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, "partial hits");
+  }
+};
+
 std::shared_ptr<RocksRawEngine> VectorIndexReaderTest::engine = nullptr;
 std::shared_ptr<Config> VectorIndexReaderTest::config = nullptr;
 
@@ -1910,4 +1938,74 @@ TEST_F(VectorIndexReaderTest, IdPreFilter) {
   }
 }
 
+TEST_F(VectorIndexReaderTest, BruteForceFallbackDropPartialResults) {
+  ASSERT_TRUE(Server::GetInstance().InitVectorIndexManager());
+
+  const int64_t fallback_partition_id = 0x2233445566778899;
+  const uint32_t topk = 5;
+
+  pb::common::Range region_range;
+  std::string start_key = VectorCodec::EncodeVectorKey(prefix, fallback_partition_id);
+  region_range.set_start_key(start_key);
+  region_range.set_end_key(Helper::PrefixNext(start_key));
+
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  int64_t id = 100;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  auto short_index =
+      std::make_shared<ShortVectorIndexFlat>(id, index_parameter, epoch, region_range, vector_index_thread_pool);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  RawEngine::WriterPtr writer = engine->Writer();
+  for (int64_t vector_id = 1; vector_id <= 20; ++vector_id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(vector_id);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+    for (int j = 0; j < dimension; ++j) {
+      vector_with_id.mutable_vector()->add_float_values(static_cast<float>(vector_id) + j * 0.1);
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(mvcc::Codec::EncodeKey(VectorCodec::EncodeVectorKey(prefix, fallback_partition_id, vector_id), 1));
+    std::string value = vector_with_id.vector().SerializeAsString();
+    mvcc::Codec::PackageValue(mvcc::ValueFlag::kPut, value);
+    kv.set_value(value);
+    ASSERT_TRUE(writer->KvPut(Constant::kVectorDataCF, kv).ok());
+
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(short_index->Upsert(vector_with_ids).ok());
+
+  auto wrapper = std::make_shared<VectorIndexWrapper>(id, index_parameter, 100);
+  wrapper->SetShareVectorIndex(short_index);
+
+  std::vector<pb::common::VectorWithId> query_vectors = {vector_with_ids[3], vector_with_ids[10]};
+  pb::common::VectorSearchParameter parameter;
+  parameter.set_top_n(topk);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+
+  VectorReader vector_reader(mvcc::VectorReader::New(engine->Reader()));
+  auto status = vector_reader.SearchAndRangeSearchWrapper(wrapper, region_range, query_vectors, parameter, results,
+                                                          topk, {});
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(query_vectors.size(), results.size());
+
+  for (const auto& result : results) {
+    EXPECT_EQ(topk, result.vector_with_distances_size());
+
+    std::set<int64_t> ids;
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      ids.insert(vector_with_distance.vector_with_id().id());
+    }
+    EXPECT_EQ(topk, ids.size());
+  }
+}
+
 }  // namespace dingodb